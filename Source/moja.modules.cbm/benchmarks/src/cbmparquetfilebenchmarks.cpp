@@ -0,0 +1,133 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/cbmaggregatorparquetwriter.h"
+#include "moja/modules/cbm/classifiersetinterner.h"
+#include "moja/modules/cbm/flatrecord.h"
+
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace moja::modules;
+
+namespace {
+
+    const int kYears = 20;
+    const int kClassifierSets = 250;
+    const int kPoolPairs = 40;
+
+    class ColumnTypes : public cbm::FlatRecordColumnVisitor {
+    public:
+        void integer(int) override { types.push_back(cbm::FlatColumnType::Integer); }
+        void number(double) override { types.push_back(cbm::FlatColumnType::Number); }
+        void text(const std::string&) override { types.push_back(cbm::FlatColumnType::Text); }
+        void null(cbm::FlatColumnType type) override { types.push_back(type); }
+
+        std::vector<cbm::FlatColumnType> types;
+    };
+
+    /**
+     * Flux records shaped like a typical aggregated run: a few hundred classifier sets, each with
+     * the same set of pool-to-pool fluxes every year, and the odd disturbance.
+     */
+    std::vector<std::vector<cbm::FlatFluxRecord>> makeFluxesByYear(cbm::ClassifierSetInterner& interner) {
+        std::vector<cbm::ClassifierSetRef> classifierSets;
+        for (int i = 0; i < kClassifierSets; i++) {
+            classifierSets.push_back(interner.intern({
+                std::string("admin_") + std::to_string(i % 13), std::string("eco_") + std::to_string(i % 17),
+                std::string("species_") + std::to_string(i % 11), std::string("site_") + std::to_string(i % 3),
+                std::string("growth_curve_") + std::to_string(i), std::string("ownership_") + std::to_string(i % 2) }));
+        }
+
+        std::vector<std::vector<cbm::FlatFluxRecord>> years(kYears);
+        for (int year = 0; year < kYears; year++) {
+            for (int c = 0; c < kClassifierSets; c++) {
+                auto ageClass = std::to_string((year + c) % 20 * 10) + "-" + std::to_string((year + c) % 20 * 10 + 9);
+                for (int p = 0; p < kPoolPairs; p++) {
+                    bool disturbed = (year + c + p) % 97 == 0;
+                    years[year].emplace_back(
+                        2000 + year, classifierSets[c], "FL", ageClass, classifierSets[c], "FL", ageClass,
+                        disturbed ? Poco::Nullable<std::string>("Wildfire") : Poco::Nullable<std::string>(),
+                        disturbed ? Poco::Nullable<int>(1) : Poco::Nullable<int>(),
+                        "Pool_" + std::to_string(p % 19), "Pool_" + std::to_string((p * 7 + 3) % 19),
+                        (year + 1) * 0.731 + c * 0.0173 + p * 1.13);
+                }
+            }
+        }
+
+        return years;
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(CBMParquetFileBenchmarks);
+
+BOOST_AUTO_TEST_CASE(ParquetAgainstCsvSizeAndWriteTime) {
+    std::vector<std::string> classifierNames{ "admin", "eco", "species", "site", "growth_curve", "ownership" };
+    cbm::ClassifierSetInterner interner;
+    auto fluxesByYear = makeFluxesByYear(interner);
+    const auto& first = fluxesByYear[0][0];
+    auto header = first.header(classifierNames);
+
+    auto dir = std::filesystem::temp_directory_path() / ("cbmparquetfilebenchmarks_"
+        + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    std::filesystem::create_directories(dir);
+    auto csvPath = (dir / "flux.csv").string();
+    auto parquetPath = (dir / "flux.parquet").string();
+
+    // Same text the CSV writer produces: the header, then asPersistable() per record.
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::ofstream csv(csvPath, std::ios::binary);
+        csv << header;
+        for (const auto& year : fluxesByYear) {
+            for (const auto& record : year) {
+                csv << record.asPersistable();
+            }
+        }
+    }
+    auto csvElapsed = std::chrono::steady_clock::now() - start;
+
+    std::vector<std::string> columnNames;
+    boost::split(columnNames, boost::trim_copy(header), boost::is_any_of(","));
+    ColumnTypes columnTypes;
+    first.visitColumns(columnTypes);
+
+    // Same calls the Parquet writer makes: one row group per year.
+    start = std::chrono::steady_clock::now();
+    {
+        cbm::CBMParquetFile parquet(parquetPath, columnNames, columnTypes.types, "snappy", 1024 * 1024);
+        for (const auto& year : fluxesByYear) {
+            for (const auto& record : year) {
+                record.visitColumns(parquet.rowBuilder());
+                parquet.endRow();
+            }
+
+            parquet.writeRowGroup();
+        }
+
+        parquet.save();
+    }
+    auto parquetElapsed = std::chrono::steady_clock::now() - start;
+
+    auto csvBytes = std::filesystem::file_size(csvPath);
+    auto parquetBytes = std::filesystem::file_size(parquetPath);
+    auto csvMs = std::chrono::duration_cast<std::chrono::milliseconds>(csvElapsed).count();
+    auto parquetMs = std::chrono::duration_cast<std::chrono::milliseconds>(parquetElapsed).count();
+    std::filesystem::remove_all(dir);
+
+    BOOST_TEST_MESSAGE("rows: " << kYears * kClassifierSets * kPoolPairs
+        << " csv: " << csvBytes << " bytes, " << csvMs << "ms"
+        << " parquet: " << parquetBytes << " bytes, " << parquetMs << "ms"
+        << " size ratio: " << static_cast<double>(csvBytes) / parquetBytes
+        << " time ratio: " << static_cast<double>(csvMs) / std::max<decltype(parquetMs)>(parquetMs, 1));
+
+    BOOST_CHECK_LT(parquetBytes, csvBytes);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,101 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/decayratetable.h"
+#include "moja/modules/cbm/pooldecayparameters.h"
+
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace moja::modules;
+
+namespace {
+
+    typedef std::map<std::string, double> DecayRates;
+
+    std::map<std::string, cbm::PoolDecayParameters> decayParameters() {
+        std::map<std::string, cbm::PoolDecayParameters> parameters;
+        double rate = 0.5;
+        for (auto name : {
+            "AboveGroundVeryFastSoil", "BelowGroundVeryFastSoil", "AboveGroundFastSoil", "BelowGroundFastSoil",
+            "MediumSoil", "SoftwoodStemSnag", "SoftwoodBranchSnag", "HardwoodStemSnag", "HardwoodBranchSnag",
+            "AboveGroundSlowSoil", "BelowGroundSlowSoil" }) {
+
+            cbm::PoolDecayParameters pool;
+            pool.pool = name;
+            pool.baseDecayRate = rate;
+            pool.maxDecayRate = 1.0;
+            pool.q10 = 2.65;
+            pool.tRef = 10.0;
+            pool.pAtm = 0.83;
+            parameters[name] = pool;
+            rate *= 0.6;
+        }
+
+        return parameters;
+    }
+
+    DecayRates computeRates(const std::map<std::string, cbm::PoolDecayParameters>& parameters, double mat) {
+        DecayRates rates;
+        for (const auto& pool : parameters) {
+            rates.emplace(pool.first, pool.second.getDecayRate(mat));
+        }
+
+        return rates;
+    }
+
+    // A mean annual temperature raster: many pixels, few distinct values.
+    std::vector<double> temperatureRaster(size_t pixels, int distinctValues) {
+        std::mt19937 generator(7);
+        std::uniform_int_distribution<int> value(0, distinctValues - 1);
+        std::vector<double> raster(pixels);
+        for (auto& mat : raster) {
+            mat = -5.0 + value(generator) * 0.25;
+        }
+
+        return raster;
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(DecayRateTableBenchmarks);
+
+BOOST_AUTO_TEST_CASE(TableIsFasterThanComputingRatesPerStep) {
+    // Decay module per step: one rate for each of the eleven dead organic matter pools.
+    const int steps = 10;
+    auto parameters = decayParameters();
+    auto raster = temperatureRaster(100000, 40);
+
+    double direct = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; step++) {
+        for (auto mat : raster) {
+            for (const auto& pool : parameters) {
+                direct += pool.second.getDecayRate(mat);
+            }
+        }
+    }
+    auto directElapsed = std::chrono::steady_clock::now() - start;
+
+    double memoized = 0.0;
+    cbm::DecayRateTable<DecayRates> table;
+    start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; step++) {
+        for (auto mat : raster) {
+            const auto& rates = table.get(mat, [&parameters](double t) { return computeRates(parameters, t); });
+            for (const auto& rate : rates) {
+                memoized += rate.second;
+            }
+        }
+    }
+    auto memoizedElapsed = std::chrono::steady_clock::now() - start;
+
+    BOOST_CHECK_EQUAL(direct, memoized);
+    BOOST_TEST_MESSAGE("pixel steps: " << raster.size() * steps
+        << " direct: " << std::chrono::duration_cast<std::chrono::milliseconds>(directElapsed).count() << "ms"
+        << " table: " << std::chrono::duration_cast<std::chrono::milliseconds>(memoizedElapsed).count() << "ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
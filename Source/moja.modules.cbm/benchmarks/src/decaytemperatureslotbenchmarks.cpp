@@ -0,0 +1,136 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/decayratetable.h"
+#include "moja/modules/cbm/pooldecayparameters.h"
+#include "moja/modules/cbm/timeseries.h"
+#include "moja/modules/cbm/variableslot.h"
+
+#include <moja/flint/timing.h>
+
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace moja;
+using namespace moja::modules;
+
+namespace {
+
+    typedef std::map<std::string, double> DecayRates;
+
+    // Annual timing over parameter years.
+    void initTiming(flint::Timing& timing, int years) {
+        timing.setStartDate(DateTime(2000, 1, 1));
+        timing.setEndDate(DateTime(2000 + years, 1, 1));
+        timing.setStepping(flint::TimeStepping::Annual);
+        timing.init();
+    }
+
+    std::map<std::string, cbm::PoolDecayParameters> decayParameters() {
+        std::map<std::string, cbm::PoolDecayParameters> parameters;
+        double rate = 0.5;
+        for (auto name : {
+            "AboveGroundVeryFastSoil", "BelowGroundVeryFastSoil", "AboveGroundFastSoil", "BelowGroundFastSoil",
+            "MediumSoil", "SoftwoodStemSnag", "SoftwoodBranchSnag", "HardwoodStemSnag", "HardwoodBranchSnag",
+            "AboveGroundSlowSoil", "BelowGroundSlowSoil" }) {
+
+            cbm::PoolDecayParameters pool;
+            pool.pool = name;
+            pool.baseDecayRate = rate;
+            pool.maxDecayRate = 1.0;
+            pool.q10 = 2.65;
+            pool.tRef = 10.0;
+            pool.pAtm = 0.83;
+            parameters[name] = pool;
+            rate *= 0.6;
+        }
+
+        return parameters;
+    }
+
+    // One land unit's decay for a step: every dead organic matter pool loses its decay rate.
+    void decayStep(std::vector<double>& pools, const DecayRates& rates) {
+        size_t p = 0;
+        for (const auto& rate : rates) {
+            pools[p++] *= 1.0 - rate.second;
+        }
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(DecayTemperatureSlotBenchmarks);
+
+BOOST_AUTO_TEST_CASE(BenchmarkDecayStepTemperatureRead) {
+    // The part of the decay modules' step that the slot changes, for every land unit: read the
+    // mean annual temperature, look up the decay rates for it and decay the dead organic matter
+    // pools. Growth, the other modules and FLINT's operations are not part of it, so the slot
+    // saves a smaller share of a full CBM step than of this one.
+    const int landUnits = 2000;
+    const int years = 50;
+    flint::Timing timing;
+    initTiming(timing, years);
+
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> temperature(-20, 20);
+    std::vector<DynamicVar> temperatures;
+    for (int i = 0; i < landUnits; i++) {
+        std::vector<boost::optional<double>> raw;
+        for (int year = 0; year <= years; year++) {
+            raw.push_back(temperature(generator) * 0.25);
+        }
+
+        cbm::TimeSeries series(0, 1, years + 1, true, raw);
+        series.setTiming(&timing);
+        temperatures.push_back(DynamicVar(series));
+    }
+
+    auto parameters = decayParameters();
+    auto computeRates = [&parameters](double mat) {
+        DecayRates rates;
+        for (const auto& pool : parameters) {
+            rates.emplace(pool.first, pool.second.getDecayRate(mat));
+        }
+
+        return rates;
+    };
+
+    // Before: the DynamicVar is copied and its type checked on every step.
+    cbm::DecayRateTable<DecayRates> dynamicTable;
+    std::vector<std::vector<double>> dynamicPools(landUnits, std::vector<double>(parameters.size(), 100.0));
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < landUnits; i++) {
+        for (int step = 1; step < timing.nSteps(); step++) {
+            timing.setStep(step);
+            auto mat = temperatures[i];
+            auto t = mat.isEmpty() ? 0
+                : mat.type() == typeid(cbm::TimeSeries) ? mat.extract<cbm::TimeSeries>().value()
+                : mat.convert<double>();
+
+            decayStep(dynamicPools[i], dynamicTable.get(t, computeRates));
+        }
+    }
+    auto dynamicElapsed = std::chrono::steady_clock::now() - start;
+
+    // After: the slot is loaded when the land unit starts and read directly on every step.
+    cbm::DecayRateTable<DecayRates> slotTable;
+    std::vector<std::vector<double>> slotPools(landUnits, std::vector<double>(parameters.size(), 100.0));
+    cbm::TimeSeriesSlot slot;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < landUnits; i++) {
+        slot.assign(temperatures[i]);
+        for (int step = 1; step < timing.nSteps(); step++) {
+            timing.setStep(step);
+            decayStep(slotPools[i], slotTable.get(slot.value(), computeRates));
+        }
+    }
+    auto slotElapsed = std::chrono::steady_clock::now() - start;
+
+    BOOST_CHECK(dynamicPools == slotPools);
+    BOOST_TEST_MESSAGE("land unit steps: " << landUnits * (timing.nSteps() - 1)
+        << " DynamicVar: " << std::chrono::duration_cast<std::chrono::microseconds>(dynamicElapsed).count() << "us"
+        << " slot: " << std::chrono::duration_cast<std::chrono::microseconds>(slotElapsed).count() << "us");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,79 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/localrecordaccumulator.h"
+#include "moja/modules/cbm/record.h"
+#include "moja/flint/recordaccumulatorwithmutex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace moja;
+using namespace moja::modules;
+
+namespace {
+
+    const int kRecordsPerThread = 200000;
+    const int kDistinctKeys = 5000;
+
+    cbm::FluxRecord makeFlux(int i) {
+        auto key = i % kDistinctKeys;
+        return cbm::FluxRecord(key, 1, Poco::Nullable<Int64>(), key % 23, key % 29, 1.0);
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(LocalRecordAccumulatorBenchmarks);
+
+BOOST_AUTO_TEST_CASE(ShardedAccumulationScalesWithThreads) {
+    auto maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+        flint::RecordAccumulatorWithMutex2<cbm::FluxRow, cbm::FluxRecord> shared;
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threadCount; t++) {
+                workers.emplace_back([&shared]() {
+                    for (int i = 0; i < kRecordsPerThread; i++) {
+                        shared.accumulate(makeFlux(i));
+                    }
+                });
+            }
+
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+        auto sharedElapsed = std::chrono::steady_clock::now() - start;
+
+        flint::RecordAccumulatorWithMutex2<cbm::FluxRow, cbm::FluxRecord> merged;
+        start = std::chrono::steady_clock::now();
+        {
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threadCount; t++) {
+                workers.emplace_back([&merged]() {
+                    cbm::LocalRecordAccumulator<cbm::FluxRecord> local;
+                    for (int i = 0; i < kRecordsPerThread; i++) {
+                        local.accumulate(makeFlux(i));
+                    }
+
+                    for (const auto record : local.recordsById()) {
+                        merged.accumulate(*record);
+                    }
+                });
+            }
+
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+        auto shardedElapsed = std::chrono::steady_clock::now() - start;
+
+        BOOST_TEST_MESSAGE("threads: " << threadCount
+            << " shared: " << std::chrono::duration_cast<std::chrono::milliseconds>(sharedElapsed).count() << "ms"
+            << " sharded: " << std::chrono::duration_cast<std::chrono::milliseconds>(shardedElapsed).count() << "ms");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,148 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/dynamic.h"
+#include "moja/modules/cbm/standgrowthcurve.h"
+#include "moja/modules/cbm/treeyieldtable.h"
+#include "moja/modules/cbm/treespecies.h"
+#include "moja/modules/cbm/perdfactor.h"
+#include "moja/modules/cbm/volumetobiomassconverter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+namespace cbm = moja::modules::cbm;
+using moja::DynamicObject;
+
+namespace {
+
+    // Yield tables and PERD factors from the unit tests' CBM inputs.
+    std::vector<double> aVolumes{
+        //   0,   5,  10,  15,  20,  25,  30,  35,  40,  45,  50,  55,  60,  65
+             0,   0,   5,  10,  20,  40,  75, 130, 200, 250, 275, 280, 282, 282
+    };
+
+    std::vector<double> cVolumes{
+        //   0,   5,  10,  15,  20,  25,  30,  35,  40,  45,  50,  55,  60,  65,  70,  75,  80,  85,  90,  95, 100, 105, 110, 115, 120
+             0,   0,   0,   0,   0,   0,  20,  52,  82, 105, 109, 121, 147, 160, 162, 183, 215, 222, 157, 134, 113,  90,  68,  44,  22
+    };
+
+    std::vector<double> swPerdFactors{
+         1              ,   0.940757947    ,  0.893308863     , 26.74911954      , -0.842754964,
+         0.634304739    ,   4.359026813    ,  7.876122189     , -1.768994003     ,  0.999038508,
+         1.031175277    ,  -1.719625       , -0.0001865       , -0.0678935       , -1.338323   ,
+        -0.0003408      ,  -0.115071       , -1.365578        , -0.0008351       , -0.1792023  ,
+         0.789301498    , 409.5496953      ,  0.641263962     ,  0.777724244     ,  0.1019464  ,
+         0.085726225    ,   0.137384444    ,  0.088669801     ,  0.119405194     ,  0.04787973 ,
+         1.7940000295639,   5.3899998664856,  3.00200009346008,  5.51999998092651
+    };
+
+    std::vector<double> hwPerdFactors{
+         2              ,   0.605526666    ,   0.968769544     , 43.36460139      , -1.094296331,
+         0.694702256    ,   4.864578887    , 204.6063969       , -2.758123355     ,  0.999990336,
+         1.012284879    ,  -2.226267       ,  -0.004037        ,  0.2254254       , -2.987039   ,
+        -0.0065417      ,   0.4155504      ,  -3.009557        , -0.0057198       ,  0.0936287  ,
+        14.10121815     , 203.6218461      ,   0.706766368     ,  0.765715018     ,  0.140113889,
+         0.12107513     ,   0.110740086    ,   0.093784032     ,  0.042379657     ,  0.019425819,
+         1.7940000295639,   5.3899998664856,   3.00200009346008,  5.51999998092651
+    };
+
+    // A yield table set like a real landscape's: tableCount distinct softwood/hardwood tables,
+    // varied in scale and rate of growth, each used in spuCount SPUs.
+    std::vector<std::unique_ptr<cbm::StandGrowthCurve>> yieldTableSet(int tableCount, int spuCount) {
+        std::vector<std::unique_ptr<cbm::StandGrowthCurve>> curves;
+        for (int table = 0; table < tableCount; table++) {
+            double scale = 0.5 + (table % 50) * 0.03;
+            double growthRate = 0.6 + (table / 50) * 0.05;
+            std::vector<DynamicObject> swRows;
+            for (int i = 0; i < 14; i++) {
+                swRows.push_back(DynamicObject({ { "age", i * 5 }, { "merchantable_volume", aVolumes[i] * scale } }));
+            }
+
+            std::vector<DynamicObject> hwRows;
+            for (int i = 0; i < 25; i++) {
+                double age = std::min(24.0, i * growthRate);
+                double volume = cVolumes[int(age)] + (age - int(age)) * (cVolumes[std::min(24, int(age) + 1)] - cVolumes[int(age)]);
+                hwRows.push_back(DynamicObject({ { "age", i * 5 }, { "merchantable_volume", volume } }));
+            }
+
+            for (int spu = 0; spu < spuCount; spu++) {
+                auto curve = std::make_unique<cbm::StandGrowthCurve>(table, spu);
+                cbm::TreeYieldTable swYieldTable(swRows, cbm::SpeciesType::Softwood);
+                cbm::TreeYieldTable hwYieldTable(hwRows, cbm::SpeciesType::Hardwood);
+                curve->addYieldTable(swYieldTable);
+                curve->addYieldTable(hwYieldTable);
+
+                auto swPerdFactor = std::make_unique<cbm::PERDFactor>();
+                swPerdFactor->setDefaultValue(swPerdFactors);
+                curve->setPERDFactor(std::move(swPerdFactor), cbm::SpeciesType::Softwood);
+
+                auto hwPerdFactor = std::make_unique<cbm::PERDFactor>();
+                hwPerdFactor->setDefaultValue(hwPerdFactors);
+                curve->setPERDFactor(std::move(hwPerdFactor), cbm::SpeciesType::Hardwood);
+
+                curve->processStandYieldTables();
+                curves.push_back(std::move(curve));
+            }
+        }
+
+        return curves;
+    }
+
+    // Unsmoothed softwood and hardwood carbon curves for each stand growth curve, and a smoothing job for each.
+    std::vector<cbm::SmoothingJob> smoothingJobs(const std::vector<std::unique_ptr<cbm::StandGrowthCurve>>& growthCurves,
+                                                 std::vector<std::shared_ptr<cbm::ComponentBiomassCarbonCurve>>& carbonCurves) {
+        cbm::VolumeToBiomassConverter converter;
+        std::vector<cbm::SmoothingJob> jobs;
+        for (const auto& growthCurve : growthCurves) {
+            for (auto speciesType : { cbm::SpeciesType::Softwood, cbm::SpeciesType::Hardwood }) {
+                carbonCurves.push_back(converter.generateComponentBiomassCarbonCurve(*growthCurve, speciesType));
+                jobs.push_back(cbm::SmoothingJob{ growthCurve.get(), carbonCurves.back().get(), speciesType });
+            }
+        }
+
+        return jobs;
+    }
+
+    bool identical(const cbm::ComponentBiomassCarbonCurve& lhs, const cbm::ComponentBiomassCarbonCurve& rhs) {
+        return lhs.getMerchCarbonCurve() == rhs.getMerchCarbonCurve()
+            && lhs.getFoliageCarbonCurve() == rhs.getFoliageCarbonCurve()
+            && lhs.getOtherCarbonCurve() == rhs.getOtherCarbonCurve();
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(SmootherBenchmarks);
+
+BOOST_AUTO_TEST_CASE(BenchmarkBatchSmoothing) {
+    auto growthCurves = yieldTableSet(1000, 4);
+    std::vector<std::shared_ptr<cbm::ComponentBiomassCarbonCurve>> serialCurves;
+    auto serialJobs = smoothingJobs(growthCurves, serialCurves);
+    std::vector<std::shared_ptr<cbm::ComponentBiomassCarbonCurve>> batchCurves;
+    auto batchJobs = smoothingJobs(growthCurves, batchCurves);
+
+    // Serial baseline: a fresh smoother per curve, as before fits were shared.
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& job : serialJobs) {
+        cbm::Smoother().smooth(*job.standGrowthCurve, job.carbonCurve, job.speciesType);
+    }
+    auto serialElapsed = std::chrono::steady_clock::now() - start;
+
+    cbm::Smoother smoother;
+    start = std::chrono::steady_clock::now();
+    smoother.smoothAll(batchJobs);
+    auto batchElapsed = std::chrono::steady_clock::now() - start;
+
+    int mismatches = 0;
+    for (size_t i = 0; i < serialCurves.size(); i++) {
+        mismatches += identical(*serialCurves[i], *batchCurves[i]) ? 0 : 1;
+    }
+
+    BOOST_CHECK_EQUAL(mismatches, 0);
+    BOOST_TEST_MESSAGE("component curves: " << batchJobs.size()
+        << " distinct fits: " << smoother.cachedFitCount()
+        << " serial: " << std::chrono::duration_cast<std::chrono::milliseconds>(serialElapsed).count() << "ms"
+        << " batch: " << std::chrono::duration_cast<std::chrono::milliseconds>(batchElapsed).count() << "ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,90 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/timeseries.h"
+
+#include <moja/flint/timing.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace moja;
+using namespace moja::modules;
+
+namespace {
+
+    void initTiming(flint::Timing& timing, DateTime startDate, DateTime endDate, flint::TimeStepping stepping) {
+        timing.setStartDate(startDate);
+        timing.setEndDate(endDate);
+        timing.setStepping(stepping);
+        timing.init();
+    }
+
+    // Random raw data for a series, with roughly one value in gapEvery missing after the
+    // first year, so every column has data.
+    std::vector<boost::optional<double>> randomRaw(std::mt19937& rng, int dataPerYr, int nYrs, int gapEvery) {
+        std::uniform_real_distribution<double> value(0.0, 100.0);
+        std::uniform_int_distribution<int> gap(0, gapEvery - 1);
+        std::vector<boost::optional<double>> raw;
+        for (int i = 0; i < dataPerYr * nYrs; i++) {
+            raw.push_back(i >= dataPerYr && gap(rng) == 0 ? boost::optional<double>() : boost::optional<double>(value(rng)));
+        }
+
+        return raw;
+    }
+
+    bool close(double expected, double actual) {
+        return std::fabs(expected - actual) <= 1e-12 * std::max(1.0, std::fabs(expected));
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(TimeSeriesBenchmarks);
+
+BOOST_AUTO_TEST_CASE(BenchmarkBatchPreparation) {
+    flint::Timing timing;
+    initTiming(timing, DateTime(2000, 1, 1), DateTime(2020, 1, 1), flint::TimeStepping::Monthly);
+
+    std::mt19937 rng(7);
+    std::vector<std::vector<boost::optional<double>>> raws;
+    for (int i = 0; i < 2000; i++) {
+        raws.push_back(randomRaw(rng, 12, 10, 10));
+    }
+
+    // Scalar baseline: one TimeSeries per series, as the climate transforms build them.
+    auto start = std::chrono::steady_clock::now();
+    std::vector<cbm::TimeSeries> scalar;
+    for (const auto& raw : raws) {
+        scalar.emplace_back(2005, 12, 10, true, raw, cbm::DateOrigin::Calendar);
+        scalar.back().setTiming(&timing);
+        scalar.back().series();
+    }
+    auto scalarElapsed = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    cbm::TimeSeriesBatch batch(2005, 12, 10, true, cbm::DateOrigin::Calendar);
+    for (const auto& raw : raws) {
+        batch.add(raw);
+    }
+    batch.prepare(&timing);
+    auto batchElapsed = std::chrono::steady_clock::now() - start;
+
+    int mismatches = 0;
+    for (size_t i = 0; i < scalar.size(); i++) {
+        const auto& series = scalar[i].series();
+        auto view = batch.series(i);
+        for (size_t step = 0; step < series.size(); step++) {
+            mismatches += close(series[step], view[step]) ? 0 : 1;
+        }
+    }
+
+    BOOST_CHECK_EQUAL(mismatches, 0);
+    BOOST_TEST_MESSAGE("series: " << raws.size()
+        << " steps: " << batch.series(0).size()
+        << " scalar: " << std::chrono::duration_cast<std::chrono::microseconds>(scalarElapsed).count() << "us"
+        << " batch: " << std::chrono::duration_cast<std::chrono::microseconds>(batchElapsed).count() << "us");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,110 @@
+#ifndef MOJA_MODULES_CBM_BATCHDECAYKERNEL_H_
+#define MOJA_MODULES_CBM_BATCHDECAYKERNEL_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+#include "moja/modules/cbm/pooldecayparameters.h"
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+	/**
+	 * Pools touched by dead organic matter decay, in the order CBMDecayModule transfers them.
+	 */
+	enum class DecayPool : int {
+		AboveGroundVeryFastSoil,
+		BelowGroundVeryFastSoil,
+		AboveGroundFastSoil,
+		BelowGroundFastSoil,
+		MediumSoil,
+		SoftwoodStemSnag,
+		SoftwoodBranchSnag,
+		HardwoodStemSnag,
+		HardwoodBranchSnag,
+		AboveGroundSlowSoil,
+		BelowGroundSlowSoil,
+		CO2
+	};
+
+	/**
+	 * Dead organic matter pools for a batch of land units, stored as one contiguous array
+	 * per pool (structure of arrays) so that the decay kernel runs as simple vector loops.
+	 */
+	class CBM_API DecayBatch {
+	public:
+		static const int PoolCount = int(DecayPool::CO2) + 1;
+
+		explicit DecayBatch(size_t size = 0);
+
+		void resize(size_t size);
+		size_t size() const { return _size; }
+
+		double* pool(DecayPool pool) { return _pools[int(pool)].data(); }
+		const double* pool(DecayPool pool) const { return _pools[int(pool)].data(); }
+
+		// Destination of extra decay removals by index into BatchDecayKernel::removalPools().
+		double* removalPool(size_t index) { return _removals[index].data(); }
+		const double* removalPool(size_t index) const { return _removals[index].data(); }
+
+	private:
+		friend class BatchDecayKernel;
+
+		size_t _size;
+		std::vector<std::vector<double>> _pools;
+		std::vector<std::vector<double>> _removals;
+
+		// Per land unit transfer proportions for its mean annual temperature, by kernel column.
+		std::vector<std::vector<double>> _proportions;
+	};
+
+	/**
+	 * Advances the dead organic matter pools of many land units by one annual step with the
+	 * same transfers, in the same order, as CBMDecayModule::doTimingStep: dead organic matter
+	 * decay to the slow pools and the atmosphere, slow pool decay (with any extra decay
+	 * removals), then slow pool mixing. Decay rates are computed once per distinct mean annual
+	 * temperature and stored per land unit in the batch by setTemperatures(), so step() does no
+	 * transcendental math and no lookups. A kernel memoizes rates and is meant to be owned by
+	 * a single thread.
+	 *
+	 * The kernel only covers decay and is not on the FLINT run path: the local domain controller
+	 * hands sequencers one land unit at a time, so CBMDecayModule still decays each land unit
+	 * through its own operations. It doesn't advance stand age, and the temperatures given to
+	 * setTemperatures() hold until it is called again, so a caller with a mean annual temperature
+	 * timeseries has to call it before every step.
+	 */
+	class CBM_API BatchDecayKernel {
+	public:
+		BatchDecayKernel(
+			const std::map<std::string, PoolDecayParameters>& decayParameters,
+			double slowMixingRate,
+			const std::map<std::string, std::map<std::string, double>>& decayRemovals = {});
+
+		const std::vector<std::string>& removalPools() const { return _removalPools; }
+
+		void prepare(DecayBatch& batch) const;
+		void setTemperatures(DecayBatch& batch, const double* meanAnnualTemperatures);
+		void step(DecayBatch& batch) const;
+
+	private:
+		size_t columns() const;
+		const std::vector<double>& proportions(double meanAnnualTemperature);
+
+		std::vector<PoolDecayParameters> _domParameters;
+		std::vector<PoolDecayParameters> _slowParameters;
+		double _slowMixingRate;
+
+		std::vector<std::string> _removalPools;
+		std::vector<std::vector<double>> _removalProportions;	// [slow pool][removal pool]
+
+		std::unordered_map<double, std::vector<double>> _proportionsByTemperature;
+	};
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_BATCHDECAYKERNEL_H_
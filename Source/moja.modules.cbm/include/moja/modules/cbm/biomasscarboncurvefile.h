@@ -0,0 +1,91 @@
+#ifndef MOJA_MODULES_CBM_BIOMASSCARBONCURVEFILE_H_
+#define MOJA_MODULES_CBM_BIOMASSCARBONCURVEFILE_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+#include "moja/modules/cbm/standbiomasscarboncurve.h"
+#include "moja/hash.h"
+#include "moja/types.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Poco {
+    class SharedMemory;
+}
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * Binary file of precompiled stand biomass carbon curves, keyed by growth curve ID and SPU.
+     *
+     * A file is written once from the curves built by a run and memory-mapped read-only by later
+     * runs, so that they skip the volume to biomass conversion and smoothing. Opening a file only
+     * indexes it; a curve's arrays are copied out of the mapping in one block each when it is first
+     * read, so curves stay valid after the file is closed. Files are tagged with a version string
+     * that callers derive from the conversion settings, and each curve with a hash of the yield
+     * tables and parameters it was built from, so curves built from other settings or inputs are
+     * never reused.
+     *
+     * This is a copy-based cache of the conversion only. Curves are not served from the mapping in
+     * place, and because the input hash is computed from the yield tables themselves, the yield
+     * table queries still run for every stand growth curve before the file is consulted.
+     */
+    class CBM_API BiomassCarbonCurveFile {
+    public:
+        // Growth curve ID, SPU ID
+        typedef std::tuple<Int64, Int64> Key;
+
+        struct Entry {
+            Key key;
+            std::uint64_t inputHash;
+            std::shared_ptr<StandBiomassCarbonCurve> curve;
+        };
+
+        typedef std::vector<Entry> CurveList;
+
+        BiomassCarbonCurveFile();
+        ~BiomassCarbonCurveFile();
+
+        BiomassCarbonCurveFile(const BiomassCarbonCurveFile&) = delete;
+        BiomassCarbonCurveFile& operator=(const BiomassCarbonCurveFile&) = delete;
+
+        bool open(const std::string& path, const std::string& version);
+        void close();
+
+        bool isOpen() const { return _data != nullptr; }
+        bool contains(const Key& key) const { return _index.find(key) != _index.end(); }
+        bool contains(const Key& key, std::uint64_t inputHash) const;
+        std::uint64_t inputHash(const Key& key) const;
+        std::vector<Key> keys() const;
+
+        std::shared_ptr<StandBiomassCarbonCurve> read(const Key& key) const;
+
+        static void write(const std::string& path, const std::string& version, const CurveList& curves);
+
+    private:
+        template <typename T>
+        T readValue(std::uint64_t& offset) const;
+        const double* readArray(std::uint64_t& offset, std::uint64_t count) const;
+
+        struct IndexEntry {
+            std::uint64_t inputHash;
+            std::uint64_t offset;
+        };
+
+        std::unique_ptr<Poco::SharedMemory> _mapping;
+        const char* _data;
+        std::uint64_t _size;
+        std::string _path;
+        std::unordered_map<Key, IndexEntry, moja::Hash> _index;
+    };
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_BIOMASSCARBONCURVEFILE_H_
@@ -4,9 +4,11 @@
 #include "moja/modules/cbm/_modules.cbm_exports.h"
 #include "moja/modules/cbm/flatrecord.h"
 #include "moja/modules/cbm/cbmmodulebase.h"
+#include "moja/modules/cbm/recordflushcoordinator.h"
 
 #include <moja/flint/spatiallocationinfo.h>
 
+#include <unordered_map>
 #include <vector>
 
 namespace Poco {
@@ -50,6 +52,7 @@ namespace cbm {
             std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatAgeAreaRecord>> ageDimension,
             std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatDisturbanceRecord>> disturbanceDimension,
 			std::shared_ptr<std::vector<std::string>> classifierNames,
+			std::shared_ptr<RecordFlushCoordinator> flushCoordinator,
 			bool isPrimary = false)
             : CBMModuleBase(),
               _fluxDimension(fluxDimension),
@@ -58,6 +61,8 @@ namespace cbm {
               _ageDimension(ageDimension),
               _disturbanceDimension(disturbanceDimension),
               _classifierNames(classifierNames),
+              _flushCoordinator(flushCoordinator),
+              _jobId(0),
               _isPrimaryAggregator(isPrimary),
               _separateYears(false) {}
 
@@ -79,6 +84,7 @@ namespace cbm {
         std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatAgeAreaRecord>> _ageDimension;
         std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatDisturbanceRecord>> _disturbanceDimension;
         std::shared_ptr<std::vector<std::string>> _classifierNames;
+        std::shared_ptr<RecordFlushCoordinator> _flushCoordinator;
 
         std::shared_ptr<const flint::SpatialLocationInfo> _spatialLocationInfo;
 
@@ -86,9 +92,17 @@ namespace cbm {
         Int64 _jobId;
         bool _isPrimaryAggregator;
         bool _separateYears;
+        std::unordered_map<std::string, std::shared_ptr<CBMFlatFile>> _flatFiles;
+
+        void flush();
+
+        std::shared_ptr<CBMFlatFile> getFlatFile(const std::string& outputPath,
+                                                 const std::string& outputFilename,
+                                                 int year,
+                                                 const std::string& header);
 
         template<typename TAccumulator>
-        void load(const std::string& outputPath,
+        void write(const std::string& outputPath,
                   const std::string& outputFilename,
                   std::shared_ptr<std::vector<std::string>> classifierNames,
                   std::shared_ptr<TAccumulator> dataDimension);
@@ -5,10 +5,15 @@
 #include "moja/modules/cbm/record.h"
 #include "moja/modules/cbm/cbmmodulebase.h"
 #include "moja/modules/cbm/ageclasshelper.h"
+#include "moja/modules/cbm/localrecordaccumulator.h"
+#include "moja/modules/cbm/classifiersetinterner.h"
+#include "moja/modules/cbm/recordflushcoordinator.h"
+#include "moja/modules/cbm/landunittrace.h"
 #include "moja/flint/spatiallocationinfo.h"
 
 #include <Poco/Mutex.h>
 
+#include <unordered_map>
 #include <vector>
 
 namespace moja {
@@ -38,7 +43,10 @@ namespace cbm {
 			std::shared_ptr<flint::RecordAccumulatorWithMutex2<AgeClassRow, AgeClassRecord>> AgeClassDimension,
 			std::shared_ptr<flint::RecordAccumulatorWithMutex2<AgeAreaRow, AgeAreaRecord>> AgeAreaDimension,
 			std::shared_ptr<flint::RecordAccumulatorWithMutex2<ErrorRow, ErrorRecord>> errorDimension,
-			std::shared_ptr<flint::RecordAccumulatorWithMutex2<LocationErrorRow, LocationErrorRecord>> locationErrorDimension)
+			std::shared_ptr<flint::RecordAccumulatorWithMutex2<LocationErrorRow, LocationErrorRecord>> locationErrorDimension,
+			std::shared_ptr<ClassifierSetInterner> classifierSets,
+			std::shared_ptr<RecordFlushCoordinator> flushCoordinator,
+			std::shared_ptr<LandUnitTraceStore> landUnitTraces)
         : CBMModuleBase(),
           _dateDimension(dateDimension),
           _poolInfoDimension(poolInfoDimension),
@@ -56,8 +64,16 @@ namespace cbm {
 		  _ageAreaDimension(AgeAreaDimension),
 		  _errorDimension(errorDimension),
 		  _locationErrorDimension(locationErrorDimension),
+		  _classifierSets(classifierSets),
+		  _classifierSetStale(true),
+		  _classifierSetVaries(false),
+		  _flushCoordinator(flushCoordinator),
 		  _landUnitArea(0),
-          _previousLocationId(0) {}
+          _previousLocationId(0),
+          _shardedAccumulation(false),
+          _deduplicating(false),
+          _landUnitTraces(landUnitTraces),
+          _tracing(false) {}
 
         virtual ~CBMAggregatorLandUnitData() = default;
 
@@ -67,8 +83,12 @@ namespace cbm {
         flint::ModuleTypes moduleType() override { return flint::ModuleTypes::System; };
 
 		void doLocalDomainInit() override;
+		void doLocalDomainShutdown() override;
+        void doPreTimingSequence() override;
         void doTimingInit() override;
         void doOutputStep() override;
+        void doTimingShutdown() override;
+        void doDisturbanceEvent(DynamicVar e) override;
 		void doError(std::string msg) override;
 
     private:
@@ -88,6 +108,15 @@ namespace cbm {
 		std::shared_ptr<flint::RecordAccumulatorWithMutex2<LocationErrorRow, LocationErrorRecord>> _locationErrorDimension;
 		std::shared_ptr<std::vector<std::string>> _classifierNames;
 		std::shared_ptr<Poco::Mutex> _classifierNamesLock;
+		std::shared_ptr<ClassifierSetInterner> _classifierSets;
+		ClassifierSetRef _currentClassifierSet;
+		bool _classifierSetStale;
+		bool _classifierSetVaries;
+		std::unordered_map<Int64, Int64> _classifierSetRecordIds;
+		std::shared_ptr<RecordFlushCoordinator> _flushCoordinator;
+
+		// Pool info dimension Id of each pool, indexed by pool idx; pools are fixed after local domain init.
+		std::vector<Int64> _poolIds;
 
 		flint::IVariable* _classifierSet;
         flint::IVariable* _landClass;
@@ -99,13 +128,80 @@ namespace cbm {
 		std::string _classifierSetVar;
         AgeClassHelper _ageClassHelper;
 
-        Int64 getPoolId(const flint::IPool* pool);
-        Int64 recordLocation(bool isSpinup);
+        // Per-thread dimension tables used when sharded accumulation is enabled;
+        // merged into the shared accumulators at the end of the local domain.
+        bool _shardedAccumulation;
+        LocalRecordAccumulator<DateRecord> _localDateDimension;
+        LocalRecordAccumulator<ClassifierSetRecord> _localClassifierSetDimension;
+        LocalRecordAccumulator<LandClassRecord> _localLandClassDimension;
+        LocalRecordAccumulator<TemporalLocationRecord> _localLocationDimension;
+        LocalRecordAccumulator<ModuleInfoRecord> _localModuleInfoDimension;
+        LocalRecordAccumulator<PoolRecord> _localPoolDimension;
+        LocalRecordAccumulator<FluxRecord> _localFluxDimension;
+        LocalRecordAccumulator<AgeClassRecord> _localAgeClassDimension;
+        LocalRecordAccumulator<AgeAreaRecord> _localAgeAreaDimension;
+        LocalRecordAccumulator<DisturbanceTypeRecord> _localDisturbanceTypeDimension;
+        LocalRecordAccumulator<DisturbanceRecord> _localDisturbanceDimension;
+        LocalRecordAccumulator<ErrorRecord> _localErrorDimension;
+        LocalRecordAccumulator<LocationErrorRecord> _localLocationErrorDimension;
+
+        template<class TPersistable, class TRecord>
+        Int64 accumulate(
+            flint::RecordAccumulatorWithMutex2<TPersistable, TRecord>& sharedDimension,
+            LocalRecordAccumulator<TRecord>& localDimension,
+            const TRecord& record);
+
+        template<class TPersistable, class TRecord>
+        void accumulateFact(
+            flint::RecordAccumulatorWithMutex2<TPersistable, TRecord>& sharedDimension,
+            LocalRecordAccumulator<TRecord>& localDimension,
+            const TRecord& record);
+
+        template<class TPersistable, class TRecord, class TRemap>
+        std::vector<Int64> mergeDimension(
+            flint::RecordAccumulatorWithMutex2<TPersistable, TRecord>& sharedDimension,
+            LocalRecordAccumulator<TRecord>& localDimension,
+            TRemap remap);
+
+        template<class TPersistable, class TRecord, class TRemap>
+        void mergeFacts(
+            flint::RecordAccumulatorWithMutex2<TPersistable, TRecord>& sharedDimension,
+            LocalRecordAccumulator<TRecord>& localDimension,
+            TRemap remap);
+
+        Int64 idOffset(RecordFlushCoordinator::ReleasedDimension dimension) const;
+
+        void mergeShard();
+
+        // Land unit deduplication: a land unit whose inputs match those of an already simulated
+        // and traced land unit isn't simulated; the other land unit's trace is recorded again
+        // with this land unit's area instead. The inputs are every spatial or transform variable
+        // except the ones configured as shared by all land units. A replayed land unit is never
+        // built, so no other module produces output for it.
+        bool _deduplicating;
+        std::vector<std::string> _signatureVarNames;
+        std::vector<std::string> _sharedVarNames;
+        std::vector<const flint::IVariable*> _signatureVars;
+        flint::IVariable* _buildWorked;
+        std::shared_ptr<LandUnitTraceStore> _landUnitTraces;
+        std::shared_ptr<LandUnitTrace> _trace;
+        std::string _signature;
+        bool _tracing;
+
+        // Scratch step reused for every output step.
+        LandUnitStep _step;
+
+        void internClassifierSet();
+        void captureLocation(bool isSpinup, LandUnitStep& step);
+        void captureStep(bool isSpinup, LandUnitStep& step);
+
+        Int64 recordLocation(const LandUnitStep& step);
         void recordLandUnitData(bool isSpinup);
-        void recordPoolsSet(Int64 locationId);
-        void recordFluxSet(Int64 locationId);
+        void recordStep(const LandUnitStep& step);
+        void recordPoolsSet(Int64 locationId, const LandUnitStep& step);
+        void recordFluxSet(Int64 locationId, const LandUnitStep& step);
 		void recordClassifierNames(const DynamicObject& classifierSet);
-		void recordAgeArea(Int64 locationId);
+		void recordAgeArea(Int64 locationId, const LandUnitStep& step);
 		void recordAgeClass();
         bool hasDisturbanceInfo(std::shared_ptr<flint::IOperationResult> flux);
     };
@@ -4,6 +4,7 @@
 #include "moja/modules/cbm/_modules.cbm_exports.h"
 #include "moja/modules/cbm/flatrecord.h"
 #include "moja/modules/cbm/cbmmodulebase.h"
+#include "moja/modules/cbm/recordflushcoordinator.h"
 
 #include <moja/flint/spatiallocationinfo.h>
 
@@ -28,6 +29,7 @@ namespace cbm {
             std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatAgeAreaRecord>> ageDimension,
             std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatDisturbanceRecord>> disturbanceDimension,
             std::shared_ptr<std::vector<std::string>> classifierNames,
+            std::shared_ptr<RecordFlushCoordinator> flushCoordinator,
             bool isPrimary = false)
             : CBMModuleBase(),
               _fluxDimension(fluxDimension),
@@ -36,8 +38,12 @@ namespace cbm {
               _ageDimension(ageDimension),
               _disturbanceDimension(disturbanceDimension),
               _classifierNames(classifierNames),
+              _flushCoordinator(flushCoordinator),
+              _jobId(0),
               _isPrimaryAggregator(isPrimary),
-              _dropSchema(true) {}
+              _dropSchema(true),
+              _tablesCreated(false),
+              _resultsPreviouslyLoaded(false) {}
 
         virtual ~CBMAggregatorLibPQXXWriter() = default;
 
@@ -57,6 +63,7 @@ namespace cbm {
         std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatAgeAreaRecord>> _ageDimension;
         std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatDisturbanceRecord>> _disturbanceDimension;
         std::shared_ptr<std::vector<std::string>> _classifierNames;
+        std::shared_ptr<RecordFlushCoordinator> _flushCoordinator;
 
         std::shared_ptr<const flint::SpatialLocationInfo> _spatialLocationInfo;
 
@@ -65,6 +72,12 @@ namespace cbm {
         Int64 _jobId;
         bool _isPrimaryAggregator;
         bool _dropSchema;
+        bool _tablesCreated;
+        bool _resultsPreviouslyLoaded;
+
+        void flush();
+        bool resultsPreviouslyLoaded(pqxx::connection_base& conn);
+        std::vector<std::string> createTablesDdl() const;
 
         template<typename TAccumulator>
         void load(pqxx::work& tx,
@@ -0,0 +1,117 @@
+#ifndef MOJA_MODULES_CBM_CBMAGGREGATORPARQUETWRITER_H_
+#define MOJA_MODULES_CBM_CBMAGGREGATORPARQUETWRITER_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+#include "moja/modules/cbm/flatrecord.h"
+#include "moja/modules/cbm/cbmmodulebase.h"
+#include "moja/modules/cbm/recordflushcoordinator.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace moja {
+namespace flint {
+	template<class TPersistable, class TRecord>
+	class RecordAccumulatorWithMutex2;
+}
+
+namespace modules {
+namespace cbm {
+
+    /**
+     * A Parquet file under construction: each row is added through rowBuilder() and ended with
+     * endRow(), which checks it against the file's schema, and the pending rows are written out
+     * as a row group by writeRowGroup(). Like CBMFlatFile, the file is written to a temporary
+     * path and only renamed to its final path when saved; a file that is never saved is removed.
+     */
+    class CBM_API CBMParquetFile {
+    public:
+        CBMParquetFile(const std::string& path,
+                       const std::vector<std::string>& columnNames,
+                       const std::vector<FlatColumnType>& columnTypes,
+                       const std::string& compression,
+                       Int64 rowGroupSize);
+
+        ~CBMParquetFile();
+
+        FlatRecordColumnVisitor& rowBuilder();
+        void endRow();
+        void writeRowGroup();
+        void save();
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> _impl;
+    };
+
+    class CBM_API CBMAggregatorParquetWriter : public CBMModuleBase {
+    public:
+        CBMAggregatorParquetWriter(
+            std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatFluxRecord>> fluxDimension,
+            std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatPoolRecord>> poolDimension,
+            std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatErrorRecord>> errorDimension,
+            std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatAgeAreaRecord>> ageDimension,
+            std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatDisturbanceRecord>> disturbanceDimension,
+            std::shared_ptr<std::vector<std::string>> classifierNames,
+            std::shared_ptr<RecordFlushCoordinator> flushCoordinator,
+            bool isPrimary = false)
+            : CBMModuleBase(),
+              _fluxDimension(fluxDimension),
+              _poolDimension(poolDimension),
+              _errorDimension(errorDimension),
+              _ageDimension(ageDimension),
+              _disturbanceDimension(disturbanceDimension),
+              _classifierNames(classifierNames),
+              _flushCoordinator(flushCoordinator),
+              _jobId(0),
+              _isPrimaryAggregator(isPrimary),
+              _separateYears(false),
+              _compression("snappy"),
+              _rowGroupSize(1024 * 1024) {}
+
+        virtual ~CBMAggregatorParquetWriter() = default;
+
+        void configure(const DynamicObject& config) override;
+        void subscribe(NotificationCenter& notificationCenter) override;
+
+        flint::ModuleTypes moduleType() override { return flint::ModuleTypes::System; };
+
+        void doSystemInit() override;
+        void doLocalDomainInit() override;
+        void doSystemShutdown() override;
+
+    private:
+        std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatFluxRecord>> _fluxDimension;
+        std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatPoolRecord>> _poolDimension;
+        std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatErrorRecord>> _errorDimension;
+        std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatAgeAreaRecord>> _ageDimension;
+        std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatDisturbanceRecord>> _disturbanceDimension;
+        std::shared_ptr<std::vector<std::string>> _classifierNames;
+        std::shared_ptr<RecordFlushCoordinator> _flushCoordinator;
+
+        std::string _outputPath;
+        Int64 _jobId;
+        bool _isPrimaryAggregator;
+        bool _separateYears;
+        std::string _compression;
+        Int64 _rowGroupSize;
+        std::unordered_map<std::string, std::shared_ptr<CBMParquetFile>> _parquetFiles;
+
+        void flush();
+
+        template<typename TRecord>
+        std::shared_ptr<CBMParquetFile> getParquetFile(const std::string& outputPath,
+                                                       const std::string& outputFilename,
+                                                       int year,
+                                                       const TRecord& firstRecord);
+
+        template<typename TAccumulator>
+        void write(const std::string& outputPath,
+                   const std::string& outputFilename,
+                   std::shared_ptr<TAccumulator> dataDimension);
+    };
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_CBMAGGREGATORPARQUETWRITER_H_
@@ -4,8 +4,11 @@
 #include "moja/modules/cbm/_modules.cbm_exports.h"
 #include "moja/modules/cbm/record.h"
 #include "moja/modules/cbm/cbmmodulebase.h"
+#include "moja/modules/cbm/recordflushcoordinator.h"
 
 #include <Poco/Data/Session.h>
+
+#include <unordered_map>
 #include <vector>
 
 namespace moja {
@@ -35,6 +38,7 @@ namespace cbm {
 			std::shared_ptr<flint::RecordAccumulatorWithMutex2<AgeAreaRow, AgeAreaRecord>> ageAreaDimension,
 			std::shared_ptr<flint::RecordAccumulatorWithMutex2<ErrorRow, ErrorRecord>> errorDimension,
 			std::shared_ptr<flint::RecordAccumulatorWithMutex2<LocationErrorRow, LocationErrorRecord>> locationErrorDimension,
+			std::shared_ptr<RecordFlushCoordinator> flushCoordinator,
 			bool isPrimary = false)
         : CBMModuleBase(),
           _dateDimension(dateDimension),
@@ -52,7 +56,9 @@ namespace cbm {
 		  _ageAreaDimension(ageAreaDimension),
 		  _errorDimension(errorDimension),
 		  _locationErrorDimension(locationErrorDimension),
-          _isPrimaryAggregator(isPrimary) {}
+		  _flushCoordinator(flushCoordinator),
+          _isPrimaryAggregator(isPrimary),
+          _tablesCreated(false) {}
 
         virtual ~CBMAggregatorSQLiteWriter() = default;
 
@@ -80,14 +86,38 @@ namespace cbm {
 		std::shared_ptr<flint::RecordAccumulatorWithMutex2<ErrorRow, ErrorRecord>> _errorDimension;
 		std::shared_ptr<flint::RecordAccumulatorWithMutex2<LocationErrorRow, LocationErrorRecord>> _locationErrorDimension;
 		std::shared_ptr<std::vector<std::string>> _classifierNames;
+		std::shared_ptr<RecordFlushCoordinator> _flushCoordinator;
 
         std::string _dbName;
         bool _isPrimaryAggregator;
+        bool _tablesCreated;
+        std::unordered_map<std::string, Int64> _factIdOffsets;
+
+        // Highest Id written to each dimension table; later flushes only write records past it.
+        std::unordered_map<std::string, Int64> _lastDimensionIds;
+
+        void flush();
+        void createTables(Poco::Data::Session& session);
+        void loadDimensions(Poco::Data::Session& session);
+        void loadFacts(Poco::Data::Session& session);
 
 		template<typename TAccumulator>
 		void load(Poco::Data::Session& session,
 				  const std::string& table,
-				  std::shared_ptr<TAccumulator> dataDimension);
+				  std::shared_ptr<TAccumulator> dataDimension,
+				  Int64 idOffset = 0);
+
+		template<typename TAccumulator, typename TKeyOf>
+		void loadReleased(Poco::Data::Session& session,
+						  const std::string& table,
+						  std::shared_ptr<TAccumulator> dataDimension,
+						  RecordFlushCoordinator::ReleasedDimension dimension,
+						  TKeyOf keyOf);
+
+		template<typename TAccumulator>
+		void loadFacts(Poco::Data::Session& session,
+					   const std::string& table,
+					   std::shared_ptr<TAccumulator> dataDimension);
 
 		static void tryExecute(Poco::Data::Session& session,
 							   std::function<void(Poco::Data::Session&)> fn);
@@ -27,6 +27,9 @@ namespace moja {
 			private:
 				flint::IVariable* _age;
 
+				// All pools by idx, for applying shared disturbance matrices.
+				std::vector<const flint::IPool*> _pools;
+
 				const flint::IPool* _softwoodMerch;
 				const flint::IPool* _softwoodOther;
 				const flint::IPool* _softwoodFoliage;
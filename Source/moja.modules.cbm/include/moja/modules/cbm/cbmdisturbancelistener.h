@@ -2,6 +2,10 @@
 #define MOJA_MODULES_CBM_CBMDISTURBANCELISTENER_H_
 
 #include "moja/modules/cbm/cbmmodulebase.h"
+#include "moja/modules/cbm/disturbanceconditiontarget.h"
+#include "moja/modules/cbm/disturbanceeventqueue.h"
+#include "moja/modules/cbm/disturbancematrixstore.h"
+#include "moja/modules/cbm/landunittrace.h"
 #include "moja/hash.h"
 #include "moja/flint/ivariable.h"
 #include "moja/flint/ipool.h"
@@ -41,15 +45,6 @@ namespace moja {
 				virtual bool check() const = 0;
 			};
 
-			enum class DisturbanceConditionType {
-				LessThan,
-				EqualTo,
-				AtLeast,
-				Between,
-				In,
-				NotIn
-			};
-
 			struct DisturbanceHistoryCondition {
 				std::string disturbanceType;
 				int maxYearsAgo = 9999;
@@ -68,20 +63,19 @@ namespace moja {
 					_matchConditions(matchConditions), _runConditions(runConditions),
 					_overrideConditions(overrideConditions), _overrideDisturbanceType(overrideDisturbanceType) { }
 
-				bool isApplicable(const std::string& disturbanceType) {
-					bool isMatchingDisturbance = false;
+				bool appliesTo(const std::string& disturbanceType) const {
 					for (const auto& matchDisturbanceType : _disturbanceTypes) {
 						if (disturbanceType == matchDisturbanceType) {
-							isMatchingDisturbance = true;
-							break;
+							return true;
 						}
 					}
 
-					if (!isMatchingDisturbance) {
-						return false;
-					}
+					return false;
+				}
 
-					for (auto matchCondition : _matchConditions) {
+				// Check the match conditions of a disturbance type the condition appliesTo().
+				bool isApplicable() const {
+					for (const auto& matchCondition : _matchConditions) {
 						if (!matchCondition->check()) {
 							return false;
 						}
@@ -90,14 +84,14 @@ namespace moja {
 					return true;
 				}
 
-				DisturbanceConditionResult check() {
+				DisturbanceConditionResult check() const {
 					DisturbanceConditionResult result;
 
 					if (_runConditions.size() > 0) {
 						result.hadRunConditions = true;
 					}
 
-					for (auto runCondition : _runConditions) {
+					for (const auto& runCondition : _runConditions) {
 						if (runCondition->check()) {
 							result.shouldRun = true;
 							break;
@@ -108,7 +102,7 @@ namespace moja {
 						return result;
 					}
 
-					for (auto overrideCondition : _overrideConditions) {
+					for (const auto& overrideCondition : _overrideConditions) {
 						if (overrideCondition->check()) {
 							result.newDisturbanceType = _overrideDisturbanceType;
 							break;
@@ -132,7 +126,7 @@ namespace moja {
 					_conditions(conditions) { }
 
 				bool check() const override {
-					for (const auto condition : _conditions) {
+					for (const auto& condition : _conditions) {
 						if (!condition->check()) {
 							return false;
 						}
@@ -150,41 +144,24 @@ namespace moja {
 				VariableDisturbanceSubCondition(
 					const flint::IVariable* var, DisturbanceConditionType type, const DynamicVar& target,
 					const std::string& propertyName = "") : _var(var), _property(propertyName),
-					_type(type), _target(target) { }
+					_target(type, target) { }
 
 				bool check() const override {
-					const auto value = _property == "" ? _var->value() : _var->value()[_property];
-					return _type == DisturbanceConditionType::LessThan ? value - _target < 0
-						: _type == DisturbanceConditionType::EqualTo ? value == _target
-						: _type == DisturbanceConditionType::AtLeast ? value - _target >= 0
-						: _type == DisturbanceConditionType::Between ? value >= _target[0] && value <= _target[1]
-						: _type == DisturbanceConditionType::In ? search(value)
-						: _type == DisturbanceConditionType::NotIn ? !search(value)
-						: false;
+					const auto& value = _var->value();
+					return _property.empty() ? _target.check(value) : _target.check(value[_property]);
 				}
 
 			private:
-				const std::string _property;
 				const flint::IVariable* _var;
-				const DisturbanceConditionType _type;
-				const DynamicVar _target;
-
-				bool search(DynamicVar value) const {
-					for (const auto& targetValue : _target) {
-						if (value == targetValue) {
-							return true;
-						}
-					}
-
-					return false;
-				}
+				const std::string _property;
+				const DisturbanceConditionTarget _target;
 			};
 
 			class PoolDisturbanceSubCondition : public IDisturbanceSubCondition {
 			public:
 				PoolDisturbanceSubCondition(
 					std::vector<const flint::IPool*> pools, DisturbanceConditionType type, const DynamicVar& target)
-					: _pools(pools), _type(type), _target(target) { }
+					: _pools(pools), _target(type, target) { }
 
 				bool check() const override {
 					double sum = 0.0;
@@ -192,17 +169,12 @@ namespace moja {
 						sum += pool->value();
 					}
 
-					return _type == DisturbanceConditionType::LessThan ? sum - _target < 0
-						: _type == DisturbanceConditionType::EqualTo ? sum == _target
-						: _type == DisturbanceConditionType::AtLeast ? sum - _target >= 0
-						: _type == DisturbanceConditionType::Between ? sum >= _target[0] && sum <= _target[1]
-						: false;
+					return _target.check(sum);
 				}
 
 			private:
 				const std::vector<const flint::IPool*> _pools;
-				const DisturbanceConditionType _type;
-				const DynamicVar _target;
+				const DisturbanceConditionTarget _target;
 			};
 
 			class DisturbanceSequenceSubCondition : public IDisturbanceSubCondition {
@@ -272,41 +244,6 @@ namespace moja {
 				std::vector<DisturbanceHistoryCondition> _sequence;
 			};
 
-			class CBMDistEventRef {
-			public:
-				CBMDistEventRef() = default;
-
-				explicit CBMDistEventRef(
-					std::string& disturbanceType, int year, int transitionId,
-					std::vector<std::shared_ptr<IDisturbanceSubCondition>> conditions,
-					const DynamicObject& metadata) :
-					_disturbanceType(disturbanceType), _year(year), _transitionRuleId(transitionId),
-					_disturbanceConditions(conditions), _metadata(metadata) { }
-
-				std::string disturbanceType() const { return _disturbanceType; }
-				void setDisturbanceType(const std::string& disturbanceType) { _disturbanceType = disturbanceType; }
-				int transitionRuleId() const { return _transitionRuleId; }
-				int year() const { return _year; }
-				const DynamicObject& metadata() { return _metadata; }
-
-				bool checkConditions() {
-					for (const auto condition : _disturbanceConditions) {
-						if (!condition->check()) {
-							return false;
-						}
-					}
-
-					return true;
-				}
-
-			private:
-				std::string _disturbanceType;
-				int _transitionRuleId;
-				int	_year;
-				DynamicObject _metadata;
-				std::vector<std::shared_ptr<IDisturbanceSubCondition>> _disturbanceConditions;
-			};
-
 			class CBMDistEventTransfer {
 			public:
 				CBMDistEventTransfer() = default;
@@ -324,6 +261,13 @@ namespace moja {
 					_destPool(landUnitData.getPool(destPool)),
 					_proportion(proportion) { }
 
+				CBMDistEventTransfer(int disturbanceMatrixId, const flint::IPool* sourcePool,
+					const flint::IPool* destPool, double proportion) :
+					_disturbanceMatrixId(disturbanceMatrixId),
+					_sourcePool(sourcePool),
+					_destPool(destPool),
+					_proportion(proportion) { }
+
 				int disturbanceMatrixId() const { return _disturbanceMatrixId; }
 				const flint::IPool* sourcePool() const { return _sourcePool; }
 				const flint::IPool* destPool() const { return _destPool; }
@@ -339,8 +283,17 @@ namespace moja {
 
 			class CBMDisturbanceListener : public CBMModuleBase {
 			public:
-				CBMDisturbanceListener() : CBMModuleBase() {
+				CBMDisturbanceListener(
+					std::shared_ptr<DisturbanceMatrixStore> disturbanceMatrices,
+					std::shared_ptr<LandUnitTraceStore> landUnitTraces)
+					: CBMModuleBase(), _disturbanceMatrices(disturbanceMatrices), _landUnitTraces(landUnitTraces) {
 					_disturbanceHistory = std::make_shared<std::deque<DisturbanceHistoryRecord>>();
+					bindVariable("current_land_class", _landClass);
+					bindVariable("spatial_unit_id", _spu);
+					bindVariable("classifier_set", _classifierSet);
+					bindVariable("age", _age);
+					bindVariable("enable_peatland", _enablePeatland, true);
+					bindVariable("peatland_class", _peatlandClass, true);
 				}
 
 				virtual ~CBMDisturbanceListener() = default;
@@ -357,9 +310,6 @@ namespace moja {
 				virtual void doDisturbanceEvent(DynamicVar) override;
 
 			private:
-				typedef std::vector<CBMDistEventTransfer> EventVector;
-				typedef std::unordered_map<int, EventVector> EventMap;
-
 				NotificationCenter* _notificationCenter;
 				std::vector<std::string> _layerNames;
 				std::vector<const flint::IVariable*> _layers;
@@ -367,18 +317,34 @@ namespace moja {
 				flint::IVariable* _spu;
 				flint::IVariable* _classifierSet;
 				flint::IVariable* _age;
-				EventMap _matrices;
+				VariableHandle<bool> _enablePeatland;
+				VariableHandle<int> _peatlandClass;
+				std::shared_ptr<DisturbanceMatrixStore> _disturbanceMatrices;
+				std::shared_ptr<LandUnitTraceStore> _landUnitTraces;
 
 				std::unordered_map<std::pair<int, std::string>, std::pair<int, int>> _peatlandDmAssociations;
 				std::unordered_map<std::pair<std::string, int>, int> _dmAssociations;
 				std::unordered_map<std::string, std::string> _landClassTransitions;
-				std::map<int, std::vector<CBMDistEventRef>> _landUnitEvents;
+				DisturbanceEventQueue _landUnitEvents;
+				std::vector<std::shared_ptr<IDisturbanceSubCondition>> _eventConditions;
 				std::unordered_map<std::string, int> _distTypeCodes;
 				std::unordered_map<int, std::string> _distTypeNames;
 				std::unordered_set<std::string> _errorLayers;
 				std::unordered_set<std::string> _classifierNames;
 				std::unordered_map<std::string, int> _disturbanceOrder;
 
+				// Disturbance types by interned id, with their order rank, type code and the
+				// indexes of the CBMDisturbanceListener._disturbanceConditions that apply to them.
+				struct DisturbanceTypeInfo {
+					std::string name;
+					int order;
+					int code;
+					std::vector<size_t> conditions;
+				};
+
+				std::vector<DisturbanceTypeInfo> _disturbanceTypes;
+				std::unordered_map<std::string, int> _disturbanceTypeIds;
+
 				bool _disturbanceConditionsInitialized = false;
 				DynamicVar _conditionConfig;
 				std::vector<DisturbanceCondition> _disturbanceConditions;
@@ -392,9 +358,12 @@ namespace moja {
 				void fetchDisturbanceOrder();
 				std::shared_ptr<IDisturbanceSubCondition> createSubCondition(const DynamicObject& config);
 				std::string getDisturbanceTypeName(const DynamicObject& eventData);
-				bool addLandUnitEvent(const DynamicVar& eventData);
-				void fireCBMDisturbanceEvent(CBMDistEventRef& e);
-				void firePeatlandDisturbanceEvent(CBMDistEventRef& e);
+				int disturbanceTypeId(const std::string& disturbanceType);
+				bool addLandUnitEvent(const DynamicObject& event, int layer, int layerEvent);
+				bool checkConditions(const CBMDistEventRef& e) const;
+				const DynamicObject& eventMetadata(const CBMDistEventRef& e) const;
+				void fireCBMDisturbanceEvent(const CBMDistEventRef& e);
+				void firePeatlandDisturbanceEvent(const CBMDistEventRef& e);
 			};
 
 		}
@@ -3,6 +3,9 @@
 
 #include "moja/modules/cbm/_modules.cbm_exports.h"
 #include "moja/modules/cbm/flatrecord.h"
+#include "moja/modules/cbm/classifiersetinterner.h"
+#include "moja/modules/cbm/poolnametable.h"
+#include "moja/modules/cbm/recordflushcoordinator.h"
 #include "moja/modules/cbm/cbmmodulebase.h"
 #include "moja/modules/cbm/ageclasshelper.h"
 #include "moja/flint/spatiallocationinfo.h"
@@ -30,7 +33,10 @@ namespace cbm {
             std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatAgeAreaRecord>> ageDimension,
             std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatDisturbanceRecord>> disturbanceDimension,
             std::shared_ptr<std::vector<std::string>> classifierNames,
-            std::shared_ptr<Poco::Mutex> classifierNamesLock)
+            std::shared_ptr<Poco::Mutex> classifierNamesLock,
+            std::shared_ptr<ClassifierSetInterner> classifierSets,
+            std::shared_ptr<PoolNameTable> poolNames,
+            std::shared_ptr<RecordFlushCoordinator> flushCoordinator)
         : CBMModuleBase(),
           _fluxDimension(fluxDimension),
           _poolDimension(poolDimension),
@@ -39,6 +45,9 @@ namespace cbm {
           _disturbanceDimension(disturbanceDimension),
           _classifierNames(classifierNames),
           _classifierNamesLock(classifierNamesLock),
+          _classifierSets(classifierSets),
+          _poolNames(poolNames),
+          _flushCoordinator(flushCoordinator),
 		  _landUnitArea(0),
           _previousAttributes() {}
 
@@ -62,6 +71,10 @@ namespace cbm {
         std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, FlatDisturbanceRecord>> _disturbanceDimension;
 		std::shared_ptr<std::vector<std::string>> _classifierNames;
 		std::shared_ptr<Poco::Mutex> _classifierNamesLock;
+		std::shared_ptr<ClassifierSetInterner> _classifierSets;
+		ClassifierSetRef _currentClassifierSet;
+		std::shared_ptr<PoolNameTable> _poolNames;
+		std::shared_ptr<RecordFlushCoordinator> _flushCoordinator;
 
 		flint::IVariable* _classifierSet;
         flint::IVariable* _landClass;
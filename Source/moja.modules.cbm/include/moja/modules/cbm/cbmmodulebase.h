@@ -9,12 +9,17 @@
 #ifndef MOJA_MODULES_CBM_CBMMODULEBASE_H_
 #define MOJA_MODULES_CBM_CBMMODULEBASE_H_
 
+#include "moja/modules/cbm/variableslot.h"
+
 #include "moja/flint/modulebase.h"
 #include "moja/flint/flintexceptions.h"
 #include "moja/exception.h"
 
 #include <boost/exception_ptr.hpp>
 
+#include <string>
+#include <vector>
+
 namespace moja {
 namespace modules {
 namespace cbm {
@@ -24,7 +29,7 @@ public:
 	virtual ~CBMModuleBase() = default;
 	void onSystemInit() override							 { doWithHandling([this]() { this->doSystemInit(); }); }
 	void onSystemShutdown() override						 { doWithHandling([this]() { this->doSystemShutdown(); }); }
-	void onLocalDomainInit() override						 { doWithHandling([this]() { this->doLocalDomainInit(); }); }
+	void onLocalDomainInit() override						 { doWithHandling([this]() { this->resolveBindings(); this->doLocalDomainInit(); }); }
 	void onLocalDomainShutdown() override					 { doWithHandling([this]() { this->doLocalDomainShutdown(); }); }
 	void onLocalDomainProcessingUnitInit() override			 { doWithHandling([this]() { this->doLocalDomainProcessingUnitInit(); });	}
 	void onLocalDomainProcessingUnitShutdown() override		 { doWithHandling([this]() { this->doLocalDomainProcessingUnitShutdown(); }); }
@@ -69,8 +74,47 @@ public:
 	virtual void doPostDisturbanceEvent() {}
 	virtual void doPostDisturbanceEvent2() {}
 	virtual void doPostNotification(short preMessageSignal) {}
-    
+
+protected:
+	/**
+	 * Declare a variable the module reads, usually in its constructor. The variable is resolved
+	 * before doLocalDomainInit: a required variable that does not exist is an error, and an
+	 * optional one leaves the handle unbound, which must be checked with isBound() before reading it.
+	 */
+	void bindVariable(const std::string& name, BoundVariable& handle, bool optional = false) {
+		_variableBindings.add(name, handle, optional);
+	}
+
+	void bindVariable(const std::string& name, flint::IVariable*& variable, bool optional = false) {
+		_variableBindings.add(name, variable, optional);
+	}
+
+	/**
+	 * Declare a pool the module uses; resolved before doLocalDomainInit.
+	 */
+	void bindPool(const std::string& name, const flint::IPool*& pool) {
+		_poolBindings.push_back(PoolBinding{ name, &pool });
+	}
+
 private:
+	struct PoolBinding {
+		std::string name;
+		const flint::IPool** target;
+	};
+
+	void resolveBindings() {
+		_variableBindings.resolve([this](const std::string& name) -> flint::IVariable* {
+			return _landUnitData->hasVariable(name) ? _landUnitData->getVariable(name) : nullptr;
+		});
+
+		for (const auto& binding : _poolBindings) {
+			*binding.target = _landUnitData->getPool(binding.name);
+		}
+	}
+
+	VariableBindings _variableBindings;
+	std::vector<PoolBinding> _poolBindings;
+
     void doWithHandling(const std::function<void()>& fn) {
         try {
             fn();
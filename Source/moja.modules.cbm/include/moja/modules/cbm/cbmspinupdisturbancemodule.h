@@ -14,7 +14,8 @@ namespace cbm {
     */
     class CBM_API CBMSpinupDisturbanceModule : public CBMModuleBase {
     public:
-        CBMSpinupDisturbanceModule(){};
+        CBMSpinupDisturbanceModule(std::shared_ptr<DisturbanceMatrixStore> disturbanceMatrices)
+            : _disturbanceMatrices(disturbanceMatrices) {};
         virtual ~CBMSpinupDisturbanceModule(){};		
 
         void configure(const DynamicObject& config) override;
@@ -25,12 +26,10 @@ namespace cbm {
         void doTimingInit() override;
 
     private:	
-        typedef std::vector<CBMDistEventTransfer> EventVector;
-        typedef std::unordered_map<int, EventVector> EventMap;
-
         flint::IVariable* _spu;
         int _spuId;
-        EventMap _matrices;
+        std::shared_ptr<DisturbanceMatrixStore> _disturbanceMatrices;
+        std::vector<const flint::IPool*> _pools;
         std::unordered_map<std::pair<std::string, int>, int> _dmAssociations;
 
         void fetchMatrices();
@@ -2,6 +2,8 @@
 #define MOJA_MODULES_CBM_CBMSPINUPSEQUENCER_H_
 
 #include "moja/modules/cbm/_modules.cbm_exports.h"
+#include "moja/modules/cbm/spinupcache.h"
+#include "moja/modules/cbm/spinupsteadystatesolver.h"
 #include "moja/datetime.h"
 #include "moja/flint/itiming.h"
 #include "moja/flint/sequencermodulebase.h"
@@ -9,8 +11,10 @@
 #include "moja/hash.h"
 #include "moja/pocojsonutils.h"
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace moja {
 	namespace modules {
@@ -18,8 +22,12 @@ namespace moja {
 
 			class CBM_API CBMSpinupSequencer : public flint::SequencerModuleBase {
 			public:
-				CBMSpinupSequencer() : _standAge(0) {};
-				virtual ~CBMSpinupSequencer() {};
+				CBMSpinupSequencer(std::shared_ptr<SpinupCache> spinupCache,
+								   std::shared_ptr<SpinupRegrowthStore> regrowthStore)
+					: _standAge(0), _spinupCache(spinupCache), _spinupCacheOpened(false),
+					  _regrowthStore(regrowthStore) {};
+
+				virtual ~CBMSpinupSequencer();
 
 				const std::string returnInverval = "return_interval";
 				const std::string maxRotation = "max_rotations";
@@ -33,6 +41,29 @@ namespace moja {
 						_rampStartDate = moja::parseSimpleDate(
 							config["ramp_start_date"].extract<std::string>());
 					}
+
+					if (config.contains("accelerated_spinup")) {
+						_acceleratedSpinup = config["accelerated_spinup"].convert<bool>();
+					}
+
+					if (config.contains("spinup_cache_path")) {
+						_spinupCachePath = config["spinup_cache_path"].convert<std::string>();
+					}
+
+					if (config.contains("spinup_cache_version")) {
+						_spinupCacheVersion = config["spinup_cache_version"].convert<std::string>();
+					}
+
+					if (config.contains("spinup_cache_parameters")) {
+						_spinupCacheParameters.clear();
+						for (const auto& name : config["spinup_cache_parameters"].extract<const std::vector<DynamicVar>>()) {
+							_spinupCacheParameters.push_back(name.convert<std::string>());
+						}
+					}
+
+					if (config.contains("replay_spinup_regrowth")) {
+						_replayRegrowth = config["replay_spinup_regrowth"].convert<bool>();
+					}
 				};
 
 				void configure(flint::ITiming& timing) override {
@@ -82,6 +113,8 @@ namespace moja {
 				std::string _historicDistType;  // historic disturbance type happened at each age interval
 				std::string _lastPassDistType;	// last disturance type happened when the slow pool is stable and minimum rotations are done
 				std::unordered_map<std::string, int> _disturbanceOrder;
+				bool _acceleratedSpinup{ false };	// solve for the steady state instead of simulating every rotation
+				size_t _recordedOperations{ 0 };	// operation results in the current step already passed to a SpinupSteadyStateSolver
 
 				// Optional ramp to use at the end of the spinup period; used when, for example, spinup uses a
 				// value of 10 for a variable, and the rest of the simulation uses a value of 20, and the values
@@ -89,9 +122,25 @@ namespace moja {
 				// 10 timesteps of the spinup period: 10, 11, 12, 13, ...
 				Poco::Nullable<DateTime> _rampStartDate;
 
-				// SPU, historic disturbance type, GC ID, return interval, mean annual temperature
-				typedef std::tuple<int, std::string, int, int, double> CacheKey;
-				std::unordered_map<CacheKey, std::vector<double>, moja::Hash> _cache;
+				// Spinup results shared by all threads, optionally saved to _spinupCachePath between runs.
+				std::shared_ptr<SpinupCache> _spinupCache;
+				std::string _spinupCachePath;
+				std::string _spinupCacheVersion;	// user-supplied tag for the spinup parameters, i.e. an input database checksum
+				std::vector<std::string> _spinupCacheParameters{	// variables whose values are hashed into the cache version
+					"decay_parameters", "slow_ag_to_bg_mixing_rate", "turnover_rates", "spinup_parameters",
+					"disturbance_matrices", "disturbance_matrix_associations", "volume_to_biomass_parameters" };
+				bool _spinupCacheOpened;
+
+				// End states of regular spinups shared by all threads, replayed into stands that would regrow
+				// the same way instead of simulating their last pass and regrowth.
+				std::shared_ptr<SpinupRegrowthStore> _regrowthStore;
+				bool _replayRegrowth{ false };
+
+				// Check if the end state of this stand's regular spinup depends only on its SpinupRegrowthKey
+				bool canReplayRegrowth() const;
+
+				// Open the persistent spinup cache, if configured, for the current pool set.
+				void openSpinupCache();
 
 				// Get spinup parameters for this land unit
 				bool getSpinupParameters(flint::ILandUnitDataWrapper& landUnitData);
@@ -99,6 +148,10 @@ namespace moja {
 				// Run the standard spinup procedure for most stands.
 				void runRegularSpinup(NotificationCenter& notificationCenter, flint::ILandUnitController& luc, bool runMoss);
 
+				// Simulate the standard spinup procedure for a stand with the given SPU and mean annual temperature.
+				void simulateRegularSpinup(NotificationCenter& notificationCenter, flint::ILandUnitController& luc,
+					bool runMoss, int spu, double meanAnnualTemperature);
+
 				// Run the alternate spinup procedure for peatland.
 				void runPeatlandSpinup(NotificationCenter& notificationCenter, flint::ILandUnitController& luc);
 
@@ -111,11 +164,18 @@ namespace moja {
 				// Check if to run moss module
 				bool isMossApplicable(bool runPeatland);
 
-				// Fire timing events
+				// Fire timing events, optionally recording the operations applied in each step
 				void fireSpinupSequenceEvent(NotificationCenter& notificationCenter,
 					flint::ILandUnitController& luc,
 					int maximumSteps,
-					bool incrementStep);
+					bool incrementStep,
+					SpinupSteadyStateSolver* recorder = nullptr);
+
+				// Get the current pool values, indexed by pool idx
+				std::vector<double> poolValues() const;
+
+				// Pass the operations applied since the last call to a steady state solver
+				void recordAppliedOperations(SpinupSteadyStateSolver& recorder);
 
 				// Fire historical and last disturbance
 				void fireHistoricalLastDisturbanceEvent(NotificationCenter& notificationCenter,
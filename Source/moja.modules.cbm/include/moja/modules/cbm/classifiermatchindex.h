@@ -0,0 +1,91 @@
+#ifndef MOJA_MODULES_CBM_CLASSIFIERMATCHINDEX_H_
+#define MOJA_MODULES_CBM_CLASSIFIERMATCHINDEX_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+
+#include <Poco/RWLock.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * One classifier value required by a growth curve or transition rule.
+     */
+    struct ClassifierMatchRow {
+        int id;                         // growth curve or transition ID
+        std::string group;              // disturbance type of a transition rule; empty for growth curves
+        std::string classifierName;
+        std::string classifierValue;    // "?" matches any value of the classifier
+    };
+
+    // Classifier names and values of a classifier set, in classifier set order.
+    typedef std::vector<std::pair<std::string, std::string>> ClassifierMatchQuery;
+
+    // The best matching ID in each group, by group name.
+    typedef std::vector<std::pair<std::string, int>> ClassifierMatches;
+
+    /**
+     * In-memory replacement for the growth curve and transition rule scoring queries. The
+     * classifier values required by every candidate (a growth curve, or a transition ID and
+     * disturbance type) are loaded once and bucketed by classifier and value, with a separate
+     * wildcard bucket per classifier, so a classifier set only visits the candidates that
+     * share one of its values.
+     *
+     * Scoring is the same as the SQL it replaces: each required value scores 4 if it matches
+     * the classifier set (ignoring ASCII case, like LIKE), 1 if it is the wildcard "?" and
+     * -1000 otherwise. Classifier names are compared exactly, like the IN list that selected
+     * the classifier set's classifiers. The best candidate with a positive score wins in each
+     * group; ties go to the lowest ID. Results are cached for every distinct classifier set and
+     * shared by all threads.
+     */
+    class CBM_API ClassifierMatchIndex {
+    public:
+        ClassifierMatchIndex() : _initialized(false) { }
+
+        void initialize(const std::vector<ClassifierMatchRow>& rows);
+        bool isInitialized() const { return _initialized; }
+
+        const ClassifierMatches& match(const ClassifierMatchQuery& classifierSet);
+
+        size_t candidateCount() const { return _candidates.size(); }
+
+    private:
+        struct Candidate {
+            int id;
+            size_t group;
+            int requiredValues;
+        };
+
+        struct Classifier {
+            std::unordered_map<std::string, std::vector<size_t>> values;  // candidates requiring each value
+            std::vector<size_t> wildcards;                                // candidates accepting any value
+        };
+
+        struct QueryHasher {
+            size_t operator()(const ClassifierMatchQuery& classifierSet) const;
+        };
+
+        ClassifierMatches score(const ClassifierMatchQuery& classifierSet) const;
+
+        std::mutex _initializeLock;
+        std::atomic<bool> _initialized;
+
+        std::vector<std::string> _groups;
+        std::vector<Candidate> _candidates;
+        std::unordered_map<std::string, Classifier> _classifiers;        // by classifier name
+
+        mutable Poco::RWLock _cacheLock;
+        std::unordered_map<ClassifierMatchQuery, ClassifierMatches, QueryHasher> _cache;
+    };
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_CLASSIFIERMATCHINDEX_H_
@@ -0,0 +1,71 @@
+#ifndef MOJA_MODULES_CBM_CLASSIFIERSETINTERNER_H_
+#define MOJA_MODULES_CBM_CLASSIFIERSETINTERNER_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+#include "moja/types.h"
+
+#include <Poco/Nullable.h>
+#include <Poco/RWLock.h>
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    typedef std::vector<Poco::Nullable<std::string>> ClassifierValues;
+
+    /**
+     * Compact handle to an interned classifier set: records hash and compare on the
+     * integer ID and only expand the classifier strings when they are persisted.
+     */
+    class CBM_API ClassifierSetRef {
+    public:
+        ClassifierSetRef() : _id(0), _values(nullptr) {}
+        ClassifierSetRef(Int64 id, const ClassifierValues* values) : _id(id), _values(values) {}
+
+        Int64 id() const { return _id; }
+        bool isValid() const { return _values != nullptr; }
+        const ClassifierValues& values() const { return *_values; }
+
+        bool operator==(const ClassifierSetRef& other) const { return _id == other._id; }
+        bool operator!=(const ClassifierSetRef& other) const { return _id != other._id; }
+
+    private:
+        Int64 _id;
+        const ClassifierValues* _values;
+    };
+
+    /**
+     * Process-wide table mapping each distinct set of classifier values to a compact
+     * integer ID, shared by all threads. Interned values live for the lifetime of the
+     * interner, so ClassifierSetRef handles stay valid until the writers have run.
+     */
+    class CBM_API ClassifierSetInterner {
+    public:
+        ClassifierSetInterner() = default;
+
+        ClassifierSetRef intern(const ClassifierValues& values);
+        ClassifierSetRef intern(const ClassifierValues& values, const ClassifierSetRef& previous);
+        size_t size() const;
+
+    private:
+        struct ValuesHasher {
+            size_t operator()(const ClassifierValues& values) const;
+        };
+
+        struct ValuesComparer {
+            bool operator()(const ClassifierValues& lhs, const ClassifierValues& rhs) const;
+        };
+
+        mutable Poco::RWLock _lock;
+        std::deque<ClassifierValues> _values;
+        std::unordered_map<ClassifierValues, ClassifierSetRef, ValuesHasher, ValuesComparer> _ids;
+    };
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_CLASSIFIERSETINTERNER_H_
@@ -17,6 +17,10 @@ namespace cbm {
 		virtual ~ComponentBiomassCarbonCurve() = default;	
 
 		ComponentBiomassCarbonCurve(int maxAge);
+		ComponentBiomassCarbonCurve(int maxAge, std::vector<double> merchCarbon,
+			std::vector<double> foliageCarbon, std::vector<double> otherCarbon);
+
+		int maxAge() const { return _maxAge; }
 	
 		double getMerchCarbonIncrement(int age) const;
 		double getFoliageCarbonIncrement(int age) const;
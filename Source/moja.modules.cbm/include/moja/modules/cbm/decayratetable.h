@@ -0,0 +1,58 @@
+#ifndef MOJA_MODULES_CBM_DECAYRATETABLE_H_
+#define MOJA_MODULES_CBM_DECAYRATETABLE_H_
+
+#include <cstddef>
+#include <unordered_map>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+	/**
+	 * Temperature-modified decay rates by mean annual temperature. Mean annual temperature usually
+	 * comes from a raster with few distinct values, so the rates for each value are computed once
+	 * and looked up on every later step instead of re-evaluating exp/log. Rates are computed by the
+	 * same expressions as before and so are identical to the unmemoized ones.
+	 *
+	 * A table belongs to one module instance (and so to one thread); the owner calls clear() when
+	 * the decay parameters the rates were computed from change. If the number of distinct
+	 * temperatures exceeds maxSize the table starts over, bounding its memory.
+	 */
+	template <typename TRates>
+	class DecayRateTable {
+	public:
+		explicit DecayRateTable(size_t maxSize = 4096) : _maxSize(maxSize) { }
+
+		/**
+		 * Return the rates for parameter meanAnnualTemperature, calling parameter compute with the \n
+		 * temperature to create them if they aren't in the table yet.
+		 *
+		 * @param meanAnnualTemperature double
+		 * @param compute TCompute, callable returning TRates for a temperature
+		 * @return TRates&
+		 * ************************/
+		template <typename TCompute>
+		const TRates& get(double meanAnnualTemperature, TCompute compute) {
+			auto it = _rates.find(meanAnnualTemperature);
+			if (it != _rates.end()) {
+				return it->second;
+			}
+
+			if (_rates.size() >= _maxSize) {
+				_rates.clear();
+			}
+
+			return _rates.emplace(meanAnnualTemperature, compute(meanAnnualTemperature)).first->second;
+		}
+
+		void clear() { _rates.clear(); }
+		size_t size() const { return _rates.size(); }
+
+	private:
+		size_t _maxSize;
+		std::unordered_map<double, TRates> _rates;
+	};
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_DECAYRATETABLE_H_
@@ -0,0 +1,130 @@
+#ifndef MOJA_MODULES_CBM_DECAYTRANSFERS_H_
+#define MOJA_MODULES_CBM_DECAYTRANSFERS_H_
+
+#include "moja/modules/cbm/pooldecayparameters.h"
+
+#include <map>
+#include <string>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+	/**
+	 * The pools CBMDecayModule transfers between, as handles of type TPool: the module's
+	 * IPool pointers, or anything else that identifies a pool, such as its name.
+	 */
+	template<class TPool>
+	struct DecayPools {
+		TPool aboveGroundVeryFastSoil;
+		TPool belowGroundVeryFastSoil;
+		TPool aboveGroundFastSoil;
+		TPool belowGroundFastSoil;
+		TPool mediumSoil;
+		TPool aboveGroundSlowSoil;
+		TPool belowGroundSlowSoil;
+		TPool softwoodStemSnag;
+		TPool softwoodBranchSnag;
+		TPool hardwoodStemSnag;
+		TPool hardwoodBranchSnag;
+		TPool atmosphere;
+	};
+
+	/**
+	 * The transfers of CBMDecayModule's annual step, kept apart from the module so that they
+	 * can be checked without a land unit. The step is three proportional operations applied
+	 * in turn: dead organic matter decay, slow pool decay, then slow pool mixing. Each function
+	 * adds one operation's transfers by calling addTransfer(source, sink, proportion).
+	 */
+	class DecayTransfers {
+	public:
+		// First operation: dead organic matter decay into the slow pools and the atmosphere.
+		template<class TPool, class TAddTransfer>
+		static void addDomDecayTransfers(const DecayPools<TPool>& pools,
+								  const std::map<std::string, double>& decayRates,
+								  const std::map<std::string, PoolDecayParameters>& decayParameters,
+								  TAddTransfer addTransfer) {
+
+			const auto& ag = pools.aboveGroundSlowSoil;
+			const auto& bg = pools.belowGroundSlowSoil;
+			const auto& co2 = pools.atmosphere;
+			addDecay(decayRates, decayParameters, "AboveGroundVeryFastSoil", pools.aboveGroundVeryFastSoil, ag, co2, addTransfer);
+			addDecay(decayRates, decayParameters, "BelowGroundVeryFastSoil", pools.belowGroundVeryFastSoil, bg, co2, addTransfer);
+			addDecay(decayRates, decayParameters, "AboveGroundFastSoil", pools.aboveGroundFastSoil, ag, co2, addTransfer);
+			addDecay(decayRates, decayParameters, "BelowGroundFastSoil", pools.belowGroundFastSoil, bg, co2, addTransfer);
+			addDecay(decayRates, decayParameters, "MediumSoil", pools.mediumSoil, ag, co2, addTransfer);
+			addDecay(decayRates, decayParameters, "SoftwoodStemSnag", pools.softwoodStemSnag, ag, co2, addTransfer);
+			addDecay(decayRates, decayParameters, "SoftwoodBranchSnag", pools.softwoodBranchSnag, ag, co2, addTransfer);
+			addDecay(decayRates, decayParameters, "HardwoodStemSnag", pools.hardwoodStemSnag, ag, co2, addTransfer);
+			addDecay(decayRates, decayParameters, "HardwoodBranchSnag", pools.hardwoodBranchSnag, ag, co2, addTransfer);
+		}
+
+		// Second operation: slow pool decay, with any extra decay removals.
+		template<class TPool, class TGetPool, class TAddTransfer>
+		static void addSlowDecayTransfers(const DecayPools<TPool>& pools,
+								   const std::map<std::string, double>& decayRates,
+								   const std::map<std::string, PoolDecayParameters>& decayParameters,
+								   const std::map<std::string, std::map<std::string, double>>& decayRemovals,
+								   TGetPool getPool, TAddTransfer addTransfer) {
+
+			addSlowDecay(decayRates, decayParameters, decayRemovals, "AboveGroundSlowSoil",
+						 pools.aboveGroundSlowSoil, pools.atmosphere, getPool, addTransfer);
+			addSlowDecay(decayRates, decayParameters, decayRemovals, "BelowGroundSlowSoil",
+						 pools.belowGroundSlowSoil, pools.atmosphere, getPool, addTransfer);
+		}
+
+		// Third operation: mixing of the above ground slow pool into the below ground slow pool.
+		template<class TPool, class TAddTransfer>
+		static void addSlowMixingTransfers(const DecayPools<TPool>& pools, double slowMixingRate, TAddTransfer addTransfer) {
+			addTransfer(pools.aboveGroundSlowSoil, pools.belowGroundSlowSoil, slowMixingRate);
+		}
+
+	private:
+
+		/**
+		 * Decay a dead organic matter pool, sending the share that is not released to the
+		 * atmosphere to parameter sink.
+		 * ************************/
+		template<class TPool, class TAddTransfer>
+		static void addDecay(const std::map<std::string, double>& decayRates,
+					  const std::map<std::string, PoolDecayParameters>& decayParameters,
+					  const std::string& domPool, const TPool& source, const TPool& sink,
+					  const TPool& atmosphere, TAddTransfer& addTransfer) {
+
+			double decayRate = decayRates.at(domPool);
+			double propToAtmosphere = decayParameters.at(domPool).pAtm;
+			addTransfer(source, sink, decayRate * (1 - propToAtmosphere));
+			addTransfer(source, atmosphere, decayRate * propToAtmosphere);
+		}
+
+		/**
+		 * Decay a slow pool to the atmosphere as well as any additional removals (dissolved
+		 * organic carbon, etc.) - additional removals are subtracted from the amount decayed
+		 * to the atmosphere. Parameter getPool returns the TPool for a removal pool name.
+		 * ************************/
+		template<class TPool, class TGetPool, class TAddTransfer>
+		static void addSlowDecay(const std::map<std::string, double>& decayRates,
+						  const std::map<std::string, PoolDecayParameters>& decayParameters,
+						  const std::map<std::string, std::map<std::string, double>>& decayRemovals,
+						  const std::string& domPool, const TPool& pool, const TPool& atmosphere,
+						  TGetPool& getPool, TAddTransfer& addTransfer) {
+
+			double decayRate = decayRates.at(domPool);
+			double propToAtmosphere = decayParameters.at(domPool).pAtm;
+
+			double propRemovals = 0.0;
+			const auto removals = decayRemovals.find(domPool);
+			if (removals != decayRemovals.end()) {
+				for (const auto& removal : removals->second) {
+					propRemovals += removal.second;
+					addTransfer(pool, getPool(removal.first), decayRate * removal.second);
+				}
+			}
+
+			addTransfer(pool, atmosphere, decayRate * (propToAtmosphere - propRemovals));
+		}
+	};
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_DECAYTRANSFERS_H_
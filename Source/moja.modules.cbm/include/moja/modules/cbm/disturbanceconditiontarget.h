@@ -0,0 +1,50 @@
+#ifndef MOJA_MODULES_CBM_DISTURBANCECONDITIONTARGET_H_
+#define MOJA_MODULES_CBM_DISTURBANCECONDITIONTARGET_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+
+#include <moja/dynamic.h>
+
+#include <string>
+#include <unordered_set>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    enum class DisturbanceConditionType {
+        LessThan,
+        EqualTo,
+        AtLeast,
+        Between,
+        In,
+        NotIn
+    };
+
+    /**
+     * The target of a disturbance condition, compiled once from its configuration so that a
+     * check is a comparison on doubles, or a hash lookup for In and NotIn, instead of
+     * DynamicVar arithmetic. Text values, i.e. classifier values, are compared to the text
+     * form of the target; any other value is compared as a number.
+     */
+    class CBM_API DisturbanceConditionTarget {
+    public:
+        DisturbanceConditionTarget(DisturbanceConditionType type, const DynamicVar& target);
+
+        bool check(double value) const;
+        bool check(const DynamicVar& value) const;
+
+    private:
+        DisturbanceConditionType _type;
+        bool _isNumber = false;                     // the LessThan, EqualTo or AtLeast target is a number
+        double _number = 0.0;
+        double _min = 0.0;                          // Between
+        double _max = 0.0;
+        std::string _text;                          // text form of the EqualTo target
+        std::unordered_set<double> _numbers;        // In/NotIn targets that are numbers
+        std::unordered_set<std::string> _texts;     // text form of every In/NotIn target
+    };
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_DISTURBANCECONDITIONTARGET_H_
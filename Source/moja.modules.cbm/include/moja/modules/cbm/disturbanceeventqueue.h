@@ -0,0 +1,78 @@
+#ifndef MOJA_MODULES_CBM_DISTURBANCEEVENTQUEUE_H_
+#define MOJA_MODULES_CBM_DISTURBANCEEVENTQUEUE_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * A disturbance event of a land unit, by index: the interned disturbance type and its order
+     * rank, its range of conditions in the listener's condition list, and its position in its
+     * layer, so that its attributes are read from the layer when it fires rather than copied
+     * for every event loaded.
+     */
+    class CBM_API CBMDistEventRef {
+    public:
+        CBMDistEventRef() = default;
+
+        CBMDistEventRef(int disturbanceTypeId, int order, int year, int transitionId,
+                        int layer, int layerEvent, size_t firstCondition = 0, size_t conditionCount = 0) :
+            _disturbanceTypeId(disturbanceTypeId), _order(order), _year(year), _transitionRuleId(transitionId),
+            _layer(layer), _layerEvent(layerEvent), _firstCondition(firstCondition),
+            _conditionCount(conditionCount) { }
+
+        int disturbanceTypeId() const { return _disturbanceTypeId; }
+        void setDisturbanceTypeId(int disturbanceTypeId) { _disturbanceTypeId = disturbanceTypeId; }
+        int order() const { return _order; }
+        int year() const { return _year; }
+        int transitionRuleId() const { return _transitionRuleId; }
+
+        int layer() const { return _layer; }
+        int layerEvent() const { return _layerEvent; }     // -1 when the layer holds a single event
+        size_t firstCondition() const { return _firstCondition; }
+        size_t conditionCount() const { return _conditionCount; }
+
+    private:
+        int _disturbanceTypeId = -1;
+        int _order = 0;
+        int _year = 0;
+        int _transitionRuleId = -1;
+        int _layer = -1;
+        int _layerEvent = -1;
+        size_t _firstCondition = 0;
+        size_t _conditionCount = 0;
+    };
+
+    /**
+     * The disturbance events of a land unit in one flat array sorted by year and then by order
+     * rank, events with the same year and rank keeping the order they were loaded in. A cursor
+     * moves through the years as the simulation does, so finding a year's events doesn't need
+     * a lookup.
+     */
+    class CBM_API DisturbanceEventQueue {
+    public:
+        typedef std::vector<CBMDistEventRef>::iterator iterator;
+
+        void clear();
+        void push(const CBMDistEventRef& event) { _events.push_back(event); }
+        void sort();
+
+        std::pair<iterator, iterator> eventsIn(int year);
+
+        size_t size() const { return _events.size(); }
+        bool empty() const { return _events.empty(); }
+
+    private:
+        std::vector<CBMDistEventRef> _events;
+        size_t _next = 0;   // first event not in a year before the last one asked for
+    };
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_DISTURBANCEEVENTQUEUE_H_
@@ -0,0 +1,84 @@
+#ifndef MOJA_MODULES_CBM_DISTURBANCEMATRIXSTORE_H_
+#define MOJA_MODULES_CBM_DISTURBANCEMATRIXSTORE_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+
+#include <moja/dynamic.h>
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+	/**
+	 * Immutable store of every disturbance matrix in the simulation, shared read-only by all
+	 * threads. The transfers of all matrices are kept in contiguous arrays of source pool index,
+	 * sink pool index and proportion, with each matrix a range of those arrays (compressed
+	 * sparse row layout), so a disturbance event can refer to its matrix without copying it.
+	 *
+	 * The store is built once, by the first thread to initialize it; later calls are no-ops.
+	 * Pool indices are the flint pool idx values, which are the same on every thread.
+	 */
+	class CBM_API DisturbanceMatrixStore {
+	public:
+		/**
+		 * Read-only view of one disturbance matrix in the store. Cheap to copy, so it can be
+		 * passed along with disturbance event data.
+		 */
+		class CBM_API Matrix {
+		public:
+			Matrix() : _store(nullptr), _id(-1), _begin(0), _end(0) { }
+
+			int id() const { return _id; }
+			size_t size() const { return _end - _begin; }
+			bool empty() const { return _begin == _end; }
+
+			int sourcePool(size_t transfer) const { return _store->_sources[_begin + transfer]; }
+			int sinkPool(size_t transfer) const { return _store->_sinks[_begin + transfer]; }
+			double proportion(size_t transfer) const { return _store->_proportions[_begin + transfer]; }
+
+		private:
+			friend class DisturbanceMatrixStore;
+
+			Matrix(const DisturbanceMatrixStore* store, int id, size_t begin, size_t end)
+				: _store(store), _id(id), _begin(begin), _end(end) { }
+
+			const DisturbanceMatrixStore* _store;
+			int _id;
+			size_t _begin;
+			size_t _end;
+		};
+
+		DisturbanceMatrixStore() : _initialized(false) { }
+
+		void initialize(const std::vector<DynamicObject>& transfers,
+						const std::unordered_map<std::string, int>& poolIndices);
+
+		bool isInitialized() const { return _initialized; }
+		bool contains(int disturbanceMatrixId) const;
+		Matrix matrix(int disturbanceMatrixId) const;
+
+		size_t matrixCount() const { return _matrixIndex.size(); }
+		size_t transferCount() const { return _proportions.size(); }
+
+	private:
+		std::mutex _initializeLock;
+		std::atomic<bool> _initialized;
+
+		std::unordered_map<int, size_t> _matrixIndex;	// disturbance matrix ID to position in _offsets
+		std::vector<int> _matrixIds;
+		std::vector<size_t> _offsets;					// start of each matrix's transfers, plus the end
+		std::vector<int> _sources;
+		std::vector<int> _sinks;
+		std::vector<double> _proportions;
+	};
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_DISTURBANCEMATRIXSTORE_H_
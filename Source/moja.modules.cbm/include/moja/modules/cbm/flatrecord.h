@@ -2,6 +2,8 @@
 #define MOJA_MODULES_CBM_FLATRECORD_H_
 
 #include "moja/modules/cbm/_modules.cbm_exports.h"
+#include "moja/modules/cbm/classifiersetinterner.h"
+#include "moja/modules/cbm/poolnametable.h"
 #include "moja/types.h"
 #include "moja/flint/record.h"
 
@@ -12,19 +14,41 @@ namespace moja {
 namespace modules {
 namespace cbm {
 
+    enum class FlatColumnType {
+        Integer,
+        Number,
+        Text
+    };
+
+    /**
+     * Receives the fields of a flat record one column at a time, in the same order as the
+     * record's header, so that columnar writers can build typed columns directly instead of
+     * parsing the text produced by asPersistable().
+     */
+    class CBM_API FlatRecordColumnVisitor {
+    public:
+        virtual ~FlatRecordColumnVisitor() = default;
+
+        virtual void integer(int value) = 0;
+        virtual void number(double value) = 0;
+        virtual void text(const std::string& value) = 0;
+        virtual void null(FlatColumnType type) = 0;
+    };
+
     class CBM_API FlatRecordHelper {
     public:
         static const std::string BuildClassifierNamesString(const std::vector<std::string>& classifierNames, const std::string& suffix = "");
         static const std::string BuildClassifierValueString(const std::vector<Poco::Nullable<std::string>>& classifierValues);
+        static void VisitClassifierValues(const std::vector<Poco::Nullable<std::string>>& classifierValues, FlatRecordColumnVisitor& visitor);
     };
 
     class CBM_API FlatFluxRecord {
     public:
-        FlatFluxRecord(int year, const std::vector<Poco::Nullable<std::string>>& classifierValues, const std::string& landClass,
-                       const std::string& ageClass, const std::vector<Poco::Nullable<std::string>>& previousClassifierValues,
+        FlatFluxRecord(int year, const ClassifierSetRef& classifierSet, const std::string& landClass,
+                       const std::string& ageClass, const ClassifierSetRef& previousClassifierSet,
                        const std::string& previousLandClass, const std::string& previousAgeClass,
                        const Poco::Nullable<std::string>& disturbanceType, const Poco::Nullable<int>& disturbanceCode,
-                       const std::string& srcPool, const std::string& dstPool, double flux);
+                       const PoolRef& srcPool, const PoolRef& dstPool, double flux);
 
         ~FlatFluxRecord() {}
 
@@ -33,6 +57,7 @@ namespace cbm {
         std::string header(const std::vector<std::string>& classifierNames) const;
         std::string asPersistable() const;
         std::vector<std::optional<std::string>> asVector() const;
+        void visitColumns(FlatRecordColumnVisitor& visitor) const;
         void merge(const FlatFluxRecord& other);
         void setId(Int64 id) { _id = id; }
         Int64 getId() const { return _id; }
@@ -44,23 +69,23 @@ namespace cbm {
 
         // Data
         int _year;
-        std::vector<Poco::Nullable<std::string>> _classifierValues;
+        ClassifierSetRef _classifierSet;
         std::string _landClass;
         std::string _ageClass;
-        std::vector<Poco::Nullable<std::string>> _previousClassifierValues;
+        ClassifierSetRef _previousClassifierSet;
         std::string _previousLandClass;
         std::string _previousAgeClass;
         Poco::Nullable<std::string> _disturbanceType;
         Poco::Nullable<int> _disturbanceCode;
-        std::string _srcPool;
-        std::string _dstPool;
+        PoolRef _srcPool;
+        PoolRef _dstPool;
         double _flux;
     };
 
     class CBM_API FlatPoolRecord {
     public:
-        FlatPoolRecord(int year, const std::vector<Poco::Nullable<std::string>>& classifierValues, const std::string& landClass,
-                       const std::string& ageClass, const std::string& pool, double value);
+        FlatPoolRecord(int year, const ClassifierSetRef& classifierSet, const std::string& landClass,
+                       const std::string& ageClass, const PoolRef& pool, double value);
 
         ~FlatPoolRecord() {}
 
@@ -69,6 +94,7 @@ namespace cbm {
         std::string header(const std::vector<std::string>& classifierNames) const;
         std::string asPersistable() const;
         std::vector<std::optional<std::string>> asVector() const;
+        void visitColumns(FlatRecordColumnVisitor& visitor) const;
         void merge(const FlatPoolRecord& other);
         void setId(Int64 id) { _id = id; }
         Int64 getId() const { return _id; }
@@ -80,16 +106,16 @@ namespace cbm {
 
         // Data
         int _year;
-        std::vector<Poco::Nullable<std::string>> _classifierValues;
+        ClassifierSetRef _classifierSet;
         std::string _landClass;
         std::string _ageClass;
-        std::string _pool;
+        PoolRef _pool;
         double _value;
     };
 
     class CBM_API FlatErrorRecord {
     public:
-        FlatErrorRecord(int year, const std::vector<Poco::Nullable<std::string>>& classifierValues,
+        FlatErrorRecord(int year, const ClassifierSetRef& classifierSet,
                         const std::string& module, const std::string& error, double area);
 
         ~FlatErrorRecord() {};
@@ -99,6 +125,7 @@ namespace cbm {
         std::string header(const std::vector<std::string>& classifierNames) const;
         std::string asPersistable() const;
         std::vector<std::optional<std::string>> asVector() const;
+        void visitColumns(FlatRecordColumnVisitor& visitor) const;
         void merge(const FlatErrorRecord& other);
         void setId(Int64 id) { _id = id; }
         Int64 getId() const { return _id; }
@@ -110,7 +137,7 @@ namespace cbm {
 
         // Data
         int _year;
-        std::vector<Poco::Nullable<std::string>> _classifierValues;
+        ClassifierSetRef _classifierSet;
         std::string _module;
         std::string _error;
         double _area;
@@ -118,7 +145,7 @@ namespace cbm {
 
     class CBM_API FlatAgeAreaRecord {
     public:
-        FlatAgeAreaRecord(int year, std::vector<Poco::Nullable<std::string>>& classifierValues,
+        FlatAgeAreaRecord(int year, const ClassifierSetRef& classifierSet,
                           std::string& landClass, std::string& ageClass, double area);
 
         ~FlatAgeAreaRecord() {}
@@ -128,11 +155,12 @@ namespace cbm {
         std::string header(const std::vector<std::string>& classifierNames) const;
         std::string asPersistable() const;
         std::vector<std::optional<std::string>> asVector() const;
+        void visitColumns(FlatRecordColumnVisitor& visitor) const;
         void merge(const FlatAgeAreaRecord& other);
         void setId(Int64 id) { _id = id; }
         Int64 getId() const { return _id; }
         int getYear() const { return _year; }
-        const std::vector<Poco::Nullable<std::string>>& getClassifierValues() const { return _classifierValues; }
+        const ClassifierSetRef& getClassifierSet() const { return _classifierSet; }
         const std::string& getLandClass() const { return _landClass; }
         const std::string& getAgeClass() const { return _ageClass; }
 
@@ -142,7 +170,7 @@ namespace cbm {
 
         // Data
         int _year;
-        std::vector<Poco::Nullable<std::string>> _classifierValues;
+        ClassifierSetRef _classifierSet;
         std::string _landClass;
         std::string _ageClass;
         double _area;
@@ -150,8 +178,8 @@ namespace cbm {
 
     class CBM_API FlatDisturbanceRecord {
     public:
-        FlatDisturbanceRecord(int year, const std::vector<Poco::Nullable<std::string>>& classifierValues, const std::string& landClass,
-                              const std::string& ageClass, const std::vector<Poco::Nullable<std::string>>& previousClassifierValues,
+        FlatDisturbanceRecord(int year, const ClassifierSetRef& classifierSet, const std::string& landClass,
+                              const std::string& ageClass, const ClassifierSetRef& previousClassifierSet,
                               const std::string& previousLandClass, const std::string& previousAgeClass,
                               const std::string& disturbanceType, int disturbanceCode, double area);
 
@@ -162,6 +190,7 @@ namespace cbm {
         std::string header(const std::vector<std::string>& classifierNames) const;
         std::string asPersistable() const;
         std::vector<std::optional<std::string>> asVector() const;
+        void visitColumns(FlatRecordColumnVisitor& visitor) const;
         void merge(const FlatDisturbanceRecord& other);
         void setId(Int64 id) { _id = id; }
         Int64 getId() const { return _id; }
@@ -173,10 +202,10 @@ namespace cbm {
 
         // Data
         int _year;
-        std::vector<Poco::Nullable<std::string>> _classifierValues;
+        ClassifierSetRef _classifierSet;
         std::string _landClass;
         std::string _ageClass;
-        std::vector<Poco::Nullable<std::string>> _previousClassifierValues;
+        ClassifierSetRef _previousClassifierSet;
         std::string _previousLandClass;
         std::string _previousAgeClass;
         std::string _disturbanceType;
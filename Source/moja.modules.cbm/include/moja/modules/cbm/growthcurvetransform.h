@@ -5,39 +5,17 @@
 #include "moja/flint/ilandunitcontroller.h"
 #include "moja/flint/itransform.h"
 
-#include <Poco/LRUCache.h>
-#include <Poco/ThreadLocal.h>
+#include "moja/modules/cbm/classifiermatchindex.h"
 
 namespace moja {
 namespace modules {
 namespace cbm {
 
-struct GCCacheKey {
-public:
-    void add(const std::string& classifierValue) {
-        _classifierValues.push_back(classifierValue);
-    }
-
-    bool operator<(const GCCacheKey& other) const {
-        if (_classifierValues.size() < other._classifierValues.size()) {
-            return true;
-        }
-
-        for (int i = 0; i < _classifierValues.size(); i++) {
-            if (_classifierValues[i] < other._classifierValues[i]) {
-                return true;
-            }
-        }
-
-        return false;
-    }
-
-private:
-    std::vector<std::string> _classifierValues;
-};
-
 class GrowthCurveTransform : public flint::ITransform {
 public:
+	explicit GrowthCurveTransform(std::shared_ptr<ClassifierMatchIndex> growthCurveIndex)
+		: _growthCurveIndex(growthCurveIndex) { }
+
 	void configure(DynamicObject config,
 		const flint::ILandUnitController& landUnitController,
 		datarepository::DataRepository& dataRepository) override;
@@ -51,39 +29,22 @@ private:
 	std::shared_ptr<datarepository::IProviderRelationalInterface> _provider;
 	mutable const flint::IVariable* _csetVar;
 	mutable DynamicVar _value;
-    mutable Poco::ThreadLocal<Poco::LRUCache<GCCacheKey, DynamicVar>> _cache;
-
-    const std::string buildSql(const DynamicObject& classifierSet) const;
-    const std::string buildDebuggingInfo(const DynamicObject& classifierSet) const;
-
-    const std::string _baseSql = R"(
-        SELECT growth_curve_id
-        FROM (
-            SELECT
-                gccv.growth_curve_id AS growth_curve_id,
-                SUM(CASE
-                        WHEN c.name IN (%1%) THEN
-                            CASE
-                                WHEN cv.value LIKE '?' THEN 1
-                                %2%
-                                ELSE -1000
-                            END
-                        ELSE -1000
-                    END
-                ) AS score
-            FROM growth_curve_classifier_value gccv
-            INNER JOIN classifier_value cv
-                ON gccv.classifier_value_id = cv.id
-            INNER JOIN classifier c
-                ON cv.classifier_id = c.id
-            GROUP BY gccv.growth_curve_id
-        ) AS growth_curve_ranking
-        WHERE score > 0
-        ORDER BY score DESC
-        LIMIT 1
+	std::shared_ptr<ClassifierMatchIndex> _growthCurveIndex;
+
+	std::vector<ClassifierMatchRow> loadClassifierValues() const;
+	const std::string buildDebuggingInfo(const DynamicObject& classifierSet) const;
+
+	const std::string _classifierValuesSql = R"(
+        SELECT
+            gccv.growth_curve_id AS growth_curve_id,
+            c.name AS classifier_name,
+            cv.value AS classifier_value
+        FROM growth_curve_classifier_value gccv
+        INNER JOIN classifier_value cv
+            ON gccv.classifier_value_id = cv.id
+        INNER JOIN classifier c
+            ON cv.classifier_id = c.id
     )";
-
-    const std::string _matchSql = "WHEN c.name LIKE '%1%' AND cv.value LIKE '%2%' THEN 4 ";
 };
 
 }}}
@@ -0,0 +1,97 @@
+#ifndef MOJA_MODULES_CBM_GROWTHTURNOVERKERNEL_H_
+#define MOJA_MODULES_CBM_GROWTHTURNOVERKERNEL_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+#include "moja/modules/cbm/standbiomasscarboncurve.h"
+#include "moja/modules/cbm/turnoverrates.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+	/**
+	 * Pools touched by the growth and turnover of a regular forest stand.
+	 */
+	enum class GrowthPool : int {
+		SoftwoodMerch,
+		SoftwoodOther,
+		SoftwoodFoliage,
+		SoftwoodCoarseRoots,
+		SoftwoodFineRoots,
+		HardwoodMerch,
+		HardwoodOther,
+		HardwoodFoliage,
+		HardwoodCoarseRoots,
+		HardwoodFineRoots,
+		SoftwoodStemSnag,
+		SoftwoodBranchSnag,
+		HardwoodStemSnag,
+		HardwoodBranchSnag,
+		AboveGroundVeryFastSoil,
+		BelowGroundVeryFastSoil,
+		AboveGroundFastSoil,
+		BelowGroundFastSoil,
+		MediumSoil,
+		Atmosphere
+	};
+
+	// Name of parameter pool in the pool collection.
+	CBM_API std::string growthPoolName(GrowthPool pool);
+
+	/**
+	 * A stock transfer between two growth pools.
+	 */
+	struct CBM_API GrowthTransfer {
+		GrowthPool source;
+		GrowthPool sink;
+		double value;
+	};
+
+	/**
+	 * A year of growth and turnover of a regular (non-peatland) forest stand, built as one list of
+	 * stock transfers: half of the growth increment, mid-season growth, snag turnover, biomass
+	 * turnover, then the other half of the increment.
+	 *
+	 * The transfers are the ones of the five separate operations, appended by the static functions
+	 * below, with the same values in the same order, so applying the list as a single operation
+	 * leaves the pools exactly as applying the operations in turn. YieldTableGrowthModule also
+	 * submits the mid-season growth and turnover operations on their own during the spinup delay,
+	 * and the mid-season growth for forested peatland.
+	 */
+	class CBM_API GrowthTurnoverKernel {
+	public:
+		static const int PoolCount = int(GrowthPool::Atmosphere) + 1;
+
+		const std::vector<GrowthTransfer>& build(
+			const StandBiomassCarbonIncrements& increments, const TurnoverRates& rates, const double* pools);
+
+		const std::vector<GrowthTransfer>& transfers() const { return _transfers; }
+
+		// Half of the growth increment; an overmature component's losses go to snags and soil.
+		static void addHalfGrowth(std::vector<GrowthTransfer>& transfers,
+								  const StandBiomassCarbonIncrements& increments, const TurnoverRates& rates);
+
+		// Regrowth of the biomass that is turned over during the season, from parameter biomass by GrowthPool.
+		static void addMidSeasonGrowth(std::vector<GrowthTransfer>& transfers,
+									   const TurnoverRates& rates, const double* biomass);
+
+		// Turnover of the snags to soil, from parameter snags by GrowthPool.
+		static void addSnagTurnover(std::vector<GrowthTransfer>& transfers,
+									const TurnoverRates& rates, const double* snags);
+
+		// Turnover of the biomass to snags and soil, from parameter biomass by GrowthPool.
+		static void addBiomassTurnover(std::vector<GrowthTransfer>& transfers,
+									   const TurnoverRates& rates, const double* biomass);
+
+	private:
+		std::vector<GrowthTransfer> _transfers;
+		double _pools[PoolCount];	// pools after the first half of the growth increment
+	};
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_GROWTHTURNOVERKERNEL_H_
@@ -0,0 +1,109 @@
+#ifndef MOJA_MODULES_CBM_LANDUNITTRACE_H_
+#define MOJA_MODULES_CBM_LANDUNITTRACE_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+#include "moja/modules/cbm/classifiersetinterner.h"
+#include "moja/modules/cbm/record.h"
+#include "moja/modules/cbm/sharedvaluestore.h"
+
+#include <moja/dynamic.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * An operation applied to a land unit in an output step: the module that applied it and
+     * the disturbance it belongs to, if any.
+     */
+    struct CBM_API TracedOperation {
+        ModuleInfoRecord moduleInfo;
+        std::optional<DisturbanceTypeRecord> disturbanceType;
+    };
+
+    /**
+     * A flux between two different pools, by pool idx, per unit area.
+     */
+    struct CBM_API TracedFlux {
+        size_t operation;
+        int source;
+        int sink;
+        double value;
+    };
+
+    /**
+     * Everything CBMAggregatorLandUnitData records for a land unit in one output step, per unit
+     * area, so that it can be recorded again for another land unit with a different area.
+     */
+    struct CBM_API LandUnitStep {
+        bool isSpinup = false;                  // the post-spinup step
+        DateRecord date{ 0, 0, 0, 0, 0, 0 };
+        ClassifierSetRef classifierSet;
+        std::string landClass;
+        std::optional<Int64> ageClass;          // value of the "age_class" variable, if there is one
+        int age = 0;
+        std::vector<double> pools;              // by pool idx
+        std::vector<TracedOperation> operations;
+        std::vector<TracedFlux> fluxes;
+
+        void clear();
+    };
+
+    /**
+     * The output steps of a simulated land unit, from the post-spinup step to the end of the run.
+     */
+    struct CBM_API LandUnitTrace {
+        std::vector<LandUnitStep> steps;
+    };
+
+    /**
+     * Traces of simulated land units by the signature of their inputs, shared by every thread's aggregator.
+     *
+     * The store also holds the names of the variables that make up a land unit's inputs: the ones the
+     * CBM modules read for each land unit, plus any that modules add, such as the disturbance layers.
+     * CBMAggregatorLandUnitData adds every spatial layer and transform variable to these when it
+     * builds a land unit's signature, so inputs no module has declared still tell land units apart.
+     * Its size is bounded: a land unit is only traced once another land unit with the same signature
+     * has been seen, so that unique land units cost nothing but a hash, and no more than a fixed number
+     * of traces and seen signatures are kept. Land units beyond the limits are simulated as usual.
+     */
+    class CBM_API LandUnitTraceStore {
+    public:
+        typedef std::shared_ptr<const LandUnitTrace> TracePtr;
+
+        explicit LandUnitTraceStore(size_t maxTraces = 10000, size_t maxSignatures = 1000000);
+
+        void setLimits(size_t maxTraces, size_t maxSignatures);
+
+        void addInputs(const std::vector<std::string>& names);
+        std::vector<std::string> inputs() const;
+
+        TracePtr find(const std::string& signature) const;
+        bool shouldTrace(const std::string& signature);
+        bool insert(const std::string& signature, TracePtr trace);
+
+        size_t size() const { return _traces.size(); }
+
+    private:
+        mutable std::mutex _lock;
+        size_t _maxTraces;
+        size_t _maxSignatures;
+        std::vector<std::string> _inputs;
+        std::unordered_set<std::uint64_t> _seenSignatures;
+        SharedValueStore<std::string, const LandUnitTrace> _traces;
+    };
+
+    // Append an exact, unambiguous text form of parameter value to parameter signature.
+    CBM_API void appendSignature(std::string& signature, const DynamicVar& value);
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_LANDUNITTRACE_H_
@@ -0,0 +1,77 @@
+#ifndef MOJA_MODULES_CBM_LOCALRECORDACCUMULATOR_H_
+#define MOJA_MODULES_CBM_LOCALRECORDACCUMULATOR_H_
+
+#include "moja/types.h"
+
+#include <cstddef>
+#include <unordered_set>
+#include <vector>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * Unsynchronized record accumulator owned by a single worker thread.
+     *
+     * Offers the same accumulate/search semantics as flint::RecordAccumulatorWithMutex2
+     * but without taking a lock, so each thread can build its own dimension tables and
+     * merge them into the shared accumulators once at the end of the simulation. IDs are
+     * local to the instance and start from 1.
+     */
+    template<class TRecord>
+    class LocalRecordAccumulator {
+    public:
+        LocalRecordAccumulator() : _nextId(1) {}
+
+        const TRecord* accumulate(TRecord record) {
+            auto it = _records.find(record);
+            if (it != _records.end()) {
+                // Only the non-key fields (area, value) are touched by merge, so the
+                // element's hash and position in the set are unaffected.
+                const_cast<TRecord&>(*it).merge(record);
+                return &*it;
+            }
+
+            record.setId(_nextId++);
+            return &*_records.insert(record).first;
+        }
+
+        const TRecord* search(const TRecord& record) const {
+            auto it = _records.find(record);
+            return it == _records.end() ? nullptr : &*it;
+        }
+
+        /**
+         * Returns the records ordered by local ID so that merging a shard always
+         * visits records in the order they were first seen.
+         */
+        std::vector<const TRecord*> recordsById() const {
+            std::vector<const TRecord*> ordered(_records.size());
+            for (const auto& record : _records) {
+                ordered[record.getId() - 1] = &record;
+            }
+
+            return ordered;
+        }
+
+        size_t size() const { return _records.size(); }
+        bool empty() const { return _records.empty(); }
+
+        void clear() {
+            _records.clear();
+            _nextId = 1;
+        }
+
+    private:
+        struct RecordHasher {
+            size_t operator()(const TRecord& record) const { return record.hash(); }
+        };
+
+        std::unordered_set<TRecord, RecordHasher> _records;
+        Int64 _nextId;
+    };
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_LOCALRECORDACCUMULATOR_H_
@@ -3,6 +3,7 @@
 
 #include "moja/modules/cbm/_modules.cbm_exports.h"
 #include "moja/modules/cbm/cbmmodulebase.h"
+#include "moja/modules/cbm/decayratetable.h"
 #include "moja/modules/cbm/standgrowthcurvefactory.h"
 
 namespace moja {
@@ -67,7 +68,10 @@ namespace moja {
 				//kfs - feather slow decay rate
 				//ksf - sphagnum fast decay rate
 				//kss - sphagnum slow decay rate
-				double F7(double baseDecayRate, double meanAnnualTemperature, double q10);
+				double F7(double baseDecayRate, double meanAnnualTemperature);
+
+				//Temperature modifier e^((MAT-tref)*(ln(Q10)*0.1)) by mean annual temperature
+				DecayRateTable<double> _temperatureModifiers;
 
 				void updateMossAppliedDecayParameters(double standMaximumVolume, double meanAnnualTemperature);
 
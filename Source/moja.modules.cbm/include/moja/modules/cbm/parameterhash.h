@@ -0,0 +1,53 @@
+#ifndef MOJA_MODULES_CBM_PARAMETERHASH_H_
+#define MOJA_MODULES_CBM_PARAMETERHASH_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+
+#include <moja/dynamic.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * 64-bit FNV-1a hash of strings and parameter values, the same across platforms and builds,
+     * for tagging cached results with the inputs they were built from. Each value is followed by
+     * a separator and tagged with its kind, so that e.g. ["ab", "c"] and ["a", "bc"] hash differently.
+     */
+    class CBM_API ParameterHash {
+    public:
+        std::uint64_t value() const { return _hash; }
+
+        void add(const std::string& value);
+        void add(const DynamicVar& value);
+
+    private:
+        void add(const DynamicObject& row);
+
+        template<class T>
+        void addValue(T value) {
+            addBytes(&value, sizeof(value));
+        }
+
+        void addByte(unsigned char c) {
+            _hash ^= c;
+            _hash *= 1099511628211ULL;
+        }
+
+        void addBytes(const void* data, size_t size) {
+            auto bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; i++) {
+                addByte(bytes[i]);
+            }
+        }
+
+        std::uint64_t _hash = 14695981039346656037ULL;
+    };
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_PARAMETERHASH_H_
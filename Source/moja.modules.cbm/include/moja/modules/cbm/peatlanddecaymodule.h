@@ -3,6 +3,7 @@
 
 #include "moja/modules/cbm/_modules.cbm_exports.h"
 #include "moja/modules/cbm/cbmmodulebase.h"
+#include "moja/modules/cbm/decayratetable.h"
 
 #include "moja/modules/cbm/peatlanddecayparameters.h"
 #include "moja/modules/cbm/peatlandturnoverparameters.h"
@@ -16,7 +17,7 @@ namespace moja {
 
 			class CBM_API PeatlandDecayModule : public CBMModuleBase {
 			public:
-				PeatlandDecayModule() : CBMModuleBase() { }
+				PeatlandDecayModule();
 				virtual ~PeatlandDecayModule() = default;
 
 				void configure(const DynamicObject& config) override;
@@ -45,6 +46,12 @@ namespace moja {
 
 				flint::IVariable* _spinupMossOnly{ nullptr };
 				flint::IVariable* _appliedAnnualWTD{ nullptr };
+				flint::IVariable* _decayParameters{ nullptr };
+				flint::IVariable* _turnoverParameters{ nullptr };
+				VariableHandle<bool> _enablePeatland;
+				VariableHandle<int> _peatlandClass;
+				VariableHandle<double> _defaultMeanAnnualTemperature;
+				TimeSeriesSlot _meanAnnualTemperatureSlot;
 
 				double _meanAnnualTemperature{ 0 };
 				int _peatlandId{ -1 };
@@ -55,6 +62,12 @@ namespace moja {
 				/// </summary>
 				std::shared_ptr<PeatlandDecayParameters> decayParas{ nullptr };
 
+				/// <summary>
+				/// Decay parameters applied for each mean annual temperature, computed from baseDecayParas
+				/// </summary>
+				PeatlandDecayParameters baseDecayParas;
+				DecayRateTable<std::shared_ptr<PeatlandDecayParameters>> appliedDecayParas;
+
 				/// <summary>
 				/// Turnover parameters associated with this peatland unit
 				/// </summary>
@@ -72,6 +72,8 @@ namespace moja {
 
 				void updateAppliedDecayParameters(double meanAnnualTemperature);
 
+				bool hasSameBaseParameters(const PeatlandDecayParameters& other) const;
+
 
 			private:
 				double _akwsb{ 0 };
@@ -0,0 +1,42 @@
+#ifndef MOJA_MODULES_CBM_POOLDECAYPARAMETERS_H_
+#define MOJA_MODULES_CBM_POOLDECAYPARAMETERS_H_
+
+#include <moja/dynamic.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+	struct PoolDecayParameters {
+		std::string pool;
+		double baseDecayRate;
+		double maxDecayRate;
+		double q10;
+		double tRef;
+		double pAtm;
+
+		PoolDecayParameters() {}
+
+		PoolDecayParameters(const DynamicObject& data) {
+			pool = data["pool"].convert<std::string>();
+			baseDecayRate = data["organic_matter_decay_rate"];
+			q10 = data["q10"];
+			tRef = data["reference_temp"];
+			maxDecayRate = data["max_decay_rate_soft"];
+			pAtm = data["prop_to_atmosphere"];
+		}
+
+		double getDecayRate(double mat) const {
+			return std::min(
+				baseDecayRate * std::exp((mat - tRef) * std::log(q10) * 0.1),
+				maxDecayRate);
+		}
+	};
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_POOLDECAYPARAMETERS_H_
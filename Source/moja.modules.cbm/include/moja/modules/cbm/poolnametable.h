@@ -0,0 +1,55 @@
+#ifndef MOJA_MODULES_CBM_POOLNAMETABLE_H_
+#define MOJA_MODULES_CBM_POOLNAMETABLE_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * Compact handle to a pool name: records hash and compare on the pool index and
+     * only expand the name when they are persisted.
+     */
+    class CBM_API PoolRef {
+    public:
+        PoolRef() : _idx(-1), _name(nullptr) {}
+        PoolRef(int idx, const std::string* name) : _idx(idx), _name(name) {}
+
+        int idx() const { return _idx; }
+        bool isValid() const { return _name != nullptr; }
+        const std::string& name() const { return *_name; }
+
+        bool operator==(const PoolRef& other) const { return _idx == other._idx; }
+        bool operator!=(const PoolRef& other) const { return _idx != other._idx; }
+
+    private:
+        int _idx;
+        const std::string* _name;
+    };
+
+    /**
+     * Process-wide table of pool names indexed by pool idx, shared by all threads. The
+     * names are set by the first local domain to initialize and never change afterwards,
+     * so PoolRef handles stay valid until the writers have run.
+     */
+    class CBM_API PoolNameTable {
+    public:
+        PoolNameTable() = default;
+
+        void assign(const std::vector<std::string>& names);
+        PoolRef ref(int idx) const;
+        size_t size() const { return _names.size(); }
+
+    private:
+        std::mutex _lock;
+        std::vector<std::string> _names;
+    };
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_POOLNAMETABLE_H_
@@ -0,0 +1,143 @@
+#ifndef MOJA_MODULES_CBM_RECORDFLUSHCOORDINATOR_H_
+#define MOJA_MODULES_CBM_RECORDFLUSHCOORDINATOR_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+
+#include <moja/dynamic.h>
+#include <moja/hash.h>
+#include <moja/types.h>
+
+#include <Poco/RWLock.h>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * Coordinates streaming output between the aggregator modules and the writers.
+     *
+     * Aggregators accumulate each step under a shared lock and count the fact records
+     * (pools, fluxes, age area) that are new rather than merged into an existing record. Once the configured record count or
+     * estimated memory threshold is crossed, the next aggregator to start a step takes the
+     * lock exclusively and runs the writers' flush handlers, then their clear handlers, so
+     * every writer sees the same batch and no step is ever split across two batches.
+     * Streaming is disabled until a writer configures a threshold. Because a batch is
+     * written before the rest of the simulation has been aggregated, fact rows sharing the
+     * same key can appear in more than one batch and must be summed when compiling results.
+     * Location and disturbance rows keep the Id they were first written with, see stableId(),
+     * so the writers add to the area of a row written by an earlier batch instead of writing
+     * it again. Streaming needs the shared accumulators: sharded accumulation only merges
+     * its records at the end of each local domain, so the two can't be combined.
+     */
+    class CBM_API RecordFlushCoordinator {
+    public:
+        /**
+         * Dimensions that grow with the simulation and are released by the writers after each
+         * flush. A cleared accumulator can number its records from 1 again, so the aggregators
+         * add the dimension's Id offset to the Ids they store in other records, and the writers
+         * add it to the rows they write; the writers advance the offset past the last Id written.
+         */
+        enum class ReleasedDimension { Location = 0, Disturbance = 1 };
+
+        // The attributes that identify a row of a released dimension, i.e. the ones its record compares.
+        typedef std::tuple<Int64, Int64, Int64, Int64> ReleasedKey;
+
+        // Approximate per-record bookkeeping cost of a hash set node on top of the record itself.
+        static const size_t RecordOverheadBytes = 4 * sizeof(void*);
+
+        RecordFlushCoordinator() : _maxRecords(0), _maxBytes(0), _pendingRecords(0), _pendingBytes(0) {
+            for (auto& offset : _idOffsets) {
+                offset = 0;
+            }
+        }
+
+        void configure(const DynamicObject& config);
+        void configure(size_t maxRecords, size_t maxBytes);
+        bool isEnabled() const { return _maxRecords > 0 || _maxBytes > 0; }
+
+        void addFlushHandler(std::function<void()> flush, std::function<void()> clear);
+
+        template<class TRecord>
+        void recordAccumulated(size_t count) {
+            if (isEnabled() && count > 0) {
+                _pendingRecords += count;
+                _pendingBytes += count * (sizeof(TRecord) + RecordOverheadBytes);
+            }
+        }
+
+        /**
+         * Accumulate parameter record into parameter dimension and count it as pending if it is a
+         * new record rather than merged into an existing one. Two threads adding the same new record
+         * at once can both count it, so the count can run slightly ahead of the records held.
+         */
+        template<class TAccumulator, class TRecord>
+        void accumulate(TAccumulator& dimension, const TRecord& record) {
+            if (isEnabled() && dimension.search(record) == nullptr) {
+                recordAccumulated<TRecord>(1);
+            }
+
+            dimension.accumulate(record);
+        }
+
+        Int64 idOffset(ReleasedDimension dimension) const { return _idOffsets[(int)dimension]; }
+        void setIdOffset(ReleasedDimension dimension, Int64 offset) { _idOffsets[(int)dimension] = offset; }
+
+        Int64 stableId(ReleasedDimension dimension, const ReleasedKey& key, Int64 id);
+
+        /**
+         * Run parameter fn while holding the accumulation lock shared, flushing first if a
+         * threshold has been reached.
+         */
+        template<typename Fn>
+        void withAccumulationLock(Fn fn) {
+            if (!isEnabled()) {
+                fn();
+                return;
+            }
+
+            flushIfRequired();
+            Poco::ScopedReadRWLock lock(_accumulationLock);
+            fn();
+        }
+
+        /**
+         * Run parameter fn while no aggregator is accumulating, i.e. for the final write.
+         */
+        template<typename Fn>
+        void withFlushLock(Fn fn) {
+            Poco::ScopedWriteRWLock lock(_accumulationLock);
+            fn();
+        }
+
+        void flushIfRequired();
+
+    private:
+        bool thresholdReached() const;
+
+        std::atomic<size_t> _maxRecords;
+        std::atomic<size_t> _maxBytes;
+        std::atomic<size_t> _pendingRecords;
+        std::atomic<size_t> _pendingBytes;
+        std::atomic<Int64> _idOffsets[2];
+
+        // The Id each row of a released dimension was first given, kept for the whole simulation: one
+        // entry per distinct location or disturbance row, much smaller than the fact records released.
+        std::mutex _stableIdLock;
+        std::unordered_map<ReleasedKey, Int64, moja::Hash> _stableIds[2];
+
+        Poco::RWLock _accumulationLock;
+        std::vector<std::function<void()>> _flushHandlers;
+        std::vector<std::function<void()>> _clearHandlers;
+    };
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_RECORDFLUSHCOORDINATOR_H_
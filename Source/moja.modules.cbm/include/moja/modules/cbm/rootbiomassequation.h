@@ -4,6 +4,7 @@
 #include "moja/modules/cbm/_modules.cbm_exports.h"
 
 #include <cmath>
+#include <vector>
 
 namespace moja {
 namespace modules {
@@ -35,6 +36,9 @@ namespace cbm {
         // root biomass for all components.
         virtual RootProportions calculateRootProportions(double standRootBiomass) = 0;
 
+        // The coefficients the equation was constructed with, in constructor order.
+        virtual std::vector<double> coefficients() const = 0;
+
     protected:
         double _biomassToCarbonRate;
     };
@@ -60,6 +64,10 @@ namespace cbm {
             return RootProportions{ fineRootProp, coarseRootProp };
         }
 
+        std::vector<double> coefficients() const override {
+            return { _rootBioA, _frpA, _frpB, _frpC };
+        }
+
     private:
         double _rootBioA;
         double _frpA;
@@ -88,6 +96,10 @@ namespace cbm {
             return RootProportions{ fineRootProp, coarseRootProp };
         }
 
+        std::vector<double> coefficients() const override {
+            return { _rootBioA, _rootBioB, _frpA, _frpB, _frpC };
+        }
+
     private:
         double _rootBioA;
         double _rootBioB;
@@ -0,0 +1,137 @@
+#ifndef MOJA_MODULES_CBM_SHAREDVALUESTORE_H_
+#define MOJA_MODULES_CBM_SHAREDVALUESTORE_H_
+
+#include <Poco/RWLock.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * Process-wide store of values built once and shared by every thread, such as growth curves.
+     *
+     * The first thread to ask for a missing key builds its value while other threads asking for
+     * the same key wait for the result, and threads asking for other keys carry on. Stored values
+     * are never replaced or evicted, so the pointers handed out stay valid and can be read
+     * concurrently; callers must treat them as immutable.
+     */
+    template <typename TKey, typename TValue, typename THash = std::hash<TKey>>
+    class SharedValueStore {
+    public:
+        typedef std::shared_ptr<TValue> ValuePtr;
+
+        /**
+         * Return the value for parameter key, or nullptr if it hasn't been built.
+         *
+         * @param key TKey&
+         * @return shared_ptr<TValue>
+         * ************************/
+        ValuePtr find(const TKey& key) const {
+            Poco::ScopedReadRWLock lock(_lock);
+            auto it = _values.find(key);
+            return it == _values.end() ? nullptr : it->second;
+        }
+
+        /**
+         * Return the value for parameter key, calling parameter build to create it if no thread \n
+         * has yet. If another thread is building the same value, wait for it. If build throws, \n
+         * the key is released so that a waiting thread can try instead.
+         *
+         * @param key TKey&
+         * @param build TBuild, callable returning shared_ptr<TValue>
+         * @return shared_ptr<TValue>
+         * ************************/
+        template <typename TBuild>
+        ValuePtr getOrBuild(const TKey& key, TBuild build) {
+            auto value = find(key);
+            if (value != nullptr) {
+                return value;
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(_pendingLock);
+                for (;;) {
+                    value = find(key);
+                    if (value != nullptr) {
+                        return value;
+                    }
+
+                    if (_pending.insert(key).second) {
+                        break;
+                    }
+
+                    _pendingChanged.wait(lock);
+                }
+            }
+
+            try {
+                value = build();
+                Poco::ScopedWriteRWLock lock(_lock);
+                _values.emplace(key, value);
+            } catch (...) {
+                release(key);
+                throw;
+            }
+
+            release(key);
+            return value;
+        }
+
+        /**
+         * Store parameter value for parameter key unless there already is one; return the stored value.
+         *
+         * @param key TKey&
+         * @param value shared_ptr<TValue>
+         * @return shared_ptr<TValue>
+         * ************************/
+        ValuePtr insert(const TKey& key, ValuePtr value) {
+            Poco::ScopedWriteRWLock lock(_lock);
+            return _values.emplace(key, value).first->second;
+        }
+
+        /**
+         * Call parameter visit with each stored key and value.
+         *
+         * @param visit TVisit, callable taking (const TKey&, const shared_ptr<TValue>&)
+         * @return void
+         * ************************/
+        template <typename TVisit>
+        void forEach(TVisit visit) const {
+            Poco::ScopedReadRWLock lock(_lock);
+            for (const auto& entry : _values) {
+                visit(entry.first, entry.second);
+            }
+        }
+
+        size_t size() const {
+            Poco::ScopedReadRWLock lock(_lock);
+            return _values.size();
+        }
+
+    private:
+        void release(const TKey& key) {
+            {
+                std::lock_guard<std::mutex> lock(_pendingLock);
+                _pending.erase(key);
+            }
+
+            _pendingChanged.notify_all();
+        }
+
+        mutable Poco::RWLock _lock;
+        std::unordered_map<TKey, ValuePtr, THash> _values;
+
+        std::mutex _pendingLock;
+        std::condition_variable _pendingChanged;
+        std::unordered_set<TKey, THash> _pending;
+    };
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_SHAREDVALUESTORE_H_
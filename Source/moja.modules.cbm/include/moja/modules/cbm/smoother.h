@@ -5,14 +5,81 @@
 #include "moja/flint/modulebase.h"
 #include "standgrowthcurve.h"
 #include "componentbiomasscarboncurve.h"
+#include "sharedvaluestore.h"
+
+#include <array>
+#include <memory>
+#include <vector>
 
 namespace moja {
 namespace modules {
 namespace cbm {
 
+    /*
+    * Working data for smoothing one component carbon curve: the merch, foliage, other and
+    * total aboveground carbon and the ages over the smoothing region, each normalized by
+    * its maximum, and the maximums themselves.
+    */
+    struct CBM_API SmoothingSample {
+        std::vector<double> merchC;
+        std::vector<double> foliageC;
+        std::vector<double> otherC;
+        std::vector<double> totalAGBioC;
+        std::vector<double> ageSerials;
+
+        double maxMerchC = 0;
+        double maxFoliageC = 0;
+        double maxOtherC = 0;
+        double maxTotalAGC = 0;
+        double maxAge = 0;
+
+        void clearAndReserve(int workingFitingRange);
+    };
+
+    /*
+    * A component carbon curve to smooth as part of a batch.
+    */
+    struct SmoothingJob {
+        const StandGrowthCurve* standGrowthCurve;
+        ComponentBiomassCarbonCurve* carbonCurve;
+        SpeciesType speciesType;
+    };
+
+    /*
+    * Weibull fits already made, by substitution point and normalized carbon series, so that
+    * curves with the same normalized shape - the same yield table in several SPUs, or tables
+    * that only differ by a scale factor - are only fitted once. A fit is only reused for an
+    * identical series, so reused parameters are exactly the ones a new fit would find. The
+    * table stops taking new fits once it holds a smoother's maxCachedFits; later series are
+    * fitted each time, with the same results.
+    */
+    struct WeibullFitKey {
+        int substitutionPoint;
+        std::vector<double> values;
+
+        bool operator==(const WeibullFitKey& other) const {
+            return substitutionPoint == other.substitutionPoint && values == other.values;
+        }
+    };
+
+    struct WeibullFitKeyHash {
+        size_t operator()(const WeibullFitKey& key) const;
+    };
+
+    typedef SharedValueStore<WeibullFitKey, std::array<double, 2>, WeibullFitKeyHash> WeibullFitTable;
+
+    /*
+    * Replaces the start of a component carbon curve, up to where it joins the volume-based
+    * curve, with 2-parameter Weibull fits to the merch, foliage and total aboveground carbon.
+    *
+    * smooth() and smoothAll() keep their working data on the stack and only share the fit
+    * table, so one Smoother can be used by any number of threads at once. The step-by-step
+    * methods that work on the smoother's own sample are for a single thread only.
+    */
     class CBM_API Smoother {
     public:
-        Smoother(){}
+        explicit Smoother(size_t maxCachedFits = 10000)
+            : _fits(std::make_shared<WeibullFitTable>()), _maxCachedFits(maxCachedFits) {}
         virtual ~Smoother() {};
 
         const int extendedRegionSize = 15;
@@ -21,50 +88,73 @@ namespace cbm {
 
         void smooth(const StandGrowthCurve& standGrowthCurve,
                     ComponentBiomassCarbonCurve* carbonCurve,
-                    SpeciesType speciesType);
-            
+                    SpeciesType speciesType) const;
+
+        // Smooth every curve in parameter jobs, spread over threadCount threads (0 for one per core).
+        // Each curve gets the same result as smooth() would give it.
+        void smoothAll(const std::vector<SmoothingJob>& jobs, int threadCount = 0) const;
+
+        size_t cachedFitCount() const { return _fits->size(); }
+
         int getComponentSmoothingSubstitutionRegionPoint(
             const StandGrowthCurve& standGrowthCurve,
-            SpeciesType speciesType);
+            SpeciesType speciesType) const;
 
         void prepareSmoothingInputData(const ComponentBiomassCarbonCurve& carbonCurve,
                                        int substitutionPoint,
-                                       int standMaxAge);
+                                       int standMaxAge,
+                                       SmoothingSample& sample) const;
 
-        void clearAndReserveDataSpace(int workingFitingRange);
+        void minimize(const SmoothingSample& sample, const double yValues[], double startingVals[]) const;
 
-        void minimize(double yValues[], double startingVals[]);
+        int getFinalFittingRegionAndReplaceData(
+            const SmoothingSample& sample,
+            ComponentBiomassCarbonCurve& carbonCurve,
+            int substitutionPoint,
+            double merchCWeibullParameters[],
+            double foliageCWeibullParameters[],
+            double totalAGBioCWeibullParameters[]) const;
 
-        // To be passed as a function pointer.
-        static double weibull_2Parameter(double t, double* p);
+        // Step-by-step equivalents of the above, working on the smoother's own sample.
+        void prepareSmoothingInputData(const ComponentBiomassCarbonCurve& carbonCurve,
+                                       int substitutionPoint,
+                                       int standMaxAge) {
+            prepareSmoothingInputData(carbonCurve, substitutionPoint, standMaxAge, _sample);
+        }
+
+        void clearAndReserveDataSpace(int workingFitingRange) { _sample.clearAndReserve(workingFitingRange); }
+
+        void minimize(double yValues[], double startingVals[]) const { minimize(_sample, yValues, startingVals); }
 
         int getFinalFittingRegionAndReplaceData(
             ComponentBiomassCarbonCurve& carbonCurve,
             int substitutionPoint,
             double merchCWeibullParameters[],
             double foliageCWeibullParameters[],
-            double totalAGBioCWeibullParameters[]);
+            double totalAGBioCWeibullParameters[]) const {
+
+            return getFinalFittingRegionAndReplaceData(_sample, carbonCurve, substitutionPoint,
+                merchCWeibullParameters, foliageCWeibullParameters, totalAGBioCWeibullParameters);
+        }
+
+        // To be passed as a function pointer.
+        static double weibull_2Parameter(double t, double* p);
 
-        std::vector<double>& smoothingMerchC()      { return _smoothingMerchC; };
-        std::vector<double>& smoothingFoliageC()    { return _smoothingFoliageC; };
-        std::vector<double>& smoothingOtherC()      { return _smoothingOtherC; };
-        std::vector<double>& smoothingTotalAGBioC() { return _smoothingTotalAGBioC; };
-        std::vector<double>& smoothingAageSerials() { return _smoothingAageSerials; };
+        std::vector<double>& smoothingMerchC()      { return _sample.merchC; };
+        std::vector<double>& smoothingFoliageC()    { return _sample.foliageC; };
+        std::vector<double>& smoothingOtherC()      { return _sample.otherC; };
+        std::vector<double>& smoothingTotalAGBioC() { return _sample.totalAGBioC; };
+        std::vector<double>& smoothingAageSerials() { return _sample.ageSerials; };
 
     private:
-        // Smoother uses following data vectors as working space to generate
-        // the data to add/replace the original data.
-        std::vector<double> _smoothingMerchC;
-        std::vector<double> _smoothingFoliageC;
-        std::vector<double> _smoothingOtherC;
-        std::vector<double> _smoothingTotalAGBioC;
-        std::vector<double> _smoothingAageSerials;
-
-        double _smoothingMaxMerchC = 0;
-        double _smoothingMaxFoliageC = 0;
-        double _smoothingMaxOtherC = 0;
-        double _smoothingMaxTotalAGC = 0;
-        double _smoothingMaxAge = 0;
+        void fit(const SmoothingSample& sample, int substitutionPoint,
+                 const std::vector<double>& yValues, double parameters[]) const;
+
+        // Working space for the step-by-step methods only.
+        SmoothingSample _sample;
+
+        std::shared_ptr<WeibullFitTable> _fits;
+        size_t _maxCachedFits;
     };
 
 }}}
@@ -0,0 +1,144 @@
+#ifndef MOJA_MODULES_CBM_SPINUPCACHE_H_
+#define MOJA_MODULES_CBM_SPINUPCACHE_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+#include "moja/modules/cbm/sharedvaluestore.h"
+#include "moja/dynamic.h"
+#include "moja/hash.h"
+
+#include <Poco/RWLock.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * Process-wide cache of spinup results, shared by every thread's spinup sequencer.
+     *
+     * Lookups take a shared lock, so threads only contend when a result is stored. The
+     * first thread to miss on a key reserves it and runs the spinup; other threads asking
+     * for the same key wait for that result instead of computing it again. The cache can
+     * be saved to and reloaded from a file, tagged with a version string that callers
+     * derive from the pool set and the values of the spinup and decay parameters, so that
+     * results computed with different inputs are discarded.
+     */
+    class CBM_API SpinupCache {
+    public:
+        // SPU, historic disturbance type, GC ID (or peatland ID), return interval, mean annual temperature
+        typedef std::tuple<int, std::string, int, int, double> Key;
+
+        /**
+         * A reservation on a cache key: either the cached pool values, or the right to
+         * compute and store them. If the holder never stores a result (e.g. its spinup
+         * throws), the key is released so that a waiting thread can compute it instead.
+         */
+        class CBM_API Reservation {
+        public:
+            Reservation(SpinupCache& cache, const Key& key);
+            ~Reservation();
+
+            Reservation(const Reservation&) = delete;
+            Reservation& operator=(const Reservation&) = delete;
+
+            bool isCached() const { return !_owner; }
+            const std::vector<double>& values() const { return _values; }
+            void store(const std::vector<double>& values);
+
+        private:
+            SpinupCache& _cache;
+            Key _key;
+            std::vector<double> _values;
+            bool _owner;
+        };
+
+        SpinupCache() : _unsavedEntries(0) {}
+
+        bool find(const Key& key, std::vector<double>& values) const;
+        void insert(const Key& key, const std::vector<double>& values);
+        size_t size() const;
+
+        static std::string version(const std::vector<std::string>& poolNames, const std::string& parameterVersion,
+                                   const std::map<std::string, DynamicVar>& parameters = {});
+
+        void open(const std::string& path, const std::string& version);
+        void save();
+        bool load(const std::string& path, const std::string& version);
+        void save(const std::string& path, const std::string& version);
+
+    private:
+        bool reserve(const Key& key, std::vector<double>& values);
+        void release(const Key& key);
+
+        mutable Poco::RWLock _lock;
+        std::unordered_map<Key, std::vector<double>, moja::Hash> _entries;
+
+        std::mutex _pendingLock;
+        std::condition_variable _pendingChanged;
+        std::unordered_set<Key, moja::Hash> _pending;
+
+        std::mutex _fileLock;
+        std::string _path;
+        std::string _version;
+        std::atomic<size_t> _unsavedEntries;
+    };
+
+    /**
+     * Land unit state at the end of a regular spinup: pool values by pool idx, stand age and
+     * whether the stand is decaying. Stands with the same spinup cache key, last pass disturbance,
+     * stand age and delay end up in the same state, so it only needs to be simulated once.
+     */
+    struct CBM_API SpinupRegrowth {
+        std::vector<double> pools;
+        int age;
+        bool isDecaying;
+    };
+
+    // SpinupCache::Key fields, then last pass disturbance type, stand age and stand delay
+    typedef std::tuple<int, std::string, int, int, double, std::string, int, int> SpinupRegrowthKey;
+
+    // Process-wide store of spinup end states, shared by every thread's spinup sequencer.
+    typedef SharedValueStore<SpinupRegrowthKey, SpinupRegrowth, moja::Hash> SpinupRegrowthStore;
+
+    /**
+     * Bring a land unit to the end state of its regular spinup. The first thread to ask for parameter key \n
+     * calls parameter simulate to run the spinup on its own land unit and parameter capture to record the \n
+     * end state in parameter store; other threads asking for the same key wait for it, and every later \n
+     * land unit with the key gets the recorded state from parameter apply instead of being simulated.
+     *
+     * @param store SpinupRegrowthStore&
+     * @param key SpinupRegrowthKey&
+     * @param simulate TSimulate, callable running the spinup on the land unit
+     * @param capture TCapture, callable returning the land unit's state as shared_ptr<SpinupRegrowth>
+     * @param apply TApply, callable taking the const SpinupRegrowth& to copy into the land unit
+     * @return bool, true if the spinup was simulated rather than replayed
+     * ************************/
+    template <typename TSimulate, typename TCapture, typename TApply>
+    bool replaySpinupRegrowth(SpinupRegrowthStore& store, const SpinupRegrowthKey& key,
+                              TSimulate simulate, TCapture capture, TApply apply) {
+        bool simulated = false;
+        auto regrowth = store.getOrBuild(key, [&simulated, &simulate, &capture]() {
+            simulated = true;
+            simulate();
+            return capture();
+        });
+
+        if (!simulated) {
+            apply(*regrowth);
+        }
+
+        return simulated;
+    }
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_SPINUPCACHE_H_
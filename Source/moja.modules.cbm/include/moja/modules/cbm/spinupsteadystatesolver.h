@@ -0,0 +1,120 @@
+#ifndef MOJA_MODULES_CBM_SPINUPSTEADYSTATESOLVER_H_
+#define MOJA_MODULES_CBM_SPINUPSTEADYSTATESOLVER_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * A single pool-to-pool flux from an applied operation.
+     */
+    struct SpinupPoolTransfer {
+        int source;
+        int sink;
+        double value;
+    };
+
+    /**
+     * The regular spinup's stopping rule: stop at the end of a pass once the slow pools have
+     * changed by less than 0.1% since the end of the previous pass and more than the minimum
+     * number of rotations are done, or at the maximum number of rotations regardless.
+     */
+    class CBM_API SpinupStoppingRule {
+    public:
+        SpinupStoppingRule(const std::vector<int>& slowPools, int minimumRotations, int maximumRotations);
+
+        bool isDone(int rotation, const std::vector<double>& passEndValues);
+        bool isStable() const { return _stable; }
+
+        static bool isSlowPoolStable(double lastSlowPoolValue, double currentSlowPoolValue);
+
+    private:
+        std::vector<int> _slowPools;
+        int _minimumRotations;
+        int _maximumRotations;
+        double _lastSlowPoolValue;
+        bool _stable;
+    };
+
+    /**
+     * Finds where the regular spinup procedure ends without simulating every rotation.
+     *
+     * The spinup sequencer records each rotation as the sequence of operations applied
+     * to the pools (growth, turnover, decay, the historic disturbance) and the biomass
+     * pool reset, marking where the pass ends and the disturbance begins. Comparing the
+     * last two rotations classifies each flux as either a constant amount (growth from the
+     * atmosphere, and everything flowing out of the biomass pools, which restart from zero
+     * every rotation) or a constant proportion of its source pool (decay, disturbance).
+     * The pass and the whole rotation are then affine maps of the pool values at the start
+     * of the rotation: project() applies them to run the remaining rotations under the
+     * regular stopping rule at the cost of a matrix-vector product each, and solve() finds
+     * the rotation's fixed point with a single linear solve. If a flux is neither, the
+     * modules are not linear and the caller should carry on simulating rotations.
+     */
+    class CBM_API SpinupSteadyStateSolver {
+    public:
+        explicit SpinupSteadyStateSolver(size_t poolCount, double tolerance = 1e-6);
+
+        void beginRotation(const std::vector<double>& poolValues);
+        void addOperation(const std::vector<SpinupPoolTransfer>& transfers);
+        void endPass();
+        void resetPools(const std::vector<int>& pools);
+        void endRotation();
+
+        bool matches(const std::vector<double>& poolValues) const;
+        void invalidate() { _valid = false; }
+        bool isValid() const { return _valid; }
+        size_t rotations() const { return _rotations.size(); }
+
+        bool project(const std::vector<double>& startValues, SpinupStoppingRule& stoppingRule,
+                     int& rotation, std::vector<double>& poolValues) const;
+        bool solve(std::vector<double>& poolValues) const;
+
+    private:
+        // Pool values after a sequence of operations as matrix * start + offset.
+        struct AffineMap {
+            std::vector<std::vector<double>> matrix;
+            std::vector<double> offset;
+
+            std::vector<double> apply(const std::vector<double>& values) const;
+        };
+
+        struct Transfer {
+            int source;
+            int sink;
+            double value;
+            double sourceValue;
+        };
+
+        // One applied operation, or a reset of the listed pools if isReset is true.
+        struct Event {
+            bool isReset;
+            std::vector<Transfer> transfers;
+            std::vector<int> pools;
+        };
+
+        struct Rotation {
+            std::vector<double> startValues;
+            std::vector<Event> events;
+            size_t passEnd;     // number of events in the pass, before the historic disturbance
+        };
+
+        size_t _poolCount;
+        double _tolerance;
+        bool _valid;
+        bool _inRotation;
+        std::vector<double> _currentValues;
+        std::vector<Rotation> _rotations;
+
+        bool isClose(double first, double second) const;
+        bool buildMaps(AffineMap& pass, AffineMap& rotation) const;
+    };
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_SPINUPSTEADYSTATESOLVER_H_
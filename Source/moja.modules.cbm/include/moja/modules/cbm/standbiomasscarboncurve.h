@@ -11,6 +11,27 @@ namespace moja {
 namespace modules {
 namespace cbm {
 
+    /*
+    * The age variable and softwood and hardwood biomass pools of a land unit, resolved once
+    * so that a growth step can get its increments without looking them up by name.
+    */
+    struct CBM_API StandBiomassPools {
+        StandBiomassPools() = default;
+        explicit StandBiomassPools(flint::ILandUnitDataWrapper& landUnitData);
+
+        const flint::IVariable* age = nullptr;
+        ComponentBiomassPools softwood;
+        ComponentBiomassPools hardwood;
+    };
+
+    /*
+    * Biomass carbon increments of a stand for a growth step: zero for a missing component.
+    */
+    struct StandBiomassCarbonIncrements {
+        ComponentBiomassCarbonIncrements softwood;
+        ComponentBiomassCarbonIncrements hardwood;
+    };
+
     class CBM_API StandBiomassCarbonCurve {
     public:
         StandBiomassCarbonCurve() {};
@@ -22,6 +43,12 @@ namespace cbm {
 
         std::unordered_map<std::string, double> getIncrements(flint::ILandUnitDataWrapper* landUnitData);
 
+        // Same increments as the map returned by getIncrements, without allocating.
+        void getIncrements(const StandBiomassPools& pools, StandBiomassCarbonIncrements& increments) const;
+
+        bool isEmpty() const { return _components.empty(); }
+        const std::vector<StandComponent>& components() const { return _components; }
+
         // Gets the absolute total aboveground carbon at each age, where index = age.
         std::vector<double> getAboveGroundCarbonCurve();
 
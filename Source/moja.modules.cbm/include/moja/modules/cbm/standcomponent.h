@@ -9,10 +9,33 @@
 #include "moja/flint/modulebase.h"
 
 #include <unordered_map>
+#include <vector>
 
 namespace moja {
 namespace modules {
 namespace cbm {
+
+    /*
+    * Biomass pools of one stand component (softwood or hardwood), resolved once by the caller.
+    */
+    struct ComponentBiomassPools {
+        const flint::IPool* merch = nullptr;
+        const flint::IPool* other = nullptr;
+        const flint::IPool* foliage = nullptr;
+        const flint::IPool* coarseRoots = nullptr;
+        const flint::IPool* fineRoots = nullptr;
+    };
+
+    /*
+    * Biomass carbon increments of one stand component for a growth step.
+    */
+    struct ComponentBiomassCarbonIncrements {
+        double merch = 0.0;
+        double other = 0.0;
+        double foliage = 0.0;
+        double coarseRoots = 0.0;
+        double fineRoots = 0.0;
+    };
     
     class CBM_API StandComponent {
     public:
@@ -22,16 +45,29 @@ namespace cbm {
             : _forestType(forestType), _growthCurve(growthCurve) {
             
             _rootBiomassEquation = rootBiomassEquation;
+            precomputeAGIncrements();
         }
 
         virtual ~StandComponent() = default;
 
         virtual const std::string& forestType() const { return _forestType; }
+        std::shared_ptr<RootBiomassEquation> rootBiomassEquation() const { return _rootBiomassEquation; }
+        std::shared_ptr<ComponentBiomassCarbonCurve> growthCurve() const { return _growthCurve; }
 
         virtual double calculateRootBiomass(flint::ILandUnitDataWrapper* landUnitData) const;
         virtual std::unordered_map<std::string, double> getIncrements(flint::ILandUnitDataWrapper* landUnitData, double standRootBiomass) const;
         virtual std::vector<double> getAboveGroundCarbonCurve() const;
 
+        // Typed equivalents of calculateRootBiomass and getIncrements for the growth hot path:
+        // no pool name lookups and no allocation.
+        double calculateRootBiomass(int age, const ComponentBiomassPools& pools) const;
+        void getIncrements(int age, const ComponentBiomassPools& pools, double standRootBiomass,
+                           ComponentBiomassCarbonIncrements& increments) const;
+
+        // Merch, other and foliage increments at an age for the given pool values, from the increments
+        // precomputed by age; the root increments are left at zero.
+        ComponentBiomassCarbonIncrements getAGIncrements(int age, double merch, double other, double foliage) const;
+
         virtual const std::vector<double>& getMerchCarbonCurve() const;
         virtual const std::vector<double>& getFoliageCarbonCurve() const;
         virtual const std::vector<double>& getOtherCarbonCurve() const;
@@ -40,7 +76,18 @@ namespace cbm {
         std::string _forestType;
         std::shared_ptr<RootBiomassEquation> _rootBiomassEquation;
         std::shared_ptr<ComponentBiomassCarbonCurve> _growthCurve;
-        
+
+        // Merch, other and foliage carbon increments at each age, where index = age.
+        struct AGIncrement {
+            double merch;
+            double other;
+            double foliage;
+        };
+
+        std::vector<AGIncrement> _agIncrements;
+
+        void precomputeAGIncrements();
+
         std::unordered_map<std::string, double> getAGIncrements(
             const flint::IVariable* age, const flint::IPool* merch, const flint::IPool* other,
             const flint::IPool* foliage) const;
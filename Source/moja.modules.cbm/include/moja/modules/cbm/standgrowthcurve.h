@@ -9,6 +9,8 @@
 #include "moja/modules/cbm/treeyieldtable.h"
 #include "moja/modules/cbm/foresttypeconfiguration.h"
 
+#include <cstdint>
+
 namespace moja {
 namespace modules {
 namespace cbm {
@@ -23,6 +25,10 @@ namespace cbm {
         Int64 spuID() const { return _spuID; }
 		int standMaxAge() const { return _standMaxAge; }		
 
+        // Hash of the yield tables and volume to biomass parameters the curve was built from.
+        std::uint64_t inputHash() const { return _inputHash; }
+        void setInputHash(std::uint64_t value) { _inputHash = value; }
+
 		void addYieldTable(TreeYieldTable& yieldTable);	
 		void processStandYieldTables();
 		bool hasYieldComponent(SpeciesType componentType);
@@ -54,6 +60,7 @@ namespace cbm {
 		int _standAgeForMaximumMerchVolume;
 		double _standMaximumMerchVolume;	
 		bool _okToSmooth;
+        std::uint64_t _inputHash;
 
 		std::shared_ptr<PERDFactor> _swPERDFactor;
 		std::shared_ptr<PERDFactor> _hwPERDFactor;
@@ -3,9 +3,11 @@
 
 #include "moja/modules/cbm/_modules.cbm_exports.h"
 #include "moja/flint/modulebase.h"
+#include "moja/hash.h"
+#include "moja/modules/cbm/sharedvaluestore.h"
 #include "moja/modules/cbm/standgrowthcurve.h"
 
-#include <Poco/LRUCache.h>
+#include <tuple>
 
 namespace moja {
 namespace modules {
@@ -17,18 +19,19 @@ namespace cbm {
 		StandGrowthCurveFactory();
 		virtual ~StandGrowthCurveFactory() = default;
 
-		Poco::SharedPtr<StandGrowthCurve> createStandGrowthCurve(Int64 standGrowthCurveID, Int64 spuID, flint::ILandUnitDataWrapper& landUnitData);		
-		Poco::SharedPtr<StandGrowthCurve> getStandGrowthCurve(Int64 growthCurveID);
+		std::shared_ptr<StandGrowthCurve> createStandGrowthCurve(Int64 standGrowthCurveID, Int64 spuID, flint::ILandUnitDataWrapper& landUnitData);		
+		std::shared_ptr<StandGrowthCurve> getStandGrowthCurve(Int64 growthCurveID);
 
 	private:
-		void addStandGrowthCurve(Int64 standGrowthCurveID, StandGrowthCurve& standGrowthCurve);
+		std::shared_ptr<StandGrowthCurve> buildStandGrowthCurve(Int64 standGrowthCurveID, Int64 spuID, flint::ILandUnitDataWrapper& landUnitData);
+
+		// Stand growth curves by stand growth curve ID and SPU, built once and shared by all threads:
+		// the PERD factors and root parameters depend on the SPU.
+		SharedValueStore<std::tuple<Int64, Int64>, StandGrowthCurve, moja::Hash> _curves;
 
 		// For each stand growth curve, the yield volume is not changed by SPU
-		// just create a thread safe lookup map by stand growth curve ID.
-		Poco::LRUCache<Int64, StandGrowthCurve>& getCache() {
-			thread_local Poco::LRUCache<Int64, StandGrowthCurve> cache;
-			return cache;
-		}
+		// just create a lookup by stand growth curve ID for the moss modules.
+		SharedValueStore<Int64, StandGrowthCurve> _curvesById;
 	};
 }}}
 #endif
@@ -2,6 +2,7 @@
 #define MOJA_MODULES_CBM_TIMESERIESIDXFROMFLINTDATATRANSFORM_H_
 
 #include "moja/modules/cbm/_modules.cbm_exports.h"
+#include "moja/modules/cbm/timeseries.h"
 
 #include <moja/flint/itransform.h>
 
@@ -44,7 +45,7 @@ private:
 	int _startYear;
 	int _dataPerYear;
 	int _nYears;
-    std::string _origin;
+	DateOrigin _origin;
 
 	mutable DynamicVar _cachedValue;
 	mutable size_t _lastCellHash;
@@ -5,39 +5,17 @@
 #include "moja/flint/ilandunitcontroller.h"
 #include "moja/flint/itransform.h"
 
-#include <Poco/LRUCache.h>
-#include <Poco/ThreadLocal.h>
+#include "moja/modules/cbm/classifiermatchindex.h"
 
 namespace moja {
 namespace modules {
 namespace cbm {
 
-struct TRCacheKey {
-public:
-    void add(const std::string& classifierValue) {
-        _classifierValues.push_back(classifierValue);
-    }
-
-    bool operator<(const TRCacheKey& other) const {
-        if (_classifierValues.size() < other._classifierValues.size()) {
-            return true;
-        }
-
-        for (int i = 0; i < _classifierValues.size(); i++) {
-            if (_classifierValues[i] < other._classifierValues[i]) {
-                return true;
-            }
-        }
-
-        return false;
-    }
-
-private:
-    std::vector<std::string> _classifierValues;
-};
-
 class TransitionRuleTransform : public flint::ITransform {
 public:
+	explicit TransitionRuleTransform(std::shared_ptr<ClassifierMatchIndex> transitionRuleIndex)
+		: _transitionRuleIndex(transitionRuleIndex) { }
+
 	void configure(DynamicObject config,
 		const flint::ILandUnitController& landUnitController,
 		datarepository::DataRepository& dataRepository) override;
@@ -51,62 +29,26 @@ private:
 	std::shared_ptr<datarepository::IProviderRelationalInterface> _provider;
 	mutable const flint::IVariable* _csetVar;
 	mutable DynamicVar _value;
-    mutable Poco::ThreadLocal<Poco::LRUCache<TRCacheKey, DynamicVar>> _cache;
+	std::shared_ptr<ClassifierMatchIndex> _transitionRuleIndex;
 
-    const std::string buildSql(const DynamicObject& classifierSet) const;
+	std::vector<ClassifierMatchRow> loadClassifierValues() const;
 
-    const std::string _baseSql = R"(
+	const std::string _classifierValuesSql = R"(
         SELECT
-            disturbance_type,
-            transition_id
-        FROM (
-            SELECT
-                ROW_NUMBER() OVER (PARTITION BY disturbance_type ORDER BY score DESC) AS tr_rank,
-                disturbance_type,
-                transition_id
-            FROM (
-                SELECT
-                    dt.name AS disturbance_type,
-                    tr.transition_id,
-                    SUM(CASE
-                            WHEN c.name IN (%1%) THEN
-                                CASE
-                                    WHEN cv.value LIKE '?' THEN 1
-                                    %2%
-                                    ELSE -1000
-                                END
-                            ELSE -1000
-                        END
-                    ) AS score
-                FROM transition_rule tr
-                INNER JOIN transition_rule_classifier_value trv
-                    ON trv.transition_rule_id = tr.id
-                INNER JOIN classifier_value cv
-                    ON trv.classifier_value_id = cv.id
-                INNER JOIN classifier c
-                    ON cv.classifier_id = c.id
-                INNER JOIN disturbance_type dt
-                    ON tr.disturbance_type_id = dt.id
-                GROUP BY
-                    tr.transition_id,
-                    tr.disturbance_type_id
-                HAVING SUM(
-                    CASE
-                        WHEN c.name IN (%1%) THEN
-                            CASE
-                                WHEN cv.value LIKE '?' THEN 1
-                                %2%
-                                ELSE -1000
-                            END
-                        ELSE -1000
-                    END
-                ) > 0
-            ) AS transition_ranking
-        ) AS best_matches
-        WHERE tr_rank = 1
+            tr.transition_id AS transition_id,
+            dt.name AS disturbance_type,
+            c.name AS classifier_name,
+            cv.value AS classifier_value
+        FROM transition_rule tr
+        INNER JOIN transition_rule_classifier_value trv
+            ON trv.transition_rule_id = tr.id
+        INNER JOIN classifier_value cv
+            ON trv.classifier_value_id = cv.id
+        INNER JOIN classifier c
+            ON cv.classifier_id = c.id
+        INNER JOIN disturbance_type dt
+            ON tr.disturbance_type_id = dt.id
     )";
-
-    const std::string _matchSql = "WHEN c.name LIKE '%1%' AND cv.value LIKE '%2%' THEN 4 ";
 };
 
 }}}
@@ -0,0 +1,162 @@
+#ifndef MOJA_MODULES_CBM_VARIABLESLOT_H_
+#define MOJA_MODULES_CBM_VARIABLESLOT_H_
+
+#include "moja/modules/cbm/_modules.cbm_exports.h"
+#include "moja/modules/cbm/timeseries.h"
+
+#include <moja/dynamic.h>
+#include <moja/flint/ivariable.h>
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+	class VariableBindings;
+
+	/**
+	 * A land unit variable resolved by name through VariableBindings. An optional variable that
+	 * does not exist leaves it unbound; reading it then is an error naming the variable, so
+	 * callers check isBound() first.
+	 */
+	class BoundVariable {
+	public:
+		bool isBound() const { return _variable != nullptr; }
+		flint::IVariable* variable() const { return _variable; }
+		const std::string& name() const { return _name; }
+
+	protected:
+		flint::IVariable& bound() const {
+			if (_variable == nullptr) {
+				throw std::runtime_error("land unit variable " + _name + " is not defined");
+			}
+
+			return *_variable;
+		}
+
+	private:
+		friend class VariableBindings;
+		flint::IVariable* _variable = nullptr;
+		std::string _name;
+	};
+
+	/**
+	 * Typed handle to a land unit variable declared with CBMModuleBase::bindVariable. The variable
+	 * is looked up by name once, when the local domain is initialized, and read through the handle
+	 * without hashing its name on every step.
+	 */
+	template<typename T>
+	class VariableHandle : public BoundVariable {
+	public:
+		const DynamicVar& raw() const { return bound().value(); }
+		T value() const { return bound().value().template convert<T>(); }
+
+		// The value of the variable, or fallback if it is empty.
+		T valueOr(const T& fallback) const {
+			const auto& value = bound().value();
+			return value.isEmpty() ? fallback : value.template convert<T>();
+		}
+
+		void set(const T& value) { bound().set_value(value); }
+	};
+
+	/**
+	 * Typed copy of a land unit variable with a fixed storage type (double, int or bool) for a
+	 * value a module reads on every step. The DynamicVar is converted once by load(), when the
+	 * value can have changed - usually in doTimingInit, when a land unit starts - and value() is
+	 * then a plain read with no type check or conversion. set() updates the slot and writes the
+	 * value through to the variable, so the DynamicVar stays current for other modules and output.
+	 */
+	template<typename T>
+	class VariableSlot : public BoundVariable {
+	public:
+		// Convert parameter value into the slot; an empty value gives parameter fallback.
+		void assign(const DynamicVar& value, const T& fallback = T()) {
+			_value = value.isEmpty() ? fallback : value.template convert<T>();
+		}
+
+		void load(const T& fallback = T()) { assign(bound().value(), fallback); }
+
+		const T& value() const { return _value; }
+
+		void set(const T& value) {
+			_value = value;
+			bound().set_value(value);
+		}
+
+	private:
+		T _value = T();
+	};
+
+	/**
+	 * Slot for a numeric variable that is either a constant or a TimeSeries, like the climate
+	 * variables. The TimeSeries is kept as one, sharing its prepared data with the variable's, so
+	 * value() is its value at the current step without going through the DynamicVar.
+	 */
+	class TimeSeriesSlot : public BoundVariable {
+	public:
+		// Take a TimeSeries or a number from parameter value; an empty value gives parameter fallback.
+		void assign(const DynamicVar& value, double fallback = 0.0) {
+			_isSeries = !value.isEmpty() && value.type() == typeid(TimeSeries);
+			if (_isSeries) {
+				_series = value.extract<TimeSeries>();
+			} else {
+				_constant = value.isEmpty() ? fallback : value.convert<double>();
+			}
+		}
+
+		void load(double fallback = 0.0) { assign(bound().value(), fallback); }
+
+		bool isSeries() const { return _isSeries; }
+		double value() const { return _isSeries ? _series.value() : _constant; }
+
+	private:
+		bool _isSeries = false;
+		TimeSeries _series;
+		double _constant = 0.0;
+	};
+
+	/**
+	 * The land unit variables a module reads, by name, and the handles, slots or variable pointers
+	 * they resolve to. A required variable that does not exist is an error when the bindings are
+	 * resolved; an optional one leaves its target unbound.
+	 */
+	class VariableBindings {
+	public:
+		void add(const std::string& name, BoundVariable& target, bool optional = false) {
+			target._name = name;
+			add(name, target._variable, optional);
+		}
+
+		void add(const std::string& name, flint::IVariable*& target, bool optional = false) {
+			_bindings.push_back(Binding{ name, &target, optional });
+		}
+
+		// Resolve every binding with parameter find, which gives nullptr for a variable that does not exist.
+		void resolve(const std::function<flint::IVariable*(const std::string&)>& find) const {
+			for (const auto& binding : _bindings) {
+				*binding.target = find(binding.name);
+				if (*binding.target == nullptr && !binding.optional) {
+					throw std::runtime_error("required land unit variable " + binding.name + " is not defined");
+				}
+			}
+		}
+
+	private:
+		struct Binding {
+			std::string name;
+			flint::IVariable** target;
+			bool optional;
+		};
+
+		std::vector<Binding> _bindings;
+	};
+
+}}} // namespace moja::modules::cbm
+
+#endif // MOJA_MODULES_CBM_VARIABLESLOT_H_
@@ -10,8 +10,14 @@
 #include "moja/modules/cbm/volumetobiomassconverter.h"
 #include "moja/modules/cbm/rootbiomasscarbonincrement.h"
 #include "moja/modules/cbm/foresttypeconfiguration.h"
+#include "moja/modules/cbm/sharedvaluestore.h"
+#include "moja/modules/cbm/biomasscarboncurvefile.h"
 
-#include <Poco/LRUCache.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 
 namespace moja {
 namespace modules {
@@ -19,9 +25,8 @@ namespace cbm {
 
     class CBM_API VolumeToBiomassCarbonGrowth {
     public:
-        VolumeToBiomassCarbonGrowth(bool smootherEnabled = true) {
-            getConverter().setSmoothing(smootherEnabled);
-        };
+        VolumeToBiomassCarbonGrowth(bool smootherEnabled = true)
+            : _converter(smootherEnabled), _builtCurves(0) {};
 
         virtual ~VolumeToBiomassCarbonGrowth() {};	
 
@@ -40,20 +45,36 @@ namespace cbm {
         // Check if there is a biomass carbon growth curve for a stand yield growth curve.
         bool isBiomassCarbonCurveAvailable(Int64 growthCurveID, Int64 spuID);		
 
-        void setSmoothing(bool enabled) { getConverter().setSmoothing(enabled); }
+        void setSmoothing(bool enabled) { _converter.setSmoothing(enabled); }
 
-        Poco::SharedPtr<StandBiomassCarbonCurve> getBiomassCarbonCurve(Int64 growthCurveID, Int64 spuID);
+        std::shared_ptr<StandBiomassCarbonCurve> getBiomassCarbonCurve(Int64 growthCurveID, Int64 spuID);
+
+        // Use a file of precompiled curves, and save the curves built by this run back to it.
+        // Curves are only taken from the file if they were built from the same yield tables and parameters,
+        // so the file saves the conversion and smoothing but not the yield table queries, and its curves
+        // are copied into memory rather than read from the mapping.
+        void openCurveFile(const std::string& path, const std::string& version);
+        void saveCurveFile();
 
     private:
-        VolumeToBiomassConverter& getConverter() {
-            thread_local VolumeToBiomassConverter converter;
-            return converter;
-        }
-
-       Poco::LRUCache<std::tuple<Int64, Int64>, StandBiomassCarbonCurve>& getCache() {
-           thread_local Poco::LRUCache<std::tuple<Int64, Int64>, StandBiomassCarbonCurve> cache;
-           return cache;
-        }
+        std::shared_ptr<StandBiomassCarbonCurve> buildBiomassCarbonCurve(StandGrowthCurve& standGrowthCurve);
+        std::shared_ptr<StandBiomassCarbonCurve> requireBiomassCarbonCurve(Int64 growthCurveID, Int64 spuID);
+
+        // Shared by all threads: the converter keeps no per-curve state.
+        VolumeToBiomassConverter _converter;
+
+        // Biomass carbon curves by stand growth curve ID and SPU, built once and shared by all threads.
+        SharedValueStore<std::tuple<Int64, Int64>, StandBiomassCarbonCurve, moja::Hash> _curves;
+        std::atomic<size_t> _builtCurves;
+
+        // Precompiled curves from an earlier run, read into _curves as they are first needed, and the
+        // input hash of each curve in _curves, written alongside it by saveCurveFile().
+        std::mutex _curveFileLock;
+        std::unordered_map<std::tuple<Int64, Int64>, std::uint64_t, moja::Hash> _curveHashes;
+        bool _curveFileOpened = false;
+        std::string _curveFilePath;
+        std::string _curveFileVersion;
+        BiomassCarbonCurveFile _curveFile;
 
     };
 
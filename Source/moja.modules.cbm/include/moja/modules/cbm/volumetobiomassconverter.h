@@ -10,6 +10,8 @@
 #include "moja/modules/cbm/standgrowthcurve.h"
 #include "moja/modules/cbm/smoother.h"
 
+#include <atomic>
+
 namespace moja {
 namespace modules {
 namespace cbm {			
@@ -27,17 +29,20 @@ namespace cbm {
         * Leading species for each component, PERD factor for each leading species.
         */
         std::shared_ptr<ComponentBiomassCarbonCurve> generateComponentBiomassCarbonCurve(
-            StandGrowthCurve& standGrowthCurve, SpeciesType speciesType);
+            StandGrowthCurve& standGrowthCurve, SpeciesType speciesType) const;
 
         void setSmoothing(bool enabled) { _smootherEnabled = enabled; }
 
         // Apply smoother on a carbon curve based on the stand growth yield.
         void doSmoothing(const StandGrowthCurve& standGrowthCurve,
                          ComponentBiomassCarbonCurve* carbonCurve,
-                         SpeciesType speciesType);
+                         SpeciesType speciesType) const;
+
+        // Smooth a batch of carbon curves in parallel; same results as doSmoothing on each.
+        void doSmoothing(const std::vector<SmoothingJob>& jobs, int threadCount = 0) const;
 
     private:
-        bool _smootherEnabled;
+        std::atomic<bool> _smootherEnabled;
         Smoother _smoother;
     };
 
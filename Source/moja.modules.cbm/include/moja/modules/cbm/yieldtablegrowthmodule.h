@@ -8,10 +8,13 @@
 #include "moja/modules/cbm/standgrowthcurve.h"
 #include "moja/modules/cbm/rootbiomassequation.h"
 #include "moja/modules/cbm/foresttypeconfiguration.h"
+#include "moja/modules/cbm/growthturnoverkernel.h"
 #include "moja/modules/cbm/standgrowthcurvefactory.h"
 #include "moja/modules/cbm/turnoverrates.h"
 #include "moja/modules/cbm/peatlands.h"
 
+#include <array>
+
 namespace moja {
 	namespace modules {
 		namespace cbm {
@@ -21,7 +24,7 @@ namespace moja {
 				YieldTableGrowthModule(std::shared_ptr<StandGrowthCurveFactory> gcFactory, std::shared_ptr<VolumeToBiomassCarbonGrowth> volumeToBioGrowth)
 					: _gcFactory(gcFactory), _volumeToBioGrowth(volumeToBioGrowth) {};
 
-				virtual ~YieldTableGrowthModule() {};
+				virtual ~YieldTableGrowthModule();
 
 				void configure(const DynamicObject& config) override;
 				void subscribe(NotificationCenter& notificationCenter) override;
@@ -65,6 +68,10 @@ namespace moja {
 				const flint::IPool* _woodyCoarseDead = nullptr;
 				const flint::IPool* _woodyRootsDead = nullptr;
 
+				// pools of the fused growth and turnover operation, by GrowthPool
+				std::array<const flint::IPool*, GrowthTurnoverKernel::PoolCount> _growthTurnoverPools{};
+				GrowthTurnoverKernel _growthTurnover;
+
 				flint::IVariable* _age = nullptr;
 				flint::IVariable* _gcId = nullptr;
 				flint::IVariable* _spuId = nullptr;
@@ -80,6 +87,8 @@ namespace moja {
 				bool _smootherEnabled = true;
 				bool _debuggingEnabled = false;
 				std::string _debuggingOutputPath = ".";
+				std::string _growthCurveCachePath;		// precompiled biomass carbon curves, reused between runs
+				std::string _growthCurveCacheVersion;	// user-supplied tag for the yield tables, i.e. an input database checksum
 
 				Int64 _standGrowthCurveID{ -1 };
 				Int64 _standSPUID{ -1 };
@@ -87,18 +96,24 @@ namespace moja {
 				std::shared_ptr<VolumeToBiomassCarbonGrowth> _volumeToBioGrowth = nullptr;
 				std::shared_ptr<StandGrowthCurveFactory> _gcFactory = nullptr;
 
+				// biomass carbon curve of the current stand, and the pools its increments depend on
+				std::shared_ptr<StandBiomassCarbonCurve> _standBiomassCarbonCurve = nullptr;
+				StandBiomassPools _standBiomassPools;
+				StandBiomassCarbonIncrements _increments;
+
 				void getIncrements();
 				void getTurnoverRates();
 				void initPeatland();
-				void doHalfGrowth() const;
+				void doGrowthAndTurnover();
 				void doTurnover() const;
 				void updateBiomassPools();
 				void doMidSeasonGrowth() const;
+				void getStandPools(double* pools) const;
+				void submitGrowthTransfers(const std::vector<GrowthTransfer>& transfers) const;
 				bool shouldRun() const;
 
 				void switchTurnover() const;
 				void doPeatlandTurnover() const;
-				void switchHalfGrowth() const;
 				void doPeatlandHalfGrowth() const;
 
 				bool _skipForPeatland{ false };
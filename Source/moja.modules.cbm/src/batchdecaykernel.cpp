@@ -0,0 +1,275 @@
+/**
+ * @file
+ * Batched dead organic matter decay: the CBMDecayModule transfers applied to many land units
+ * at once, for batch-oriented sequencers.
+ * ******************/
+
+#include "moja/modules/cbm/batchdecaykernel.h"
+
+#include <set>
+#include <stdexcept>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+	namespace {
+		const int DomPoolCount = 9;
+		const int SlowPoolCount = 2;
+
+		const char* const DomPoolNames[DomPoolCount] = {
+			"AboveGroundVeryFastSoil", "BelowGroundVeryFastSoil", "AboveGroundFastSoil",
+			"BelowGroundFastSoil", "MediumSoil", "SoftwoodStemSnag", "SoftwoodBranchSnag",
+			"HardwoodStemSnag", "HardwoodBranchSnag"
+		};
+
+		// Slow pool receiving the non-atmospheric share of each dead organic matter pool's decay.
+		const DecayPool DomPoolSinks[DomPoolCount] = {
+			DecayPool::AboveGroundSlowSoil, DecayPool::BelowGroundSlowSoil, DecayPool::AboveGroundSlowSoil,
+			DecayPool::BelowGroundSlowSoil, DecayPool::AboveGroundSlowSoil, DecayPool::AboveGroundSlowSoil,
+			DecayPool::AboveGroundSlowSoil, DecayPool::AboveGroundSlowSoil, DecayPool::AboveGroundSlowSoil
+		};
+
+		const char* const SlowPoolNames[SlowPoolCount] = { "AboveGroundSlowSoil", "BelowGroundSlowSoil" };
+		const DecayPool SlowPools[SlowPoolCount] = { DecayPool::AboveGroundSlowSoil, DecayPool::BelowGroundSlowSoil };
+
+		const PoolDecayParameters& findParameters(
+			const std::map<std::string, PoolDecayParameters>& decayParameters, const std::string& pool) {
+
+			auto it = decayParameters.find(pool);
+			if (it == decayParameters.end()) {
+				throw std::invalid_argument("No decay parameters for pool " + pool);
+			}
+
+			return it->second;
+		}
+	}
+
+	/**
+	 * Constructor
+	 *
+	 * @param size size_t, number of land units in the batch
+	 * ************************/
+	DecayBatch::DecayBatch(size_t size) : _size(0), _pools(PoolCount) {
+		resize(size);
+	}
+
+	/**
+	 * Resize every pool array to parameter size; new land units start with empty pools.
+	 *
+	 * @param size size_t
+	 * @return void
+	 * ************************/
+	void DecayBatch::resize(size_t size) {
+		_size = size;
+		for (auto& pool : _pools) {
+			pool.resize(size, 0.0);
+		}
+
+		for (auto& pool : _removals) {
+			pool.resize(size, 0.0);
+		}
+
+		for (auto& column : _proportions) {
+			column.resize(size, 0.0);
+		}
+	}
+
+	/**
+	 * Constructor
+	 *
+	 * Keep the decay parameters for the nine dead organic matter pools and the two slow pools, in transfer order. \n
+	 * As in CBMDecayModule, extra decay removals only apply to the slow pools; the removal destinations are \n
+	 * kept in name order, which is the order CBMDecayModule adds their transfers.
+	 *
+	 * @param decayParameters map<string, PoolDecayParameters>&
+	 * @param slowMixingRate double
+	 * @param decayRemovals map<string, map<string, double>>&, proportion of each pool's decay diverted to other pools
+	 * @exception std::invalid_argument: Handles error when a pool has no decay parameters
+	 * ************************/
+	BatchDecayKernel::BatchDecayKernel(
+		const std::map<std::string, PoolDecayParameters>& decayParameters,
+		double slowMixingRate,
+		const std::map<std::string, std::map<std::string, double>>& decayRemovals)
+		: _slowMixingRate(slowMixingRate) {
+
+		for (auto pool : DomPoolNames) {
+			_domParameters.push_back(findParameters(decayParameters, pool));
+		}
+
+		std::set<std::string> removalPools;
+		for (auto pool : SlowPoolNames) {
+			_slowParameters.push_back(findParameters(decayParameters, pool));
+			auto removals = decayRemovals.find(pool);
+			if (removals != decayRemovals.end()) {
+				for (const auto& removal : removals->second) {
+					removalPools.insert(removal.first);
+				}
+			}
+		}
+
+		_removalPools.assign(removalPools.begin(), removalPools.end());
+		for (auto pool : SlowPoolNames) {
+			std::vector<double> proportions(_removalPools.size(), 0.0);
+			auto removals = decayRemovals.find(pool);
+			for (size_t r = 0; r < _removalPools.size(); r++) {
+				if (removals == decayRemovals.end()) {
+					continue;
+				}
+
+				auto removal = removals->second.find(_removalPools[r]);
+				if (removal != removals->second.end()) {
+					proportions[r] = removal->second;
+				}
+			}
+
+			_removalProportions.push_back(proportions);
+		}
+	}
+
+	/**
+	 * Number of transfer proportions per land unit: to the slow pool and to the atmosphere for each \n
+	 * dead organic matter pool, then to each removal pool and to the atmosphere for each slow pool.
+	 *
+	 * @return size_t
+	 * ************************/
+	size_t BatchDecayKernel::columns() const {
+		return DomPoolCount * 2 + SlowPoolCount * (_removalPools.size() + 1);
+	}
+
+	/**
+	 * Allocate the removal pools and transfer proportions used by this kernel in parameter batch.
+	 *
+	 * @param batch DecayBatch&
+	 * @return void
+	 * ************************/
+	void BatchDecayKernel::prepare(DecayBatch& batch) const {
+		batch._removals.resize(_removalPools.size());
+		batch._proportions.resize(columns());
+		batch.resize(batch.size());
+	}
+
+	/**
+	 * Return the transfer proportions for parameter meanAnnualTemperature, computing them the first \n
+	 * time each temperature is seen. The proportions are computed exactly as CBMDecayModule computes \n
+	 * them, so the kernel's fluxes match the module's.
+	 *
+	 * @param meanAnnualTemperature double
+	 * @return vector<double>&
+	 * ************************/
+	const std::vector<double>& BatchDecayKernel::proportions(double meanAnnualTemperature) {
+		auto it = _proportionsByTemperature.find(meanAnnualTemperature);
+		if (it != _proportionsByTemperature.end()) {
+			return it->second;
+		}
+
+		std::vector<double> proportions;
+		proportions.reserve(columns());
+		for (const auto& parameters : _domParameters) {
+			double decayRate = parameters.getDecayRate(meanAnnualTemperature);
+			proportions.push_back(decayRate * (1 - parameters.pAtm));
+			proportions.push_back(decayRate * parameters.pAtm);
+		}
+
+		for (int s = 0; s < SlowPoolCount; s++) {
+			double decayRate = _slowParameters[s].getDecayRate(meanAnnualTemperature);
+			double propRemovals = 0.0;
+			for (auto removal : _removalProportions[s]) {
+				proportions.push_back(decayRate * removal);
+				propRemovals += removal;
+			}
+
+			proportions.push_back(decayRate * (_slowParameters[s].pAtm - propRemovals));
+		}
+
+		return _proportionsByTemperature.emplace(meanAnnualTemperature, std::move(proportions)).first->second;
+	}
+
+	/**
+	 * Set the transfer proportions of each land unit in parameter batch from its mean annual temperature \n
+	 * in parameter meanAnnualTemperatures. Only needs to be called again when temperatures change.
+	 *
+	 * @param batch DecayBatch&
+	 * @param meanAnnualTemperatures double*, one per land unit in the batch
+	 * @return void
+	 * ************************/
+	void BatchDecayKernel::setTemperatures(DecayBatch& batch, const double* meanAnnualTemperatures) {
+		prepare(batch);
+		for (size_t i = 0; i < batch.size(); i++) {
+			const auto& landUnitProportions = proportions(meanAnnualTemperatures[i]);
+			for (size_t c = 0; c < landUnitProportions.size(); c++) {
+				batch._proportions[c][i] = landUnitProportions[c];
+			}
+		}
+	}
+
+	/**
+	 * Apply one annual step of decay to every land unit in parameter batch. Each transfer is a separate \n
+	 * loop over the land units with no branches, and within a land unit the fluxes are computed and \n
+	 * applied in the same order as CBMDecayModule's proportional operations.
+	 *
+	 * @param batch DecayBatch&
+	 * @return void
+	 * ************************/
+	void BatchDecayKernel::step(DecayBatch& batch) const {
+		const size_t n = batch.size();
+		double* co2 = batch.pool(DecayPool::CO2);
+
+		// Dead organic matter decay: the sources are never sinks, so each pool's fluxes only
+		// depend on its own value at the start of the step.
+		for (int k = 0; k < DomPoolCount; k++) {
+			double* source = batch.pool(DecayPool(k));
+			double* sink = batch.pool(DomPoolSinks[k]);
+			const double* toSlow = batch._proportions[k * 2].data();
+			const double* toAtmosphere = batch._proportions[k * 2 + 1].data();
+			for (size_t i = 0; i < n; i++) {
+				double slowFlux = source[i] * toSlow[i];
+				double atmosphereFlux = source[i] * toAtmosphere[i];
+				source[i] -= slowFlux;
+				sink[i] += slowFlux;
+				source[i] -= atmosphereFlux;
+				co2[i] += atmosphereFlux;
+			}
+		}
+
+		// Slow pool decay, with any extra removals taken out of the share that would go to the atmosphere.
+		// Like a proportional operation, every flux is a proportion of the pool's value before the decay.
+		const size_t removals = _removalPools.size();
+		std::vector<double> start;
+		for (int s = 0; s < SlowPoolCount; s++) {
+			double* source = batch.pool(SlowPools[s]);
+			const size_t base = DomPoolCount * 2 + s * (removals + 1);
+			if (removals > 0) {
+				start.assign(source, source + n);
+			}
+
+			for (size_t r = 0; r < removals; r++) {
+				double* sink = batch.removalPool(r);
+				const double* proportion = batch._proportions[base + r].data();
+				for (size_t i = 0; i < n; i++) {
+					double flux = start[i] * proportion[i];
+					source[i] -= flux;
+					sink[i] += flux;
+				}
+			}
+
+			const double* toAtmosphere = batch._proportions[base + removals].data();
+			const double* initial = removals > 0 ? start.data() : source;
+			for (size_t i = 0; i < n; i++) {
+				double flux = initial[i] * toAtmosphere[i];
+				source[i] -= flux;
+				co2[i] += flux;
+			}
+		}
+
+		// Slow pool mixing.
+		double* aboveGroundSlow = batch.pool(DecayPool::AboveGroundSlowSoil);
+		double* belowGroundSlow = batch.pool(DecayPool::BelowGroundSlowSoil);
+		for (size_t i = 0; i < n; i++) {
+			double flux = aboveGroundSlow[i] * _slowMixingRate;
+			aboveGroundSlow[i] -= flux;
+			belowGroundSlow[i] += flux;
+		}
+	}
+
+}}} // namespace moja::modules::cbm
@@ -0,0 +1,334 @@
+/**
+ * @file
+ * Binary file of precompiled stand biomass carbon curves, memory-mapped by the runs that use it.
+ *
+ * Layout, in native byte order with every field 8-byte aligned:
+ *   header:    "MOJACBMC", format version, version tag length, version tag (zero padded), curve count
+ *   index:     growth curve ID, SPU ID, input hash and file offset of each curve
+ *   curves:    component count, then for each component its species type, root biomass equation
+ *              coefficient count, max age and merch, foliage and other carbon curve lengths,
+ *              followed by the coefficients and the three curves
+ */
+
+#include "moja/modules/cbm/biomasscarboncurvefile.h"
+
+#include <moja/logging.h>
+
+#include <Poco/File.h>
+#include <Poco/SharedMemory.h>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    namespace {
+        const char Magic[8] = { 'M', 'O', 'J', 'A', 'C', 'B', 'M', 'C' };
+        const std::uint64_t FormatVersion = 2;
+        const std::uint64_t SoftwoodComponent = 1;
+        const std::uint64_t HardwoodComponent = 2;
+
+        std::uint64_t padded(std::uint64_t size) {
+            return (size + 7) / 8 * 8;
+        }
+
+        template <typename T>
+        void writeValue(std::ofstream& file, T value) {
+            file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void writeArray(std::ofstream& file, const std::vector<double>& values) {
+            file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+        }
+    }
+
+    BiomassCarbonCurveFile::BiomassCarbonCurveFile() : _data(nullptr), _size(0) {}
+
+    BiomassCarbonCurveFile::~BiomassCarbonCurveFile() = default;
+
+    /**
+     * Map parameter path and index the curves in it. Returns false, leaving the file closed, if \n
+     * there is no file at parameter path or it was written with a version other than parameter version.
+     *
+     * @param path string&
+     * @param version string&
+     * @exception std::runtime_error: Handles error when the file is malformed
+     * @return bool
+     * ************************/
+    bool BiomassCarbonCurveFile::open(const std::string& path, const std::string& version) {
+        close();
+        Poco::File file(path);
+        if (!file.exists()) {
+            return false;
+        }
+
+        if (file.getSize() < sizeof(Magic) + 3 * sizeof(std::uint64_t)) {
+            throw std::runtime_error("Biomass carbon curve file " + path + " is truncated");
+        }
+
+        _path = path;
+        _mapping.reset(new Poco::SharedMemory(file, Poco::SharedMemory::AM_READ));
+        _data = _mapping->begin();
+        _size = _mapping->end() - _mapping->begin();
+
+        try {
+            if (std::memcmp(_data, Magic, sizeof(Magic)) != 0) {
+                throw std::runtime_error("Biomass carbon curve file " + path + " has an unknown format");
+            }
+
+            std::uint64_t offset = sizeof(Magic);
+            if (readValue<std::uint64_t>(offset) != FormatVersion) {
+                throw std::runtime_error("Biomass carbon curve file " + path + " has an unsupported format version");
+            }
+
+            auto versionLength = readValue<std::uint64_t>(offset);
+            if (versionLength > _size - offset) {
+                throw std::runtime_error("Malformed version in biomass carbon curve file " + path);
+            }
+
+            std::string fileVersion(_data + offset, versionLength);
+            offset += padded(versionLength);
+            if (fileVersion != version) {
+                MOJA_LOG_INFO << "Biomass carbon curve file " << path << " was built with different settings, ignoring it.";
+                close();
+                return false;
+            }
+
+            auto curveCount = readValue<std::uint64_t>(offset);
+            _index.reserve(curveCount);
+            for (std::uint64_t i = 0; i < curveCount; i++) {
+                auto gcId = readValue<std::int64_t>(offset);
+                auto spuId = readValue<std::int64_t>(offset);
+                auto inputHash = readValue<std::uint64_t>(offset);
+                _index[Key{ gcId, spuId }] = IndexEntry{ inputHash, readValue<std::uint64_t>(offset) };
+            }
+        } catch (...) {
+            close();
+            throw;
+        }
+
+        MOJA_LOG_INFO << "Mapped " << _index.size() << " biomass carbon curves from " << path;
+        return true;
+    }
+
+    /**
+     * Unmap the file. Curves already read from it stay valid.
+     *
+     * @return void
+     * ************************/
+    void BiomassCarbonCurveFile::close() {
+        _index.clear();
+        _data = nullptr;
+        _size = 0;
+        _mapping.reset();
+        _path.clear();
+    }
+
+    /**
+     * Return true if the file has a curve for parameter key built from inputs with parameter inputHash.
+     *
+     * @param key Key&
+     * @param inputHash uint64_t
+     * @return bool
+     * ************************/
+    bool BiomassCarbonCurveFile::contains(const Key& key, std::uint64_t inputHash) const {
+        auto entry = _index.find(key);
+        return entry != _index.end() && entry->second.inputHash == inputHash;
+    }
+
+    /**
+     * Return the hash of the inputs the curve for parameter key was built from.
+     *
+     * @param key Key&
+     * @exception std::out_of_range: Handles error when the file has no curve for parameter key
+     * @return uint64_t
+     * ************************/
+    std::uint64_t BiomassCarbonCurveFile::inputHash(const Key& key) const {
+        return _index.at(key).inputHash;
+    }
+
+    /**
+     * Return the keys of all curves in the file.
+     *
+     * @return vector<Key>
+     * ************************/
+    std::vector<BiomassCarbonCurveFile::Key> BiomassCarbonCurveFile::keys() const {
+        std::vector<Key> keys;
+        keys.reserve(_index.size());
+        for (const auto& entry : _index) {
+            keys.push_back(entry.first);
+        }
+
+        return keys;
+    }
+
+    /**
+     * Return a new StandBiomassCarbonCurve with the components stored for parameter key, \n
+     * or nullptr if the file has no curve for it. Each carbon curve is copied out of the mapping \n
+     * in one block, so the result does not depend on the file staying open.
+     *
+     * @param key Key&
+     * @exception std::runtime_error: Handles error when the curve is malformed
+     * @return shared_ptr<StandBiomassCarbonCurve>
+     * ************************/
+    std::shared_ptr<StandBiomassCarbonCurve> BiomassCarbonCurveFile::read(const Key& key) const {
+        auto entry = _index.find(key);
+        if (entry == _index.end()) {
+            return nullptr;
+        }
+
+        auto offset = entry->second.offset;
+        auto standCarbonCurve = std::make_shared<StandBiomassCarbonCurve>();
+        auto componentCount = readValue<std::uint64_t>(offset);
+        for (std::uint64_t i = 0; i < componentCount; i++) {
+            auto speciesType = readValue<std::uint64_t>(offset);
+            auto coefficientCount = readValue<std::uint64_t>(offset);
+            auto maxAge = readValue<std::int64_t>(offset);
+            auto merchCount = readValue<std::uint64_t>(offset);
+            auto foliageCount = readValue<std::uint64_t>(offset);
+            auto otherCount = readValue<std::uint64_t>(offset);
+
+            const double* c = readArray(offset, coefficientCount);
+            const double* merch = readArray(offset, merchCount);
+            const double* foliage = readArray(offset, foliageCount);
+            const double* other = readArray(offset, otherCount);
+
+            std::shared_ptr<RootBiomassEquation> rootBiomassEquation;
+            if (speciesType == SoftwoodComponent && coefficientCount == 4) {
+                rootBiomassEquation = std::make_shared<SoftwoodRootBiomassEquation>(c[0], c[1], c[2], c[3]);
+            } else if (speciesType == HardwoodComponent && coefficientCount == 5) {
+                rootBiomassEquation = std::make_shared<HardwoodRootBiomassEquation>(c[0], c[1], c[2], c[3], c[4]);
+            } else {
+                throw std::runtime_error("Malformed curve component in biomass carbon curve file " + _path);
+            }
+
+            auto carbonCurve = std::make_shared<ComponentBiomassCarbonCurve>(static_cast<int>(maxAge),
+                std::vector<double>(merch, merch + merchCount),
+                std::vector<double>(foliage, foliage + foliageCount),
+                std::vector<double>(other, other + otherCount));
+
+            standCarbonCurve->addComponent(StandComponent(
+                speciesType == SoftwoodComponent ? "Softwood" : "Hardwood", rootBiomassEquation, carbonCurve));
+        }
+
+        return standCarbonCurve;
+    }
+
+    /**
+     * Write parameter curves to parameter path, tagged with parameter version and each with its \n
+     * input hash. The file is written to a temporary path first so that a failed run never leaves \n
+     * a truncated file behind.
+     *
+     * @param path string&
+     * @param version string&
+     * @param curves CurveList&
+     * @exception std::runtime_error: Handles error when the file can't be written
+     * @return void
+     * ************************/
+    void BiomassCarbonCurveFile::write(const std::string& path, const std::string& version, const CurveList& curves) {
+        const std::uint64_t indexEntrySize = 4 * sizeof(std::uint64_t);
+        std::uint64_t offset = sizeof(Magic) + 2 * sizeof(std::uint64_t) + padded(version.size())
+                             + sizeof(std::uint64_t) + curves.size() * indexEntrySize;
+
+        // Curve offsets follow from the sizes of the curves before them.
+        std::vector<std::uint64_t> offsets;
+        offsets.reserve(curves.size());
+        for (const auto& curve : curves) {
+            offsets.push_back(offset);
+            offset += sizeof(std::uint64_t);
+            for (const auto& component : curve.curve->components()) {
+                offset += 6 * sizeof(std::uint64_t) + sizeof(double) * (
+                    component.rootBiomassEquation()->coefficients().size()
+                    + component.getMerchCarbonCurve().size()
+                    + component.getFoliageCarbonCurve().size()
+                    + component.getOtherCarbonCurve().size());
+            }
+        }
+
+        auto tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file.write(Magic, sizeof(Magic));
+            writeValue<std::uint64_t>(file, FormatVersion);
+            writeValue<std::uint64_t>(file, version.size());
+            file.write(version.data(), version.size());
+            for (auto i = version.size(); i < padded(version.size()); i++) {
+                file.put('\0');
+            }
+
+            writeValue<std::uint64_t>(file, curves.size());
+            for (size_t i = 0; i < curves.size(); i++) {
+                writeValue<std::int64_t>(file, std::get<0>(curves[i].key));
+                writeValue<std::int64_t>(file, std::get<1>(curves[i].key));
+                writeValue<std::uint64_t>(file, curves[i].inputHash);
+                writeValue<std::uint64_t>(file, offsets[i]);
+            }
+
+            for (const auto& curve : curves) {
+                const auto& components = curve.curve->components();
+                writeValue<std::uint64_t>(file, components.size());
+                for (const auto& component : components) {
+                    auto coefficients = component.rootBiomassEquation()->coefficients();
+                    writeValue<std::uint64_t>(file, component.forestType() == "Softwood" ? SoftwoodComponent : HardwoodComponent);
+                    writeValue<std::uint64_t>(file, coefficients.size());
+                    writeValue<std::int64_t>(file, component.growthCurve()->maxAge());
+                    writeValue<std::uint64_t>(file, component.getMerchCarbonCurve().size());
+                    writeValue<std::uint64_t>(file, component.getFoliageCarbonCurve().size());
+                    writeValue<std::uint64_t>(file, component.getOtherCarbonCurve().size());
+                    writeArray(file, coefficients);
+                    writeArray(file, component.getMerchCarbonCurve());
+                    writeArray(file, component.getFoliageCarbonCurve());
+                    writeArray(file, component.getOtherCarbonCurve());
+                }
+            }
+
+            if (!file) {
+                throw std::runtime_error("Error writing biomass carbon curve file " + tempPath);
+            }
+        }
+
+        Poco::File(tempPath).renameTo(path);
+    }
+
+    /**
+     * Read a value of type T at parameter offset in the mapping and advance parameter offset past it.
+     *
+     * @param offset uint64_t&
+     * @exception std::runtime_error: Handles error when the value runs past the end of the file
+     * @return T
+     * ************************/
+    template <typename T>
+    T BiomassCarbonCurveFile::readValue(std::uint64_t& offset) const {
+        if (offset > _size || _size - offset < sizeof(T)) {
+            throw std::runtime_error("Biomass carbon curve file " + _path + " is truncated");
+        }
+
+        T value;
+        std::memcpy(&value, _data + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    /**
+     * Return a pointer to parameter count doubles at parameter offset in the mapping, without \n
+     * copying them, and advance parameter offset past them. The pointer is only valid while the file is open.
+     *
+     * @param offset uint64_t&
+     * @param count uint64_t
+     * @exception std::runtime_error: Handles error when the array runs past the end of the file
+     * @return const double*
+     * ************************/
+    const double* BiomassCarbonCurveFile::readArray(std::uint64_t& offset, std::uint64_t count) const {
+        if (offset > _size || (_size - offset) / sizeof(double) < count) {
+            throw std::runtime_error("Biomass carbon curve file " + _path + " is truncated");
+        }
+
+        auto values = reinterpret_cast<const double*>(_data + offset);
+        offset += count * sizeof(double);
+        return values;
+    }
+
+}}} // namespace moja::modules::cbm
@@ -75,7 +75,10 @@ namespace cbm {
      * Configuration function
      * 
      * Assign CBMFlatFile._outputPath value of "outptut_path" in parameter config, \n 
-     * CBMFlatFile._separateYears value of "separate_years", if it exists in parameter config
+     * CBMFlatFile._separateYears value of "separate_years", if it exists in parameter config \n
+     * If parameter config contains "flush_record_count" or "flush_memory_mb", enable streaming: flux, pool and \n
+     * age rows are then appended to the output files in batches during the simulation, so the same row key \n
+     * can appear more than once in a file
      * 
      * @param config DynamicObject&
      * @return void
@@ -85,6 +88,8 @@ namespace cbm {
         if (config.contains("separate_years")) {
             _separateYears = config["separate_years"].convert<bool>();
         }
+
+        _flushCoordinator->configure(config);
     }
 
      /**
@@ -101,10 +106,9 @@ namespace cbm {
 	}
 
      /**
-     * If CBMAggregatorCsvWriter._isPrimaryAggregator is true, then create output directories
+     * If CBMAggregatorCsvWriter._isPrimaryAggregator is true, then create output directories, and if streaming \n
+     * is enabled, register CBMAggregatorCsvWriter.flush() with CBMAggregatorCsvWriter._flushCoordinator
      * 
-     * @param path string&
-     * @param header string&
      * @return void
      * @exception FileExistsException&: if file already exists
      * ************************/
@@ -117,6 +121,16 @@ namespace cbm {
         try {
             outputDir.createDirectories();
         } catch (Poco::FileExistsException&) { }
+
+        if (_flushCoordinator->isEnabled()) {
+            _flushCoordinator->addFlushHandler(
+                [this]() { flush(); },
+                [this]() {
+                    _fluxDimension->clear();
+                    _poolDimension->clear();
+                    _ageDimension->clear();
+                });
+        }
     }
 
      /**
@@ -131,9 +145,25 @@ namespace cbm {
             : 0;
     }
 
+     /**
+     * Append the pending batch of flux, pool and age records to their output files. Called by \n
+     * CBMAggregatorCsvWriter._flushCoordinator while no aggregator is accumulating.
+     * 
+     * @return void
+     * ************************/
+    void CBMAggregatorCsvWriter::flush() {
+        if (_classifierNames->empty()) {
+            return;
+        }
+
+        write((boost::format("%1%/flux") % _outputPath).str(), (boost::format("flux_%1%") % _jobId).str(), _classifierNames, _fluxDimension);
+        write((boost::format("%1%/pool") % _outputPath).str(), (boost::format("pool_%1%") % _jobId).str(), _classifierNames, _poolDimension);
+        write((boost::format("%1%/age")  % _outputPath).str(), (boost::format("age_%1%")  % _jobId).str(), _classifierNames, _ageDimension);
+    }
+
      /**
      * If CBMAggregatorCsvWriter._isPrimaryAggregator is true and if, CBMAggregatorCsvWriter._classifierNames is not empty, 
-     * load the flux, pool, error, age and disturbance data
+     * write the remaining flux, pool, error, age and disturbance data and save the output files
      * 
      * @return void
      * ************************/
@@ -147,84 +177,96 @@ namespace cbm {
 			return;
 		}
 
-        load((boost::format("%1%/flux")        % _outputPath).str(), (boost::format("flux_%1%")        % _jobId).str(), _classifierNames, _fluxDimension);
-        load((boost::format("%1%/pool")        % _outputPath).str(), (boost::format("pool_%1%")        % _jobId).str(), _classifierNames, _poolDimension);
-        load((boost::format("%1%/error")       % _outputPath).str(), (boost::format("error_%1%")       % _jobId).str(), _classifierNames, _errorDimension);
-        load((boost::format("%1%/age")         % _outputPath).str(), (boost::format("age_%1%")         % _jobId).str(), _classifierNames, _ageDimension);
-        load((boost::format("%1%/disturbance") % _outputPath).str(), (boost::format("disturbance_%1%") % _jobId).str(), _classifierNames, _disturbanceDimension);
+        _flushCoordinator->withFlushLock([this]() {
+            write((boost::format("%1%/flux")        % _outputPath).str(), (boost::format("flux_%1%")        % _jobId).str(), _classifierNames, _fluxDimension);
+            write((boost::format("%1%/pool")        % _outputPath).str(), (boost::format("pool_%1%")        % _jobId).str(), _classifierNames, _poolDimension);
+            write((boost::format("%1%/error")       % _outputPath).str(), (boost::format("error_%1%")       % _jobId).str(), _classifierNames, _errorDimension);
+            write((boost::format("%1%/age")         % _outputPath).str(), (boost::format("age_%1%")         % _jobId).str(), _classifierNames, _ageDimension);
+            write((boost::format("%1%/disturbance") % _outputPath).str(), (boost::format("disturbance_%1%") % _jobId).str(), _classifierNames, _disturbanceDimension);
+
+            for (auto& flatFile : _flatFiles) {
+                flatFile.second->save();
+            }
+
+            _flatFiles.clear();
+        });
 
         MOJA_LOG_INFO << "Finished loading results." << std::endl;
     }
 
+     /**
+     * Return the output file for parameter outputFilename, opening it with parameter header the first time \n
+     * it is requested. If CBMAggregatorCsvWriter._separateYears is true, each year goes into its own \n
+     * subdirectory and file. Files stay open across streaming flushes until they are saved at shutdown.
+     * 
+     * @param outputPath string&
+     * @param outputFilename string&
+     * @param year int
+     * @param header string&
+     * @return shared_ptr<CBMFlatFile>
+     * @exception FileExistsException&: if the directory already exists
+     * ************************/
+    std::shared_ptr<CBMFlatFile> CBMAggregatorCsvWriter::getFlatFile(
+        const std::string& outputPath,
+        const std::string& outputFilename,
+        int year,
+        const std::string& header) {
+
+        auto directory = _separateYears ? (boost::format("%1%/%2%") % outputPath % year).str() : outputPath;
+        auto csvOutputPath = _separateYears
+            ? (boost::format("%1%/%2%_%3%.csv") % directory % outputFilename % year).str()
+            : (boost::format("%1%/%2%.csv") % directory % outputFilename).str();
+
+        auto it = _flatFiles.find(csvOutputPath);
+        if (it != _flatFiles.end()) {
+            return it->second;
+        }
+
+        Poco::File outputDir(directory);
+        try {
+            outputDir.createDirectories();
+        } catch (Poco::FileExistsException&) {}
+
+        auto flatFile = std::make_shared<CBMFlatFile>(csvOutputPath, header);
+        _flatFiles[csvOutputPath] = flatFile;
+
+        return flatFile;
+    }
+
      /**
      * Inserting Records
      * 
-     * Assign variable records as dataDimension->records(). If records is empty, return \n 
-     * If CBMAggregatorCsvWriter._separateYears is false, create output directories and write each record to the output stream \n
-     * Else write the records to the output stream grouped based on the year
+     * Write each record in dataDimension->records() to its output file, grouped by year if \n
+     * CBMAggregatorCsvWriter._separateYears is true
      * 
      * @param outputPath string&
      * @param outputFilename string&
      * @param classifierNames shared_ptr<vector<string>>
      * @tparam dataDimension shared_ptr<TAccumulator>
      * @return void
-     * @exception FileExistsException&: if the file already exists
      * ************************/
 
     template<typename TAccumulator>
-    void CBMAggregatorCsvWriter::load(
+    void CBMAggregatorCsvWriter::write(
         const std::string& outputPath,
         const std::string& outputFilename,
         std::shared_ptr<std::vector<std::string>> classifierNames,
         std::shared_ptr<TAccumulator> dataDimension) {
 
-
         MOJA_LOG_INFO << (boost::format("Loading %1%") % outputPath).str();
 
-        auto records = dataDimension->records();
-        if (records.empty()) {
-            return;
-        }
-        if (!_separateYears) {
-            Poco::File outputDir(outputPath);
-            try {
-                outputDir.createDirectories();
-            } catch (Poco::FileExistsException&) {}
-
-            auto csvOutputPath = (boost::format("%1%/%2%.csv") % outputPath % outputFilename).str();
-            std::shared_ptr<CBMFlatFile> outputFile;
-            for (auto& record : records) {
-                if (outputFile == nullptr) {
-                    outputFile = std::make_shared<CBMFlatFile>(csvOutputPath, record.header(*classifierNames));
-                }
-
-                outputFile->write(record.asPersistable());
+        const auto& records = dataDimension->records();
+        std::unordered_map<int, std::shared_ptr<CBMFlatFile>> flatFiles;
+        for (auto& record : records) {
+            auto year = _separateYears ? record.getYear() : 0;
+            auto it = flatFiles.find(year);
+            if (it == flatFiles.end()) {
+                it = flatFiles.emplace(year, getFlatFile(
+                    outputPath, outputFilename, year, record.header(*classifierNames))).first;
             }
 
-           outputFile->save();
-        } else {
-            std::unordered_map<int, std::shared_ptr<CBMFlatFile>> flatFiles;
-            for (auto& record : records) {
-                if (flatFiles.find(record.getYear()) == flatFiles.end()) {
-                    auto yearOutputPath = (boost::format("%1%/%2%") % outputPath % record.getYear()).str();
-                    Poco::File yearOutputDir(yearOutputPath);
-                    try {
-                        yearOutputDir.createDirectories();
-                    } catch (Poco::FileExistsException&) {}
-
-                    auto yearOutputFilename = (boost::format("%1%/%2%_%3%.csv")
-                        % yearOutputPath % outputFilename % record.getYear()).str();
-
-                    flatFiles[record.getYear()] = std::make_shared<CBMFlatFile>(
-                        yearOutputFilename, record.header(*classifierNames));
-                }
-                flatFiles[record.getYear()]->write(record.asPersistable());
-            }
-            for (auto& flatFile : flatFiles) {
-                flatFile.second->save();
-            }
+            it->second->write(record.asPersistable());
         }
     }
 
 }}} // namespace moja::modules::cbm
-
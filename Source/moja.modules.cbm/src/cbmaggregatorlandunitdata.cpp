@@ -21,6 +21,9 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace moja {
 namespace modules {
 namespace cbm {
@@ -31,6 +34,21 @@ namespace cbm {
     * Initialise CBMAggregatorLandUnitData._classifierSetVar as variable "reporting_classifier_set" in paramter config if it exists, \n
     * else to "classifier_set"
     * 
+    * If parameter config contains "sharded_accumulation", assign it to CBMAggregatorLandUnitData._shardedAccumulation: \n
+    * when enabled, each thread accumulates into its own dimension tables instead of the shared, mutex-protected ones. \n
+    * It can't be combined with the writers' streaming output.
+    * 
+    * If parameter config contains "land_unit_deduplication" and it is true, land units are deduplicated by the values of \n
+    * their inputs: every spatial layer and transform variable, the inputs in CBMAggregatorLandUnitData._landUnitTraces \n
+    * (the variables the CBM modules read for each land unit and the disturbance layers of CBMDisturbanceListener), and \n
+    * any variables in "land_unit_signature_vars", which also enables deduplication. Spatial and transform variables \n
+    * listed in "land_unit_shared_vars" are left out of the signature: list the ones whose value is the same for every \n
+    * land unit, such as parameter tables, so they aren't read and compared for each land unit. \n
+    * "land_unit_trace_limit" and "land_unit_signature_limit" bound the number of traces kept and of signatures remembered. \n
+    * A deduplicated land unit is never built: "landUnitBuildSuccess" is false for it, so no other module, including \n
+    * spatial outputs and other aggregators, sees it or writes anything for it. Only use this when this module's results \n
+    * are the only output of the simulation, and order this module after CBMBuildLandUnitModule.
+    * 
     * @param config DynamicObject&
     * @return void
     * ************************/
@@ -41,10 +59,38 @@ namespace cbm {
 		} else {
 			_classifierSetVar = "classifier_set";
 		}
+
+		if (config.contains("sharded_accumulation")) {
+			_shardedAccumulation = config["sharded_accumulation"].convert<bool>();
+		}
+
+		if (config.contains("land_unit_deduplication")) {
+			_deduplicating = config["land_unit_deduplication"].convert<bool>();
+		}
+
+		if (config.contains("land_unit_signature_vars")) {
+			_deduplicating = true;
+			for (const auto& varName : config["land_unit_signature_vars"]) {
+				_signatureVarNames.push_back(varName);
+			}
+		}
+
+		if (config.contains("land_unit_shared_vars")) {
+			for (const auto& varName : config["land_unit_shared_vars"]) {
+				_sharedVarNames.push_back(varName);
+			}
+		}
+
+		if (config.contains("land_unit_trace_limit") || config.contains("land_unit_signature_limit")) {
+			_landUnitTraces->setLimits(
+				config.contains("land_unit_trace_limit") ? config["land_unit_trace_limit"].convert<size_t>() : 10000,
+				config.contains("land_unit_signature_limit") ? config["land_unit_signature_limit"].convert<size_t>() : 1000000);
+		}
 	}
 
     /**
-    * Subcribe to the signals LocalDomainInit, TimingInit, OutputStep, Error
+    * Subcribe to the signals LocalDomainInit, LocalDomainShutdown, PreTimingSequence, TimingInit, OutputStep, \n
+    * TimingShutdown, Error
     * 
     * @param notificationCenter NotificationCenter&
     * @return void
@@ -52,49 +98,121 @@ namespace cbm {
 
 	void CBMAggregatorLandUnitData::subscribe(NotificationCenter& notificationCenter) {
         notificationCenter.subscribe(signals::LocalDomainInit, &CBMAggregatorLandUnitData::onLocalDomainInit, *this);
+        notificationCenter.subscribe(signals::LocalDomainShutdown, &CBMAggregatorLandUnitData::onLocalDomainShutdown, *this);
+        notificationCenter.subscribe(signals::PreTimingSequence, &CBMAggregatorLandUnitData::onPreTimingSequence, *this);
         notificationCenter.subscribe(signals::TimingInit	 , &CBMAggregatorLandUnitData::onTimingInit		, *this);
         notificationCenter.subscribe(signals::OutputStep	 , &CBMAggregatorLandUnitData::onOutputStep		, *this);
+        notificationCenter.subscribe(signals::TimingShutdown , &CBMAggregatorLandUnitData::onTimingShutdown	, *this);
 		notificationCenter.subscribe(signals::Error			 , &CBMAggregatorLandUnitData::onError			, *this);
+        notificationCenter.subscribe(signals::DisturbanceEvent, &CBMAggregatorLandUnitData::onDisturbanceEvent, *this);
     }
 
     /**
-    * Return the Pool Id.
+    * Accumulate a record into either the shared dimension or this thread's local dimension,
+    * depending on CBMAggregatorLandUnitData._shardedAccumulation, and return its Id
     * 
-    * Create an object poolInfo of class PoolInfoRecord, \n
-    * Search poolInfo in CBMAggregatorLandUnitData._poolInfoDimension and return the Id
-    * 
-    * @param pool IPool*
+    * @param sharedDimension RecordAccumulatorWithMutex2<TPersistable, TRecord>&
+    * @param localDimension LocalRecordAccumulator<TRecord>&
+    * @param record TRecord&
+    * @return Int64
+    * ************************/
+
+    template<class TPersistable, class TRecord>
+    Int64 CBMAggregatorLandUnitData::accumulate(
+            flint::RecordAccumulatorWithMutex2<TPersistable, TRecord>& sharedDimension,
+            LocalRecordAccumulator<TRecord>& localDimension,
+            const TRecord& record) {
+
+        return _shardedAccumulation
+            ? localDimension.accumulate(record)->getId()
+            : sharedDimension.accumulate(record)->getId();
+    }
+
+    /**
+    * Accumulate a fact record
+    *
+    * Like CBMAggregatorLandUnitData.accumulate(), but facts in the shared dimensions are accumulated through \n
+    * CBMAggregatorLandUnitData._flushCoordinator so that new records count towards the streaming thresholds. \n
+    * Sharded facts are counted when they are merged.
+    *
+    * @param sharedDimension RecordAccumulatorWithMutex2<TPersistable, TRecord>&
+    * @param localDimension LocalRecordAccumulator<TRecord>&
+    * @param record TRecord&
+    * @return void
+    * ************************/
+
+    template<class TPersistable, class TRecord>
+    void CBMAggregatorLandUnitData::accumulateFact(
+            flint::RecordAccumulatorWithMutex2<TPersistable, TRecord>& sharedDimension,
+            LocalRecordAccumulator<TRecord>& localDimension,
+            const TRecord& record) {
+
+        if (_shardedAccumulation) {
+            localDimension.accumulate(record);
+        } else {
+            _flushCoordinator->accumulate(sharedDimension, record);
+        }
+    }
+
+    /**
+    * Id offset of a dimension released by the writers after each flush; 0 for the local dimensions \n
+    * of sharded accumulation, which are offset when they are merged.
+    *
+    * @param dimension RecordFlushCoordinator::ReleasedDimension
     * @return Int64
     * ************************/
 
-    Int64 CBMAggregatorLandUnitData::getPoolId(const flint::IPool* pool) {
-        PoolInfoRecord poolInfo(pool->name());
-        return _poolInfoDimension->search(poolInfo)->getId();
+    Int64 CBMAggregatorLandUnitData::idOffset(RecordFlushCoordinator::ReleasedDimension dimension) const {
+        return _shardedAccumulation ? 0 : _flushCoordinator->idOffset(dimension);
     }
 
     /**
     * Record Land Unit Data
     * 
-    * Assign the result of CBMAggregatorLandUnitData.recordLocation() to a variable locationId
-    * If the value of isSpinup is True, set CBMAggregatorLandUnitData._previousLocationId as locationId \n
-    * invoke CBMAggregatorLandUnitData.recordPoolsSet(), CBMAggregatorLandUnitData.recordFluxSet(), CBMAggregatorLandUnitData.recordAgeArea() with parameter locationId \n
-    * and set CBMAggregatorLandUnitData._previousLocationId as locationId
+    * Capture the current step of the land unit in CBMAggregatorLandUnitData._step, add it to the land unit's \n
+    * trace if one is being kept, and record it
     * 
     * @param isSpinup bool
     * @return void
     * ************************/
 
     void CBMAggregatorLandUnitData::recordLandUnitData(bool isSpinup) {
-        auto locationId = recordLocation(isSpinup);
-        if (isSpinup) {
-            _previousLocationId = locationId;
+        captureStep(isSpinup, _step);
+        if (_tracing) {
+            _trace->steps.push_back(_step);
         }
 
-        recordPoolsSet(locationId);
-        recordFluxSet(locationId);
-		recordAgeArea(locationId);
+        recordStep(_step);
+    }
+
+    /**
+    * Record Step
+    * 
+    * The step is recorded under CBMAggregatorLandUnitData._flushCoordinator's accumulation lock so that a streaming \n
+    * flush never sees a fact record without the dimension records it refers to.
+    * 
+    * Assign the result of CBMAggregatorLandUnitData.recordLocation() to a variable locationId
+    * If the step is the post-spinup step, set CBMAggregatorLandUnitData._previousLocationId as locationId \n
+    * invoke CBMAggregatorLandUnitData.recordPoolsSet(), CBMAggregatorLandUnitData.recordFluxSet(), CBMAggregatorLandUnitData.recordAgeArea() with parameter locationId \n
+    * and set CBMAggregatorLandUnitData._previousLocationId as locationId. Values are scaled by CBMAggregatorLandUnitData._landUnitArea.
+    * 
+    * @param step LandUnitStep&
+    * @return void
+    * ************************/
+
+    void CBMAggregatorLandUnitData::recordStep(const LandUnitStep& step) {
+        _flushCoordinator->withAccumulationLock([this, &step]() {
+            auto locationId = recordLocation(step);
+            if (step.isSpinup) {
+                _previousLocationId = locationId;
+            }
+
+            recordPoolsSet(locationId, step);
+            recordFluxSet(locationId, step);
+            recordAgeArea(locationId, step);
 
-        _previousLocationId = locationId;
+            _previousLocationId = locationId;
+        });
     }
 
     /**
@@ -124,57 +242,33 @@ namespace cbm {
 	}
 
     /**
-    * Record Location
-    * 
-    * If parameter isSpinup is true, instantiate an object of class DateRecord with default values, 
-    * else assign it with the current time of the simulation from _landUnitData
+    * Intern the classifier set
     * 
     * If CBMAggregatorLandUnitData._classifierNames is empty, invoke CBMAggregatorLandUnitData.recordClassifierNames()
     * 
-    * For each classifier in  CBMAggregatorLandUnitData._classifierSet, append classifier.second to a variable classifierSet
+    * For each classifier in CBMAggregatorLandUnitData._classifierSet, append its value to a variable classifierSet \n
+    * and intern it in CBMAggregatorLandUnitData._classifierSets as CBMAggregatorLandUnitData._currentClassifierSet. \n
+    * Classifiers with a TimeSeries value change from step to step, so the set is then re-interned on every step.
     * 
-    * Instantiate an object of class TemporalLocationRecord with parameters
-    * classifierSetRecordId, dateRecordId, landClassRecordId, ageClassId, _landUnitArea
-    * 
-    * Return the Id of accumulated value of locationRecord in CBMAggregatorLandUnitData._locationDimension
-    * 
-    * @param isSpinup bool
-    * @return Int64 
+    * @return void
     * ************************/
 
-    Int64 CBMAggregatorLandUnitData::recordLocation(bool isSpinup) {
-        Int64 dateRecordId = -1;
-        if (isSpinup) {
-            const auto timing = _landUnitData->timing();
-            DateRecord dateRecord(0, 0, 0, 0, 0, timing->stepLengthInYears());
-            auto storedDateRecord = _dateDimension->accumulate(dateRecord);
-            dateRecordId = storedDateRecord->getId();
-        } else {
-            // Find the date dimension record.			
-            const auto timing = _landUnitData->timing();
-            DateRecord dateRecord(
-                timing->step(), timing->curStartDate().year(),
-                timing->curStartDate().month(), timing->curStartDate().day(),
-                timing->fractionOfStep(), timing->stepLengthInYears());
-
-            auto storedDateRecord = _dateDimension->accumulate(dateRecord);
-            dateRecordId = storedDateRecord->getId();
-        }
-
-        // Classifier set information.
+    void CBMAggregatorLandUnitData::internClassifierSet() {
         const auto& landUnitClassifierSet = _classifierSet->value().extract<DynamicObject>();
-        std::vector<Poco::Nullable<std::string>> classifierSet;
+        ClassifierValues classifierSet;
         bool firstPass = _classifierNames->empty();
 		if (firstPass) {
 			recordClassifierNames(landUnitClassifierSet);
 		}
 
+        _classifierSetVaries = false;
         for (const auto& classifier : landUnitClassifierSet) {
 			Poco::Nullable<std::string> classifierValue;
 			if (!classifier.second.isEmpty()) {
                 if (classifier.second.type() == typeid(TimeSeries)) {
                     const auto timeseries = classifier.second.extract<TimeSeries>();
                     classifierValue = boost::lexical_cast<std::string>(timeseries.value());
+                    _classifierSetVaries = true;
                 } else {
                     classifierValue = classifier.second.convert<std::string>();
                 }
@@ -183,58 +277,183 @@ namespace cbm {
             classifierSet.push_back(classifierValue);
         }
 
-        ClassifierSetRecord cSetRecord(classifierSet);
-        auto storedCSetRecord = _classifierSetDimension->accumulate(cSetRecord);
-        auto classifierSetRecordId = storedCSetRecord->getId();
+        _currentClassifierSet = _classifierSets->intern(classifierSet, _currentClassifierSet);
+        _classifierSetStale = false;
+    }
 
-        std::string landClass = _landClass->value().extract<std::string>();
-		LandClassRecord landClassRecord(landClass);
-        auto storedLandClassRecord = _landClassDimension->accumulate(landClassRecord);
-        auto landClassRecordId = storedLandClassRecord->getId();
+    /**
+    * Capture Location
+    * 
+    * If parameter isSpinup is true, set the date of parameter step to a DateRecord with default values, \n
+    * else to the current time of the simulation from _landUnitData
+    * 
+    * If the classifier set is stale or has a classifier that varies by step, re-intern it with \n
+    * CBMAggregatorLandUnitData.internClassifierSet(); otherwise reuse the handle interned earlier for the land unit.
+    * 
+    * Set the land class and, if _landUnitData has the variable "age_class", the age class of parameter step
+    * 
+    * @param isSpinup bool
+    * @param step LandUnitStep&
+    * @return void
+    * ************************/
 
-        Poco::Nullable<Int64> ageClassId;
+    void CBMAggregatorLandUnitData::captureLocation(bool isSpinup, LandUnitStep& step) {
+        step.clear();
+        step.isSpinup = isSpinup;
+        const auto timing = _landUnitData->timing();
+        if (isSpinup) {
+            step.date = DateRecord(0, 0, 0, 0, 0, timing->stepLengthInYears());
+        } else {
+            step.date = DateRecord(
+                timing->step(), timing->curStartDate().year(),
+                timing->curStartDate().month(), timing->curStartDate().day(),
+                timing->fractionOfStep(), timing->stepLengthInYears());
+        }
+
+        if (_classifierSetStale || _classifierSetVaries) {
+            internClassifierSet();
+        }
+
+        step.classifierSet = _currentClassifierSet;
+        step.landClass = _landClass->value().extract<std::string>();
         if (_landUnitData->hasVariable("age_class")) {
-            Int64 ageClass = _landUnitData->getVariable("age_class")->value();
-            auto ageClassRange = _ageClassHelper.getAgeClass(ageClass);
+            step.ageClass = _landUnitData->getVariable("age_class")->value().convert<Int64>();
+        }
+    }
+
+    /**
+    * Capture Step
+    * 
+    * Capture the location of the land unit into parameter step with CBMAggregatorLandUnitData.captureLocation(), \n
+    * then its age, its pool values by pool idx, and the operations applied since the last step with their \n
+    * fluxes between different pools. The operation results are cleared from _landUnitData afterwards.
+    * 
+    * @param isSpinup bool
+    * @param step LandUnitStep&
+    * @return void
+    * ************************/
+
+    void CBMAggregatorLandUnitData::captureStep(bool isSpinup, LandUnitStep& step) {
+        captureLocation(isSpinup, step);
+        step.age = _landUnitData->getVariable("age")->value();
+
+        step.pools.resize(_landUnitData->poolCollection().size());
+        for (auto& pool : _landUnitData->poolCollection()) {
+            step.pools[pool->idx()] = pool->value();
+        }
+
+        if (_landUnitData->getOperationLastAppliedIterator().empty()) {
+            return;
+        }
+
+        for (auto operationResult : _landUnitData->getOperationLastAppliedIterator()) {
+            const auto& metaData = operationResult->metaData();
+            std::optional<DisturbanceTypeRecord> disturbanceType;
+            if (hasDisturbanceInfo(operationResult)) {
+                auto& disturbanceData = operationResult->dataPackage().extract<const DynamicObject>();
+                int disturbanceTypeCode = disturbanceData["disturbance_type_code"];
+                disturbanceType = DisturbanceTypeRecord(disturbanceTypeCode, disturbanceData["disturbance"].convert<std::string>());
+            }
+
+            step.operations.push_back(TracedOperation{
+                ModuleInfoRecord(
+                    metaData->libraryType, metaData->libraryInfoId,
+                    metaData->moduleType, metaData->moduleId, metaData->moduleName),
+                disturbanceType });
+
+            for (auto it : operationResult->operationResultFluxCollection()) {
+                auto srcIx = it->source();
+                auto dstIx = it->sink();
+                if (srcIx == dstIx) {
+                    continue; // don't process diagonal - flux to & from same pool is ignored
+                }
+
+                step.fluxes.push_back(TracedFlux{ step.operations.size() - 1, srcIx, dstIx, it->value() });
+            }
+        }
+
+        _landUnitData->clearLastAppliedOperationResults();
+    }
+
+    /**
+    * Record Location
+    * 
+    * Accumulate the date of parameter step in CBMAggregatorLandUnitData._dateDimension
+    * 
+    * The ClassifierSetRecord of the step's interned classifier set is only accumulated the first time this \n
+    * module sees it, after which its Id is looked up by interned Id
+    * 
+    * Instantiate an object of class TemporalLocationRecord with parameters
+    * classifierSetRecordId, dateRecordId, landClassRecordId, ageClassId, _landUnitArea
+    * 
+    * Return the Id of accumulated value of locationRecord in CBMAggregatorLandUnitData._locationDimension, \n
+    * plus the location dimension's Id offset
+    * 
+    * @param step LandUnitStep&
+    * @return Int64 
+    * ************************/
+
+    Int64 CBMAggregatorLandUnitData::recordLocation(const LandUnitStep& step) {
+        auto dateRecordId = accumulate(*_dateDimension, _localDateDimension, step.date);
+
+        auto storedCSetRecordId = _classifierSetRecordIds.find(step.classifierSet.id());
+        Int64 classifierSetRecordId;
+        if (storedCSetRecordId != _classifierSetRecordIds.end()) {
+            classifierSetRecordId = storedCSetRecordId->second;
+        } else {
+            ClassifierSetRecord cSetRecord(step.classifierSet.values());
+            classifierSetRecordId = accumulate(*_classifierSetDimension, _localClassifierSetDimension, cSetRecord);
+            _classifierSetRecordIds[step.classifierSet.id()] = classifierSetRecordId;
+        }
+
+		LandClassRecord landClassRecord(step.landClass);
+        auto landClassRecordId = accumulate(*_landClassDimension, _localLandClassDimension, landClassRecord);
+
+        Poco::Nullable<Int64> ageClassId;
+        if (step.ageClass.has_value()) {
+            auto ageClassRange = _ageClassHelper.getAgeClass(step.ageClass.value());
             AgeClassRecord ageClassRecord(std::get<0>(ageClassRange), std::get<1>(ageClassRange));
-            ageClassId = _ageClassDimension->accumulate(ageClassRecord)->getId();
+            ageClassId = accumulate(*_ageClassDimension, _localAgeClassDimension, ageClassRecord);
         }
 
 		TemporalLocationRecord locationRecord(
             classifierSetRecordId, dateRecordId, landClassRecordId, ageClassId, _landUnitArea);
 
-        auto storedLocationRecord = _locationDimension->accumulate(locationRecord);
-        return storedLocationRecord->getId();
+        auto locationId = accumulate(*_locationDimension, _localLocationDimension, locationRecord)
+            + idOffset(RecordFlushCoordinator::ReleasedDimension::Location);
+
+        return _flushCoordinator->stableId(
+            RecordFlushCoordinator::ReleasedDimension::Location,
+            std::make_tuple(classifierSetRecordId, dateRecordId, landClassRecordId, ageClassId.value(-1)),
+            locationId);
     }
 
     /**
     * Record Pools Set
     * 
-    * For each pool in _landUnitData->poolCollection(), create an object poolInfo of PoolInfoRecord with the pool name \n
-    * Assign poolId the Id of poolInfo in CBMAggregatorLandUnitData._poolInfoDimension , poolValue pool->value() *  CBMAggregatorLandUnitData._landUnitArea \n
+    * For each pool value in parameter step, assign poolId the pool's Id in CBMAggregatorLandUnitData._poolIds, \n
+    * poolValue the pool value *  CBMAggregatorLandUnitData._landUnitArea \n
     * Instantiate an object poolRecord of PoolRecord with locationId, poolId, poolValue \n
     * Invoke accumulate method of CBMAggregatorLandUnitData._poolDimension on poolRecord 
     * 
     * @param locationId Int64
+    * @param step LandUnitStep&
     * @return void
     * ************************/
 
-    void CBMAggregatorLandUnitData::recordPoolsSet(Int64 locationId) {
-        auto pools = _landUnitData->poolCollection();
-        for (auto& pool : _landUnitData->poolCollection()) {
-			PoolInfoRecord poolInfo(pool->name());
-            auto poolId = _poolInfoDimension->search(poolInfo)->getId();
-            double poolValue = pool->value() * _landUnitArea;
+    void CBMAggregatorLandUnitData::recordPoolsSet(Int64 locationId, const LandUnitStep& step) {
+        for (size_t idx = 0; idx < step.pools.size(); idx++) {
+            auto poolId = _poolIds[idx];
+            double poolValue = step.pools[idx] * _landUnitArea;
 			PoolRecord poolRecord(locationId, poolId, poolValue);
-            _poolDimension->accumulate(poolRecord);
+            accumulateFact(*_poolDimension, _localPoolDimension, poolRecord);
         }
     }
 
     /**
     * Record Age Area
     * 
-    * Assign variable standAge the value of variable "age" in _landUnitArea, \n
-    * ageClass as AgeClassHelper.toAgeClass() with argument standAge \n,
+    * Assign variable ageClass as AgeClassHelper.toAgeClass() with the stand age in parameter step \n,
     * ageClassRange as AgeClassHelper.getAgeClass() with argument ageClass. \n
     * Instantiate object ageClassRecord of class AgeClassRecord with argument ageClassRange, \n
     * invoke the accumulate method on CBMAggregatorLandUnitData._ageClassDimension with argument ageClassRecord, assign it to ageClassId. \n
@@ -242,17 +461,17 @@ namespace cbm {
     * Invoke accumulate method of CBMAggregatorLandUnitData._ageAreaDimension on ageAreaRecord
     * 
     * @param locationId Int64
+    * @param step LandUnitStep&
     * @return void
     * ************************/
 
-	void CBMAggregatorLandUnitData::recordAgeArea(Int64 locationId) {
-		int standAge = _landUnitData->getVariable("age")->value();
-		int ageClass = _ageClassHelper.toAgeClass(standAge);
+	void CBMAggregatorLandUnitData::recordAgeArea(Int64 locationId, const LandUnitStep& step) {
+		int ageClass = _ageClassHelper.toAgeClass(step.age);
         auto ageClassRange = _ageClassHelper.getAgeClass(ageClass);
         auto ageClassRecord = AgeClassRecord(std::get<0>(ageClassRange), std::get<1>(ageClassRange));
-        auto ageClassId = _ageClassDimension->accumulate(ageClassRecord)->getId();
+        auto ageClassId = accumulate(*_ageClassDimension, _localAgeClassDimension, ageClassRecord);
 		AgeAreaRecord ageAreaRecord(locationId, ageClassId, _landUnitArea);
-		_ageAreaDimension->accumulate(ageAreaRecord);		
+		accumulateFact(*_ageAreaDimension, _localAgeAreaDimension, ageAreaRecord);
 	}
 
     /**
@@ -284,84 +503,159 @@ namespace cbm {
     /**
     * Record the Flux Set
     *
-    * If Flux set, i.e if _landUnitData->getOperationLastAppliedIterator() is empty, return immediately.
+    * If parameter step has no operations, return immediately. Otherwise accumulate the module info and any \n
+    * disturbance of each operation, then a FluxRecord for each flux, scaled by CBMAggregatorLandUnitData._landUnitArea.
     *
     * @param locationId Int64
+    * @param step LandUnitStep&
     * @return void
     * ************************/
 
-    void CBMAggregatorLandUnitData::recordFluxSet(Int64 locationId) {
+    void CBMAggregatorLandUnitData::recordFluxSet(Int64 locationId, const LandUnitStep& step) {
         // If Flux set is empty, return immediately.
-        if (_landUnitData->getOperationLastAppliedIterator().empty()) {
+        if (step.operations.empty()) {
             return;
         }
 
-        for (auto operationResult : _landUnitData->getOperationLastAppliedIterator()) {
+        std::vector<std::pair<Int64, Poco::Nullable<Int64>>> operationRecordIds;
+        operationRecordIds.reserve(step.operations.size());
+        for (const auto& operation : step.operations) {
 			// Find the module info dimension record.
-            const auto& metaData = operationResult->metaData();
-            ModuleInfoRecord moduleInfoRecord(
-				metaData->libraryType, metaData->libraryInfoId,
-				metaData->moduleType, metaData->moduleId, metaData->moduleName);
-
-			auto moduleInfoRecordId = _moduleInfoDimension->accumulate(moduleInfoRecord)->getId();
+			auto moduleInfoRecordId = accumulate(*_moduleInfoDimension, _localModuleInfoDimension, operation.moduleInfo);
 
             Poco::Nullable<Int64> distRecordId;
-            if (hasDisturbanceInfo(operationResult)) {
-                auto& disturbanceData = operationResult->dataPackage().extract<const DynamicObject>();
-                auto disturbanceType = disturbanceData["disturbance"].convert<std::string>();
-                int disturbanceTypeCode = disturbanceData["disturbance_type_code"];
-                DisturbanceTypeRecord distTypeRecord(disturbanceTypeCode, disturbanceType);
-                auto distTypeRecordId = _disturbanceTypeDimension->accumulate(distTypeRecord)->getId();
+            if (operation.disturbanceType.has_value()) {
+                auto distTypeRecordId = accumulate(
+                    *_disturbanceTypeDimension, _localDisturbanceTypeDimension, operation.disturbanceType.value());
+
                 DisturbanceRecord disturbanceRecord(locationId, distTypeRecordId, _previousLocationId, _landUnitArea);
-                distRecordId = _disturbanceDimension->accumulate(disturbanceRecord)->getId();
+                auto disturbanceId = accumulate(*_disturbanceDimension, _localDisturbanceDimension, disturbanceRecord)
+                    + idOffset(RecordFlushCoordinator::ReleasedDimension::Disturbance);
+
+                distRecordId = _flushCoordinator->stableId(
+                    RecordFlushCoordinator::ReleasedDimension::Disturbance,
+                    std::make_tuple(locationId, distTypeRecordId, _previousLocationId, Int64(0)),
+                    disturbanceId);
             }
 
-            for (auto it : operationResult->operationResultFluxCollection()) {
-                auto srcIx = it->source();
-                auto dstIx = it->sink();
-                if (srcIx == dstIx) {
-                    continue; // don't process diagonal - flux to & from same pool is ignored
-                }
+            operationRecordIds.emplace_back(moduleInfoRecordId, distRecordId);
+        }
 
-                auto fluxValue = it->value() * _landUnitArea;
-                auto srcPool = _landUnitData->getPool(srcIx);
-                auto dstPool = _landUnitData->getPool(dstIx);
+        for (const auto& flux : step.fluxes) {
+            auto fluxValue = flux.value * _landUnitArea;
+            const auto& operationRecordId = operationRecordIds[flux.operation];
 
-                // Now have the required dimensions - look for the flux record.
-				FluxRecord fluxRecord(
-                    locationId, moduleInfoRecordId, distRecordId,
-                    getPoolId(srcPool), getPoolId(dstPool), fluxValue);
+            // Now have the required dimensions - look for the flux record.
+			FluxRecord fluxRecord(
+                locationId, operationRecordId.first, operationRecordId.second,
+                _poolIds[flux.source], _poolIds[flux.sink], fluxValue);
 
-                _fluxDimension->accumulate(fluxRecord);
-            }
+            accumulateFact(*_fluxDimension, _localFluxDimension, fluxRecord);
         }
-
-        _landUnitData->clearLastAppliedOperationResults();
     }
+
     /**
     * doError
     *
     * Detailed description here
     *
+    * A land unit that failed is never replayed, so stop keeping its trace.
+    *
     * @param msg string
     * @return void
     * ************************/
 
 	void CBMAggregatorLandUnitData::doError(std::string msg) {
-		bool detailsAvailable = _spatialLocationInfo != nullptr;
+        _tracing = false;
+        _flushCoordinator->withAccumulationLock([this, &msg]() {
+            bool detailsAvailable = _spatialLocationInfo != nullptr;
+
+            auto module = detailsAvailable ? _spatialLocationInfo->getProperty("module").convert<std::string>() : "unknown";
+            ErrorRecord errorRec(module, msg);
+            auto errorRecId = accumulate(*_errorDimension, _localErrorDimension, errorRec);
+
+            Poco::Nullable<Int64> locationId;
+            if (detailsAvailable) {
+                LandUnitStep step;
+                captureLocation(true, step);
+                locationId = recordLocation(step);
+            }
 
-		auto module = detailsAvailable ? _spatialLocationInfo->getProperty("module").convert<std::string>() : "unknown";
-		ErrorRecord errorRec(module, msg);
-		auto errorRecId = _errorDimension->accumulate(errorRec)->getId();
+            LocationErrorRecord locErrRec(locationId, errorRecId);
+            accumulate(*_locationErrorDimension, _localLocationErrorDimension, locErrRec);
+        });
+	}
 
-        Poco::Nullable<Int64> locationId;
-        if (detailsAvailable) {
-            locationId = recordLocation(true);
+    /**
+    * Deduplicate the land unit
+    *
+    * Mark the classifier set as stale: the land unit's classifier set is interned again the first time its location is captured. \n
+    * If CBMAggregatorLandUnitData._signatureVars is not empty and the land unit was built, build its signature \n
+    * from the values of the signature variables. If CBMAggregatorLandUnitData._landUnitTraces has a trace for \n
+    * the signature, record every step of it with this land unit's area and set "landUnitBuildSuccess" to false \n
+    * so that the land unit isn't simulated. Otherwise keep a trace of this land unit while it is simulated, \n
+    * if LandUnitTraceStore.shouldTrace() says so.
+    *
+    * @return void
+    * ************************/
+
+    void CBMAggregatorLandUnitData::doPreTimingSequence() {
+        _classifierSetStale = true;
+        _tracing = false;
+        if (_signatureVars.empty() || !_buildWorked->value().convert<bool>()) {
+            return;
         }
 
-		LocationErrorRecord locErrRec(locationId, errorRecId);
-		_locationErrorDimension->accumulate(locErrRec);
-	}
+        _signature.clear();
+        for (const auto var : _signatureVars) {
+            appendSignature(_signature, var->value());
+        }
+
+        auto trace = _landUnitTraces->find(_signature);
+        if (trace == nullptr) {
+            if (_landUnitTraces->shouldTrace(_signature)) {
+                _trace = std::make_shared<LandUnitTrace>();
+                _tracing = true;
+            }
+
+            return;
+        }
+
+        _landUnitArea = _spatialLocationInfo->getProperty("landUnitArea");
+        for (const auto& step : trace->steps) {
+            recordStep(step);
+        }
+
+        _buildWorked->set_value(false);
+    }
+
+    /**
+    * If a trace of the land unit was kept, store it in CBMAggregatorLandUnitData._landUnitTraces for \n
+    * land units with the same signature, unless the store is full.
+    *
+    * @return void
+    * ************************/
+
+    void CBMAggregatorLandUnitData::doTimingShutdown() {
+        if (_tracing) {
+            _landUnitTraces->insert(_signature, _trace);
+            _trace = nullptr;
+            _tracing = false;
+        }
+    }
+
+    /**
+    * A disturbance can apply a transition rule that changes the land unit's classifier set, so mark it \n
+    * as stale to re-intern it on the next step. Outside of disturbances the classifier set only changes \n
+    * when the land unit is built, in PreTimingSequence.
+    *
+    * @param e DynamicVar
+    * @return void
+    * ************************/
+
+    void CBMAggregatorLandUnitData::doDisturbanceEvent(DynamicVar e) {
+        _classifierSetStale = true;
+    }
 
     /**
     * initiate timing
@@ -381,15 +675,33 @@ namespace cbm {
     /**
     * Initiate Local Domain
     *
-    * Initialize spatial location info, classifier set and land class.
+    * Record each pool in CBMAggregatorLandUnitData._poolInfoDimension and keep its Id in CBMAggregatorLandUnitData._poolIds, \n
+    * indexed by pool idx, so that pool and flux records don't have to look pools up by name on every step. \n
+    * Initialize spatial location info, classifier set, land class and the land unit signature variables: \n
+    * the inputs of CBMAggregatorLandUnitData._landUnitTraces that the land unit has, the variables in \n
+    * CBMAggregatorLandUnitData._signatureVarNames, and every external (spatial or transform) variable not in \n
+    * CBMAggregatorLandUnitData._sharedVarNames. The variables in both lists must exist.
+    *
+    * Sharded accumulation is refused if a writer has enabled streaming: shards only reach the shared \n
+    * accumulators at the end of the local domain, so the streaming thresholds would never apply. This \n
+    * is checked here rather than in CBMAggregatorLandUnitData.configure(), which can run before the writers'.
+    *
+    * @exception std::runtime_error: Handles error when sharded accumulation is combined with streaming
+    * @exception std::runtime_error: Handles error when a variable in "land_unit_signature_vars" or "land_unit_shared_vars" doesn't exist
     *
     * @return void
     * ************************/
 
     void CBMAggregatorLandUnitData::doLocalDomainInit() {
+		if (_shardedAccumulation && _flushCoordinator->isEnabled()) {
+			throw std::runtime_error(
+				"sharded_accumulation can't be combined with streaming output (flush_record_count or flush_memory_mb)");
+		}
+
+		_poolIds.assign(_landUnitData->poolCollection().size(), -1);
 		for (auto& pool : _landUnitData->poolCollection()) {
 			PoolInfoRecord poolInfoRecord(pool->name());
-			_poolInfoDimension->accumulate(poolInfoRecord);
+			_poolIds[pool->idx()] = _poolInfoDimension->accumulate(poolInfoRecord)->getId();
 		}
 
         _spatialLocationInfo = std::static_pointer_cast<flint::SpatialLocationInfo>(
@@ -399,6 +711,223 @@ namespace cbm {
         _classifierSet = _landUnitData->getVariable(_classifierSetVar);
         _landClass = _landUnitData->getVariable("unfccc_land_class");
 		recordAgeClass();
+
+        _buildWorked = _landUnitData->getVariable("landUnitBuildSuccess");
+        if (!_deduplicating) {
+            return;
+        }
+
+        for (const auto& varName : _signatureVarNames) {
+            if (!_landUnitData->hasVariable(varName)) {
+                throw std::runtime_error(
+                    "land_unit_signature_vars: variable '" + varName + "' is not an input of the land units");
+            }
+        }
+
+        for (const auto& varName : _sharedVarNames) {
+            if (!_landUnitData->hasVariable(varName)) {
+                throw std::runtime_error(
+                    "land_unit_shared_vars: variable '" + varName + "' is not an input of the land units");
+            }
+        }
+
+        auto inputs = _landUnitTraces->inputs();
+        inputs.insert(inputs.end(), _signatureVarNames.begin(), _signatureVarNames.end());
+
+        // Spatial layers and transforms are resolved again for each land unit, so any of them can make two
+        // land units differ, whether or not a CBM module reads it. Flint data such as spatialLocationInfo
+        // is per land unit state rather than an input, and would make every signature unique.
+        for (const auto& variable : _landUnitData->variables()) {
+            const auto& varName = variable->info().name;
+            if (variable->isExternal() && !variable->isFlintData()
+                    && std::find(_sharedVarNames.begin(), _sharedVarNames.end(), varName) == _sharedVarNames.end()) {
+                inputs.push_back(varName);
+            }
+        }
+        for (const auto& varName : inputs) {
+            auto var = _landUnitData->hasVariable(varName) ? _landUnitData->getVariable(varName) : nullptr;
+            if (var != nullptr && std::find(_signatureVars.begin(), _signatureVars.end(), var) == _signatureVars.end()) {
+                _signatureVars.push_back(var);
+            }
+        }
+    }
+
+    /**
+    * Shut down the local domain
+    *
+    * If sharded accumulation is enabled, merge this thread's dimension tables into the shared accumulators. \n
+    * This happens once per thread at the end of its local domain so that the shared tables are complete \n
+    * before any writer module runs on SystemShutdown.
+    *
+    * @return void
+    * ************************/
+
+    void CBMAggregatorLandUnitData::doLocalDomainShutdown() {
+        _flushCoordinator->withAccumulationLock([this]() {
+            mergeShard();
+        });
+    }
+
+    /**
+    * Merge a local dimension into its shared counterpart
+    *
+    * Visit the records in parameter localDimension in order of their local Id, pass each through parameter remap \n
+    * to translate any foreign keys into shared Ids, and accumulate the result into parameter sharedDimension. \n
+    * Return a vector indexed by local Id holding the shared Id each local record was assigned; index 0 maps to 0. \n
+    * Parameter localDimension is cleared afterwards.
+    *
+    * @param sharedDimension RecordAccumulatorWithMutex2<TPersistable, TRecord>&
+    * @param localDimension LocalRecordAccumulator<TRecord>&
+    * @param remap TRemap
+    * @return vector<Int64>
+    * ************************/
+
+    template<class TPersistable, class TRecord, class TRemap>
+    std::vector<Int64> CBMAggregatorLandUnitData::mergeDimension(
+            flint::RecordAccumulatorWithMutex2<TPersistable, TRecord>& sharedDimension,
+            LocalRecordAccumulator<TRecord>& localDimension,
+            TRemap remap) {
+
+        std::vector<Int64> sharedIds(localDimension.size() + 1, 0);
+        for (const auto record : localDimension.recordsById()) {
+            sharedIds[record->getId()] = sharedDimension.accumulate(remap(*record))->getId();
+        }
+
+        localDimension.clear();
+        return sharedIds;
+    }
+
+    /**
+    * Merge a local fact dimension into its shared counterpart
+    *
+    * As CBMAggregatorLandUnitData.mergeDimension(), but through CBMAggregatorLandUnitData._flushCoordinator \n
+    * so that new fact records count towards the streaming thresholds; no Ids are returned.
+    *
+    * @param sharedDimension RecordAccumulatorWithMutex2<TPersistable, TRecord>&
+    * @param localDimension LocalRecordAccumulator<TRecord>&
+    * @param remap TRemap
+    * @return void
+    * ************************/
+
+    template<class TPersistable, class TRecord, class TRemap>
+    void CBMAggregatorLandUnitData::mergeFacts(
+            flint::RecordAccumulatorWithMutex2<TPersistable, TRecord>& sharedDimension,
+            LocalRecordAccumulator<TRecord>& localDimension,
+            TRemap remap) {
+
+        for (const auto record : localDimension.recordsById()) {
+            _flushCoordinator->accumulate(sharedDimension, remap(*record));
+        }
+
+        localDimension.clear();
+    }
+
+    /**
+    * Merge Shard
+    *
+    * If sharded accumulation is enabled, merge every local dimension into the shared accumulators, \n
+    * dimension tables first so that the foreign keys in the location, disturbance, pool, flux, age area \n
+    * and location error records can be remapped from local to shared Ids. Each local record maps to exactly \n
+    * one shared record, so areas and values are summed exactly as they would have been in the shared mode. \n
+    * Location and disturbance Ids get the Id offsets of the released dimensions, as in the shared mode.
+    *
+    * @return void
+    * ************************/
+
+    void CBMAggregatorLandUnitData::mergeShard() {
+        if (!_shardedAccumulation) {
+            return;
+        }
+
+        auto keep = [](const auto& record) { return record; };
+        auto remapId = [](const std::vector<Int64>& sharedIds, Int64 localId) {
+            return localId > 0 && localId < (Int64)sharedIds.size() ? sharedIds[localId] : localId;
+        };
+
+        // Ids of the released dimensions are stored with their current offset.
+        auto addOffset = [this](std::vector<Int64>& sharedIds, RecordFlushCoordinator::ReleasedDimension dimension) {
+            auto offset = _flushCoordinator->idOffset(dimension);
+            for (size_t i = 1; i < sharedIds.size(); i++) {
+                sharedIds[i] += offset;
+            }
+        };
+
+        auto dateIds = mergeDimension(*_dateDimension, _localDateDimension, keep);
+        auto classifierSetIds = mergeDimension(*_classifierSetDimension, _localClassifierSetDimension, keep);
+        _classifierSetRecordIds.clear();
+        auto landClassIds = mergeDimension(*_landClassDimension, _localLandClassDimension, keep);
+        auto ageClassIds = mergeDimension(*_ageClassDimension, _localAgeClassDimension, keep);
+        auto moduleInfoIds = mergeDimension(*_moduleInfoDimension, _localModuleInfoDimension, keep);
+        auto disturbanceTypeIds = mergeDimension(*_disturbanceTypeDimension, _localDisturbanceTypeDimension, keep);
+        auto errorIds = mergeDimension(*_errorDimension, _localErrorDimension, keep);
+
+        auto locationIds = mergeDimension(*_locationDimension, _localLocationDimension,
+            [&](const TemporalLocationRecord& record) {
+                auto location = record.asTuple();
+                auto localAgeClassId = std::get<4>(location);
+                Poco::Nullable<Int64> ageClassId;
+                if (localAgeClassId.has_value()) {
+                    ageClassId = remapId(ageClassIds, localAgeClassId.value());
+                }
+
+                return TemporalLocationRecord(
+                    remapId(classifierSetIds, std::get<1>(location)),
+                    remapId(dateIds, std::get<2>(location)),
+                    remapId(landClassIds, std::get<3>(location)),
+                    ageClassId, std::get<5>(location));
+            });
+
+        addOffset(locationIds, RecordFlushCoordinator::ReleasedDimension::Location);
+
+        auto disturbanceIds = mergeDimension(*_disturbanceDimension, _localDisturbanceDimension,
+            [&](const DisturbanceRecord& record) {
+                auto disturbance = record.asTuple();
+                return DisturbanceRecord(
+                    remapId(locationIds, std::get<1>(disturbance)),
+                    remapId(disturbanceTypeIds, std::get<2>(disturbance)),
+                    remapId(locationIds, std::get<3>(disturbance)),
+                    std::get<4>(disturbance));
+            });
+
+        addOffset(disturbanceIds, RecordFlushCoordinator::ReleasedDimension::Disturbance);
+
+        mergeFacts(*_poolDimension, _localPoolDimension,
+            [&](const PoolRecord& record) {
+                auto pool = record.asTuple();
+                return PoolRecord(remapId(locationIds, std::get<1>(pool)), std::get<2>(pool), std::get<3>(pool));
+            });
+
+        mergeFacts(*_fluxDimension, _localFluxDimension,
+            [&](const FluxRecord& record) {
+                auto flux = record.asTuple();
+                auto localDisturbanceId = std::get<3>(flux);
+                Poco::Nullable<Int64> disturbanceId;
+                if (localDisturbanceId.has_value()) {
+                    disturbanceId = remapId(disturbanceIds, localDisturbanceId.value());
+                }
+
+                return FluxRecord(
+                    remapId(locationIds, std::get<1>(flux)),
+                    remapId(moduleInfoIds, std::get<2>(flux)),
+                    disturbanceId, std::get<4>(flux), std::get<5>(flux), std::get<6>(flux));
+            });
+
+        mergeFacts(*_ageAreaDimension, _localAgeAreaDimension,
+            [&](const AgeAreaRecord& record) {
+                auto ageArea = record.asTuple();
+                return AgeAreaRecord(
+                    remapId(locationIds, std::get<1>(ageArea)),
+                    remapId(ageClassIds, std::get<2>(ageArea)),
+                    std::get<3>(ageArea));
+            });
+
+        mergeDimension(*_locationErrorDimension, _localLocationErrorDimension,
+            [&](const LocationErrorRecord& record) {
+                auto locationError = record.asTuple();
+                return LocationErrorRecord(
+                    remapId(locationIds, std::get<1>(locationError)),
+                    remapId(errorIds, std::get<2>(locationError)));
+            });
     }
 
     /**
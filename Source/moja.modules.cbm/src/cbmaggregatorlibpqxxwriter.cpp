@@ -35,7 +35,9 @@ namespace cbm {
     *
     * Assign CBMAggregatorLibPQXXWriter._connectionString as variable "connection_string" in parameter config, \n
     * CBMAggregatorLibPQXXWriter._schema as variable "schema" in parameter config, \n
-    * If parameter config has "drop_schema", assign it to CBMAggregatorLibPQXXWriter._dropSchema
+    * If parameter config has "drop_schema", assign it to CBMAggregatorLibPQXXWriter._dropSchema \n
+    * If parameter config contains "flush_record_count" or "flush_memory_mb", enable streaming: flux, pool and \n
+    * age rows are then copied into the job's tables in batches during the simulation
     * 
     * @param config DynamicObject&
     * @return void
@@ -48,6 +50,8 @@ namespace cbm {
         if (config.contains("drop_schema")) {
             _dropSchema = config["drop_schema"];
         }
+
+        _flushCoordinator->configure(config);
     }
 
     /**
@@ -68,7 +72,8 @@ namespace cbm {
     *
     * If CBMAggregatorLibPQXXWriter._isPrimaryAggregator and CBMAggregatorLibPQXXWriter._dropSchema are true \n
     * drop CBMAggregatorLibPQXXWriter._schema \n
-    * Create CBMAggregatorLibPQXXWriter._schema
+    * Create CBMAggregatorLibPQXXWriter._schema \n
+    * If streaming is enabled, register CBMAggregatorLibPQXXWriter.flush() with CBMAggregatorLibPQXXWriter._flushCoordinator
     *
     * @return void
     * ************************/
@@ -84,6 +89,16 @@ namespace cbm {
         }
 
         doIsolated(conn, (boost::format("CREATE SCHEMA %1%;") % _schema).str(), true);
+
+        if (_flushCoordinator->isEnabled()) {
+            _flushCoordinator->addFlushHandler(
+                [this]() { flush(); },
+                [this]() {
+                    _fluxDimension->clear();
+                    _poolDimension->clear();
+                    _ageDimension->clear();
+                });
+        }
     }
 
     /**
@@ -100,13 +115,52 @@ namespace cbm {
             : 0;
     }
 
+    /**
+    * Copy the pending batch of flux, pool and age records into the job's tables, creating them on the \n
+    * first flush. Called by CBMAggregatorLibPQXXWriter._flushCoordinator while no aggregator is accumulating. \n
+    * The job is only marked as completed at shutdown, so a rerun after a crash starts the tables over.
+    * 
+    * @return void
+    * ************************/
+    void CBMAggregatorLibPQXXWriter::flush() {
+        if (_classifierNames->empty() || _resultsPreviouslyLoaded) {
+            return;
+        }
+
+        connection conn(_connectionString);
+        doIsolated(conn, (boost::format("SET search_path = %1%;") % _schema).str());
+
+        if (!_tablesCreated) {
+            if (resultsPreviouslyLoaded(conn)) {
+                MOJA_LOG_INFO << "Results previously loaded for jobId " << _jobId << " - skipping.";
+                _resultsPreviouslyLoaded = true;
+                return;
+            }
+
+            doIsolated(conn, createTablesDdl());
+            _tablesCreated = true;
+        }
+
+        MOJA_LOG_INFO << (boost::format("Flushing results into %1% on server: %2%")
+            % _schema % _connectionString).str();
+
+        perform([&conn, this] {
+            work tx(conn);
+            load(tx, _jobId, "flux", _fluxDimension);
+            load(tx, _jobId, "pool", _poolDimension);
+            load(tx, _jobId, "age", _ageDimension);
+            tx.commit();
+        });
+    }
+
     /**
     * doSystemShutDown
     *
     * If CBMAggregatorLibPQXXWriter._isPrimaryAggregator is true, create unlogged tables for the DateDimension, LandClassDimension, \n
-	* PoolDimension, ClassifierSetDimension, ModuleInfoDimension, LocationDimension, DisturbanceTypeDimension, \n
+	* PoolDimension, ClassifierSetDimension, ModuleInfoDimension, LocationDimension, DisturbanceTypeDimension, \n
     * DisturbanceDimension, Pools, Fluxes, ErrorDimension, AgeClassDimension, LocationErrorDimension, \n
-	* and AgeArea if they do not already exist, and load data into tables on PostgreSQL
+	* and AgeArea if they do not already exist, and load data into tables on PostgreSQL. \n
+	* When streaming, the tables already hold the earlier batches and only the remaining records are loaded.
     * 
     * @return void
     * ************************/
@@ -120,56 +174,94 @@ namespace cbm {
 			return;
 		}
 
+        if (_resultsPreviouslyLoaded) {
+            MOJA_LOG_INFO << "Results previously loaded for jobId " << _jobId << " - skipping.";
+            return;
+        }
+
         MOJA_LOG_INFO << (boost::format("Loading results into %1% on server: %2%")
             % _schema % _connectionString).str();
 
-        connection conn(_connectionString);
-        doIsolated(conn, (boost::format("SET search_path = %1%;") % _schema).str());
+        _flushCoordinator->withFlushLock([this] {
+            connection conn(_connectionString);
+            doIsolated(conn, (boost::format("SET search_path = %1%;") % _schema).str());
 
-        MOJA_LOG_INFO << "Creating results tables.";
+            if (!_tablesCreated) {
+                MOJA_LOG_INFO << "Creating results tables.";
+                if (resultsPreviouslyLoaded(conn)) {
+                    MOJA_LOG_INFO << "Results previously loaded for jobId " << _jobId << " - skipping.";
+                    _resultsPreviouslyLoaded = true;
+                    return;
+                }
+            }
+
+            perform([&conn, this] {
+                work tx(conn);
+
+                // First, try to insert into the completed jobs table - if this is a duplicate, the transaction
+                // will fail immediately.
+                tx.exec((boost::format("INSERT INTO CompletedJobs VALUES (%1%);") % _jobId).str());
+
+                // Bulk load the job results into a temporary set of tables.
+                if (!_tablesCreated) {
+                    for (const auto& ddl : createTablesDdl()) {
+                        tx.exec(ddl);
+                    }
+                }
+
+                load(tx, _jobId, "flux", _fluxDimension);
+                load(tx, _jobId, "pool", _poolDimension);
+                load(tx, _jobId, "error", _errorDimension);
+                load(tx, _jobId, "age", _ageDimension);
+                load(tx, _jobId, "disturbance", _disturbanceDimension);
+
+                tx.commit();
+            });
+        });
+
+        if (!_resultsPreviouslyLoaded) {
+            MOJA_LOG_INFO << "PostgreSQL insert complete." << std::endl;
+        }
+    }
+
+    /**
+    * Create the CompletedJobs table if needed and check whether CBMAggregatorLibPQXXWriter._jobId has \n
+    * already been loaded
+    * 
+    * @param conn connection_base&
+    * @return bool
+    * ************************/
+    bool CBMAggregatorLibPQXXWriter::resultsPreviouslyLoaded(pqxx::connection_base& conn) {
         doIsolated(conn, "CREATE UNLOGGED TABLE IF NOT EXISTS CompletedJobs (id BIGINT PRIMARY KEY);", false);
 
-        bool resultsPreviouslyLoaded = perform([&conn, this] {
+        return perform([&conn, this] {
             return !nontransaction(conn).exec((boost::format(
                 "SELECT 1 FROM CompletedJobs WHERE id = %1%;"
             ) % _jobId).str()).empty();
         });
+    }
 
-        if (resultsPreviouslyLoaded) {
-            MOJA_LOG_INFO << "Results previously loaded for jobId " << _jobId << " - skipping.";
-            return;
+    /**
+    * Return the statements that (re)create the job's flux, pool, error, age and disturbance tables. \n
+    * Tables left behind by an earlier, incomplete streaming run of the same job are dropped first.
+    * 
+    * @return vector<string>
+    * ************************/
+    std::vector<std::string> CBMAggregatorLibPQXXWriter::createTablesDdl() const {
+        std::vector<std::string> ddl;
+        for (const auto& table : { "flux", "pool", "error", "age", "disturbance" }) {
+            ddl.push_back((boost::format("DROP TABLE IF EXISTS %1%_%2%;") % table % _jobId).str());
         }
 
-        perform([&conn, this] {
-            work tx(conn);
-
-            // First, try to insert into the completed jobs table - if this is a duplicate, the transaction
-            // will fail immediately.
-            tx.exec((boost::format("INSERT INTO CompletedJobs VALUES (%1%);") % _jobId).str());
-
-            // Bulk load the job results into a temporary set of tables.
-            std::vector<std::string> tempTableDdl{
-                (boost::format("CREATE UNLOGGED TABLE flux_%1% (year INTEGER, %2% VARCHAR, unfccc_land_class VARCHAR, age_range VARCHAR, %3%_previous VARCHAR, unfccc_land_class_previous VARCHAR, age_range_previous VARCHAR, disturbance_type VARCHAR, disturbance_code INTEGER, from_pool VARCHAR, to_pool VARCHAR, flux_tc NUMERIC);") % _jobId % boost::join(*_classifierNames, " VARCHAR, ") % boost::join(*_classifierNames, "_previous VARCHAR, ")).str(),
-                (boost::format("CREATE UNLOGGED TABLE pool_%1% (year INTEGER, %2% VARCHAR, unfccc_land_class VARCHAR, age_range VARCHAR, pool VARCHAR, pool_tc NUMERIC);") % _jobId % boost::join(*_classifierNames, " VARCHAR, ")).str(),
-                (boost::format("CREATE UNLOGGED TABLE error_%1% (year INTEGER, %2% VARCHAR, module VARCHAR, error VARCHAR, area NUMERIC);") % _jobId % boost::join(*_classifierNames, " VARCHAR, ")).str(),
-                (boost::format("CREATE UNLOGGED TABLE age_%1% (year INTEGER, %2% VARCHAR, unfccc_land_class VARCHAR, age_range VARCHAR, area NUMERIC);") % _jobId % boost::join(*_classifierNames, " VARCHAR, ")).str(),
-                (boost::format("CREATE UNLOGGED TABLE disturbance_%1% (year INTEGER, %2% VARCHAR, unfccc_land_class VARCHAR, age_range VARCHAR, %3%_previous VARCHAR, unfccc_land_class_previous VARCHAR, age_range_previous VARCHAR, disturbance_type VARCHAR, disturbance_code INTEGER, area NUMERIC);") % _jobId % boost::join(*_classifierNames, " VARCHAR, ") % boost::join(*_classifierNames, "_previous VARCHAR, ")).str()
-            };
-
-            for (const auto& ddl : tempTableDdl) {
-                tx.exec(ddl);
-            }
-
-            load(tx, _jobId, "flux", _fluxDimension);
-            load(tx, _jobId, "pool", _poolDimension);
-            load(tx, _jobId, "error", _errorDimension);
-            load(tx, _jobId, "age", _ageDimension);
-            load(tx, _jobId, "disturbance", _disturbanceDimension);
-
-            tx.commit();
+        ddl.insert(ddl.end(), {
+            (boost::format("CREATE UNLOGGED TABLE flux_%1% (year INTEGER, %2% VARCHAR, unfccc_land_class VARCHAR, age_range VARCHAR, %3%_previous VARCHAR, unfccc_land_class_previous VARCHAR, age_range_previous VARCHAR, disturbance_type VARCHAR, disturbance_code INTEGER, from_pool VARCHAR, to_pool VARCHAR, flux_tc NUMERIC);") % _jobId % boost::join(*_classifierNames, " VARCHAR, ") % boost::join(*_classifierNames, "_previous VARCHAR, ")).str(),
+            (boost::format("CREATE UNLOGGED TABLE pool_%1% (year INTEGER, %2% VARCHAR, unfccc_land_class VARCHAR, age_range VARCHAR, pool VARCHAR, pool_tc NUMERIC);") % _jobId % boost::join(*_classifierNames, " VARCHAR, ")).str(),
+            (boost::format("CREATE UNLOGGED TABLE error_%1% (year INTEGER, %2% VARCHAR, module VARCHAR, error VARCHAR, area NUMERIC);") % _jobId % boost::join(*_classifierNames, " VARCHAR, ")).str(),
+            (boost::format("CREATE UNLOGGED TABLE age_%1% (year INTEGER, %2% VARCHAR, unfccc_land_class VARCHAR, age_range VARCHAR, area NUMERIC);") % _jobId % boost::join(*_classifierNames, " VARCHAR, ")).str(),
+            (boost::format("CREATE UNLOGGED TABLE disturbance_%1% (year INTEGER, %2% VARCHAR, unfccc_land_class VARCHAR, age_range VARCHAR, %3%_previous VARCHAR, unfccc_land_class_previous VARCHAR, age_range_previous VARCHAR, disturbance_type VARCHAR, disturbance_code INTEGER, area NUMERIC);") % _jobId % boost::join(*_classifierNames, " VARCHAR, ") % boost::join(*_classifierNames, "_previous VARCHAR, ")).str()
         });
 
-        MOJA_LOG_INFO << "PostgreSQL insert complete." << std::endl;
+        return ddl;
     }
 
     /**
@@ -240,7 +332,7 @@ namespace cbm {
         MOJA_LOG_INFO << (boost::format("Loading %1%") % table).str();
         auto tempTableName = (boost::format("%1%_%2%") % table % jobId).str();
         pqxx::stream_to stream(tx, tempTableName);
-        auto records = dataDimension->records();
+        const auto& records = dataDimension->records();
         if (!records.empty()) {
             for (auto& record : records) {
                 stream << record.asVector();
@@ -0,0 +1,488 @@
+/**
+ * @file
+ * The CBMAggregatorParquetWriter module writes the stand-level information gathered by
+ * CBMFlatAggregatorLandUnitData into Parquet files: one file per output table, with typed
+ * numeric columns, dictionary-encoded text columns (classifiers, land class, age range,
+ * pools), a row group per year and configurable compression.
+ * ******/
+
+#include "moja/modules/cbm/cbmaggregatorparquetwriter.h"
+
+#include <moja/flint/recordaccumulatorwithmutex.h>
+#include <moja/flint/ilandunitdatawrapper.h>
+#include <moja/flint/ivariable.h>
+#include <moja/logging.h>
+#include <moja/signals.h>
+#include <moja/notificationcenter.h>
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/util/compression.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/exception.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+
+#include <Poco/Exception.h>
+#include <Poco/File.h>
+#include <Poco/Path.h>
+#include <Poco/TemporaryFile.h>
+
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    namespace {
+
+        /**
+         * Collects the column types of a flat record, used to build the file schema from the first record written.
+         */
+        class ColumnTypeCollector : public FlatRecordColumnVisitor {
+        public:
+            void integer(int) override { types.push_back(FlatColumnType::Integer); }
+            void number(double) override { types.push_back(FlatColumnType::Number); }
+            void text(const std::string&) override { types.push_back(FlatColumnType::Text); }
+            void null(FlatColumnType type) override { types.push_back(type); }
+
+            std::vector<FlatColumnType> types;
+        };
+
+        const char* columnTypeName(FlatColumnType type) {
+            switch (type) {
+                case FlatColumnType::Integer: return "integer";
+                case FlatColumnType::Number:  return "number";
+                default:                      return "text";
+            }
+        }
+
+        /**
+         * Split a flat record's CSV header into its column names.
+         */
+        std::vector<std::string> columnNames(const std::string& header) {
+            std::vector<std::string> names;
+            auto trimmed = boost::trim_right_copy(header);
+            boost::split(names, trimmed, boost::is_any_of(","));
+            for (auto& name : names) {
+                boost::erase_all(name, "\"");
+            }
+
+            return names;
+        }
+
+    }
+
+    /**
+     * Builds the columns of the pending row group; each record visits the columns in schema order,
+     * and every column is checked against the schema, which was taken from the file's first record.
+     */
+    class CBMParquetFile::Impl : public FlatRecordColumnVisitor {
+    public:
+        Impl(const std::string& path,
+             const std::vector<std::string>& columnNames,
+             const std::vector<FlatColumnType>& columnTypes,
+             const std::string& compression,
+             Int64 rowGroupSize)
+            : _path(path), _columnNames(columnNames), _columnTypes(columnTypes),
+              _rowGroupSize(rowGroupSize), _column(0), _saved(false) {
+
+            // Unique name in the output directory, so the final rename never crosses file systems.
+            Poco::Path tempPath(path);
+            tempPath.setFileName(Poco::Path(Poco::TemporaryFile::tempName()).getFileName());
+            _tempPath = tempPath.toString();
+
+            arrow::FieldVector fields;
+            for (size_t i = 0; i < columnTypes.size(); i++) {
+                switch (columnTypes[i]) {
+                    case FlatColumnType::Integer:
+                        fields.push_back(arrow::field(columnNames[i], arrow::int32()));
+                        _builders.push_back(std::make_unique<arrow::Int32Builder>());
+                        break;
+                    case FlatColumnType::Number:
+                        fields.push_back(arrow::field(columnNames[i], arrow::float64()));
+                        _builders.push_back(std::make_unique<arrow::DoubleBuilder>());
+                        break;
+                    case FlatColumnType::Text:
+                        fields.push_back(arrow::field(columnNames[i], arrow::dictionary(arrow::int32(), arrow::utf8())));
+                        _builders.push_back(std::make_unique<arrow::StringDictionary32Builder>());
+                        break;
+                }
+            }
+
+            _schema = arrow::schema(fields);
+
+            PARQUET_ASSIGN_OR_THROW(auto compressionType, arrow::util::Codec::GetCompressionType(compression));
+            auto properties = parquet::WriterProperties::Builder().compression(compressionType)->build();
+            auto arrowProperties = parquet::ArrowWriterProperties::Builder().store_schema()->build();
+
+            PARQUET_ASSIGN_OR_THROW(_outputStream, arrow::io::FileOutputStream::Open(_tempPath));
+            PARQUET_ASSIGN_OR_THROW(_writer, parquet::arrow::FileWriter::Open(
+                *_schema, arrow::default_memory_pool(), _outputStream, properties, arrowProperties));
+        }
+
+        ~Impl() {
+            if (_saved) {
+                return;
+            }
+
+            // Abandoned before save(), e.g. by a record that did not match the schema: drop the partial file.
+            try {
+                (void)_writer->Close();
+                (void)_outputStream->Close();
+                Poco::File(_tempPath).remove();
+            } catch (...) { }
+        }
+
+        void integer(int value) override {
+            PARQUET_THROW_NOT_OK(static_cast<arrow::Int32Builder&>(nextColumn(FlatColumnType::Integer)).Append(value));
+        }
+
+        void number(double value) override {
+            PARQUET_THROW_NOT_OK(static_cast<arrow::DoubleBuilder&>(nextColumn(FlatColumnType::Number)).Append(value));
+        }
+
+        void text(const std::string& value) override {
+            PARQUET_THROW_NOT_OK(static_cast<arrow::StringDictionary32Builder&>(nextColumn(FlatColumnType::Text)).Append(value));
+        }
+
+        void null(FlatColumnType type) override {
+            PARQUET_THROW_NOT_OK(nextColumn(type).AppendNull());
+        }
+
+        void endRow() {
+            if (_column != _columnTypes.size()) {
+                throw std::runtime_error((boost::format(
+                    "Record for %1% has %2% columns but the file has %3%")
+                    % _path % _column % _columnTypes.size()).str());
+            }
+
+            _column = 0;
+        }
+
+        void writeRowGroup() {
+            if (_builders.empty() || _builders[0]->length() == 0) {
+                return;
+            }
+
+            arrow::ArrayVector columns;
+            for (auto& builder : _builders) {
+                std::shared_ptr<arrow::Array> column;
+                PARQUET_THROW_NOT_OK(builder->Finish(&column));
+                columns.push_back(column);
+            }
+
+            auto table = arrow::Table::Make(_schema, columns);
+            PARQUET_THROW_NOT_OK(_writer->WriteTable(*table, _rowGroupSize));
+        }
+
+        void save() {
+            PARQUET_THROW_NOT_OK(_writer->Close());
+            PARQUET_THROW_NOT_OK(_outputStream->Close());
+            Poco::File(_tempPath).renameTo(_path);
+            _saved = true;
+        }
+
+    private:
+        arrow::ArrayBuilder& nextColumn(FlatColumnType type) {
+            if (_column >= _columnTypes.size()) {
+                throw std::runtime_error((boost::format(
+                    "Record for %1% has more than the file's %2% columns")
+                    % _path % _columnTypes.size()).str());
+            }
+
+            if (_columnTypes[_column] != type) {
+                throw std::runtime_error((boost::format(
+                    "Record for %1% has a %2% value in column %3% (%4%), which holds %5% values")
+                    % _path % columnTypeName(type) % _column % _columnNames[_column]
+                    % columnTypeName(_columnTypes[_column])).str());
+            }
+
+            return *_builders[_column++];
+        }
+
+        std::string _path;
+        std::string _tempPath;
+        std::vector<std::string> _columnNames;
+        std::vector<FlatColumnType> _columnTypes;
+        Int64 _rowGroupSize;
+        size_t _column;
+        bool _saved;
+        std::shared_ptr<arrow::Schema> _schema;
+        std::vector<std::unique_ptr<arrow::ArrayBuilder>> _builders;
+        std::shared_ptr<arrow::io::FileOutputStream> _outputStream;
+        std::unique_ptr<parquet::arrow::FileWriter> _writer;
+    };
+
+    /**
+     * Constructor
+     *
+     * Open a uniquely named temporary file in the directory of parameter path and create the schema \n
+     * from parameters columnNames and columnTypes; text columns are dictionary-encoded.
+     *
+     * @param path string&
+     * @param columnNames vector<string>&
+     * @param columnTypes vector<FlatColumnType>&
+     * @param compression string&, any codec name understood by Arrow, i.e. "snappy", "zstd", "gzip" or "uncompressed"
+     * @param rowGroupSize Int64, maximum number of rows in a row group
+     * ************************/
+    CBMParquetFile::CBMParquetFile(
+        const std::string& path,
+        const std::vector<std::string>& columnNames,
+        const std::vector<FlatColumnType>& columnTypes,
+        const std::string& compression,
+        Int64 rowGroupSize)
+        : _impl(std::make_unique<Impl>(path, columnNames, columnTypes, compression, rowGroupSize)) { }
+
+    CBMParquetFile::~CBMParquetFile() = default;
+
+    /**
+     * Return the visitor that appends a record's columns to the pending row group
+     *
+     * @return FlatRecordColumnVisitor&
+     * ************************/
+    FlatRecordColumnVisitor& CBMParquetFile::rowBuilder() {
+        return *_impl;
+    }
+
+    /**
+     * End the row being added through rowBuilder(); throws std::runtime_error if the record had fewer \n
+     * columns than the file's schema. Columns of the wrong type or extra columns throw as they are added.
+     *
+     * @return void
+     * ************************/
+    void CBMParquetFile::endRow() {
+        _impl->endRow();
+    }
+
+    /**
+     * Write the pending rows out as a new row group
+     *
+     * @return void
+     * ************************/
+    void CBMParquetFile::writeRowGroup() {
+        _impl->writeRowGroup();
+    }
+
+    /**
+     * Write the file footer and move the file to its final path
+     *
+     * @return void
+     * ************************/
+    void CBMParquetFile::save() {
+        _impl->save();
+    }
+
+    /**
+     * Configuration function
+     *
+     * Assign CBMAggregatorParquetWriter._outputPath value of "output_path" in parameter config, \n
+     * CBMAggregatorParquetWriter._separateYears value of "separate_years", CBMAggregatorParquetWriter._compression \n
+     * value of "compression" and CBMAggregatorParquetWriter._rowGroupSize value of "row_group_size", if they exist \n
+     * in parameter config. Streaming is configured the same way as the other writers
+     *
+     * @param config DynamicObject&
+     * @return void
+     * ************************/
+    void CBMAggregatorParquetWriter::configure(const DynamicObject& config) {
+        _outputPath = config["output_path"].convert<std::string>();
+        if (config.contains("separate_years")) {
+            _separateYears = config["separate_years"].convert<bool>();
+        }
+
+        if (config.contains("compression")) {
+            _compression = config["compression"].convert<std::string>();
+        }
+
+        if (config.contains("row_group_size")) {
+            _rowGroupSize = config["row_group_size"].convert<Int64>();
+        }
+
+        _flushCoordinator->configure(config);
+    }
+
+    /**
+     * Subscribe to the signals SystemInit, LocalDomainInit and SystemShutdown
+     *
+     * @param notificationCenter NotificationCenter&
+     * @return void
+     * ************************/
+    void CBMAggregatorParquetWriter::subscribe(NotificationCenter& notificationCenter) {
+        notificationCenter.subscribe(signals::SystemInit,      &CBMAggregatorParquetWriter::onSystemInit,      *this);
+        notificationCenter.subscribe(signals::LocalDomainInit, &CBMAggregatorParquetWriter::onLocalDomainInit, *this);
+        notificationCenter.subscribe(signals::SystemShutdown,  &CBMAggregatorParquetWriter::onSystemShutdown,  *this);
+    }
+
+    /**
+     * If CBMAggregatorParquetWriter._isPrimaryAggregator is true, then create the output directory, and if streaming \n
+     * is enabled, register CBMAggregatorParquetWriter.flush() with CBMAggregatorParquetWriter._flushCoordinator
+     *
+     * @return void
+     * ************************/
+    void CBMAggregatorParquetWriter::doSystemInit() {
+        if (!_isPrimaryAggregator) {
+            return;
+        }
+
+        Poco::File outputDir(_outputPath);
+        try {
+            outputDir.createDirectories();
+        } catch (Poco::FileExistsException&) { }
+
+        if (_flushCoordinator->isEnabled()) {
+            _flushCoordinator->addFlushHandler(
+                [this]() { flush(); },
+                [this]() {
+                    _fluxDimension->clear();
+                    _poolDimension->clear();
+                    _ageDimension->clear();
+                });
+        }
+    }
+
+    /**
+     * Assign CBMAggregatorParquetWriter._jobId the value of variable "job_id" in _landUnitData, if it exists, else to 0
+     *
+     * @return void
+     * ************************/
+    void CBMAggregatorParquetWriter::doLocalDomainInit() {
+        _jobId = _landUnitData->hasVariable("job_id")
+            ? _landUnitData->getVariable("job_id")->value().convert<Int64>()
+            : 0;
+    }
+
+    /**
+     * Write the pending batch of flux, pool and age records as new row groups. Called by \n
+     * CBMAggregatorParquetWriter._flushCoordinator while no aggregator is accumulating.
+     *
+     * @return void
+     * ************************/
+    void CBMAggregatorParquetWriter::flush() {
+        if (_classifierNames->empty()) {
+            return;
+        }
+
+        write((boost::format("%1%/flux") % _outputPath).str(), (boost::format("flux_%1%") % _jobId).str(), _fluxDimension);
+        write((boost::format("%1%/pool") % _outputPath).str(), (boost::format("pool_%1%") % _jobId).str(), _poolDimension);
+        write((boost::format("%1%/age")  % _outputPath).str(), (boost::format("age_%1%")  % _jobId).str(), _ageDimension);
+    }
+
+    /**
+     * If CBMAggregatorParquetWriter._isPrimaryAggregator is true and CBMAggregatorParquetWriter._classifierNames is not empty, \n
+     * write the remaining flux, pool, error, age and disturbance data and save the output files
+     *
+     * @return void
+     * ************************/
+    void CBMAggregatorParquetWriter::doSystemShutdown() {
+        if (!_isPrimaryAggregator) {
+            return;
+        }
+
+        if (_classifierNames->empty()) {
+            MOJA_LOG_INFO << "No data to load.";
+            return;
+        }
+
+        _flushCoordinator->withFlushLock([this]() {
+            write((boost::format("%1%/flux")        % _outputPath).str(), (boost::format("flux_%1%")        % _jobId).str(), _fluxDimension);
+            write((boost::format("%1%/pool")        % _outputPath).str(), (boost::format("pool_%1%")        % _jobId).str(), _poolDimension);
+            write((boost::format("%1%/error")       % _outputPath).str(), (boost::format("error_%1%")       % _jobId).str(), _errorDimension);
+            write((boost::format("%1%/age")         % _outputPath).str(), (boost::format("age_%1%")         % _jobId).str(), _ageDimension);
+            write((boost::format("%1%/disturbance") % _outputPath).str(), (boost::format("disturbance_%1%") % _jobId).str(), _disturbanceDimension);
+
+            for (auto& parquetFile : _parquetFiles) {
+                parquetFile.second->save();
+            }
+
+            _parquetFiles.clear();
+        });
+
+        MOJA_LOG_INFO << "Finished loading results." << std::endl;
+    }
+
+    /**
+     * Return the output file for parameter outputFilename, creating it the first time it is requested with \n
+     * a schema taken from parameter firstRecord; later records are checked against it as they are written. If CBMAggregatorParquetWriter._separateYears is true, each year \n
+     * goes into its own subdirectory and file.
+     *
+     * @param outputPath string&
+     * @param outputFilename string&
+     * @param year int
+     * @param firstRecord TRecord&
+     * @return shared_ptr<CBMParquetFile>
+     * ************************/
+    template<typename TRecord>
+    std::shared_ptr<CBMParquetFile> CBMAggregatorParquetWriter::getParquetFile(
+        const std::string& outputPath,
+        const std::string& outputFilename,
+        int year,
+        const TRecord& firstRecord) {
+
+        auto directory = _separateYears ? (boost::format("%1%/%2%") % outputPath % year).str() : outputPath;
+        auto parquetOutputPath = _separateYears
+            ? (boost::format("%1%/%2%_%3%.parquet") % directory % outputFilename % year).str()
+            : (boost::format("%1%/%2%.parquet") % directory % outputFilename).str();
+
+        auto it = _parquetFiles.find(parquetOutputPath);
+        if (it != _parquetFiles.end()) {
+            return it->second;
+        }
+
+        Poco::File outputDir(directory);
+        try {
+            outputDir.createDirectories();
+        } catch (Poco::FileExistsException&) {}
+
+        ColumnTypeCollector columnTypes;
+        firstRecord.visitColumns(columnTypes);
+
+        auto parquetFile = std::make_shared<CBMParquetFile>(
+            parquetOutputPath, columnNames(firstRecord.header(*_classifierNames)),
+            columnTypes.types, _compression, _rowGroupSize);
+
+        _parquetFiles[parquetOutputPath] = parquetFile;
+
+        return parquetFile;
+    }
+
+    /**
+     * Write the records in parameter dataDimension, one row group per year
+     *
+     * @param outputPath string&
+     * @param outputFilename string&
+     * @param dataDimension shared_ptr<TAccumulator>
+     * @return void
+     * ************************/
+    template<typename TAccumulator>
+    void CBMAggregatorParquetWriter::write(
+        const std::string& outputPath,
+        const std::string& outputFilename,
+        std::shared_ptr<TAccumulator> dataDimension) {
+
+        MOJA_LOG_INFO << (boost::format("Loading %1%") % outputPath).str();
+
+        const auto& records = dataDimension->records();
+        using TRecord = std::decay_t<decltype(*std::begin(records))>;
+
+        std::map<int, std::vector<const TRecord*>> recordsByYear;
+        for (auto& record : records) {
+            recordsByYear[record.getYear()].push_back(&record);
+        }
+
+        for (const auto& yearRecords : recordsByYear) {
+            auto year = _separateYears ? yearRecords.first : 0;
+            auto parquetFile = getParquetFile(outputPath, outputFilename, year, *yearRecords.second.front());
+            auto& row = parquetFile->rowBuilder();
+            for (auto record : yearRecords.second) {
+                record->visitColumns(row);
+                parquetFile->endRow();
+            }
+
+            parquetFile->writeRowGroup();
+        }
+    }
+
+}}} // namespace moja::modules::cbm
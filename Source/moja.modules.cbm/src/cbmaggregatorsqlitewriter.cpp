@@ -20,6 +20,8 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 
+#include <algorithm>
+
 using namespace Poco::Data::Keywords;
 using Poco::Data::Session;
 using Poco::Data::Statement;
@@ -35,7 +37,10 @@ namespace cbm {
     /**
     * Configuration function
     *
-    * Initialize CBMAggregatorSQLiteWriter._dbName as variable "databasename" in parameter config
+    * Initialize CBMAggregatorSQLiteWriter._dbName as variable "databasename" in parameter config. \n
+    * If parameter config contains "flush_record_count" or "flush_memory_mb", enable streaming: the Pools, \n
+    * Fluxes and AgeArea tables are then written in batches during the simulation, together with the new \n
+    * dimension records they refer to, instead of all at once at shutdown
     *
     * @param config DynamicObject&
     * @return void
@@ -43,6 +48,7 @@ namespace cbm {
 
     void CBMAggregatorSQLiteWriter::configure(const DynamicObject& config) {
         _dbName = config["databasename"].convert<std::string>();
+        _flushCoordinator->configure(config);
     }
 
     /**
@@ -59,23 +65,70 @@ namespace cbm {
 
 	/**
 	*
-	* If CBMAggregatorSQLiteWriter._isPrimaryAggregator is true, remove the database name
+	* If CBMAggregatorSQLiteWriter._isPrimaryAggregator is true, remove the database name, and if streaming \n
+	* is enabled, register CBMAggregatorSQLiteWriter.flush() with CBMAggregatorSQLiteWriter._flushCoordinator. \n
+	* After each flush the fact records are released, and so are the location and disturbance dimensions, \n
+	* which grow with the simulation; their Id offsets move past the last Ids written.
 	*
 	* @return void
 	* ************************/
 	void CBMAggregatorSQLiteWriter::doSystemInit() {
 		if (_isPrimaryAggregator) {
 			std::remove(_dbName.c_str());
+
+			if (_flushCoordinator->isEnabled()) {
+				_flushCoordinator->addFlushHandler(
+					[this]() { flush(); },
+					[this]() {
+						_poolDimension->clear();
+						_fluxDimension->clear();
+						_ageAreaDimension->clear();
+
+						_locationDimension->clear();
+						_flushCoordinator->setIdOffset(
+							RecordFlushCoordinator::ReleasedDimension::Location, _lastDimensionIds["LocationDimension"]);
+
+						_disturbanceDimension->clear();
+						_flushCoordinator->setIdOffset(
+							RecordFlushCoordinator::ReleasedDimension::Disturbance, _lastDimensionIds["DisturbanceDimension"]);
+					});
+			}
 		}
 	}
 
-	
+	/**
+	* Write the pending batch of Pools, Fluxes and AgeArea records, preceded by any dimension records \n
+	* they refer to. Called by CBMAggregatorSQLiteWriter._flushCoordinator while no aggregator is accumulating.
+	*
+	* @return void
+	* ************************/
+	void CBMAggregatorSQLiteWriter::flush() {
+		if (_classifierNames->empty()) {
+			return;
+		}
+
+		MOJA_LOG_INFO << (boost::format("Flushing results into %1%") % _dbName).str();
+		SQLite::Connector::registerConnector();
+		{
+			Session session("SQLite", _dbName);
+			if (!_tablesCreated) {
+				createTables(session);
+			}
+
+			loadDimensions(session);
+			loadFacts(session);
+		}
+
+		Poco::Data::SQLite::Connector::unregisterConnector();
+	}
+
    /**
     *
     * If CBMAggregatorSQLiteWriter._isPrimaryAggregator, creates unlogged tables for the DateDimension, LandClassDimension, \n
-	* PoolDimension, ClassifierSetDimension, ModuleInfoDimension, LocationDimension, DisturbanceTypeDimension, \n
+	* PoolDimension, ClassifierSetDimension, ModuleInfoDimension, LocationDimension, DisturbanceTypeDimension, \n
     * DisturbanceDimension, Pools, Fluxes, ErrorDimension, AgeClassDimension, LocationErrorDimension, \n
-	* and AgeArea if they do not already exist, and loads data into these tables on SQL.
+	* and AgeArea if they do not already exist, and loads data into these tables on SQL. \n
+	* When streaming, only the records accumulated since the last flush are added to the fact tables.
     *
     * @return void
     * ************************/	
@@ -91,8 +144,29 @@ namespace cbm {
 
         MOJA_LOG_INFO << (boost::format("Loading results into %1%") % _dbName).str();
 		SQLite::Connector::registerConnector();
-		Session session("SQLite", _dbName);
+		_flushCoordinator->withFlushLock([this]() {
+			Session session("SQLite", _dbName);
+			if (!_tablesCreated) {
+				createTables(session);
+			}
+
+			loadDimensions(session);
+			loadFacts(session);
+			load(session, "ErrorDimension",		    _errorDimension);
+			load(session, "LocationErrorDimension", _locationErrorDimension);
+		});
+
+        Poco::Data::SQLite::Connector::unregisterConnector();
+        MOJA_LOG_INFO << "SQLite insert complete." << std::endl;
+    }
 
+	/**
+	* Create the output tables in the database opened by parameter session
+	*
+	* @param session Session&
+	* @return void
+	* ************************/
+	void CBMAggregatorSQLiteWriter::createTables(Poco::Data::Session& session) {
 		std::vector<std::string> ddl{
             "PRAGMA foreign_keys=ON",
 			(boost::format("CREATE TABLE ClassifierSetDimension (id UNSIGNED BIG INT PRIMARY KEY, %1% VARCHAR)") % boost::join(*_classifierNames, " VARCHAR, ")).str(),
@@ -117,6 +191,20 @@ namespace cbm {
 			});
 		}
 
+		_tablesCreated = true;
+	}
+
+	/**
+	* Load the dimension tables referenced by the fact tables. \n
+	* Only the records added since the last flush are written: the dimensions that are kept for the whole \n
+	* simulation number their records in order, so these are the ones past the last Id written, and the \n
+	* location and disturbance dimensions only hold this batch's records since they are released after each \n
+	* flush; see CBMAggregatorSQLiteWriter.loadReleased().
+	*
+	* @param session Session&
+	* @return void
+	* ************************/
+	void CBMAggregatorSQLiteWriter::loadDimensions(Poco::Data::Session& session) {
         std::vector<std::string> csetPlaceholders;
         auto classifierCount = _classifierNames->size();
         for (auto i = 0; i < classifierCount; i++) {
@@ -126,8 +214,14 @@ namespace cbm {
         auto csetSql = (boost::format("INSERT INTO ClassifierSetDimension VALUES (?, %1%)")
             % boost::join(csetPlaceholders, ", ")).str();
 
-		tryExecute(session, [this, &csetSql, &classifierCount](auto& sess) {
+		auto& lastCSetId = _lastDimensionIds["ClassifierSetDimension"];
+		tryExecute(session, [this, &csetSql, &classifierCount, &lastCSetId](auto& sess) {
+			Int64 maxId = lastCSetId;
 			for (auto cset : this->_classifierSetDimension->getPersistableCollection()) {
+				if (cset.get<0>() <= lastCSetId) {
+					continue;
+				}
+
 				Statement insert(sess);
 				insert << csetSql, bind(cset.get<0>());
 				auto values = cset.get<1>();
@@ -136,7 +230,10 @@ namespace cbm {
 				}
 
 				insert.execute();
+				maxId = std::max(maxId, cset.get<0>());
 			}
+
+			lastCSetId = maxId;
 		});
 
 		load(session, "DateDimension",		      _dateDimension);
@@ -144,38 +241,176 @@ namespace cbm {
 		load(session, "LandClassDimension",       _landClassDimension);
 		load(session, "ModuleInfoDimension",      _moduleInfoDimension);
         load(session, "AgeClassDimension",        _ageClassDimension);
-        load(session, "LocationDimension",	      _locationDimension);
+        loadReleased(session, "LocationDimension", _locationDimension,
+            RecordFlushCoordinator::ReleasedDimension::Location, [](const TemporalLocationRow& row) {
+                return std::make_tuple(row.get<1>(), row.get<2>(), row.get<3>(), row.get<4>().value(-1));
+            });
+
         load(session, "DisturbanceTypeDimension", _disturbanceTypeDimension);
-		load(session, "DisturbanceDimension",     _disturbanceDimension);
-		load(session, "Pools",				      _poolDimension);
-		load(session, "Fluxes",				      _fluxDimension);
-		load(session, "ErrorDimension",		      _errorDimension);
-		load(session, "LocationErrorDimension",   _locationErrorDimension);
-		load(session, "AgeArea",				  _ageAreaDimension);
+        loadReleased(session, "DisturbanceDimension", _disturbanceDimension,
+            RecordFlushCoordinator::ReleasedDimension::Disturbance, [](const DisturbanceRow& row) {
+                return std::make_tuple(row.get<1>(), row.get<2>(), row.get<3>(), Int64(0));
+            });
+	}
 
-        Poco::Data::SQLite::Connector::unregisterConnector();
-        MOJA_LOG_INFO << "SQLite insert complete." << std::endl;
-    }
+	/**
+	* Load the Pools, Fluxes and AgeArea fact tables.
+	*
+	* @param session Session&
+	* @return void
+	* ************************/
+	void CBMAggregatorSQLiteWriter::loadFacts(Poco::Data::Session& session) {
+		loadFacts(session, "Pools",   _poolDimension);
+		loadFacts(session, "Fluxes",  _fluxDimension);
+		loadFacts(session, "AgeArea", _ageAreaDimension);
+	}
 
 	/**
-	* Load persistable collecton data into the table using SQL
+	* Load persistable collecton data into the table using SQL. \n
+	* Parameter idOffset is added to each record's Id, and records whose Id is no greater than the last Id \n
+	* written to the table are skipped, so every record is written once.
 	* 
 	* @param session Session&
 	* @param table string&
 	* @param dataDimension shared_ptr<TAccumulator>
+	* @param idOffset Int64
 	* @return void
 	* ************************/
 
 	template<typename TAccumulator>
 	void CBMAggregatorSQLiteWriter::load(
+			Poco::Data::Session& session,
+			const std::string& table,
+			std::shared_ptr<TAccumulator> dataDimension,
+			Int64 idOffset) {
+
+		MOJA_LOG_INFO << (boost::format("Loading %1%") % table).str();
+		auto& lastId = _lastDimensionIds[table];
+		tryExecute(session, [table, dataDimension, idOffset, &lastId](auto& sess) {
+			auto rows = dataDimension->getPersistableCollection();
+			decltype(rows) data;
+			Int64 maxId = lastId;
+			for (auto& row : rows) {
+				row.template set<0>(row.template get<0>() + idOffset);
+				if (row.template get<0>() > lastId) {
+					maxId = std::max(maxId, row.template get<0>());
+					data.push_back(row);
+				}
+			}
+
+			if (!data.empty()) {
+				std::vector<std::string> placeholders;
+				for (auto i = 0; i < data[0].length; i++) {
+					placeholders.push_back("?");
+				}
+
+				auto sql = (boost::format("INSERT INTO %1% VALUES (%2%)")
+					% table % boost::join(placeholders, ", ")).str();
+
+				sess << sql, use(data), now;
+				lastId = maxId;
+			}
+		});
+	}
+
+	/**
+	* Load the rows of a dimension that is released after each streaming flush into the table. \n
+	* Parameter idOffset of parameter dimension is added to each record's Id. A row whose key, given by \n
+	* parameter keyOf, was first written by an earlier batch has a different stable Id in \n
+	* CBMAggregatorSQLiteWriter._flushCoordinator: its area, the last column, is added to that row's \n
+	* instead of writing it again, so each location and disturbance is a single row.
+	*
+	* @param session Session&
+	* @param table string&
+	* @param dataDimension shared_ptr<TAccumulator>
+	* @param dimension RecordFlushCoordinator::ReleasedDimension
+	* @param keyOf TKeyOf, callable returning the RecordFlushCoordinator::ReleasedKey of a row
+	* @return void
+	* ************************/
+
+	template<typename TAccumulator, typename TKeyOf>
+	void CBMAggregatorSQLiteWriter::loadReleased(
+			Poco::Data::Session& session,
+			const std::string& table,
+			std::shared_ptr<TAccumulator> dataDimension,
+			RecordFlushCoordinator::ReleasedDimension dimension,
+			TKeyOf keyOf) {
+
+		MOJA_LOG_INFO << (boost::format("Loading %1%") % table).str();
+		auto& lastId = _lastDimensionIds[table];
+		auto idOffset = _flushCoordinator->idOffset(dimension);
+		tryExecute(session, [this, table, dataDimension, dimension, keyOf, idOffset, &lastId](auto& sess) {
+			auto rows = dataDimension->getPersistableCollection();
+			typedef typename decltype(rows)::value_type Row;
+			const int areaColumn = Row::length - 1;
+
+			decltype(rows) inserts;
+			std::vector<Poco::Tuple<double, Int64>> areaUpdates;
+			Int64 maxId = lastId;
+			for (auto& row : rows) {
+				auto id = row.template get<0>() + idOffset;
+				if (id <= lastId) {
+					continue;
+				}
+
+				maxId = std::max(maxId, id);
+				auto stableId = _flushCoordinator->stableId(dimension, keyOf(row), id);
+				if (stableId == id) {
+					row.template set<0>(id);
+					inserts.push_back(row);
+				} else {
+					areaUpdates.emplace_back(row.template get<areaColumn>(), stableId);
+				}
+			}
+
+			if (!inserts.empty()) {
+				std::vector<std::string> placeholders;
+				for (auto i = 0; i < inserts[0].length; i++) {
+					placeholders.push_back("?");
+				}
+
+				auto sql = (boost::format("INSERT INTO %1% VALUES (%2%)")
+					% table % boost::join(placeholders, ", ")).str();
+
+				sess << sql, use(inserts), now;
+			}
+
+			if (!areaUpdates.empty()) {
+				auto sql = (boost::format("UPDATE %1% SET area = area + ? WHERE id = ?") % table).str();
+				sess << sql, use(areaUpdates), now;
+			}
+
+			lastId = maxId;
+		});
+	}
+
+	/**
+	* Load a batch of fact records into the table. Ids are offset past the highest Id written to the table \n
+	* by earlier batches, since the accumulator is cleared after each streaming flush.
+	*
+	* @param session Session&
+	* @param table string&
+	* @param dataDimension shared_ptr<TAccumulator>
+	* @return void
+	* ************************/
+
+	template<typename TAccumulator>
+	void CBMAggregatorSQLiteWriter::loadFacts(
 			Poco::Data::Session& session,
 			const std::string& table,
 			std::shared_ptr<TAccumulator> dataDimension) {
 
 		MOJA_LOG_INFO << (boost::format("Loading %1%") % table).str();
-		tryExecute(session, [table, dataDimension](auto& sess) {
+		auto& idOffset = _factIdOffsets[table];
+		tryExecute(session, [table, dataDimension, &idOffset](auto& sess) {
 			auto data = dataDimension->getPersistableCollection();
 			if (!data.empty()) {
+				Int64 maxId = idOffset;
+				for (auto& row : data) {
+					row.template set<0>(row.template get<0>() + idOffset);
+					maxId = std::max(maxId, row.template get<0>());
+				}
+
 				std::vector<std::string> placeholders;
 				for (auto i = 0; i < data[0].length; i++) {
 					placeholders.push_back("?");
@@ -185,6 +420,7 @@ namespace cbm {
 					% table % boost::join(placeholders, ", ")).str();
 
 				sess << sql, use(data), now;
+				idOffset = maxId;
 			}
 		});
 	}
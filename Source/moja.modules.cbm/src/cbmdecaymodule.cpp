@@ -24,6 +24,33 @@ namespace moja {
 	namespace modules {
 		namespace cbm {
 
+			/**
+			* Constructor
+			*
+			* Bind the soil, snag and atmosphere pools, and the variables "spinup_moss_only", "is_decaying", \n
+			* "mean_annual_temperature" and, if they exist, "enable_peatland" and "peatland_class", read on every step
+			* ************************/
+			CBMDecayModule::CBMDecayModule() : CBMModuleBase() {
+				bindPool("AboveGroundVeryFastSoil", _pools.aboveGroundVeryFastSoil);
+				bindPool("BelowGroundVeryFastSoil", _pools.belowGroundVeryFastSoil);
+				bindPool("AboveGroundFastSoil", _pools.aboveGroundFastSoil);
+				bindPool("BelowGroundFastSoil", _pools.belowGroundFastSoil);
+				bindPool("MediumSoil", _pools.mediumSoil);
+				bindPool("AboveGroundSlowSoil", _pools.aboveGroundSlowSoil);
+				bindPool("BelowGroundSlowSoil", _pools.belowGroundSlowSoil);
+				bindPool("SoftwoodStemSnag", _pools.softwoodStemSnag);
+				bindPool("SoftwoodBranchSnag", _pools.softwoodBranchSnag);
+				bindPool("HardwoodStemSnag", _pools.hardwoodStemSnag);
+				bindPool("HardwoodBranchSnag", _pools.hardwoodBranchSnag);
+				bindPool("CO2", _pools.atmosphere);
+
+				bindVariable("spinup_moss_only", _spinupMossOnly);
+				bindVariable("is_decaying", _isDecaying);
+				bindVariable("mean_annual_temperature", _meanAnnualTemperature);
+				bindVariable("enable_peatland", _enablePeatland, true);
+				bindVariable("peatland_class", _peatlandClass, true);
+			}
+
 			/**
             * Configuration function
 			* 
@@ -54,99 +81,14 @@ namespace moja {
 
 
 			/**
-			* Transfer between source and destination pools (Overloaded function)
-			* 
-			* Initialise the double variables decayRate and proptoatmosphere from CBMDecayModule._decayParameters \n
-			* Invoke addTransfer() method on parameter operation, using arguments poolSrc, CBMDecayModule._atmosphere, poolDest \n
-			* and variables decayRate and propToAtmosphere.
-			* 
-			* @param operation shared_ptr<Ioperation>
-			* @param meanAnnualTemperature double
-			* @param domPool string&
-			* @param poolSrc IPool*
-			* @param poolDest IPool*
-			* @return void
-			* ************************/
-			void CBMDecayModule::getTransfer(std::shared_ptr<flint::IOperation> operation,
-				double meanAnnualTemperature,
-				const std::string& domPool,
-				const flint::IPool* poolSrc,
-				const flint::IPool* poolDest) {
-				double decayRate = _decayParameters[domPool].getDecayRate(meanAnnualTemperature);
-				double propToAtmosphere = _decayParameters[domPool].pAtm;
-				operation->addTransfer(poolSrc, poolDest, decayRate * (1 - propToAtmosphere))
-					->addTransfer(poolSrc, _atmosphere, decayRate * propToAtmosphere);
-			}
-
-			/**
-			* Transfer between source and destination pools (Overloaded Operation)
 			*
-			* Initialise the double variables decayRate and proptoatmosphere from CBMDecayModule._decayParameters \n
-			* Get the additional removals from the amount decayed to the atmosphere and add transfer to the operation \n
-			* using the parameter(pool),dstPool,decayRate and dstProps.
-			* Add transfer to operation parameter using the parameters(pool,_atmopshere), decayRate and
-			* propToAtmosphere.
-			* 
-			* @param operation shared_ptr<Ioperation>
-			* @param meanAnnualTemperature double
-			* @param domPool string&
-			* @param pool IPool*
-			* @return void
-			* ************************/
-
-			void CBMDecayModule::getTransfer(std::shared_ptr<flint::IOperation> operation,
-				double meanAnnualTemperature,
-				const std::string& domPool,
-				const flint::IPool* pool) {
-				double decayRate = _decayParameters[domPool].getDecayRate(meanAnnualTemperature);
-				double propToAtmosphere = _decayParameters[domPool].pAtm;
-
-				// Decay a proportion of a pool to the atmosphere as well as any additional
-				// removals (dissolved organic carbon, etc.) - additional removals are subtracted
-				// from the amount decayed to the atmosphere.
-				double propRemovals = 0.0;
-				const auto removals = _decayRemovals.find(domPool);
-				if (removals != _decayRemovals.end()) {
-					for (const auto removal : (*removals).second) {
-						const auto dstPool = _landUnitData->getPool(removal.first);
-						const auto dstProp = removal.second;
-						propRemovals += dstProp;
-						operation->addTransfer(pool, dstPool, decayRate * dstProp);
-					}
-				}
-
-				operation->addTransfer(pool, _atmosphere, decayRate * (propToAtmosphere - propRemovals));
-			}
-
-			/**
-			*
-			* Initialise CBMDecayModule._aboveGroundVeryFastSoil, CBMDecayModule._belowGroundVeryFastSoil, \n
-			* CBMDecayModule._aboveGroundFastSoil, CBMDecayModule._belowGroundFastSoil, CBMDecayModule._mediumSoil, CBMDecayModule._aboveGroundSlowSoil, \n
-			* CBMDecayModule._belowGroundSlowSoil, CBMDecayModule._softwoodStemSnag, CBMDecayModule._softwoodBranchSnag, 
-			* CBMDecayModule._hardwoodStemSnag, CBMDecayModule._hardwoodBranchSnag, CBMDecayModule._atmosphere, \n
-			* CBMDecayModule._spinupMossOnly and CBMDecayModule._isDecaying from _landUnitData
-			* Initialise constant variable decayParameterTable and add the values to CBMDecayModule._decayParameters
+			* Initialise constant variable decayParameterTable and add the values to CBMDecayModule._decayParameters, \n
+			* clearing any decay rates computed from the previous parameters
 			*
 			* @return void
 			* ************************/
 
 			void CBMDecayModule::doLocalDomainInit() {
-				_aboveGroundVeryFastSoil = _landUnitData->getPool("AboveGroundVeryFastSoil");
-				_belowGroundVeryFastSoil = _landUnitData->getPool("BelowGroundVeryFastSoil");
-				_aboveGroundFastSoil = _landUnitData->getPool("AboveGroundFastSoil");
-				_belowGroundFastSoil = _landUnitData->getPool("BelowGroundFastSoil");
-				_mediumSoil = _landUnitData->getPool("MediumSoil");
-				_aboveGroundSlowSoil = _landUnitData->getPool("AboveGroundSlowSoil");
-				_belowGroundSlowSoil = _landUnitData->getPool("BelowGroundSlowSoil");
-				_softwoodStemSnag = _landUnitData->getPool("SoftwoodStemSnag");
-				_softwoodBranchSnag = _landUnitData->getPool("SoftwoodBranchSnag");
-				_hardwoodStemSnag = _landUnitData->getPool("HardwoodStemSnag");
-				_hardwoodBranchSnag = _landUnitData->getPool("HardwoodBranchSnag");
-				_atmosphere = _landUnitData->getPool("CO2");
-
-				_spinupMossOnly = _landUnitData->getVariable("spinup_moss_only");
-				_isDecaying = _landUnitData->getVariable("is_decaying");
-
 				const auto decayParameterTable = _landUnitData->getVariable("decay_parameters")->value()
 					.extract<const std::vector<DynamicObject>>();
 
@@ -155,6 +97,28 @@ namespace moja {
 					_decayParameters.emplace(row["pool"].convert<std::string>(),
 						PoolDecayParameters(row));
 				}
+
+				_decayRates.clear();
+			}
+
+			/**
+			* Return the decay rate of each pool in CBMDecayModule._decayParameters at parameter meanAnnualTemperature. \n
+			* The rates for each distinct temperature are computed once and kept in CBMDecayModule._decayRates \n
+			* until the decay parameters are reloaded.
+			*
+			* @param meanAnnualTemperature double
+			* @return map<string, double>&
+			* ************************/
+
+			const std::map<std::string, double>& CBMDecayModule::getDecayRates(double meanAnnualTemperature) {
+				return _decayRates.get(meanAnnualTemperature, [this](double mat) {
+					std::map<std::string, double> rates;
+					for (const auto& parameters : _decayParameters) {
+						rates.emplace(parameters.first, parameters.second.getDecayRate(mat));
+					}
+
+					return rates;
+				});
 			}
 
 			/**
@@ -162,6 +126,7 @@ namespace moja {
 			* Assign CBMDecayModule._slowMixingRate value of variable "slow_ag_to_bg_mixing_rate" in _landUnitData \n
 			* If CBMDecayModule._extraDecayRemovals is true, assign the proportion of transfer between the source and \n
 			* destination pools in CBMDecayModule._decayRemovals \n
+			* Load the land unit's mean annual temperature into CBMDecayModule._meanAnnualTemperature, 0 if it is empty \n
 			* Invoke CBMDecayModule.initPeatland()
 
 			* @return void
@@ -169,6 +134,7 @@ namespace moja {
 
 			void CBMDecayModule::doTimingInit() {
 				_slowMixingRate = _landUnitData->getVariable("slow_ag_to_bg_mixing_rate")->value();
+				_meanAnnualTemperature.load(0.0);
 
 				if (_extraDecayRemovals) {
 					const auto decayRemovalsTable = _landUnitData->getVariable("decay_removals")->value()
@@ -203,13 +169,11 @@ namespace moja {
 			/**
 			*
 			* If CBMDecayModule.shouldRun() is false or CBMDecayModule._skipforPeatland is true, return \n
+			* Look up the decay rates for the mean annual temperature with CBMDecayModule.getDecayRates(). \n
 			* Initialise  proportional operation variables domDecay, soilDecay and soilTurnover. \n
-			* Add domDecay transfer for CBMDecayModule._aboveGroundVeryFastSoil, CBMDecayModule._belowGroundVeryFastSoil, \n
-			* CBMDecayModule._aboveGroundFastSoil, CBMDecayModule._belowGroundFastSoil, CBMDecayModule._mediumSoil, \n
-			* CBMDecayModule._softwoodStemSnag, CBMDecayModule._softwoodBranchSnag, CBMDecayModule._hardwoodStemSnag, CBMDecayModule._hardwoodBranchSnag. \n
-			* Add soilDecay transfer for CBMDecayModule._aboveGroundSlowSoil and CBMDecayModule._belowGroundSlowSoil. \n
-			* Add soilTurnover transfer using CBMDecayModule._aboveGroundSlowSoil, CBMDecayModule._belowGroundSlowSoil and \n 
-			* CBMDecayModule._slowMixingRate values.
+			* Add the dead organic matter decay transfers to domDecay, the slow pool decay transfers (with any \n
+			* CBMDecayModule._decayRemovals) to soilDecay and the slow pool mixing transfer at CBMDecayModule._slowMixingRate \n
+			* to soilTurnover, as defined by DecayTransfers, and apply each operation in turn.
 			* 
 			* @return void
 			* ************************/
@@ -218,32 +182,30 @@ namespace moja {
 					return;
 				}
 
-				auto mat = _landUnitData->getVariable("mean_annual_temperature")->value();
-				auto t = mat.isEmpty() ? 0
-					: mat.type() == typeid(TimeSeries) ? mat.extract<TimeSeries>().value()
-					: mat.convert<double>();
+				const auto& decayRates = getDecayRates(_meanAnnualTemperature.value());
 
 				auto domDecay = _landUnitData->createProportionalOperation();
-				getTransfer(domDecay, t, "AboveGroundVeryFastSoil", _aboveGroundVeryFastSoil, _aboveGroundSlowSoil);
-				getTransfer(domDecay, t, "BelowGroundVeryFastSoil", _belowGroundVeryFastSoil, _belowGroundSlowSoil);
-				getTransfer(domDecay, t, "AboveGroundFastSoil", _aboveGroundFastSoil, _aboveGroundSlowSoil);
-				getTransfer(domDecay, t, "BelowGroundFastSoil", _belowGroundFastSoil, _belowGroundSlowSoil);
-				getTransfer(domDecay, t, "MediumSoil", _mediumSoil, _aboveGroundSlowSoil);
-				getTransfer(domDecay, t, "SoftwoodStemSnag", _softwoodStemSnag, _aboveGroundSlowSoil);
-				getTransfer(domDecay, t, "SoftwoodBranchSnag", _softwoodBranchSnag, _aboveGroundSlowSoil);
-				getTransfer(domDecay, t, "HardwoodStemSnag", _hardwoodStemSnag, _aboveGroundSlowSoil);
-				getTransfer(domDecay, t, "HardwoodBranchSnag", _hardwoodBranchSnag, _aboveGroundSlowSoil);
+				DecayTransfers::addDomDecayTransfers(_pools, decayRates, _decayParameters,
+					[&domDecay](const flint::IPool* source, const flint::IPool* sink, double proportion) {
+						domDecay->addTransfer(source, sink, proportion);
+					});
 				_landUnitData->submitOperation(domDecay);
 				_landUnitData->applyOperations();
 
 				auto soilDecay = _landUnitData->createProportionalOperation();
-				getTransfer(soilDecay, t, "AboveGroundSlowSoil", _aboveGroundSlowSoil);
-				getTransfer(soilDecay, t, "BelowGroundSlowSoil", _belowGroundSlowSoil);
+				DecayTransfers::addSlowDecayTransfers(_pools, decayRates, _decayParameters, _decayRemovals,
+					[this](const std::string& pool) { return _landUnitData->getPool(pool); },
+					[&soilDecay](const flint::IPool* source, const flint::IPool* sink, double proportion) {
+						soilDecay->addTransfer(source, sink, proportion);
+					});
 				_landUnitData->submitOperation(soilDecay);
 				_landUnitData->applyOperations();
 
 				auto soilTurnover = _landUnitData->createProportionalOperation();
-				soilTurnover->addTransfer(_aboveGroundSlowSoil, _belowGroundSlowSoil, _slowMixingRate);
+				DecayTransfers::addSlowMixingTransfers(_pools, _slowMixingRate,
+					[&soilTurnover](const flint::IPool* source, const flint::IPool* sink, double proportion) {
+						soilTurnover->addTransfer(source, sink, proportion);
+					});
 				_landUnitData->submitOperation(soilTurnover);
 				_landUnitData->applyOperations();
 			}
@@ -265,11 +227,8 @@ namespace moja {
 				//always reset to false
 				_skipForPeatland = false;
 
-				if (_landUnitData->hasVariable("enable_peatland") &&
-					_landUnitData->getVariable("enable_peatland")->value()) {
-
-					auto& peatland_class = _landUnitData->getVariable("peatland_class")->value();
-					auto peatlandId = peatland_class.isEmpty() ? -1 : peatland_class.convert<int>();
+				if (_enablePeatland.isBound() && _enablePeatland.value()) {
+					auto peatlandId = _peatlandClass.valueOr(-1);
 
 					bool isOpenPeatland = (
 						peatlandId == (int)Peatlands::OPEN_PEATLAND_BOG ||
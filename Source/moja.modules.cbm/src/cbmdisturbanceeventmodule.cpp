@@ -45,11 +45,17 @@ namespace moja {
 			* If _landUnitData has variable "enable_peatland" and is not null, \n
 			* initialise pools CBMDisturbanceEventModule._woodyFoliageLive, CBMDisturbanceEventModule._woodyStemsBranchesLive, CBMDisturbanceEventModule._woodyRootsLive, \n
 			* CBMDisturbanceEventModule._softwoodStem, CBMDisturbanceEventModule._hardwoodStem and variables
-			* CBMDisturbanceEventModule._shrubAge, CBMDisturbanceEventModule._smalltreeAge from _landUnitData
+			* CBMDisturbanceEventModule._shrubAge, CBMDisturbanceEventModule._smalltreeAge from _landUnitData \n
+			* Index all pools by idx in CBMDisturbanceEventModule._pools
 			*
 			* @return void
 			* ************************/
 			void CBMDisturbanceEventModule::doLocalDomainInit() {
+				_pools.assign(_landUnitData->poolCollection().size(), nullptr);
+				for (const auto pool : _landUnitData->poolCollection()) {
+					_pools[pool->idx()] = pool;
+				}
+
 				_softwoodMerch = _landUnitData->getPool("SoftwoodMerch");
 				_softwoodFoliage = _landUnitData->getPool("SoftwoodFoliage");
 				_softwoodOther = _landUnitData->getPool("SoftwoodOther");
@@ -83,7 +89,8 @@ namespace moja {
 			/**
 			* Get the disturbances and disturbance type codes from parameter n, \n
 			* Invoke createProportionalOperation() on _landUnitData, \n
-			* for each disturbance, add a transfer between the source and destination pools \n
+			* for each transfer in the event's shared disturbance matrix, if any, and then in its "transfers", \n
+			* add a transfer between the source and destination pools \n
 			* Invoke submitOperation() and applyOperations() on _landUnitData \n
 			* If the total biomass is < 0.001, set CBMDisturbanceEventModule._age to 0, \n
 			* if the variable "enable_peatland" is present in _landUnitData and is not null, if the total woody biomass is < 0.001,
@@ -108,6 +115,17 @@ namespace moja {
 					});
 
 				auto disturbanceEvent = _landUnitData->createProportionalOperation(metadata);
+				if (data.contains("disturbance_matrix")) {
+					auto distMatrix = data["disturbance_matrix"].extract<std::shared_ptr<DisturbanceMatrixStore::Matrix>>();
+					for (size_t i = 0; i < distMatrix->size(); i++) {
+						auto srcPool = distMatrix->sourcePool(i);
+						auto dstPool = distMatrix->sinkPool(i);
+						if (srcPool != dstPool) {
+							disturbanceEvent->addTransfer(_pools[srcPool], _pools[dstPool], distMatrix->proportion(i));
+						}
+					}
+				}
+
 				auto transferVec = data["transfers"].extract<std::shared_ptr<std::vector<CBMDistEventTransfer>>>();
 				for (const auto& transfer : *transferVec) {
 					auto srcPool = transfer.sourcePool();
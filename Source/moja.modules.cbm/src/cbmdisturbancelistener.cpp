@@ -36,6 +36,7 @@ namespace moja {
             *
 			* If parameter config has variable "vars", and it is not empty, \n 
 			* add each layer in config["vars"] to CBMDisturbanceListener._layerNames \n
+			* and to the inputs of CBMDisturbanceListener._landUnitTraces, since land units with different events differ. \n
 			* If parameter config has, variable, "conditions", assign the value to CBMDisturbanceListener._conditionConfig \n
 			* else assign the result of DynamicVar()
 			* 
@@ -52,6 +53,8 @@ namespace moja {
 					_layerNames.push_back(layerName);
 				}
 
+				_landUnitTraces->addInputs(_layerNames);
+
 				_conditionConfig = config.contains("conditions") ? config["conditions"] : DynamicVar();
 			}
 
@@ -75,8 +78,6 @@ namespace moja {
 			* Add layerNames to CBMDisturbanceListener._layers variable.
 			* Invoke CBMDisturbanceListener.fetchMatrices(), CBMDisturbanceListener.fetchDMAssoiciations(), CBMDisturbanceListener.fetchLandClassTransistions(),
 			* CBMDisturbanceListener.fetchDistTypeCodes(), CBMDisturbanceListener.fetchPeatlandDMAssociations() and CBMDisturbanceListener.fetchDisturbanceOrder().
-			* Initialise CBMDisturbanceListener._landClass, CBMDisturbanceListener._spu, CBMDisturbanceListener._classifierSet, CBMDisturbanceListener._age.
-			* from _landUnitData
 			* 
 			* @return void
 			* ************************/
@@ -92,11 +93,6 @@ namespace moja {
 				fetchDistTypeCodes();
 				fetchPeatlandDMAssociations();
 				fetchDisturbanceOrder();
-
-				_landClass = _landUnitData->getVariable("current_land_class");
-				_spu = _landUnitData->getVariable("spatial_unit_id");
-				_classifierSet = _landUnitData->getVariable("classifier_set");
-				_age = _landUnitData->getVariable("age");
 			}
 
 			/**
@@ -144,7 +140,7 @@ namespace moja {
 			* For each event in CBMDisturbanceListener._layers if CBMDisturbanceListener.addLandUnitEvent with parameter event is false, then \n
 			* the layer is added to CBMDisturbanceListener._errorLayers
 			* 
-			* Perform a stable_sort on each event year in CBMDisturbanceListener._landUnitEvents
+			* Sort CBMDisturbanceListener._landUnitEvents by year and disturbance order
 			* 
 			* @return void
 			**************************/
@@ -212,8 +208,10 @@ namespace moja {
 				}
 
 				_landUnitEvents.clear();
+				_eventConditions.clear();
 				// Pre-load every disturbance event for this land unit.
-				for (const auto layer : _layers) {
+				for (size_t layerIdx = 0; layerIdx < _layers.size(); layerIdx++) {
+					const auto layer = _layers[layerIdx];
 					const auto& events = layer->value();
 					if (events.isEmpty()) {
 						continue;
@@ -221,12 +219,15 @@ namespace moja {
 
 					bool success = true;
 					if (events.isVector()) {
-						for (const auto& event : events.extract<const std::vector<DynamicObject>>()) {
-							success = addLandUnitEvent(event);
+						const auto& layerEvents = events.extract<const std::vector<DynamicObject>>();
+						for (size_t eventIdx = 0; eventIdx < layerEvents.size(); eventIdx++) {
+							success = addLandUnitEvent(
+								layerEvents[eventIdx], static_cast<int>(layerIdx), static_cast<int>(eventIdx));
 						}
 					}
 					else {
-						success = addLandUnitEvent(events);
+						success = events.isStruct() && addLandUnitEvent(
+							events.extract<DynamicObject>(), static_cast<int>(layerIdx), -1);
 					}
 
 					if (!success) {
@@ -234,18 +235,42 @@ namespace moja {
 					}
 				}
 
-				for (auto& eventYear : _landUnitEvents) {
-					std::stable_sort(
-						eventYear.second.begin(), eventYear.second.end(),
-						[this](const CBMDistEventRef& first, const CBMDistEventRef& second
-							) {
-								if (_disturbanceOrder.find(first.disturbanceType()) == _disturbanceOrder.end()) {
-									return false;
-								}
+				_landUnitEvents.sort();
+			}
 
-								return _disturbanceOrder[first.disturbanceType()] < _disturbanceOrder[second.disturbanceType()];
-						});
+			/**
+			* Return the interned id of parameter disturbanceType, adding it to CBMDisturbanceListener._disturbanceTypes \n
+			* with its rank in CBMDisturbanceListener._disturbanceOrder, its code in CBMDisturbanceListener._distTypeCodes \n
+			* and the CBMDisturbanceListener._disturbanceConditions that apply to it, in configured order, the first time it is seen. \n
+			* Disturbance types with no configured order sort before every ordered type, and types without a code get -1
+			*
+			* @param disturbanceType string&
+			* @return int
+			* ************************/
+			int CBMDisturbanceListener::disturbanceTypeId(const std::string& disturbanceType) {
+				auto it = _disturbanceTypeIds.find(disturbanceType);
+				if (it != _disturbanceTypeIds.end()) {
+					return it->second;
 				}
+
+				std::vector<size_t> conditions;
+				for (size_t i = 0; i < _disturbanceConditions.size(); i++) {
+					if (_disturbanceConditions[i].appliesTo(disturbanceType)) {
+						conditions.push_back(i);
+					}
+				}
+
+				const auto& order = _disturbanceOrder.find(disturbanceType);
+				const auto& code = _distTypeCodes.find(disturbanceType);
+				_disturbanceTypes.push_back(DisturbanceTypeInfo{
+					disturbanceType,
+					order != _disturbanceOrder.end() ? order->second : 0,
+					code != _distTypeCodes.end() ? code->second : -1,
+					conditions });
+
+				int id = int(_disturbanceTypes.size()) - 1;
+				_disturbanceTypeIds[disturbanceType] = id;
+				return id;
 			}
 
 			/**
@@ -297,28 +322,22 @@ namespace moja {
 			}
 
 			/**
-			 * If parameter eventData is not a structure, return \n
-			 * Get the disturbanceType using  CBMDisturbanceListener.getDisturbanceTypeName(), year and transition Id from parameter eventData, \n
-			 * Extract DynamicObject from parameter eventData and store it in a variable event \n 
+			 * Get the disturbanceType using  CBMDisturbanceListener.getDisturbanceTypeName(), year and transition Id from parameter event, \n
 			 * If event has "conditions" and it is not empty, create a variable to store all the disturbance conditions \n
 			 * for every condition, assign variable varName to condition[0], target to condition[2], 
 			 * targetType to condition[1] that can either take values DisturbanceConditionType::LessThan, DisturbanceConditionType::AtLeast or DisturbanceConditionType::EqualTo \n
 			 * If varName is not found in CBMDisturbanceListener._classifierNames, instantiate an object of VariableDisturbanceSubCondition with CBMDisturbanceListener._classifierSet, targetType, target, varName, \n 
 			 * else instantiate it with variable varName in _landUnitData, targetType, target and append it to conditions \n
-			 * Corresponding to the current year, instantiate an object of CBMDistEventRef with disturbanceType, year, transitionId, conditions, event
-			 * and append it to CBMDisturbanceListener._landUnitEvents
+			 * Append the conditions to CBMDisturbanceListener._eventConditions, and an object of CBMDistEventRef with the interned disturbance type, 
+			 * its order rank, year, transitionId, parameter layer and parameter layerEvent and the range of its conditions to CBMDisturbanceListener._landUnitEvents
 			 * 
-			 * @param eventData DynamicVar& 
+			 * @param event DynamicObject& 
+			 * @param layer int, index of the event's layer in CBMDisturbanceListener._layers
+			 * @param layerEvent int, index of the event in its layer, or -1 when the layer holds a single event
 			 * @return bool
 			 *************************/
-			bool CBMDisturbanceListener::addLandUnitEvent(const DynamicVar& eventData) {
-				if (!eventData.isStruct()) {
-					return false;
-				}
-
-				const auto& event = eventData.extract<DynamicObject>();
-
-				auto disturbanceType = getDisturbanceTypeName(event);
+			bool CBMDisturbanceListener::addLandUnitEvent(const DynamicObject& event, int layer, int layerEvent) {
+				int disturbanceType = disturbanceTypeId(getDisturbanceTypeName(event));
 				int year = event["year"];
 
 				int transitionId = -1;
@@ -326,7 +345,7 @@ namespace moja {
 					transitionId = event["transition"];
 				}
 
-				std::vector<std::shared_ptr<IDisturbanceSubCondition>> conditions;
+				size_t firstCondition = _eventConditions.size();
 				if (event.contains("conditions") && !event["conditions"].isEmpty()) {
 					for (const auto& condition : event["conditions"]) {
 						std::string varName = condition[0];
@@ -336,25 +355,57 @@ namespace moja {
 						DynamicVar target = condition[2];
 
 						if (_classifierNames.find(varName) != _classifierNames.end()) {
-							conditions.push_back(std::make_shared<VariableDisturbanceSubCondition>(
+							_eventConditions.push_back(std::make_shared<VariableDisturbanceSubCondition>(
 								_classifierSet, targetType, target, varName));
 						}
 						else {
-							conditions.push_back(std::make_shared<VariableDisturbanceSubCondition>(
+							_eventConditions.push_back(std::make_shared<VariableDisturbanceSubCondition>(
 								_landUnitData->getVariable(varName), targetType, target));
 						}
 					}
 				}
 
-				_landUnitEvents[year].push_back(CBMDistEventRef(
-					disturbanceType, year, transitionId, conditions, event));
+				_landUnitEvents.push(CBMDistEventRef(
+					disturbanceType, _disturbanceTypes[disturbanceType].order, year, transitionId,
+					layer, layerEvent, firstCondition, _eventConditions.size() - firstCondition));
 
 				return true;
 			}
 
+			/**
+			* Return true if every condition of parameter e in CBMDisturbanceListener._eventConditions is met
+			*
+			* @param e CBMDistEventRef&
+			* @return bool
+			* ************************/
+			bool CBMDisturbanceListener::checkConditions(const CBMDistEventRef& e) const {
+				for (size_t i = e.firstCondition(); i < e.firstCondition() + e.conditionCount(); i++) {
+					if (!_eventConditions[i]->check()) {
+						return false;
+					}
+				}
+
+				return true;
+			}
+
+			/**
+			* Return the attributes of parameter e, read from its layer in CBMDisturbanceListener._layers
+			*
+			* @param e CBMDistEventRef&
+			* @return DynamicObject&
+			* ************************/
+			const DynamicObject& CBMDisturbanceListener::eventMetadata(const CBMDistEventRef& e) const {
+				const auto& events = _layers[e.layer()]->value();
+				if (e.layerEvent() < 0) {
+					return events.extract<DynamicObject>();
+				}
+
+				return events.extract<const std::vector<DynamicObject>>()[e.layerEvent()];
+			}
+
 			/**
 			* For each event in CBMDisturbanceListener._landUnitEvents of the current year, invoke CBMDisturbanceListener.checkConditions() \n
-			* If it is true, then for each condition in CBMDisturbanceListener._disturbanceConditions, if it is applicable, \n
+			* If it is true, then for each condition in CBMDisturbanceListener._disturbanceConditions for the event's disturbance type, if it is applicable, \n
 			* it is assigned to variable result of DisturbanceConditionResult \n
 			* Apply the first matching condition from each category (run/override), conditions are prioritized in the order they're configured.
 			*
@@ -367,16 +418,19 @@ namespace moja {
 				const auto& timing = _landUnitData->timing();
 				auto currentYear = timing->curStartDate().year();
 
-				for (auto& e : _landUnitEvents[currentYear]) {
-					if (!e.checkConditions()) {
+				auto events = _landUnitEvents.eventsIn(currentYear);
+				for (auto it = events.first; it != events.second; ++it) {
+					auto& e = *it;
+					if (!checkConditions(e)) {
 						MOJA_LOG_DEBUG << (boost::format("Conditions not met for %1% in %2% - skipped")
-							% e.disturbanceType() % currentYear).str();
+							% _disturbanceTypes[e.disturbanceTypeId()].name % currentYear).str();
 						continue;
 					}
 
 					DisturbanceConditionResult result;
-					for (auto& condition : _disturbanceConditions) {
-						if (!condition.isApplicable(e.disturbanceType())) {
+					for (auto conditionIdx : _disturbanceTypes[e.disturbanceTypeId()].conditions) {
+						const auto& condition = _disturbanceConditions[conditionIdx];
+						if (!condition.isApplicable()) {
 							continue;
 						}
 
@@ -387,27 +441,19 @@ namespace moja {
 
 					if (result.hadRunConditions && !result.shouldRun) {
 						MOJA_LOG_DEBUG << (boost::format("Conditions not met for %1% in %2% - skipped")
-							% e.disturbanceType() % currentYear).str();
+							% _disturbanceTypes[e.disturbanceTypeId()].name % currentYear).str();
 						continue;
 					}
 
 					if (result.newDisturbanceType != "") {
-						e.setDisturbanceType(result.newDisturbanceType);
-					}
-
-					int disturbanceTypeCode = -1;
-					const auto& code = _distTypeCodes.find(e.disturbanceType());
-					if (code != _distTypeCodes.end()) {
-						disturbanceTypeCode = code->second;
+						e.setDisturbanceTypeId(disturbanceTypeId(result.newDisturbanceType));
 					}
 
 					// Check if running on peatland.
 					bool runPeatland = false;
 					int peatlandId = -1;
-					if (_landUnitData->hasVariable("enable_peatland") &&
-						_landUnitData->getVariable("enable_peatland")->value().extract<bool>()) {
-						auto& peatland_class = _landUnitData->getVariable("peatland_class")->value();
-						peatlandId = peatland_class.isEmpty() ? -1 : peatland_class.convert<int>();
+					if (_enablePeatland.isBound() && _enablePeatland.raw().extract<bool>()) {
+						peatlandId = _peatlandClass.valueOr(-1);
 						runPeatland = peatlandId > 0;
 					}
 
@@ -415,7 +461,7 @@ namespace moja {
 						fireCBMDisturbanceEvent(e);
 					}
 					else {
-						std::string disturbanceType = e.disturbanceType();
+						const auto& disturbanceType = _disturbanceTypes[e.disturbanceTypeId()].name;
 
 						//check if the disturbance is applied in this peatland
 						const auto& dmAssociation = _peatlandDmAssociations.find(std::make_pair(peatlandId, disturbanceType));
@@ -436,22 +482,18 @@ namespace moja {
 			 *   
 			 * If the disturbance type of parameter e transitions to a new land class, set CBMDisturbanceListener._landClass to the landClassTransition \n
 			 * Find the disturbance type code corresponding to the disturbance type of parameter e, else set it to 1 \n
-			 * If disturbance is applied in this peatland, prepare the disturbance data object with "disturbance" - e.disturbanceType(), \n
+			 * If disturbance is applied in this peatland, prepare the disturbance data object with "disturbance" - the name of e's disturbance type, \n
 			 * "disturbance_type_code", "transition" - e.transitionRuleId(), "transfers" is a vector of CBMDistEventTransfer, which will be injected by peatland disturbance module \n
 			 * Merge any additional metadata into disturbance data and fire the disturbance events
 			 * 
 			 * @param e CBMDistEventRef&
 			 * @return void
 			 * ********************/
-			void CBMDisturbanceListener::firePeatlandDisturbanceEvent(CBMDistEventRef& e) {
-				int disturbanceTypeCode = -1;
-				const auto& code = _distTypeCodes.find(e.disturbanceType());
-				if (code != _distTypeCodes.end()) {
-					disturbanceTypeCode = code->second;
-				}
+			void CBMDisturbanceListener::firePeatlandDisturbanceEvent(const CBMDistEventRef& e) {
+				const auto& disturbanceType = _disturbanceTypes[e.disturbanceTypeId()];
 
 				// Check if the disturbance transitions to a new land class.
-				const auto& it = _landClassTransitions.find(e.disturbanceType());
+				const auto& it = _landClassTransitions.find(disturbanceType.name);
 				std::string landClassTransition = it != _landClassTransitions.end() ? (*it).second : "";
 
 				if (landClassTransition != "") {
@@ -463,14 +505,14 @@ namespace moja {
 				//if disturbance is applied in this peatland, prepare the event data object
 				//disturbance matrix will be injected by peatland disturbance module
 				auto data = DynamicObject({
-						{ "disturbance", e.disturbanceType() },
-						{ "disturbance_type_code", disturbanceTypeCode },
+						{ "disturbance", disturbanceType.name },
+						{ "disturbance_type_code", disturbanceType.code },
 						{ "transfers", distMatrix },
 						{ "transition", e.transitionRuleId() }
 					});
 
 				// Merge any additional metadata into disturbance data.
-				for (const auto& item : e.metadata()) {
+				for (const auto& item : eventMetadata(e)) {
 					if (!data.contains(item.first)) {
 						data[item.first] = item.second;
 					}
@@ -486,61 +528,62 @@ namespace moja {
 			 * If CBMDisturbanceListener._dmAssociations does not contain the key <disturbance type - from parameter e, spatial unit - value of CBMDisturbanceListener._spu >, return \n
 			 * If the disturbance type of parameter e transitions to a new land class, set CBMDisturbanceListener._landClass to the landClassTransition \n
 			 * Find the disturbance type code corresponding to the disturbance type of parameter e, else set it to 1 \n
-			 * Add all transfers from CBMDisturbanceListener._matrices for the current disturbance id \n
-			 * Prepare the disturbance data object with attributes "disturbance" - e.disturbanceType() , \n 
-			 * "disturbance_type_code", "transfers" - disturbance matrix, "transition" - e.transitionRuleId() \n
-			 * Merge any additional metadata into disturbance data and fire the disturbance events
+			 * Look up the disturbance matrix for the current disturbance id in CBMDisturbanceListener._disturbanceMatrices \n
+			 * Prepare the disturbance data object with attributes "disturbance" - the name of e's disturbance type, \n 
+			 * "disturbance_type_code", "disturbance_matrix" - a view of the shared disturbance matrix, \n
+			 * "transfers" - additional transfers filled in by other modules, "transition" - e.transitionRuleId() \n
+			 * Merge the event's attributes from its layer into disturbance data and fire the disturbance events
 			 * 
 			 * @param e CBMDistEventRef&
 			 * @return void 
 			 * *********************/
-			void CBMDisturbanceListener::fireCBMDisturbanceEvent(CBMDistEventRef& e) {
+			void CBMDisturbanceListener::fireCBMDisturbanceEvent(const CBMDistEventRef& e) {
+				const auto& disturbanceType = _disturbanceTypes[e.disturbanceTypeId()];
+
 				// Find the disturbance matrix for the disturbance type/SPU.
 				int spu = _spu->value();
-				auto key = std::make_pair(e.disturbanceType(), spu);
+				auto key = std::make_pair(disturbanceType.name, spu);
 				const auto& dm = _dmAssociations.find(key);
 				if (dm == _dmAssociations.end()) {
 					MOJA_LOG_FATAL << (boost::format(
 						"Missing DM association for dist type %1% in SPU %2% - skipped")
-						% e.disturbanceType() % spu).str();
+						% disturbanceType.name % spu).str();
 					return;
 				}
 
 				auto dmId = dm->second;
+				if (!_disturbanceMatrices->contains(dmId)) {
+					MOJA_LOG_FATAL << (boost::format(
+						"Missing disturbance matrix %1% for dist type %2% in SPU %3% - skipped")
+						% dmId % disturbanceType.name % spu).str();
+					return;
+				}
 
 				// Check if the disturbance transitions to a new land class.
-				const auto& it = _landClassTransitions.find(e.disturbanceType());
+				const auto& it = _landClassTransitions.find(disturbanceType.name);
 				std::string landClassTransition = it != _landClassTransitions.end() ? (*it).second : "";
 
 				if (landClassTransition != "") {
 					_landClass->set_value(landClassTransition);
 				}
 
-				// Find the disturbance type code.
-				int disturbanceTypeCode = -1;
-				const auto& code = _distTypeCodes.find(e.disturbanceType());
-				if (code != _distTypeCodes.end()) {
-					disturbanceTypeCode = code->second;
-				}
-
-				auto distMatrix = std::make_shared<std::vector<CBMDistEventTransfer>>();
-				{
-					const auto& it = _matrices.find(dmId);
-					const auto& operations = it->second;
-					for (const auto& transfer : operations) {
-						distMatrix->push_back(CBMDistEventTransfer(transfer));
-					}
-				}
+				// The event refers to the shared disturbance matrix; the transfers vector only
+				// holds transfers added by other modules, i.e. for moss. A module that needs to
+				// change the matrix for this event copies it into the transfers and resets the view.
+				auto distMatrix = std::make_shared<DisturbanceMatrixStore::Matrix>(
+					_disturbanceMatrices->matrix(dmId));
+				auto transfers = std::make_shared<std::vector<CBMDistEventTransfer>>();
 
 				auto data = DynamicObject({
-						{ "disturbance", e.disturbanceType() },
-						{ "disturbance_type_code", disturbanceTypeCode },
-						{ "transfers", distMatrix },
+						{ "disturbance", disturbanceType.name },
+						{ "disturbance_type_code", disturbanceType.code },
+						{ "disturbance_matrix", distMatrix },
+						{ "transfers", transfers },
 						{ "transition", e.transitionRuleId() }
 					});
 
 				// Merge any additional metadata into disturbance data.
-				for (const auto& item : e.metadata()) {
+				for (const auto& item : eventMetadata(e)) {
 					if (!data.contains(item.first)) {
 						data[item.first] = item.second;
 					}
@@ -554,32 +597,25 @@ namespace moja {
 			/**
 			* Fetch disturbance matrices
 			*
-			* For each row in variable "disturbance_matrices" of _landUnitData, 
-			* instantiate an object transfer of CBMDisturbanceListener with *_landUnitData, row and obtain the disturbance id \n
-			* If the disturbance id is not present in CBMDisturbanceListener._matrices add the disturbance matrix id, and 
-			* a vector containing all the transfers encountered to CBMDisturbanceListener._matrices
+			* Build CBMDisturbanceListener._disturbanceMatrices from the rows in variable "disturbance_matrices" \n
+			* of _landUnitData, unless another thread already has. The store is shared read-only by all threads.
 			*
 			* @return void
 			* ************************/
 			void CBMDisturbanceListener::fetchMatrices() {
-				_matrices.clear();
+				if (_disturbanceMatrices->isInitialized()) {
+					return;
+				}
+
 				const auto& transfers = _landUnitData->getVariable("disturbance_matrices")->value()
 					.extract<const std::vector<DynamicObject>>();
 
-				for (const auto& row : transfers) {
-					auto transfer = CBMDistEventTransfer(*_landUnitData, row);
-					int dmId = transfer.disturbanceMatrixId();
-					const auto& v = _matrices.find(dmId);
-					if (v == _matrices.end()) {
-						EventVector vec;
-						vec.push_back(transfer);
-						_matrices.emplace(dmId, vec);
-					}
-					else {
-						auto& vec = v->second;
-						vec.push_back(transfer);
-					}
+				std::unordered_map<std::string, int> poolIndices;
+				for (const auto pool : _landUnitData->poolCollection()) {
+					poolIndices[pool->name()] = pool->idx();
 				}
+
+				_disturbanceMatrices->initialize(transfers, poolIndices);
 			}
 
 			/**
@@ -53,21 +53,24 @@ namespace cbm {
     /**
     * If parameter isSpinup is true, assign CBMFlatAggregatorLandUnitData._previousAttributes the result of the function CBMFlatAggregatorLandUnitData.recordLocation() \n
     * Invoke CBMFlatAggregatorLandUnitData.recordPoolsSet() and CBMFlatAggregatorLandUnitData.recordFluxSet() by using isSpinUp as the parameter \n
-    * Assign CBMFlatAggregatorLandUnitData._previousAttributes the result of the function CBMFlatAggregatorLandUnitData.recordLocation()
+    * Assign CBMFlatAggregatorLandUnitData._previousAttributes the result of the function CBMFlatAggregatorLandUnitData.recordLocation() \n
+    * The step is recorded under CBMFlatAggregatorLandUnitData._flushCoordinator's accumulation lock so that streaming writers flush whole steps
     * 
     * @param isSpinup bool
 	* @return void
 	* ************************/
     void CBMFlatAggregatorLandUnitData::recordLandUnitData(bool isSpinup) {
-        auto location = recordLocation(isSpinup);
-        if (isSpinup) {
-            _previousAttributes = location;
-        }
+        _flushCoordinator->withAccumulationLock([this, isSpinup]() {
+            auto location = recordLocation(isSpinup);
+            if (isSpinup) {
+                _previousAttributes = location;
+            }
 
-        recordPoolsSet(location);
-        recordFluxSet(location);
+            recordPoolsSet(location);
+            recordFluxSet(location);
 
-        _previousAttributes = location;
+            _previousAttributes = location;
+        });
     }
 
     /**
@@ -95,7 +98,8 @@ namespace cbm {
     * If parameter isSpinup is false, get the current year of the simulation from _landUnitData \n
     * If CBMAggregatorLandUnitData._classifierNames is empty, invoke CBMAggregatorLandUnitData.recordClassifierNames() \n
     * For each classifier in  CBMAggregatorLandUnitData._classifierSet, append classifier.second to a variable classifierSet \n
-    * Instantiate an object of FlatAgeAreaRecord with year, classifierSet, value of CBMFlatAggregatorLandUnitData._landClass, 
+    * and intern it in CBMFlatAggregatorLandUnitData._classifierSets; the previous interned set is reused without locking if unchanged \n
+    * Instantiate an object of FlatAgeAreaRecord with year, the interned classifier set, value of CBMFlatAggregatorLandUnitData._landClass, 
     * value of variable "age_class" in _landUnitData if it exists else "", _landUnitArea, invoke accumulate() on 
     * CBMFlatAggregatorLandUnitData._ageDimension with argument object and return the object
     * 
@@ -110,7 +114,7 @@ namespace cbm {
         }
 
         const auto& landUnitClassifierSet = _classifierSet->value().extract<DynamicObject>();
-        std::vector<Poco::Nullable<std::string>> classifierSet;
+        ClassifierValues classifierSet;
         bool firstPass = _classifierNames->empty();
 		if (firstPass) {
 			recordClassifierNames(landUnitClassifierSet);
@@ -130,6 +134,7 @@ namespace cbm {
             classifierSet.push_back(classifierValue);
         }
         
+        _currentClassifierSet = _classifierSets->intern(classifierSet, _currentClassifierSet);
         std::string landClass = _landClass->value().extract<std::string>();
 
         std::string ageClass = "";
@@ -138,8 +143,8 @@ namespace cbm {
             ageClass = _ageClassHelper.getAgeClassString(ageClassId);
         }
 
-        FlatAgeAreaRecord locationRecord(year, classifierSet, landClass, ageClass, _landUnitArea);
-        _ageDimension->accumulate(locationRecord);
+        FlatAgeAreaRecord locationRecord(year, _currentClassifierSet, landClass, ageClass, _landUnitArea);
+        _flushCoordinator->accumulate(*_ageDimension, locationRecord);
 
         return locationRecord;
     }
@@ -152,17 +157,16 @@ namespace cbm {
 	* @return void
 	* ************************/
     void CBMFlatAggregatorLandUnitData::recordPoolsSet(const FlatAgeAreaRecord& location) {
-        auto pools = _landUnitData->poolCollection();
         for (auto& pool : _landUnitData->poolCollection()) {
             double poolValue = pool->value() * _landUnitArea;
             if (poolValue == 0) {
                 continue;
             }
 
-            FlatPoolRecord poolRecord(location.getYear(), location.getClassifierValues(), location.getLandClass(),
-                location.getAgeClass(), pool->name(), poolValue);
+            FlatPoolRecord poolRecord(location.getYear(), location.getClassifierSet(), location.getLandClass(),
+                location.getAgeClass(), _poolNames->ref(pool->idx()), poolValue);
 
-            _poolDimension->accumulate(poolRecord);
+            _flushCoordinator->accumulate(*_poolDimension, poolRecord);
         }
     }
 
@@ -214,8 +218,8 @@ namespace cbm {
                 disturbanceType = disturbanceData["disturbance"].convert<std::string>();
                 disturbanceCode = disturbanceData["disturbance_type_code"].extract<int>();
 
-                FlatDisturbanceRecord disturbanceRecord(location.getYear(), location.getClassifierValues(), location.getLandClass(),
-                    location.getAgeClass(), _previousAttributes->getClassifierValues(), _previousAttributes->getLandClass(),
+                FlatDisturbanceRecord disturbanceRecord(location.getYear(), location.getClassifierSet(), location.getLandClass(),
+                    location.getAgeClass(), _previousAttributes->getClassifierSet(), _previousAttributes->getLandClass(),
                     _previousAttributes->getAgeClass(), disturbanceType, disturbanceCode, _landUnitArea);
 
                 _disturbanceDimension->accumulate(disturbanceRecord);
@@ -229,14 +233,11 @@ namespace cbm {
                 }
 
                 auto fluxValue = it->value() * _landUnitArea;
-                auto srcPool = _landUnitData->getPool(srcIx);
-                auto dstPool = _landUnitData->getPool(dstIx);
+                FlatFluxRecord fluxRecord(location.getYear(), location.getClassifierSet(), location.getLandClass(),
+                    location.getAgeClass(), _previousAttributes->getClassifierSet(), _previousAttributes->getLandClass(),
+                    _previousAttributes->getAgeClass(), disturbanceType, disturbanceCode, _poolNames->ref(srcIx), _poolNames->ref(dstIx), fluxValue);
 
-                FlatFluxRecord fluxRecord(location.getYear(), location.getClassifierValues(), location.getLandClass(),
-                    location.getAgeClass(), _previousAttributes->getClassifierValues(), _previousAttributes->getLandClass(),
-                    _previousAttributes->getAgeClass(), disturbanceType, disturbanceCode, srcPool->name(), dstPool->name(), fluxValue);
-
-                _fluxDimension->accumulate(fluxRecord);
+                _flushCoordinator->accumulate(*_fluxDimension, fluxRecord);
             }
         }
 
@@ -253,21 +254,23 @@ namespace cbm {
 	* @return void
 	* ************************/
 	void CBMFlatAggregatorLandUnitData::doError(std::string msg) {
-		bool detailsAvailable = _spatialLocationInfo != nullptr;
-		auto module = detailsAvailable ? _spatialLocationInfo->getProperty("module").convert<std::string>() : "unknown";
-		
-        if (detailsAvailable) {
-            auto location = recordLocation(true);
-            FlatErrorRecord errorRecord(location.getYear(), location.getClassifierValues(),
-                module, msg, _landUnitArea);
-            
-            _errorDimension->accumulate(errorRecord);
-        } else {
-            FlatErrorRecord errorRecord(0, std::vector<Poco::Nullable<std::string>>(),
-                module, msg, _landUnitArea);
-
-            _errorDimension->accumulate(errorRecord);
-        }
+        _flushCoordinator->withAccumulationLock([this, &msg]() {
+            bool detailsAvailable = _spatialLocationInfo != nullptr;
+            auto module = detailsAvailable ? _spatialLocationInfo->getProperty("module").convert<std::string>() : "unknown";
+
+            if (detailsAvailable) {
+                auto location = recordLocation(true);
+                FlatErrorRecord errorRecord(location.getYear(), location.getClassifierSet(),
+                    module, msg, _landUnitArea);
+
+                _errorDimension->accumulate(errorRecord);
+            } else {
+                FlatErrorRecord errorRecord(0, _classifierSets->intern(ClassifierValues()),
+                    module, msg, _landUnitArea);
+
+                _errorDimension->accumulate(errorRecord);
+            }
+        });
 	}
 
     /**
@@ -284,6 +287,7 @@ namespace cbm {
     }
 
     /**
+    * Assign the pool names, indexed by pool idx, to the shared CBMFlatAggregatorLandUnitData._poolNames table \n
     * Assign CBMFlatAggregatorLandUnitData._spatialLocationInfo, CBMFlatAggregatorLandUnitData._landClass values of variables 
     * "spatialLocationInfo" and "unfccc_land_class", CBMFlatAggregatorLandUnitData._classifierSet value of  CBMFlatAggregatorLandUnitData._classifierSet in _landUnitData \n
     * If _landUnitData contains variables "age_class_range" and "age_maximum", create an object of AgeClassHelper, \n
@@ -292,6 +296,13 @@ namespace cbm {
 	* @return void
 	* ************************/
     void CBMFlatAggregatorLandUnitData::doLocalDomainInit() {
+        std::vector<std::string> poolNames(_landUnitData->poolCollection().size());
+        for (auto& pool : _landUnitData->poolCollection()) {
+            poolNames[pool->idx()] = pool->name();
+        }
+
+        _poolNames->assign(poolNames);
+
         _spatialLocationInfo = std::static_pointer_cast<flint::SpatialLocationInfo>(
             _landUnitData->getVariable("spatialLocationInfo")->value()
             .extract<std::shared_ptr<flint::IFlintData>>());
@@ -91,17 +91,14 @@ namespace moja {
 				if (!runPeatland) {
 					// use CBM DM transfers
 					auto dmId = _dmAssociations.at(std::make_pair(disturbanceType, _spuId));
-					const auto& it = _matrices.find(dmId);
-
-					if (it != _matrices.end()) {
-						//valid disturbance matrix is found
-						const auto& operations = it->second;
-						for (const auto& transfer : operations) {
-							auto srcPool = transfer.sourcePool();
-							auto dstPool = transfer.destPool();
-							if (srcPool != dstPool) {
-								disturbanceEvent->addTransfer(srcPool, dstPool, transfer.proportion());
-							}
+					const auto distMatrix = _disturbanceMatrices->matrix(dmId);
+
+					//an unknown disturbance matrix is empty
+					for (size_t i = 0; i < distMatrix.size(); i++) {
+						auto srcPool = distMatrix.sourcePool(i);
+						auto dstPool = distMatrix.sinkPool(i);
+						if (srcPool != dstPool) {
+							disturbanceEvent->addTransfer(_pools[srcPool], _pools[dstPool], distMatrix.proportion(i));
 						}
 					}
 
@@ -137,35 +134,28 @@ namespace moja {
 			 /**
              * Fetch disturbance matrices.
              * 
-			 * For each row in "disturbance_matrices", \n
-			 * initialise variable transfer as CBMDistEventTransfer(*_landUnitData, row). \n
-			 * Initialise integer variable dmId as transfer.disturbanceMatrixId(). \n
-			 * if dmId in CBMSpinupDisturbanceModule._matrices is equal to CBMSpinupDisturbanceModule._matrices.end(), \n
-			 * add transfer to eventVector, \n
-			 * dmId and eventVector to CBMSpinupDisturbanceModule._matrices. \n
-			 * else add transfer to v->second.
+			 * Index all pools by idx in CBMSpinupDisturbanceModule._pools and build the shared \n
+			 * CBMSpinupDisturbanceModule._disturbanceMatrices from "disturbance_matrices", unless \n
+			 * another module or thread already has.
 			 * 
              * @return void
              * ************************/
 			void CBMSpinupDisturbanceModule::fetchMatrices() {
-				_matrices.clear();
+				std::unordered_map<std::string, int> poolIndices;
+				_pools.assign(_landUnitData->poolCollection().size(), nullptr);
+				for (const auto pool : _landUnitData->poolCollection()) {
+					_pools[pool->idx()] = pool;
+					poolIndices[pool->name()] = pool->idx();
+				}
+
+				if (_disturbanceMatrices->isInitialized()) {
+					return;
+				}
+
 				const auto& transfers = _landUnitData->getVariable("disturbance_matrices")->value()
 					.extract<const std::vector<DynamicObject>>();
 
-				for (const auto& row : transfers) {
-					auto transfer = CBMDistEventTransfer(*_landUnitData, row);
-					int dmId = transfer.disturbanceMatrixId();
-					const auto& v = _matrices.find(dmId);
-					if (v == _matrices.end()) {
-						EventVector vec;
-						vec.push_back(transfer);
-						_matrices.emplace(dmId, vec);
-					}
-					else {
-						auto& vec = v->second;
-						vec.push_back(transfer);
-					}
-				}
+				_disturbanceMatrices->initialize(transfers, poolIndices);
 			}
 
 			 /**
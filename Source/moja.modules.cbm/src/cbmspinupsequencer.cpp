@@ -2,10 +2,13 @@
 #include "moja/modules/cbm/cbmdisturbanceeventmodule.h"
 #include "moja/modules/cbm/timeseries.h"
 #include "moja/modules/cbm/peatlands.h"
+#include "moja/modules/cbm/spinupsteadystatesolver.h"
 
 #include <moja/flint/ivariable.h>
 #include <moja/flint/ipool.h>
 #include <moja/flint/ilandunitcontroller.h>
+#include <moja/flint/ioperationresult.h>
+#include <moja/flint/ioperationresultflux.h>
 
 #include <moja/exception.h>
 #include <moja/signals.h>
@@ -16,12 +19,63 @@
 #include <boost/format.hpp>
 
 #include <algorithm>
+#include <map>
+#include <memory>
 using namespace moja::flint;
 
 namespace moja {
 	namespace modules {
 		namespace cbm {
 
+			/**
+			* Destructor
+			*
+			* Save any spinup results added by this run to CBMSpinupSequencer._spinupCachePath. Each thread's \n
+			* sequencer saves as it is destroyed, so the file is complete once the last one finishes.
+			* *****************/
+			CBMSpinupSequencer::~CBMSpinupSequencer() {
+				if (!_spinupCacheOpened) {
+					return;
+				}
+
+				try {
+					_spinupCache->save();
+				}
+				catch (const std::exception& e) {
+					MOJA_LOG_ERROR << "Error saving spinup cache: " << e.what();
+				}
+			}
+
+			/**
+			* If CBMSpinupSequencer._spinupCachePath is set, open it as the backing file of CBMSpinupSequencer._spinupCache. \n
+			* The cache is versioned by the names of the pools, in order, CBMSpinupSequencer._spinupCacheVersion and the \n
+			* values of the variables in CBMSpinupSequencer._spinupCacheParameters that exist, so results saved for a \n
+			* different pool set or different spinup and decay parameters are not reused. The values are those seen \n
+			* by the first land unit; for tables that vary in space, spinup_cache_version still has to identify the inputs.
+			*
+			* @return void
+			* *****************/
+			void CBMSpinupSequencer::openSpinupCache() {
+				_spinupCacheOpened = true;
+				if (_spinupCachePath.empty()) {
+					return;
+				}
+
+				std::vector<std::string> poolNames;
+				for (const auto pool : _landUnitData->poolCollection()) {
+					poolNames.push_back(pool->name());
+				}
+
+				std::map<std::string, DynamicVar> parameters;
+				for (const auto& name : _spinupCacheParameters) {
+					if (_landUnitData->hasVariable(name)) {
+						parameters[name] = _landUnitData->getVariable(name)->value();
+					}
+				}
+
+				_spinupCache->open(_spinupCachePath, SpinupCache::version(poolNames, _spinupCacheVersion, parameters));
+			}
+
 			/**
 			* Initialise constant variable spinup as variable "spinup_parameters" in landUnitData. \n
 			* If spinup is empty, it will return false. \n
@@ -234,6 +288,10 @@ namespace moja {
 				}
 
 				try {
+					if (!_spinupCacheOpened) {
+						openSpinupCache();
+					}
+
 					_landUnitData->getVariable("run_delay")->set_value("false");
 					_landUnitData->getVariable("regen_delay")->set_value(0);
 
@@ -342,7 +400,7 @@ namespace moja {
 			 * variable "fire_return_interval" in _landUnitData
 			 *
 			 * If the cache object consisting of { CBMSpinupSequencer._spu, CBMSpinupSequencer._historicDistType, peatlandId, variable fireReturnIntervalValue and variable meanAnnualTemperature },
-			 * is present in CBMSpinupSequencer._cache, set value of variable "peat_pool_cached" in _landUnitData to true and set poolCached to true \n
+			 * is present in CBMSpinupSequencer._spinupCache, set value of variable "peat_pool_cached" in _landUnitData to true and set poolCached to true \n
 			 *
 			 * Reset the ages CBMSpinupSequencer._shrubAge, CBMSpinupSequencer._smallTreeAge, CBMSpinupSequencer._age to zero before the spinup procedure
 			 *
@@ -392,20 +450,18 @@ namespace moja {
 				auto& peatland_class = _landUnitData->getVariable("peatland_class")->value();
 				auto peatlandId = peatland_class.isEmpty() ? -1 : peatland_class.convert<int>();
 
-				CacheKey cacheKey{
+				SpinupCache::Reservation cachedResult(*_spinupCache, SpinupCache::Key{
 					_spu->value().convert<int>(),
 					_historicDistType,
 					peatlandId,
 					fireReturnIntervalValue,
 					meanAnnualTemperature
-				};
+				});
 
-				auto it = _cache.find(cacheKey);
-				if (it != _cache.end()) {
-					auto cachedResult = (*it).second;
+				if (cachedResult.isCached()) {
 					auto pools = _landUnitData->poolCollection();
 					for (auto& pool : pools) {
-						pool->set_value(cachedResult[pool->idx()]);
+						pool->set_value(cachedResult.values()[pool->idx()]);
 					}
 					poolCached = true;
 					_landUnitData->getVariable("peat_pool_cached")->set_value(poolCached);
@@ -468,7 +524,7 @@ namespace moja {
 					for (auto& pool : pools) {
 						cacheValue.push_back(pool->value());
 					}
-					_cache[cacheKey] = cacheValue;
+					cachedResult.store(cacheValue);
 				}
 
 				// Regrow to minimum peatland woody age.
@@ -485,6 +541,10 @@ namespace moja {
 			/**
 			 * Perform Regular Spinup
 			 *
+			 * Get the mean annual temperature of the stand and run CBMSpinupSequencer.simulateRegularSpinup(). \n
+			 * If moss is not simulated and canReplayRegrowth() is true, the end state of the spinup is shared through \n
+			 * CBMSpinupSequencer._regrowthStore by the stand's SpinupRegrowthKey with replaySpinupRegrowth(): only the \n
+			 * first stand with the key is simulated, and its pools, "age" and "is_decaying" are copied into the others.
 			 *
 			 * @param notificationCenter NotificationCenter&
 			 * @param luc ILandUnitController&
@@ -492,36 +552,95 @@ namespace moja {
 			 * @return void
 			 */
 			void CBMSpinupSequencer::runRegularSpinup(NotificationCenter& notificationCenter, ILandUnitController& luc, bool runMoss) {
-				bool poolCached = false;
-				_age->set_value(0);
-				const auto timing = _landUnitData->timing();
 				auto mat = _mat->value();
 				auto meanAnnualTemperature = mat.isEmpty() ? 0
 					: mat.type() == typeid(TimeSeries) ? mat.extract<TimeSeries>().value()
 					: mat.convert<double>();
 
-				CacheKey cacheKey{
-					_spu->value().convert<int>(),
+				int spu = _spu->value().convert<int>();
+				if (runMoss || !canReplayRegrowth()) {
+					simulateRegularSpinup(notificationCenter, luc, runMoss, spu, meanAnnualTemperature);
+					return;
+				}
+
+				SpinupRegrowthKey regrowthKey{
+					spu, _historicDistType, _spinupGrowthCurveID, _ageReturnInterval, meanAnnualTemperature,
+					_lastPassDistType, _standAge, _standDelay
+				};
+
+				replaySpinupRegrowth(*_regrowthStore, regrowthKey,
+					[&]() {
+						simulateRegularSpinup(notificationCenter, luc, runMoss, spu, meanAnnualTemperature);
+					},
+					[this]() {
+						auto regrowth = std::make_shared<SpinupRegrowth>();
+						regrowth->pools = poolValues();
+						regrowth->age = _age->value().convert<int>();
+						regrowth->isDecaying = _isDecaying->value().convert<bool>();
+						return regrowth;
+					},
+					[this](const SpinupRegrowth& regrowth) {
+						for (auto& pool : _landUnitData->poolCollection()) {
+							pool->set_value(regrowth.pools[pool->idx()]);
+						}
+
+						_age->set_value(regrowth.age);
+						_isDecaying->set_value(regrowth.isDecaying);
+					});
+			}
+
+			/**
+			 * Simulate Regular Spinup
+			 *
+			 * If CBMSpinupSequencer._acceleratedSpinup is true and moss is not simulated, the operations applied in \n
+			 * each rotation are recorded in a SpinupSteadyStateSolver. Once two consecutive rotations show that \n
+			 * every flux is either a constant amount or a constant proportion of its source pool, the remaining \n
+			 * rotations are run on the recorded maps under the same SpinupStoppingRule and only the pass the rule \n
+			 * stops at is simulated, so the stand ends up where the regular procedure leaves it. Otherwise the \n
+			 * regular procedure carries on unchanged.
+			 *
+			 * @param notificationCenter NotificationCenter&
+			 * @param luc ILandUnitController&
+			 * @param runMoss int
+			 * @param spu int
+			 * @param meanAnnualTemperature double
+			 * @return void
+			 */
+			void CBMSpinupSequencer::simulateRegularSpinup(NotificationCenter& notificationCenter, ILandUnitController& luc,
+				bool runMoss, int spu, double meanAnnualTemperature) {
+
+				bool poolCached = false;
+				_age->set_value(0);
+				const auto timing = _landUnitData->timing();
+
+				SpinupCache::Reservation cachedResult(*_spinupCache, SpinupCache::Key{
+					spu,
 					_historicDistType,
 					_spinupGrowthCurveID,
 					_ageReturnInterval,
 					meanAnnualTemperature
-				};
+				});
 
-				auto it = _cache.find(cacheKey);
-				if (it != _cache.end()) {
-					auto cachedResult = (*it).second;
+				if (cachedResult.isCached()) {
 					auto pools = _landUnitData->poolCollection();
 					for (auto& pool : pools) {
-						pool->set_value(cachedResult[pool->idx()]);
+						pool->set_value(cachedResult.values()[pool->idx()]);
 					}
 
 					poolCached = true;
 				}
 
 				bool mossSlowPoolStable = false;
-				double lastSlowPoolValue = 0;
 				double lastMossSlowPoolValue = 0;
+				SpinupStoppingRule stoppingRule(
+					{ _aboveGroundSlowSoil->idx(), _belowGroundSlowSoil->idx() }, _minimumRotation, _maxRotationValue);
+
+				// In accelerated mode, record the rotations so that the rest of them can be run on the recorded
+				// maps; moss spinup has its own stability loop, so it always runs the full procedure.
+				std::unique_ptr<SpinupSteadyStateSolver> steadyStateSolver;
+				if (_acceleratedSpinup && !runMoss) {
+					steadyStateSolver = std::make_unique<SpinupSteadyStateSolver>(_landUnitData->poolCollection().size());
+				}
 
 				// Loop up to the maximum number of rotations/passes.
 				int currentRotation = 0;
@@ -529,46 +648,76 @@ namespace moja {
 					// Fire spinup pass, each pass is up to the stand age return interval.
 					// Reset forest stand and peatland age anyway for each pass.
 					_age->set_value(0);
-					fireSpinupSequenceEvent(notificationCenter, luc, _ageReturnInterval, false);
+					if (steadyStateSolver) {
+						steadyStateSolver->beginRotation(poolValues());
+					}
 
-					// Get the slow pool values at the end of age interval.			
-					double currentSlowPoolValue = _aboveGroundSlowSoil->value() + _belowGroundSlowSoil->value();
+					fireSpinupSequenceEvent(notificationCenter, luc, _ageReturnInterval, false, steadyStateSolver.get());
+					if (steadyStateSolver) {
+						steadyStateSolver->endPass();
+					}
 
-					// Check if the slow pool is stable.
-					bool slowPoolStable = isSlowPoolStable(lastSlowPoolValue, currentSlowPoolValue);
 					if (runMoss) {
 						double currentMossSlowPoolValue = _featherMossSlow->value() + _sphagnumMossSlow->value();
 						mossSlowPoolStable = isSlowPoolStable(lastMossSlowPoolValue, currentMossSlowPoolValue);
 						lastMossSlowPoolValue = currentMossSlowPoolValue;
 					}
 
-					// Update previous total slow pool value.
-					lastSlowPoolValue = currentSlowPoolValue;
-					if (slowPoolStable && currentRotation > _minimumRotation) {
-						// Slow pool is stable, and the minimum rotations are done.
-						break;
-					}
-
-					if (currentRotation == _maxRotationValue) {
-						if (!slowPoolStable) {
+					// Stop once the slow pool is stable and the minimum rotations are done, or at the maximum rotations.
+					if (stoppingRule.isDone(currentRotation, poolValues())) {
+						if (!stoppingRule.isStable()) {
 							MOJA_LOG_INFO << "Slow pool is not stable at maximum rotation: " << currentRotation;
 						}
-						// Whenever the max rotations are reached, stop even if the slow pool is not stable.
+
 						break;
 					}
 
 					// CBM spinup is not done, notify to simulate the historic disturbance.
 					fireHistoricalLastDisturbanceEvent(notificationCenter, luc, _historicDistType);
+					if (steadyStateSolver) {
+						recordAppliedOperations(*steadyStateSolver);
+					}
 
 					// Growth curves assume a starting condition of zero biomass. If we use the post-disturbance
 					// starting condition, biomass values could potentially be greater than zero and our
 					// biomass/age class curves are shifted to the left.
+					std::vector<int> resetPools;
 					auto pools = _landUnitData->poolCollection();
 					for (auto& pool : pools) {
 						if (_biomassPools.find(pool->name()) != _biomassPools.end()) {
 							pool->set_value(0);
+							resetPools.push_back(pool->idx());
 						}
 					}
+
+					if (!steadyStateSolver) {
+						continue;
+					}
+
+					steadyStateSolver->resetPools(resetPools);
+					steadyStateSolver->endRotation();
+					if (!steadyStateSolver->matches(poolValues())) {
+						MOJA_LOG_DEBUG << "Spinup pools changed outside of operations, using regular spinup.";
+						steadyStateSolver.reset();
+						continue;
+					}
+
+					// Run the remaining rotations on the recorded maps, then simulate the pass the stopping
+					// rule stopped at from its start, leaving the stand where the regular procedure stops.
+					std::vector<double> lastPassStart;
+					if (steadyStateSolver->project(poolValues(), stoppingRule, currentRotation, lastPassStart)) {
+						if (!stoppingRule.isStable()) {
+							MOJA_LOG_INFO << "Slow pool is not stable at maximum rotation: " << currentRotation;
+						}
+
+						for (auto& pool : pools) {
+							pool->set_value(lastPassStart[pool->idx()]);
+						}
+
+						_age->set_value(0);
+						fireSpinupSequenceEvent(notificationCenter, luc, _ageReturnInterval, false);
+						break;
+					}
 				}
 
 				while (!poolCached && runMoss && !mossSlowPoolStable) {
@@ -693,7 +842,7 @@ namespace moja {
 						cacheValue.push_back(pool->value());
 					}
 
-					_cache[cacheKey] = cacheValue;
+					cachedResult.store(cacheValue);
 				}
 
 				// Run the growth and disturbances in the last pass timeseries. The event at the beginning
@@ -729,6 +878,21 @@ namespace moja {
 				}
 			}
 
+			/**
+			 * Return true if CBMSpinupSequencer._replayRegrowth is set and nothing outside the stand's SpinupRegrowthKey \n
+			 * changes how it regrows after the last pass disturbance: there is no ramp period and no last pass \n
+			 * disturbance timeseries, so the stand has a single last pass disturbance of CBMSpinupSequencer._lastPassDistType.
+			 *
+			 * @return bool
+			 */
+			bool CBMSpinupSequencer::canReplayRegrowth() const {
+				if (!_replayRegrowth || !_rampStartDate.isNull()) {
+					return false;
+				}
+
+				return _lastPassDisturbanceTimeseries == nullptr || _lastPassDisturbanceTimeseries->value().isEmpty();
+			}
+
 			/**
 			 * If parameter lastSlowPoolValue != 0, returns if the the ratio currentSlowPoolValue / lastSlowPoolValue
 			 * is greater than 0.999 and less than 1.001, else returns True.
@@ -738,12 +902,7 @@ namespace moja {
 			 * @return bool
 			 */
 			bool CBMSpinupSequencer::isSlowPoolStable(double lastSlowPoolValue, double currentSlowPoolValue) {
-				double changeRatio = 0;
-				if (lastSlowPoolValue != 0) {
-					changeRatio = currentSlowPoolValue / lastSlowPoolValue;
-				}
-
-				return changeRatio > 0.999 && changeRatio < 1.001;
+				return SpinupStoppingRule::isSlowPoolStable(lastSlowPoolValue, currentSlowPoolValue);
 			}
 
 			/**
@@ -752,18 +911,20 @@ namespace moja {
 			 * current start and end date by 1 (one year) \n
 			 * Post notifications TimingStep, TimingPreEndStep, TimingEndStep and TimingPostStep \n
 			 * Invoke applyOperations() to apply the operations in the current step and clearAllOperationResults() to clear the results
-			 * on _landUnitData
+			 * on _landUnitData. If parameter recorder is not nullptr, the applied operations are passed to it before being cleared.
 			 *
 			 * @param maximumSteps int
 			 * @param incrementStep bool
 			 * @param notificationCenter NotificationCenter&
 			 * @param luc ILandUnitController&
+			 * @param recorder SpinupSteadyStateSolver*
 			 * @return void
 			 */
 			void CBMSpinupSequencer::fireSpinupSequenceEvent(NotificationCenter& notificationCenter,
 				flint::ILandUnitController& luc,
 				int maximumSteps,
-				bool incrementStep) {
+				bool incrementStep,
+				SpinupSteadyStateSolver* recorder) {
 				for (int i = 0; i < maximumSteps; i++) {
 					if (incrementStep) {
 						const auto timing = _landUnitData->timing();
@@ -779,8 +940,54 @@ namespace moja {
 					notificationCenter.postNotification(moja::signals::TimingEndStep);
 					notificationCenter.postNotification(moja::signals::TimingPostStep);
 					_landUnitData->applyOperations();
+					if (recorder != nullptr) {
+						recordAppliedOperations(*recorder);
+					}
+
 					_landUnitData->clearAllOperationResults();
+					_recordedOperations = 0;
+				}
+			}
+
+			/**
+			 * Return the current pool values, indexed by pool idx
+			 *
+			 * @return vector<double>
+			 */
+			std::vector<double> CBMSpinupSequencer::poolValues() const {
+				std::vector<double> values(_landUnitData->poolCollection().size());
+				for (const auto pool : _landUnitData->poolCollection()) {
+					values[pool->idx()] = pool->value();
 				}
+
+				return values;
+			}
+
+			/**
+			 * Pass the fluxes of each operation applied since the last call to parameter recorder, in the order \n
+			 * they were applied. CBMSpinupSequencer._recordedOperations tracks how many of the current step's \n
+			 * operation results have already been recorded, i.e. by a disturbance event.
+			 *
+			 * @param recorder SpinupSteadyStateSolver&
+			 * @return void
+			 */
+			void CBMSpinupSequencer::recordAppliedOperations(SpinupSteadyStateSolver& recorder) {
+				size_t operation = 0;
+				std::vector<SpinupPoolTransfer> transfers;
+				for (auto operationResult : _landUnitData->getOperationLastAppliedIterator()) {
+					if (operation++ < _recordedOperations) {
+						continue;
+					}
+
+					transfers.clear();
+					for (auto flux : operationResult->operationResultFluxCollection()) {
+						transfers.push_back(SpinupPoolTransfer{ flux->source(), flux->sink(), flux->value() });
+					}
+
+					recorder.addOperation(transfers);
+				}
+
+				_recordedOperations = operation;
 			}
 
 			/**
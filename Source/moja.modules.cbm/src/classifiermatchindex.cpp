@@ -0,0 +1,190 @@
+/**
+ * @file
+ * Shared index of the classifier values required by growth curves and transition rules,
+ * used by GrowthCurveTransform and TransitionRuleTransform to find the best match for a
+ * classifier set without querying the provider.
+ * ******************/
+
+#include "moja/modules/cbm/classifiermatchindex.h"
+
+#include "moja/hash.h"
+
+#include <map>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    namespace {
+        const int exactMatchScore = 4;
+        const int wildcardScore = 1;
+        const int mismatchScore = -1000;
+        const std::string wildcard = "?";
+
+        // Parameter text with ASCII letters in lower case, which is how LIKE compares text.
+        std::string foldCase(const std::string& value) {
+            std::string folded(value);
+            for (auto& c : folded) {
+                if (c >= 'A' && c <= 'Z') {
+                    c = c - 'A' + 'a';
+                }
+            }
+
+            return folded;
+        }
+    }
+
+    /**
+     * Hash a classifier set by its classifier names and values.
+     *
+     * @param classifierSet ClassifierMatchQuery&
+     * @return size_t
+     * ************************/
+    size_t ClassifierMatchIndex::QueryHasher::operator()(const ClassifierMatchQuery& classifierSet) const {
+        size_t hash = 0;
+        for (const auto& classifier : classifierSet) {
+            hash = moja::hash::hash_combine(hash, classifier.first, classifier.second);
+        }
+
+        return hash;
+    }
+
+    /**
+     * Build the index from parameter rows, one per classifier value required by a candidate. \n
+     * Rows with the same ID and group belong to the same candidate. Classifier values are stored \n
+     * in lower case so that the classifier set's values are matched ignoring case. Only the first call builds \n
+     * the index; later calls, from other threads, return once it is built.
+     *
+     * @param rows vector<ClassifierMatchRow>&
+     * @return void
+     * ************************/
+    void ClassifierMatchIndex::initialize(const std::vector<ClassifierMatchRow>& rows) {
+        if (_initialized) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_initializeLock);
+        if (_initialized) {
+            return;
+        }
+
+        _groups.clear();
+        _candidates.clear();
+        _classifiers.clear();
+
+        std::unordered_map<std::string, size_t> groups;
+        std::map<std::pair<int, size_t>, size_t> candidates;
+        for (const auto& row : rows) {
+            auto group = groups.find(row.group);
+            if (group == groups.end()) {
+                group = groups.emplace(row.group, _groups.size()).first;
+                _groups.push_back(row.group);
+            }
+
+            auto candidate = candidates.find(std::make_pair(row.id, group->second));
+            if (candidate == candidates.end()) {
+                candidate = candidates.emplace(std::make_pair(row.id, group->second), _candidates.size()).first;
+                _candidates.push_back(Candidate{ row.id, group->second, 0 });
+            }
+
+            _candidates[candidate->second].requiredValues++;
+            auto& classifier = _classifiers[row.classifierName];
+            if (row.classifierValue == wildcard) {
+                classifier.wildcards.push_back(candidate->second);
+            } else {
+                classifier.values[foldCase(row.classifierValue)].push_back(candidate->second);
+            }
+        }
+
+        _initialized = true;
+    }
+
+    /**
+     * Return the best matching ID in each group for parameter classifierSet, scoring it the \n
+     * first time the classifier set is seen by any thread.
+     *
+     * @param classifierSet ClassifierMatchQuery&
+     * @return ClassifierMatches&
+     * ************************/
+    const ClassifierMatches& ClassifierMatchIndex::match(const ClassifierMatchQuery& classifierSet) {
+        {
+            Poco::ScopedReadRWLock lock(_cacheLock);
+            auto it = _cache.find(classifierSet);
+            if (it != _cache.end()) {
+                return it->second;
+            }
+        }
+
+        auto matches = score(classifierSet);
+
+        Poco::ScopedWriteRWLock lock(_cacheLock);
+        return _cache.emplace(classifierSet, std::move(matches)).first->second;
+    }
+
+    /**
+     * Score the candidates against parameter classifierSet. Only the candidates in the value and \n
+     * wildcard buckets of the classifier set are visited: each starts with every required value \n
+     * counted as a mismatch, then has its score corrected. A candidate that is never visited \n
+     * mismatches every required value, so it cannot score above 0 and is not scored at all.
+     *
+     * @param classifierSet ClassifierMatchQuery&
+     * @return ClassifierMatches
+     * ************************/
+    ClassifierMatches ClassifierMatchIndex::score(const ClassifierMatchQuery& classifierSet) const {
+        std::unordered_map<size_t, int> scores;
+        auto addScore = [this, &scores](size_t candidate, int score) {
+            auto it = scores.find(candidate);
+            if (it == scores.end()) {
+                it = scores.emplace(candidate, _candidates[candidate].requiredValues * mismatchScore).first;
+            }
+
+            it->second += score - mismatchScore;
+        };
+
+        for (const auto& value : classifierSet) {
+            auto classifier = _classifiers.find(value.first);
+            if (classifier == _classifiers.end()) {
+                continue;
+            }
+
+            for (auto candidate : classifier->second.wildcards) {
+                addScore(candidate, wildcardScore);
+            }
+
+            auto bucket = classifier->second.values.find(foldCase(value.second));
+            if (bucket != classifier->second.values.end()) {
+                for (auto candidate : bucket->second) {
+                    addScore(candidate, exactMatchScore);
+                }
+            }
+        }
+
+        const size_t none = _candidates.size();
+        std::vector<size_t> best(_groups.size(), none);
+        std::vector<int> bestScores(_groups.size(), 0);
+        for (const auto& candidate : scores) {
+            if (candidate.second <= 0) {
+                continue;
+            }
+
+            auto group = _candidates[candidate.first].group;
+            auto& groupBest = best[group];
+            if (groupBest == none || candidate.second > bestScores[group]
+                    || (candidate.second == bestScores[group]
+                        && _candidates[candidate.first].id < _candidates[groupBest].id)) {
+                groupBest = candidate.first;
+                bestScores[group] = candidate.second;
+            }
+        }
+
+        ClassifierMatches matches;
+        for (size_t group = 0; group < _groups.size(); group++) {
+            if (best[group] != none) {
+                matches.emplace_back(_groups[group], _candidates[best[group]].id);
+            }
+        }
+
+        return matches;
+    }
+
+}}} // namespace moja::modules::cbm
@@ -0,0 +1,107 @@
+/**
+ * @file
+ * Interning table for classifier sets used by the aggregator modules, so that
+ * output records can be keyed on a small integer instead of copies of the
+ * classifier value strings.
+ */
+
+#include "moja/modules/cbm/classifiersetinterner.h"
+
+#include "moja/hash.h"
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * Hash a set of classifier values; null values hash the same as empty strings,
+     * matching the equality used by the output records.
+     *
+     * @param values ClassifierValues&
+     * @return size_t
+     * ************************/
+    size_t ClassifierSetInterner::ValuesHasher::operator()(const ClassifierValues& values) const {
+        size_t hash = 0;
+        for (const auto& value : values) {
+            hash = moja::hash::hash_combine(hash, value.value(""));
+        }
+
+        return hash;
+    }
+
+    /**
+     * Compare two sets of classifier values, treating null values as empty strings.
+     *
+     * @param lhs ClassifierValues&
+     * @param rhs ClassifierValues&
+     * @return bool
+     * ************************/
+    bool ClassifierSetInterner::ValuesComparer::operator()(const ClassifierValues& lhs, const ClassifierValues& rhs) const {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < lhs.size(); i++) {
+            if (lhs[i].value("") != rhs[i].value("")) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Return the handle for parameter values, assigning a new ID the first time a set of values is seen.
+     *
+     * @param values ClassifierValues&
+     * @return ClassifierSetRef
+     * ************************/
+    ClassifierSetRef ClassifierSetInterner::intern(const ClassifierValues& values) {
+        {
+            Poco::ScopedReadRWLock lock(_lock);
+            auto it = _ids.find(values);
+            if (it != _ids.end()) {
+                return it->second;
+            }
+        }
+
+        Poco::ScopedWriteRWLock lock(_lock);
+        auto it = _ids.find(values);
+        if (it != _ids.end()) {
+            return it->second;
+        }
+
+        _values.push_back(values);
+        ClassifierSetRef ref(_values.size(), &_values.back());
+        _ids.emplace(values, ref);
+
+        return ref;
+    }
+
+    /**
+     * Return parameter previous if it already refers to parameter values, otherwise intern parameter values. \n
+     * A land unit's classifier set rarely changes between steps, so this avoids hashing and locking on most calls.
+     *
+     * @param values ClassifierValues&
+     * @param previous ClassifierSetRef&
+     * @return ClassifierSetRef
+     * ************************/
+    ClassifierSetRef ClassifierSetInterner::intern(const ClassifierValues& values, const ClassifierSetRef& previous) {
+        if (previous.isValid() && ValuesComparer()(previous.values(), values)) {
+            return previous;
+        }
+
+        return intern(values);
+    }
+
+    /**
+     * Return the number of distinct classifier sets interned so far.
+     *
+     * @return size_t
+     * ************************/
+    size_t ClassifierSetInterner::size() const {
+        Poco::ScopedReadRWLock lock(_lock);
+        return _values.size();
+    }
+
+}}} // namespace moja::modules::cbm
@@ -1,5 +1,7 @@
 #include "moja/modules/cbm/componentbiomasscarboncurve.h"
 
+#include <utility>
+
 namespace moja {
 namespace modules {
 namespace cbm {
@@ -18,4 +20,20 @@ namespace cbm {
 		: _maxAge(maxAge), _merchCarbonIncrements(maxAge + 1),
 		  _foliageCarbonIncrements(maxAge + 1), _otherCarbonIncrements(maxAge + 1) {}	
 
+	/**
+	 * Constructor
+	 * 
+	 * Assign ComponentBiomassCarbonCurve._maxAge as parameter maxAge, and the carbon at each age \n
+	 * as parameters merchCarbon, foliageCarbon and otherCarbon, where index = age
+	 * 
+	 * @param maxAge int
+	 * @param merchCarbon vector<double>
+	 * @param foliageCarbon vector<double>
+	 * @param otherCarbon vector<double>
+	 * **********************/
+	ComponentBiomassCarbonCurve::ComponentBiomassCarbonCurve(int maxAge, std::vector<double> merchCarbon,
+		std::vector<double> foliageCarbon, std::vector<double> otherCarbon)
+		: _maxAge(maxAge), _merchCarbonIncrements(std::move(merchCarbon)),
+		  _foliageCarbonIncrements(std::move(foliageCarbon)), _otherCarbonIncrements(std::move(otherCarbon)) {}
+
 }}}
\ No newline at end of file
@@ -0,0 +1,126 @@
+/**
+ * @file
+ * Disturbance condition targets compiled from their configuration, checked by the
+ * variable and pool disturbance sub-conditions of CBMDisturbanceListener.
+ * ******************/
+
+#include "moja/modules/cbm/disturbanceconditiontarget.h"
+
+#include <cstdlib>
+#include <stdexcept>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    namespace {
+        // The number parameter value stands for, if it has one: numbers, booleans and numeric text.
+        bool toNumber(const DynamicVar& value, double& number) {
+            if (value.isEmpty()) {
+                return false;
+            }
+
+            if (value.isNumeric() || value.isBoolean()) {
+                number = value.convert<double>();
+                return true;
+            }
+
+            if (value.isString()) {
+                const auto& text = value.extract<std::string>();
+                char* end = nullptr;
+                number = std::strtod(text.c_str(), &end);
+                return !text.empty() && end == text.c_str() + text.size();
+            }
+
+            return false;
+        }
+    }
+
+    /**
+     * Constructor
+     *
+     * @param type DisturbanceConditionType
+     * @param target DynamicVar&, a value; the lower and upper bound for Between; the list of values for In and NotIn
+     * @exception std::invalid_argument: Handles error when the target of an ordered comparison isn't a number
+     * ************************/
+    DisturbanceConditionTarget::DisturbanceConditionTarget(DisturbanceConditionType type, const DynamicVar& target)
+        : _type(type) {
+
+        if (type == DisturbanceConditionType::Between) {
+            _min = target[0].convert<double>();
+            _max = target[1].convert<double>();
+        } else if (type == DisturbanceConditionType::In || type == DisturbanceConditionType::NotIn) {
+            for (const auto& item : target) {
+                double number;
+                if (toNumber(item, number)) {
+                    _numbers.insert(number);
+                }
+
+                if (!item.isEmpty()) {
+                    _texts.insert(item.convert<std::string>());
+                }
+            }
+        } else {
+            _isNumber = toNumber(target, _number);
+            if (!target.isEmpty()) {
+                _text = target.convert<std::string>();
+            }
+
+            if (!_isNumber && type != DisturbanceConditionType::EqualTo) {
+                throw std::invalid_argument("Disturbance condition target '" + _text + "' is not a number");
+            }
+        }
+    }
+
+    /**
+     * Return true if parameter value meets the condition.
+     *
+     * @param value double
+     * @return bool
+     * ************************/
+    bool DisturbanceConditionTarget::check(double value) const {
+        switch (_type) {
+        case DisturbanceConditionType::LessThan:
+            return value < _number;
+        case DisturbanceConditionType::EqualTo:
+            return _isNumber && value == _number;
+        case DisturbanceConditionType::AtLeast:
+            return value >= _number;
+        case DisturbanceConditionType::Between:
+            return value >= _min && value <= _max;
+        case DisturbanceConditionType::In:
+            return _numbers.find(value) != _numbers.end();
+        case DisturbanceConditionType::NotIn:
+            return _numbers.find(value) == _numbers.end();
+        }
+
+        return false;
+    }
+
+    /**
+     * Return true if parameter value meets the condition: text is compared to the text form of \n
+     * the target for equality and In/NotIn, and as a number otherwise; an empty value equals nothing.
+     *
+     * @param value DynamicVar&
+     * @return bool
+     * ************************/
+    bool DisturbanceConditionTarget::check(const DynamicVar& value) const {
+        bool isEquality = _type == DisturbanceConditionType::EqualTo
+                       || _type == DisturbanceConditionType::In
+                       || _type == DisturbanceConditionType::NotIn;
+
+        if (isEquality && value.isEmpty()) {
+            return _type == DisturbanceConditionType::NotIn;
+        }
+
+        if (isEquality && value.isString()) {
+            const auto& text = value.extract<std::string>();
+            return _type == DisturbanceConditionType::EqualTo ? text == _text
+                 : _type == DisturbanceConditionType::In ? _texts.find(text) != _texts.end()
+                 : _texts.find(text) == _texts.end();
+        }
+
+        return check(value.convert<double>());
+    }
+
+}}} // namespace moja::modules::cbm
@@ -0,0 +1,62 @@
+/**
+ * @file
+ * The disturbance events of a land unit, sorted once when they are loaded and walked
+ * year by year by CBMDisturbanceListener.
+ * ******************/
+
+#include "moja/modules/cbm/disturbanceeventqueue.h"
+
+#include <algorithm>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * Remove every event, keeping the capacity of the array for the next land unit.
+     *
+     * @return void
+     * ************************/
+    void DisturbanceEventQueue::clear() {
+        _events.clear();
+        _next = 0;
+    }
+
+    /**
+     * Sort the events by year, then by order rank, keeping the load order of events with the \n
+     * same year and rank, and move the cursor back to the first event.
+     *
+     * @return void
+     * ************************/
+    void DisturbanceEventQueue::sort() {
+        std::stable_sort(_events.begin(), _events.end(),
+            [](const CBMDistEventRef& first, const CBMDistEventRef& second) {
+                return first.year() != second.year() ? first.year() < second.year()
+                                                     : first.order() < second.order();
+            });
+
+        _next = 0;
+    }
+
+    /**
+     * Return the range of events in parameter year. Events of earlier years are passed over \n
+     * and won't be returned again, so years must be asked for in increasing order; asking for \n
+     * the same year again returns the same range.
+     *
+     * @param year int
+     * @return pair<iterator, iterator>
+     * ************************/
+    std::pair<DisturbanceEventQueue::iterator, DisturbanceEventQueue::iterator> DisturbanceEventQueue::eventsIn(int year) {
+        while (_next < _events.size() && _events[_next].year() < year) {
+            _next++;
+        }
+
+        size_t end = _next;
+        while (end < _events.size() && _events[end].year() == year) {
+            end++;
+        }
+
+        return std::make_pair(_events.begin() + _next, _events.begin() + end);
+    }
+
+}}} // namespace moja::modules::cbm
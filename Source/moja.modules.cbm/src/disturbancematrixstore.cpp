@@ -0,0 +1,112 @@
+/**
+ * @file
+ * Compact, shared store of the disturbance matrices applied by disturbance events.
+ */
+
+#include "moja/modules/cbm/disturbancematrixstore.h"
+
+#include <stdexcept>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+	/**
+	 * Build the store from parameter transfers, the rows of the "disturbance_matrices" variable \n
+	 * ("disturbance_matrix_id", "source_pool_name", "dest_pool_name", "proportion"), resolving pool \n
+	 * names with parameter poolIndices. Each matrix keeps its transfers in the order of the rows. \n
+	 * Only the first call builds the store; later calls, from other threads, return once it is built.
+	 *
+	 * @param transfers vector<DynamicObject>&
+	 * @param poolIndices unordered_map<string, int>&, pool idx by pool name
+	 * @exception std::invalid_argument: Handles error when a transfer refers to an unknown pool
+	 * @return void
+	 * ************************/
+	void DisturbanceMatrixStore::initialize(const std::vector<DynamicObject>& transfers,
+											const std::unordered_map<std::string, int>& poolIndices) {
+		if (_initialized) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(_initializeLock);
+		if (_initialized) {
+			return;
+		}
+
+		auto poolIndex = [&poolIndices](const std::string& pool) {
+			auto it = poolIndices.find(pool);
+			if (it == poolIndices.end()) {
+				throw std::invalid_argument("Disturbance matrix refers to unknown pool " + pool);
+			}
+
+			return it->second;
+		};
+
+		// First pass: number the matrices in order of appearance and count their transfers.
+		// Starts over if an earlier attempt failed part way.
+		_matrixIndex.clear();
+		_matrixIds.clear();
+		std::vector<int> dmIds;
+		dmIds.reserve(transfers.size());
+		std::vector<size_t> counts;
+		for (const auto& row : transfers) {
+			int dmId = row["disturbance_matrix_id"];
+			auto matrix = _matrixIndex.find(dmId);
+			if (matrix == _matrixIndex.end()) {
+				matrix = _matrixIndex.emplace(dmId, _matrixIds.size()).first;
+				_matrixIds.push_back(dmId);
+				counts.push_back(0);
+			}
+
+			counts[matrix->second]++;
+			dmIds.push_back(dmId);
+		}
+
+		_offsets.assign(counts.size() + 1, 0);
+		for (size_t i = 0; i < counts.size(); i++) {
+			_offsets[i + 1] = _offsets[i] + counts[i];
+		}
+
+		// Second pass: place each transfer in its matrix's range.
+		_sources.resize(transfers.size());
+		_sinks.resize(transfers.size());
+		_proportions.resize(transfers.size());
+		std::vector<size_t> next(_offsets.begin(), _offsets.end() - 1);
+		for (size_t i = 0; i < transfers.size(); i++) {
+			const auto& row = transfers[i];
+			auto position = next[_matrixIndex[dmIds[i]]]++;
+			_sources[position] = poolIndex(row["source_pool_name"].convert<std::string>());
+			_sinks[position] = poolIndex(row["dest_pool_name"].convert<std::string>());
+			_proportions[position] = row["proportion"];
+		}
+
+		_initialized = true;
+	}
+
+	/**
+	 * Return true if the store has a disturbance matrix with parameter disturbanceMatrixId.
+	 *
+	 * @param disturbanceMatrixId int
+	 * @return bool
+	 * ************************/
+	bool DisturbanceMatrixStore::contains(int disturbanceMatrixId) const {
+		return _matrixIndex.find(disturbanceMatrixId) != _matrixIndex.end();
+	}
+
+	/**
+	 * Return a view of the disturbance matrix with parameter disturbanceMatrixId, or an empty \n
+	 * matrix if there is none.
+	 *
+	 * @param disturbanceMatrixId int
+	 * @return DisturbanceMatrixStore::Matrix
+	 * ************************/
+	DisturbanceMatrixStore::Matrix DisturbanceMatrixStore::matrix(int disturbanceMatrixId) const {
+		auto it = _matrixIndex.find(disturbanceMatrixId);
+		if (it == _matrixIndex.end()) {
+			return Matrix();
+		}
+
+		return Matrix(this, disturbanceMatrixId, _offsets[it->second], _offsets[it->second + 1]);
+	}
+
+}}} // namespace moja::modules::cbm
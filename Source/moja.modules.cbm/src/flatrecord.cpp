@@ -40,19 +40,31 @@ namespace cbm {
         return classifierStr;
     }
 
+    void FlatRecordHelper::VisitClassifierValues(const std::vector<Poco::Nullable<std::string>>& classifierValues, FlatRecordColumnVisitor& visitor) {
+        for (const auto& value : classifierValues) {
+            if (value.isNull()) {
+                visitor.null(FlatColumnType::Text);
+            } else {
+                visitor.text(value.value());
+            }
+        }
+    }
+
     // -- FlatFluxRecord
     FlatFluxRecord::FlatFluxRecord(
-        int year, const std::vector<Poco::Nullable<std::string>>& classifierValues, const std::string& landClass,
-        const std::string& ageClass, const std::vector<Poco::Nullable<std::string>>& previousClassifierValues,
+        int year, const ClassifierSetRef& classifierSet, const std::string& landClass,
+        const std::string& ageClass, const ClassifierSetRef& previousClassifierSet,
         const std::string& previousLandClass, const std::string& previousAgeClass, const Poco::Nullable<std::string>& disturbanceType,
-        const Poco::Nullable<int>& disturbanceCode, const std::string& srcPool, const std::string& dstPool, double flux
-    ) : _year(year), _classifierValues(classifierValues), _landClass(landClass), _ageClass(ageClass),
-        _previousClassifierValues(previousClassifierValues), _previousLandClass(previousLandClass),
+        const Poco::Nullable<int>& disturbanceCode, const PoolRef& srcPool, const PoolRef& dstPool, double flux
+    ) : _year(year), _classifierSet(classifierSet), _landClass(landClass), _ageClass(ageClass),
+        _previousClassifierSet(previousClassifierSet), _previousLandClass(previousLandClass),
         _previousAgeClass(previousAgeClass), _disturbanceType(disturbanceType), _disturbanceCode(disturbanceCode),
         _srcPool(srcPool), _dstPool(dstPool), _flux(flux) { }
 
     bool FlatFluxRecord::operator==(const FlatFluxRecord& other) const {
-        bool isEqual = _year == other._year
+        return _year == other._year
+            && _classifierSet == other._classifierSet
+            && _previousClassifierSet == other._previousClassifierSet
 			&& _landClass == other._landClass
             && _ageClass == other._ageClass
 			&& _previousLandClass == other._previousLandClass
@@ -61,40 +73,14 @@ namespace cbm {
             && _disturbanceCode.value(-1) == other._disturbanceCode.value(-1)
             && _srcPool == other._srcPool
             && _dstPool == other._dstPool;
-
-        if (!isEqual) {
-            return false;
-        }
-
-        for (int i = 0; i < other._classifierValues.size(); i++) {
-            if (_classifierValues[i].value("") != other._classifierValues[i].value("")) {
-                return false;
-            }
-        }
-
-        for (int i = 0; i < other._previousClassifierValues.size(); i++) {
-            if (_previousClassifierValues[i].value("") != other._previousClassifierValues[i].value("")) {
-                return false;
-            }
-        }
-
-        return true;
     }
 
     size_t FlatFluxRecord::hash() const {
         if (_hash == -1) {
-            size_t hash = 0;
-            hash = moja::hash::hash_combine(hash, _disturbanceType.value(""), _disturbanceCode.value(-1));
-            for (const auto& classifier : _classifierValues) {
-                hash = moja::hash::hash_combine(hash, classifier.value(""));
-            }
-
-            for (const auto& classifier : _previousClassifierValues) {
-                hash = moja::hash::hash_combine(hash, classifier.value(""));
-            }
-
+            size_t hash = moja::hash::hash_combine(
+                _classifierSet.id(), _previousClassifierSet.id(), _disturbanceType.value(""), _disturbanceCode.value(-1));
             _hash = moja::hash::hash_combine(
-                hash, _year, _landClass, _ageClass, _previousLandClass, _previousAgeClass, _srcPool, _dstPool);
+                hash, _year, _landClass, _ageClass, _previousLandClass, _previousAgeClass, _srcPool.idx(), _dstPool.idx());
         }
 
         return _hash;
@@ -109,24 +95,24 @@ namespace cbm {
     }
 
     std::string FlatFluxRecord::asPersistable() const {
-        auto classifierStr = FlatRecordHelper::BuildClassifierValueString(_classifierValues);
-        auto previousClassifierStr = FlatRecordHelper::BuildClassifierValueString(_previousClassifierValues);
+        auto classifierStr = FlatRecordHelper::BuildClassifierValueString(_classifierSet.values());
+        auto previousClassifierStr = FlatRecordHelper::BuildClassifierValueString(_previousClassifierSet.values());
 
         return (boost::format("%1%,%2%,%3%,%4%,%5%,%6%,%7%,\"%8%\",%9%,%10%,%11%,%12%\n")
             % _year % classifierStr % _landClass % _ageClass % previousClassifierStr % _previousLandClass
-            % _previousAgeClass % _disturbanceType % _disturbanceCode % _srcPool % _dstPool % _flux).str();
+            % _previousAgeClass % _disturbanceType % _disturbanceCode % _srcPool.name() % _dstPool.name() % _flux).str();
     }
 
     std::vector<std::optional<std::string>> FlatFluxRecord::asVector() const {
         std::vector<std::optional<std::string>> row;
         row.push_back(pqxx::to_string(_year));
-        for (const auto& value : _classifierValues) {
+        for (const auto& value : _classifierSet.values()) {
             row.push_back(value.isNull() ? std::optional<std::string>(std::nullopt) : value.value());
         }
 
         row.push_back(_landClass);
         row.push_back(_ageClass);
-        for (const auto& value : _previousClassifierValues) {
+        for (const auto& value : _previousClassifierSet.values()) {
             row.push_back(value.isNull() ? std::optional<std::string>(std::nullopt) : value.value());
         }
 
@@ -134,51 +120,60 @@ namespace cbm {
         row.push_back(_previousAgeClass);
         row.push_back(_disturbanceType.isNull() ? std::optional<std::string>(std::nullopt) : pqxx::to_string(_disturbanceType.value()));
         row.push_back(_disturbanceCode.isNull() ? std::optional<std::string>(std::nullopt) : pqxx::to_string(_disturbanceCode.value()));
-        row.push_back(_srcPool);
-        row.push_back(_dstPool);
+        row.push_back(_srcPool.name());
+        row.push_back(_dstPool.name());
         row.push_back(pqxx::to_string(_flux));
 
         return row;
     }
 
+    void FlatFluxRecord::visitColumns(FlatRecordColumnVisitor& visitor) const {
+        visitor.integer(_year);
+        FlatRecordHelper::VisitClassifierValues(_classifierSet.values(), visitor);
+        visitor.text(_landClass);
+        visitor.text(_ageClass);
+        FlatRecordHelper::VisitClassifierValues(_previousClassifierSet.values(), visitor);
+        visitor.text(_previousLandClass);
+        visitor.text(_previousAgeClass);
+        if (_disturbanceType.isNull()) {
+            visitor.null(FlatColumnType::Text);
+        } else {
+            visitor.text(_disturbanceType.value());
+        }
+
+        if (_disturbanceCode.isNull()) {
+            visitor.null(FlatColumnType::Integer);
+        } else {
+            visitor.integer(_disturbanceCode.value());
+        }
+
+        visitor.text(_srcPool.name());
+        visitor.text(_dstPool.name());
+        visitor.number(_flux);
+    }
+
     void FlatFluxRecord::merge(const FlatFluxRecord& other) {
         _flux += other._flux;
     }
     // --
 
 	// -- FlatPoolRecord
-    FlatPoolRecord::FlatPoolRecord(int year, const std::vector<Poco::Nullable<std::string>>& classifierValues,
-                                   const std::string& landClass, const std::string& ageClass, const std::string& pool, double value)
-        : _year(year), _classifierValues(classifierValues), _landClass(landClass), _ageClass(ageClass),
+    FlatPoolRecord::FlatPoolRecord(int year, const ClassifierSetRef& classifierSet,
+                                   const std::string& landClass, const std::string& ageClass, const PoolRef& pool, double value)
+        : _year(year), _classifierSet(classifierSet), _landClass(landClass), _ageClass(ageClass),
           _pool(pool), _value(value) { }
 
     bool FlatPoolRecord::operator==(const FlatPoolRecord& other) const {
-        bool isEqual = _year == other._year
+        return _year == other._year
+            && _classifierSet == other._classifierSet
             && _landClass == other._landClass
             && _ageClass == other._ageClass
             && _pool == other._pool;
-
-        if (!isEqual) {
-            return false;
-        }
-
-        for (int i = 0; i < other._classifierValues.size(); i++) {
-            if (_classifierValues[i].value("") != other._classifierValues[i].value("")) {
-                return false;
-            }
-        }
-
-        return true;
     }
 
     size_t FlatPoolRecord::hash() const {
         if (_hash == -1) {
-            size_t hash = 0;
-            for (const auto& classifier : _classifierValues) {
-                hash = moja::hash::hash_combine(hash, classifier.value(""));
-            }
-
-            _hash = moja::hash::hash_combine(hash, _year, _landClass, _ageClass, _pool);
+            _hash = moja::hash::hash_combine(_classifierSet.id(), _year, _landClass, _ageClass, _pool.idx());
         }
 
         return _hash;
@@ -191,63 +186,56 @@ namespace cbm {
     }
 
     std::string FlatPoolRecord::asPersistable() const {
-        auto classifierStr = FlatRecordHelper::BuildClassifierValueString(_classifierValues);
+        auto classifierStr = FlatRecordHelper::BuildClassifierValueString(_classifierSet.values());
 
         return (boost::format("%1%,%2%,%3%,%4%,%5%,%6%\n")
-            % _year % classifierStr % _landClass % _ageClass % _pool % _value).str();
+            % _year % classifierStr % _landClass % _ageClass % _pool.name() % _value).str();
     }
 
     std::vector<std::optional<std::string>> FlatPoolRecord::asVector() const {
         std::vector<std::optional<std::string>> row;
         row.push_back(pqxx::to_string(_year));
-        for (const auto& value : _classifierValues) {
+        for (const auto& value : _classifierSet.values()) {
             row.push_back(value.isNull() ? std::optional<std::string>(std::nullopt) : value.value());
         }
 
         row.push_back(_landClass);
         row.push_back(_ageClass);
-        row.push_back(_pool);
+        row.push_back(_pool.name());
         row.push_back(pqxx::to_string(_value));
 
         return row;
     }
 
+    void FlatPoolRecord::visitColumns(FlatRecordColumnVisitor& visitor) const {
+        visitor.integer(_year);
+        FlatRecordHelper::VisitClassifierValues(_classifierSet.values(), visitor);
+        visitor.text(_landClass);
+        visitor.text(_ageClass);
+        visitor.text(_pool.name());
+        visitor.number(_value);
+    }
+
     void FlatPoolRecord::merge(const FlatPoolRecord& other) {
         _value += other._value;
     }
     // --
 
 	// -- FlatErrorRecord
-    FlatErrorRecord::FlatErrorRecord(int year, const std::vector<Poco::Nullable<std::string>>& classifierValues,
+    FlatErrorRecord::FlatErrorRecord(int year, const ClassifierSetRef& classifierSet,
                                      const std::string& module, const std::string& error, double area)
-		: _year(year), _classifierValues(classifierValues), _module(module), _error(error), _area(area) { }
+		: _year(year), _classifierSet(classifierSet), _module(module), _error(error), _area(area) { }
 
 	bool FlatErrorRecord::operator==(const FlatErrorRecord& other) const {
-        bool isEqual = _year == other._year
+        return _year == other._year
+            && _classifierSet == other._classifierSet
             && _module == other._module
             && _error == other._error;
-
-        if (!isEqual) {
-            return false;
-        }
-
-        for (int i = 0; i < other._classifierValues.size(); i++) {
-            if (_classifierValues[i].value("") != other._classifierValues[i].value("")) {
-                return false;
-            }
-        }
-
-        return true;
     }
 
 	size_t FlatErrorRecord::hash() const {
         if (_hash == -1) {
-            size_t hash = 0;
-            for (const auto& classifier : _classifierValues) {
-                hash = moja::hash::hash_combine(hash, classifier.value(""));
-            }
-
-            _hash = moja::hash::hash_combine(hash, _year, _module, _error);
+            _hash = moja::hash::hash_combine(_classifierSet.id(), _year, _module, _error);
         }
 
         return _hash;
@@ -260,7 +248,7 @@ namespace cbm {
     }
 
     std::string FlatErrorRecord::asPersistable() const {
-        auto classifierStr = FlatRecordHelper::BuildClassifierValueString(_classifierValues);
+        auto classifierStr = FlatRecordHelper::BuildClassifierValueString(_classifierSet.values());
         auto errorStr = _error;
         boost::replace_all(errorStr, "\"", "'");
 
@@ -271,7 +259,7 @@ namespace cbm {
     std::vector<std::optional<std::string>> FlatErrorRecord::asVector() const {
         std::vector<std::optional<std::string>> row;
         row.push_back(pqxx::to_string(_year));
-        for (const auto& value : _classifierValues) {
+        for (const auto& value : _classifierSet.values()) {
             row.push_back(value.isNull() ? std::optional<std::string>(std::nullopt) : value.value());
         }
 
@@ -282,42 +270,34 @@ namespace cbm {
         return row;
     }
 
+    void FlatErrorRecord::visitColumns(FlatRecordColumnVisitor& visitor) const {
+        visitor.integer(_year);
+        FlatRecordHelper::VisitClassifierValues(_classifierSet.values(), visitor);
+        visitor.text(_module);
+        visitor.text(_error);
+        visitor.number(_area);
+    }
+
     void FlatErrorRecord::merge(const FlatErrorRecord& other) {
         _area += other._area;
     }
     // --
 
 	// -- FlatAgeAreaRecord
-    FlatAgeAreaRecord::FlatAgeAreaRecord(int year, std::vector<Poco::Nullable<std::string>>& classifierValues,
+    FlatAgeAreaRecord::FlatAgeAreaRecord(int year, const ClassifierSetRef& classifierSet,
                                          std::string& landClass, std::string& ageClass, double area)
-		: _year(year), _classifierValues(classifierValues), _landClass(landClass), _ageClass(ageClass), _area(area) { }
+		: _year(year), _classifierSet(classifierSet), _landClass(landClass), _ageClass(ageClass), _area(area) { }
 
 	bool FlatAgeAreaRecord::operator==(const FlatAgeAreaRecord& other) const {
-        bool isEqual = _year == other._year
+        return _year == other._year
+            && _classifierSet == other._classifierSet
             && _landClass == other._landClass
             && _ageClass == other._ageClass;
-
-        if (!isEqual) {
-            return false;
-        }
-
-        for (int i = 0; i < other._classifierValues.size(); i++) {
-            if (_classifierValues[i].value("") != other._classifierValues[i].value("")) {
-                return false;
-            }
-        }
-
-        return true;
     }
 
 	size_t FlatAgeAreaRecord::hash() const {
         if (_hash == -1) {
-            size_t hash = 0;
-            for (const auto& classifier : _classifierValues) {
-                hash = moja::hash::hash_combine(hash, classifier.value(""));
-            }
-
-            _hash = moja::hash::hash_combine(hash, _year, _landClass, _ageClass);
+            _hash = moja::hash::hash_combine(_classifierSet.id(), _year, _landClass, _ageClass);
         }
 
         return _hash;
@@ -330,7 +310,7 @@ namespace cbm {
     }
 
     std::string FlatAgeAreaRecord::asPersistable() const {
-        auto classifierStr = FlatRecordHelper::BuildClassifierValueString(_classifierValues);
+        auto classifierStr = FlatRecordHelper::BuildClassifierValueString(_classifierSet.values());
 
         return (boost::format("%1%,%2%,%3%,%4%,%5%\n") % _year % classifierStr % _landClass % _ageClass % _area).str();
     }
@@ -338,7 +318,7 @@ namespace cbm {
     std::vector<std::optional<std::string>> FlatAgeAreaRecord::asVector() const {
         std::vector<std::optional<std::string>> row;
         row.push_back(pqxx::to_string(_year));
-        for (const auto& value : _classifierValues) {
+        for (const auto& value : _classifierSet.values()) {
             row.push_back(value.isNull() ? std::optional<std::string>(std::nullopt) : value.value());
         }
 
@@ -349,6 +329,14 @@ namespace cbm {
         return row;
     }
 
+    void FlatAgeAreaRecord::visitColumns(FlatRecordColumnVisitor& visitor) const {
+        visitor.integer(_year);
+        FlatRecordHelper::VisitClassifierValues(_classifierSet.values(), visitor);
+        visitor.text(_landClass);
+        visitor.text(_ageClass);
+        visitor.number(_area);
+    }
+
     void FlatAgeAreaRecord::merge(const FlatAgeAreaRecord& other) {
 		_area += other._area;
 	}
@@ -356,54 +344,30 @@ namespace cbm {
 
     // -- FlatDisturbanceRecord
     FlatDisturbanceRecord::FlatDisturbanceRecord(
-        int year, const std::vector<Poco::Nullable<std::string>>& classifierValues, const std::string& landClass,
-        const std::string& ageClass, const std::vector<Poco::Nullable<std::string>>& previousClassifierValues,
+        int year, const ClassifierSetRef& classifierSet, const std::string& landClass,
+        const std::string& ageClass, const ClassifierSetRef& previousClassifierSet,
         const std::string& previousLandClass, const std::string& previousAgeClass,
         const std::string& disturbanceType, int disturbanceCode, double area
-    ) : _year(year), _classifierValues(classifierValues), _landClass(landClass), _ageClass(ageClass),
-        _previousClassifierValues(previousClassifierValues), _previousLandClass(previousLandClass),
+    ) : _year(year), _classifierSet(classifierSet), _landClass(landClass), _ageClass(ageClass),
+        _previousClassifierSet(previousClassifierSet), _previousLandClass(previousLandClass),
         _previousAgeClass(previousAgeClass), _disturbanceType(disturbanceType), _disturbanceCode(disturbanceCode),
         _area(area) { }
 
     bool FlatDisturbanceRecord::operator==(const FlatDisturbanceRecord& other) const {
-        bool isEqual = _year == other._year
+        return _year == other._year
+            && _classifierSet == other._classifierSet
+            && _previousClassifierSet == other._previousClassifierSet
             && _landClass == other._landClass
             && _ageClass == other._ageClass
             && _previousLandClass == other._previousLandClass
             && _previousAgeClass == other._previousAgeClass
             && _disturbanceType == other._disturbanceType
             && _disturbanceCode == other._disturbanceCode;
-
-        if (!isEqual) {
-            return false;
-        }
-
-        for (int i = 0; i < other._classifierValues.size(); i++) {
-            if (_classifierValues[i].value("") != other._classifierValues[i].value("")) {
-                return false;
-            }
-        }
-
-        for (int i = 0; i < other._previousClassifierValues.size(); i++) {
-            if (_previousClassifierValues[i].value("") != other._previousClassifierValues[i].value("")) {
-                return false;
-            }
-        }
-
-        return true;
     }
 
     size_t FlatDisturbanceRecord::hash() const {
         if (_hash == -1) {
-            size_t hash = 0;
-            for (const auto& classifier : _classifierValues) {
-                hash = moja::hash::hash_combine(hash, classifier.value(""));
-            }
-
-            for (const auto& classifier : _previousClassifierValues) {
-                hash = moja::hash::hash_combine(hash, classifier.value(""));
-            }
-
+            size_t hash = moja::hash::hash_combine(_classifierSet.id(), _previousClassifierSet.id());
             _hash = moja::hash::hash_combine(
                 hash, _year, _landClass, _ageClass, _previousLandClass, _previousAgeClass,
                 _disturbanceType, _disturbanceCode);
@@ -421,8 +385,8 @@ namespace cbm {
     }
 
     std::string FlatDisturbanceRecord::asPersistable() const {
-        auto classifierStr = FlatRecordHelper::BuildClassifierValueString(_classifierValues);
-        auto previousClassifierStr = FlatRecordHelper::BuildClassifierValueString(_previousClassifierValues);
+        auto classifierStr = FlatRecordHelper::BuildClassifierValueString(_classifierSet.values());
+        auto previousClassifierStr = FlatRecordHelper::BuildClassifierValueString(_previousClassifierSet.values());
 
         return (boost::format("%1%,%2%,%3%,%4%,%5%,%6%,%7%,\"%8%\",%9%,%10%\n")
             % _year % classifierStr % _landClass % _ageClass % previousClassifierStr % _previousLandClass
@@ -432,13 +396,13 @@ namespace cbm {
     std::vector<std::optional<std::string>> FlatDisturbanceRecord::asVector() const {
         std::vector<std::optional<std::string>> row;
         row.push_back(pqxx::to_string(_year));
-        for (const auto& value : _classifierValues) {
+        for (const auto& value : _classifierSet.values()) {
             row.push_back(value.isNull() ? std::optional<std::string>(std::nullopt) : value.value());
         }
 
         row.push_back(_landClass);
         row.push_back(_ageClass);
-        for (const auto& value : _previousClassifierValues) {
+        for (const auto& value : _previousClassifierSet.values()) {
             row.push_back(value.isNull() ? std::optional<std::string>(std::nullopt) : value.value());
         }
 
@@ -451,6 +415,19 @@ namespace cbm {
         return row;
     }
 
+    void FlatDisturbanceRecord::visitColumns(FlatRecordColumnVisitor& visitor) const {
+        visitor.integer(_year);
+        FlatRecordHelper::VisitClassifierValues(_classifierSet.values(), visitor);
+        visitor.text(_landClass);
+        visitor.text(_ageClass);
+        FlatRecordHelper::VisitClassifierValues(_previousClassifierSet.values(), visitor);
+        visitor.text(_previousLandClass);
+        visitor.text(_previousAgeClass);
+        visitor.text(_disturbanceType);
+        visitor.integer(_disturbanceCode);
+        visitor.number(_area);
+    }
+
     void FlatDisturbanceRecord::merge(const FlatDisturbanceRecord& other) {
         _area += other._area;
     }
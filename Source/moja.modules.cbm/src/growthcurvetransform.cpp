@@ -4,9 +4,7 @@
 #include <moja/datarepository/datarepository.h>
 #include <moja/logging.h>
 
-#include <boost/format.hpp>
 #include <boost/algorithm/string/join.hpp>
-#include <boost/algorithm/string.hpp>
 
 
 using moja::datarepository::IProviderRelationalInterface;
@@ -17,7 +15,8 @@ namespace cbm {
 
     /**
      * Assign GrowthCurveTransform._landUnitController, GrowthCurveTransform._dataRepository as parameters &landUnitController, &dataRepository \n
-     * GrowthCurveTransform._provider, GrowthCurveTransform._csetVar value of "provider", "classifier_set_var" in parameter config
+     * GrowthCurveTransform._provider, GrowthCurveTransform._csetVar value of "provider", "classifier_set_var" in parameter config \n
+     * Load the classifier values of every growth curve into GrowthCurveTransform._growthCurveIndex, unless another thread already has
      * 
      * @param config DynamicObject
      * @param landUnitController const flint::ILandUnitController&
@@ -38,6 +37,10 @@ namespace cbm {
 
         auto csetVarName = config["classifier_set_var"].convert<std::string>();
         _csetVar = _landUnitController->getVariable(csetVarName);
+
+        if (!_growthCurveIndex->isInitialized()) {
+            _growthCurveIndex->initialize(loadClassifierValues());
+        }
     }
 
     /**
@@ -51,38 +54,29 @@ namespace cbm {
     };
 
     /**
-     * Replace the placeholder values in SQL queries GrowthCurveTransform._baseSql, GrowthCurveTransform._matchSql
-     * 
-     * Create variables classifierNames, a vector of strings and classifierValuesSql, a string \n
-     * For each classifier in parameter classifierSet, append classifier.first to classifierNames, concatenate classifierValuesSql with the SQL query GrowthCurveTransform._matchSql, placeholder values
-     * clasifier.first and classifier.second (gives the classifier value)
-     * Assign a variable classifierNamesSql the join vector classifierNames, separated by "," \n
-     * Return the SQL query GrowthCurveTransform._baseSql with placeholders classifierNamesSql and classifierValuesSql
+     * Return one row for each classifier value of each growth curve in GrowthCurveTransform._provider
      * 
-     * @param classifierSet const DynamicObject&
-     * @return string
+     * @return vector<ClassifierMatchRow>
      * **********************/
-    const std::string GrowthCurveTransform::buildSql(const DynamicObject& classifierSet) const {
-        std::vector<std::string> classifierNames;
-        std::string classifierValuesSql = "";
-
-        for (const auto& classifier : classifierSet) {
-            const std::string& classifierName = classifier.first;
-            classifierNames.push_back("'" + classifierName + "'");
-
-            if (!classifier.second.isEmpty()) {
-                const std::string& classifierValue = classifier.second;
-                classifierValuesSql += (boost::format(_matchSql)
-                    % classifierName % classifierValue).str();
-            } else {
-                classifierValuesSql += (boost::format(_matchSql)
-                    % classifierName % "NULL").str();
+    std::vector<ClassifierMatchRow> GrowthCurveTransform::loadClassifierValues() const {
+        auto toRow = [](const DynamicObject& row) {
+            return ClassifierMatchRow{
+                row["growth_curve_id"].convert<int>(), "",
+                row["classifier_name"].convert<std::string>(),
+                row["classifier_value"].convert<std::string>() };
+        };
+
+        std::vector<ClassifierMatchRow> rows;
+        const auto& result = _provider->GetDataSet(_classifierValuesSql);
+        if (result.isVector()) {
+            for (const auto& row : result.extract<std::vector<DynamicObject>>()) {
+                rows.push_back(toRow(row));
             }
+        } else if (!result.isEmpty()) {
+            rows.push_back(toRow(result.extract<DynamicObject>()));
         }
 
-        std::string classifierNamesSql = boost::algorithm::join(classifierNames, ",");
-
-        return (boost::format(_baseSql) % classifierNamesSql % classifierValuesSql).str();
+        return rows;
     }
 
     /**
@@ -108,14 +102,11 @@ namespace cbm {
     }
 
     /**
-     * If value of GrowthCurveTransform._csetVar is empty assign GrowthCurveTransform._value as DynamicObject() and return GrowthCurveTransform._value \n
+     * If value of GrowthCurveTransform._csetVar is empty assign GrowthCurveTransform._value as DynamicVar() and return GrowthCurveTransform._value \n
      * Extract DynamicObject from the value of GrowthCurveTransform._csetVar and store it in variable cset \n
-     * Assign variable sql, the result of GrowthCurveTransform.buildSql() on argument cset \n
-     * If sql has a null value in GrowthCurveTransform._cache, return a pointer to the result \n
-     * If the result of GetDataSet() on GrowthCurveTransform._provider with argument sql has a size > 0, 
-     * add sql, and "growth_curve_id" at index 0 of the result to GrowthCurveTransform._cache, \n
-     * else add sql, and a variable of type DynamicVar to GrowthCurveTransform._cache, indicate an error and invoke GrowthCurveTransform.buildDebuggingInfo() with argument cset \n
-     * Return a pointer to the value of sql in GrowthCurveTransform._cache
+     * Assign GrowthCurveTransform._value the best matching growth curve ID for cset in GrowthCurveTransform._growthCurveIndex, \n
+     * else indicate an error, invoke GrowthCurveTransform.buildDebuggingInfo() with argument cset and assign GrowthCurveTransform._value as DynamicVar() \n
+     * Return GrowthCurveTransform._value
      * 
      * @return const DynamicVar&
      ***************************/
@@ -127,40 +118,28 @@ namespace cbm {
         }
 
         const auto& cset = csetVariableValue.extract<DynamicObject>();
-        
-        GCCacheKey key;
+
+        ClassifierMatchQuery classifierSet;
+        classifierSet.reserve(cset.size());
         for (const auto& classifier : cset) {
             if (!classifier.second.isEmpty()) {
                 const std::string& classifierValue = classifier.second;
-                key.add(classifierValue);
+                classifierSet.emplace_back(classifier.first, classifierValue);
             } else {
-                key.add("null");
+                classifierSet.emplace_back(classifier.first, "NULL");
             }
         }
 
-        auto cachedValue = _cache->get(key);
-        if (!cachedValue.isNull()) {
-            _value = *cachedValue;
-            return _value;
-        }
-
-        DynamicVar value;
-        const auto sql = buildSql(cset);
-        const auto& gc = _provider->GetDataSet(sql);
-        if (gc.size() > 0) {
-            auto& gcRows = gc.extract<const std::vector<DynamicObject>>();
-            int gcId = gcRows.at(0)["growth_curve_id"];
-            value = gcId;
+        const auto& matches = _growthCurveIndex->match(classifierSet);
+        if (!matches.empty()) {
+            _value = matches.front().second;
         } else {
             MOJA_LOG_DEBUG << "Error getting growth curve for classifier set: "
                            << buildDebuggingInfo(cset);
+            _value = DynamicVar();
         }
 
-        _cache->add(key, value);
-        _value = value;
-
         return _value;
     }
 
-}}} // namespace moja::modules::cbm
-
+}}} // namespace moja::modules::cbm
\ No newline at end of file
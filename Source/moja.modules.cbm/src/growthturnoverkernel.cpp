@@ -0,0 +1,282 @@
+/**
+ * @file
+ * Fused growth and turnover of a regular forest stand: the YieldTableGrowthModule half growth,
+ * mid-season growth and turnover transfers of a step, built as a single stock operation.
+ * ******************/
+
+#include "moja/modules/cbm/growthturnoverkernel.h"
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+	namespace {
+		const char* const GrowthPoolNames[GrowthTurnoverKernel::PoolCount] = {
+			"SoftwoodMerch", "SoftwoodOther", "SoftwoodFoliage", "SoftwoodCoarseRoots", "SoftwoodFineRoots",
+			"HardwoodMerch", "HardwoodOther", "HardwoodFoliage", "HardwoodCoarseRoots", "HardwoodFineRoots",
+			"SoftwoodStemSnag", "SoftwoodBranchSnag", "HardwoodStemSnag", "HardwoodBranchSnag",
+			"AboveGroundVeryFastSoil", "BelowGroundVeryFastSoil", "AboveGroundFastSoil", "BelowGroundFastSoil",
+			"MediumSoil", "Atmosphere"
+		};
+
+		// Live biomass and snag pools of a softwood or hardwood component.
+		struct ComponentPools {
+			GrowthPool merch;
+			GrowthPool other;
+			GrowthPool foliage;
+			GrowthPool coarseRoots;
+			GrowthPool fineRoots;
+			GrowthPool stemSnag;
+			GrowthPool branchSnag;
+		};
+
+		const ComponentPools SoftwoodPools = {
+			GrowthPool::SoftwoodMerch, GrowthPool::SoftwoodOther, GrowthPool::SoftwoodFoliage,
+			GrowthPool::SoftwoodCoarseRoots, GrowthPool::SoftwoodFineRoots,
+			GrowthPool::SoftwoodStemSnag, GrowthPool::SoftwoodBranchSnag
+		};
+
+		const ComponentPools HardwoodPools = {
+			GrowthPool::HardwoodMerch, GrowthPool::HardwoodOther, GrowthPool::HardwoodFoliage,
+			GrowthPool::HardwoodCoarseRoots, GrowthPool::HardwoodFineRoots,
+			GrowthPool::HardwoodStemSnag, GrowthPool::HardwoodBranchSnag
+		};
+
+		// Turnover rates of a softwood or hardwood component.
+		struct ComponentRates {
+			double foliageTurnover;
+			double stemTurnover;
+			double branchTurnover;
+			double stemSnagTurnover;
+			double branchSnagTurnover;
+			double coarseRootTurnover;
+			double fineRootTurnover;
+			double branchSnagSplit;
+			double coarseRootSplit;
+			double fineRootSplit;
+		};
+
+		ComponentRates softwoodRates(const TurnoverRates& rates) {
+			return ComponentRates{
+				rates.swFoliageTurnover(), rates.swStemTurnover(), rates.swBranchTurnover(),
+				rates.swStemSnagTurnover(), rates.swBranchSnagTurnover(), rates.swCoarseRootTurnover(),
+				rates.swFineRootTurnover(), rates.swBranchSnagSplit(), rates.swCoarseRootSplit(),
+				rates.swFineRootSplit()
+			};
+		}
+
+		ComponentRates hardwoodRates(const TurnoverRates& rates) {
+			return ComponentRates{
+				rates.hwFoliageTurnover(), rates.hwStemTurnover(), rates.hwBranchTurnover(),
+				rates.hwStemSnagTurnover(), rates.hwBranchSnagTurnover(), rates.hwCoarseRootTurnover(),
+				rates.hwFineRootTurnover(), rates.hwBranchSnagSplit(), rates.hwCoarseRootSplit(),
+				rates.hwFineRootSplit()
+			};
+		}
+
+		void add(std::vector<GrowthTransfer>& transfers, GrowthPool source, GrowthPool sink, double value) {
+			transfers.push_back(GrowthTransfer{ source, sink, value });
+		}
+
+		// Half of a component's increment; an overmature component's losses go to snags and soil.
+		void addComponentHalfGrowth(std::vector<GrowthTransfer>& transfers, const ComponentBiomassCarbonIncrements& increments,
+						   const ComponentPools& pools, const ComponentRates& rates) {
+
+			static double tolerance = -0.0001;
+			double m = increments.merch;
+			double o = increments.other;
+			double f = increments.foliage;
+			double cr = increments.coarseRoots;
+			double fr = increments.fineRoots;
+
+			bool overmature = m + o + f + cr + fr < tolerance;
+			if (overmature && m < 0) {
+				add(transfers, pools.merch, pools.stemSnag, -m / 2);
+			}
+			else {
+				add(transfers, GrowthPool::Atmosphere, pools.merch, m / 2);
+			}
+
+			if (overmature && o < 0) {
+				add(transfers, pools.other, pools.branchSnag, -o * rates.branchSnagSplit / 2);
+				add(transfers, pools.other, GrowthPool::AboveGroundFastSoil, -o * (1 - rates.branchSnagSplit) / 2);
+			}
+			else {
+				add(transfers, GrowthPool::Atmosphere, pools.other, o / 2);
+			}
+
+			if (overmature && f < 0) {
+				add(transfers, pools.foliage, GrowthPool::AboveGroundVeryFastSoil, -f / 2);
+			}
+			else {
+				add(transfers, GrowthPool::Atmosphere, pools.foliage, f / 2);
+			}
+
+			if (overmature && cr < 0) {
+				add(transfers, pools.coarseRoots, GrowthPool::AboveGroundFastSoil, -cr * rates.coarseRootSplit / 2);
+				add(transfers, pools.coarseRoots, GrowthPool::BelowGroundFastSoil, -cr * (1 - rates.coarseRootSplit) / 2);
+			}
+			else {
+				add(transfers, GrowthPool::Atmosphere, pools.coarseRoots, cr / 2);
+			}
+
+			if (overmature && fr < 0) {
+				add(transfers, pools.fineRoots, GrowthPool::AboveGroundVeryFastSoil, -fr * rates.fineRootSplit / 2);
+				add(transfers, pools.fineRoots, GrowthPool::BelowGroundVeryFastSoil, -fr * (1 - rates.fineRootSplit) / 2);
+			}
+			else {
+				add(transfers, GrowthPool::Atmosphere, pools.fineRoots, fr / 2);
+			}
+		}
+
+		// Regrowth of the biomass that is turned over during the season.
+		void addComponentMidSeasonGrowth(std::vector<GrowthTransfer>& transfers, const double* biomass,
+								const ComponentPools& pools, const ComponentRates& rates) {
+
+			add(transfers, GrowthPool::Atmosphere, pools.merch, biomass[int(pools.merch)] * rates.stemTurnover);
+			add(transfers, GrowthPool::Atmosphere, pools.other, biomass[int(pools.other)] * rates.branchTurnover);
+			add(transfers, GrowthPool::Atmosphere, pools.foliage, biomass[int(pools.foliage)] * rates.foliageTurnover);
+			add(transfers, GrowthPool::Atmosphere, pools.coarseRoots, biomass[int(pools.coarseRoots)] * rates.coarseRootTurnover);
+			add(transfers, GrowthPool::Atmosphere, pools.fineRoots, biomass[int(pools.fineRoots)] * rates.fineRootTurnover);
+		}
+
+		void addComponentSnagTurnover(std::vector<GrowthTransfer>& transfers, const double* snags,
+							 const ComponentPools& pools, const ComponentRates& rates) {
+
+			add(transfers, pools.stemSnag, GrowthPool::MediumSoil, snags[int(pools.stemSnag)] * rates.stemSnagTurnover);
+			add(transfers, pools.branchSnag, GrowthPool::AboveGroundFastSoil, snags[int(pools.branchSnag)] * rates.branchSnagTurnover);
+		}
+
+		void addComponentBiomassTurnover(std::vector<GrowthTransfer>& transfers, const double* biomass,
+								const ComponentPools& pools, const ComponentRates& rates) {
+
+			double merch = biomass[int(pools.merch)];
+			double other = biomass[int(pools.other)];
+			double foliage = biomass[int(pools.foliage)];
+			double coarseRoots = biomass[int(pools.coarseRoots)];
+			double fineRoots = biomass[int(pools.fineRoots)];
+
+			add(transfers, pools.merch, pools.stemSnag, merch * rates.stemTurnover);
+			add(transfers, pools.foliage, GrowthPool::AboveGroundVeryFastSoil, foliage * rates.foliageTurnover);
+			add(transfers, pools.other, pools.branchSnag, other * rates.branchSnagSplit * rates.branchTurnover);
+			add(transfers, pools.other, GrowthPool::AboveGroundFastSoil, other * (1 - rates.branchSnagSplit) * rates.branchTurnover);
+			add(transfers, pools.coarseRoots, GrowthPool::AboveGroundFastSoil, coarseRoots * rates.coarseRootSplit * rates.coarseRootTurnover);
+			add(transfers, pools.coarseRoots, GrowthPool::BelowGroundFastSoil, coarseRoots * (1 - rates.coarseRootSplit) * rates.coarseRootTurnover);
+			add(transfers, pools.fineRoots, GrowthPool::AboveGroundVeryFastSoil, fineRoots * rates.fineRootSplit * rates.fineRootTurnover);
+			add(transfers, pools.fineRoots, GrowthPool::BelowGroundVeryFastSoil, fineRoots * (1 - rates.fineRootSplit) * rates.fineRootTurnover);
+		}
+	}
+
+	/**
+	 * Return the name of parameter pool in the pool collection.
+	 *
+	 * @param pool GrowthPool
+	 * @return string
+	 * ************************/
+	std::string growthPoolName(GrowthPool pool) {
+		return GrowthPoolNames[int(pool)];
+	}
+
+	/**
+	 * Build the transfers of a year of growth and turnover for a stand with parameter increments, \n
+	 * already scaled by any growth multipliers, parameter rates and parameter pools, its pool values \n
+	 * by GrowthPool at the start of the step. \n
+	 * Snag turnover uses the snags at the start of the step; mid-season growth and biomass turnover \n
+	 * use the biomass after the first half of the increment, found by applying those transfers to a \n
+	 * copy of the pools the way a stock operation is applied.
+	 *
+	 * @param increments StandBiomassCarbonIncrements&
+	 * @param rates TurnoverRates&
+	 * @param pools double*
+	 * @return vector<GrowthTransfer>&
+	 * ************************/
+	const std::vector<GrowthTransfer>& GrowthTurnoverKernel::build(
+		const StandBiomassCarbonIncrements& increments, const TurnoverRates& rates, const double* pools) {
+
+		_transfers.clear();
+		addHalfGrowth(_transfers, increments, rates);
+		size_t halfGrowthEnd = _transfers.size();
+
+		for (int p = 0; p < PoolCount; p++) {
+			_pools[p] = pools[p];
+		}
+
+		for (const auto& transfer : _transfers) {
+			_pools[int(transfer.source)] -= transfer.value;
+			_pools[int(transfer.sink)] += transfer.value;
+		}
+
+		addMidSeasonGrowth(_transfers, rates, _pools);
+		addSnagTurnover(_transfers, rates, pools);
+		addBiomassTurnover(_transfers, rates, _pools);
+
+		// The second half of the increment is the same as the first.
+		for (size_t i = 0; i < halfGrowthEnd; i++) {
+			auto transfer = _transfers[i];
+			_transfers.push_back(transfer);
+		}
+
+		return _transfers;
+	}
+
+	/**
+	 * Append the transfers of half of parameter increments, softwood then hardwood, to parameter transfers.
+	 *
+	 * @param transfers vector<GrowthTransfer>&
+	 * @param increments StandBiomassCarbonIncrements&
+	 * @param rates TurnoverRates&
+	 * @return void
+	 * ************************/
+	void GrowthTurnoverKernel::addHalfGrowth(std::vector<GrowthTransfer>& transfers,
+											 const StandBiomassCarbonIncrements& increments, const TurnoverRates& rates) {
+
+		addComponentHalfGrowth(transfers, increments.softwood, SoftwoodPools, softwoodRates(rates));
+		addComponentHalfGrowth(transfers, increments.hardwood, HardwoodPools, hardwoodRates(rates));
+	}
+
+	/**
+	 * Append the mid-season growth transfers of parameter biomass, softwood then hardwood, to parameter transfers.
+	 *
+	 * @param transfers vector<GrowthTransfer>&
+	 * @param rates TurnoverRates&
+	 * @param biomass double*
+	 * @return void
+	 * ************************/
+	void GrowthTurnoverKernel::addMidSeasonGrowth(std::vector<GrowthTransfer>& transfers,
+												  const TurnoverRates& rates, const double* biomass) {
+
+		addComponentMidSeasonGrowth(transfers, biomass, SoftwoodPools, softwoodRates(rates));
+		addComponentMidSeasonGrowth(transfers, biomass, HardwoodPools, hardwoodRates(rates));
+	}
+
+	/**
+	 * Append the turnover transfers of parameter snags, softwood then hardwood, to parameter transfers.
+	 *
+	 * @param transfers vector<GrowthTransfer>&
+	 * @param rates TurnoverRates&
+	 * @param snags double*
+	 * @return void
+	 * ************************/
+	void GrowthTurnoverKernel::addSnagTurnover(std::vector<GrowthTransfer>& transfers,
+											   const TurnoverRates& rates, const double* snags) {
+
+		addComponentSnagTurnover(transfers, snags, SoftwoodPools, softwoodRates(rates));
+		addComponentSnagTurnover(transfers, snags, HardwoodPools, hardwoodRates(rates));
+	}
+
+	/**
+	 * Append the turnover transfers of parameter biomass, softwood then hardwood, to parameter transfers.
+	 *
+	 * @param transfers vector<GrowthTransfer>&
+	 * @param rates TurnoverRates&
+	 * @param biomass double*
+	 * @return void
+	 * ************************/
+	void GrowthTurnoverKernel::addBiomassTurnover(std::vector<GrowthTransfer>& transfers,
+												  const TurnoverRates& rates, const double* biomass) {
+
+		addComponentBiomassTurnover(transfers, biomass, SoftwoodPools, softwoodRates(rates));
+		addComponentBiomassTurnover(transfers, biomass, HardwoodPools, hardwoodRates(rates));
+	}
+
+}}} // namespace moja::modules::cbm
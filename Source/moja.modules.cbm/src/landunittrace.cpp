@@ -0,0 +1,228 @@
+/**
+ * @file
+ * Per unit area traces of simulated land units, replayed by CBMAggregatorLandUnitData for
+ * land units with the same inputs.
+ * ******************/
+
+#include "moja/modules/cbm/landunittrace.h"
+#include "moja/modules/cbm/parameterhash.h"
+#include "moja/modules/cbm/timeseries.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    namespace {
+        void appendNumber(std::string& signature, double value) {
+            // Hexadecimal floating point is exact, so distinct values never share a signature.
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%a", value);
+            signature += buffer;
+        }
+
+        void appendString(std::string& signature, const std::string& value) {
+            signature += std::to_string(value.size());
+            signature += ':';
+            signature += value;
+        }
+
+        // The inputs the CBM modules read for each land unit; the rest of a land unit's state is derived from them.
+        const std::vector<std::string> CBMInputs = {
+            "initial_classifier_set", "initial_age", "spatial_unit_id", "mean_annual_temperature",
+            "initial_historic_land_class", "initial_current_land_class", "growth_curve_id",
+            "last_pass_disturbance_timeseries", "last_fire_year", "fire_return_interval",
+            "enable_peatland", "peatland_class", "enable_moss"
+        };
+    }
+
+    /**
+     * Constructor
+     *
+     * Keep at most parameter maxTraces traces and remember at most parameter maxSignatures signatures \n
+     * that have been seen once. The inputs start as the ones the CBM modules read for each land unit.
+     *
+     * @param maxTraces size_t
+     * @param maxSignatures size_t
+     * ************************/
+    LandUnitTraceStore::LandUnitTraceStore(size_t maxTraces, size_t maxSignatures)
+        : _maxTraces(maxTraces), _maxSignatures(maxSignatures), _inputs(CBMInputs) { }
+
+    /**
+     * Set the number of traces and seen signatures to keep. Traces and signatures already kept stay.
+     *
+     * @param maxTraces size_t
+     * @param maxSignatures size_t
+     * @return void
+     * ************************/
+    void LandUnitTraceStore::setLimits(size_t maxTraces, size_t maxSignatures) {
+        std::lock_guard<std::mutex> lock(_lock);
+        _maxTraces = maxTraces;
+        _maxSignatures = maxSignatures;
+    }
+
+    /**
+     * Add the variables in parameter names, that aren't already there, to the inputs of a land unit.
+     *
+     * @param names vector<string>&
+     * @return void
+     * ************************/
+    void LandUnitTraceStore::addInputs(const std::vector<std::string>& names) {
+        std::lock_guard<std::mutex> lock(_lock);
+        for (const auto& name : names) {
+            if (std::find(_inputs.begin(), _inputs.end(), name) == _inputs.end()) {
+                _inputs.push_back(name);
+            }
+        }
+    }
+
+    /**
+     * Return the names of the variables that make up the inputs of a land unit.
+     *
+     * @return vector<string>
+     * ************************/
+    std::vector<std::string> LandUnitTraceStore::inputs() const {
+        std::lock_guard<std::mutex> lock(_lock);
+        return _inputs;
+    }
+
+    /**
+     * Return the trace of a land unit with parameter signature, or nullptr if none was kept.
+     *
+     * @param signature string&
+     * @return shared_ptr<const LandUnitTrace>
+     * ************************/
+    LandUnitTraceStore::TracePtr LandUnitTraceStore::find(const std::string& signature) const {
+        return _traces.find(signature);
+    }
+
+    /**
+     * Return true if a land unit with parameter signature should be traced: a land unit with the same \n
+     * signature has been seen before and there is room for another trace. Otherwise remember the \n
+     * signature's hash, while there is room for it, and return false.
+     *
+     * @param signature string&
+     * @return bool
+     * ************************/
+    bool LandUnitTraceStore::shouldTrace(const std::string& signature) {
+        ParameterHash hash;
+        hash.add(signature);
+
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_traces.size() >= _maxTraces) {
+            return false;
+        }
+
+        if (_seenSignatures.count(hash.value()) > 0) {
+            return true;
+        }
+
+        if (_seenSignatures.size() < _maxSignatures) {
+            _seenSignatures.insert(hash.value());
+        }
+
+        return false;
+    }
+
+    /**
+     * Keep parameter trace for land units with parameter signature, unless there already is one or \n
+     * the store is full. Return true if the trace was kept.
+     *
+     * @param signature string&
+     * @param trace shared_ptr<const LandUnitTrace>
+     * @return bool
+     * ************************/
+    bool LandUnitTraceStore::insert(const std::string& signature, TracePtr trace) {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_traces.size() >= _maxTraces) {
+            return false;
+        }
+
+        return _traces.insert(signature, trace) == trace;
+    }
+
+    /**
+     * Clear the step, keeping the capacity of its vectors.
+     *
+     * @return void
+     * ************************/
+    void LandUnitStep::clear() {
+        isSpinup = false;
+        classifierSet = ClassifierSetRef();
+        landClass.clear();
+        ageClass.reset();
+        age = 0;
+        pools.clear();
+        operations.clear();
+        fluxes.clear();
+    }
+
+    /**
+     * Append parameter value to parameter signature. Strings are length-prefixed and containers are \n
+     * bracketed, so that two different values never append the same text; numbers are written \n
+     * exactly. Timeseries are written in full, not just their current value.
+     *
+     * @param signature string&
+     * @param value DynamicVar&
+     * @exception std::invalid_argument: Handles error when the value is of a type that can't be written
+     * @return void
+     * ************************/
+    void appendSignature(std::string& signature, const DynamicVar& value) {
+        if (value.isEmpty()) {
+            signature += 'n';
+        } else if (value.type() == typeid(DynamicObject)) {
+            signature += '{';
+            for (const auto& item : value.extract<DynamicObject>()) {
+                appendString(signature, item.first);
+                appendSignature(signature, item.second);
+            }
+
+            signature += '}';
+        } else if (value.type() == typeid(std::vector<DynamicObject>)) {
+            signature += '[';
+            for (const auto& item : value.extract<std::vector<DynamicObject>>()) {
+                appendSignature(signature, DynamicVar(item));
+            }
+
+            signature += ']';
+        } else if (value.type() == typeid(std::vector<DynamicVar>)) {
+            signature += '[';
+            for (const auto& item : value.extract<std::vector<DynamicVar>>()) {
+                appendSignature(signature, item);
+            }
+
+            signature += ']';
+        } else if (value.type() == typeid(TimeSeries)) {
+            const auto& timeseries = value.extract<TimeSeries>();
+            signature += 't';
+            signature += std::to_string(timeseries.yr0()) + ',' + std::to_string(timeseries.dataPerYr()) + ','
+                       + std::to_string(timeseries.nYrs()) + ',' + std::to_string(int(timeseries.origin())) + ','
+                       + std::to_string(int(timeseries.extrap())) + ',' + std::to_string(timeseries.subSame());
+            signature += '[';
+            for (auto item : timeseries.series()) {
+                appendNumber(signature, item);
+                signature += ',';
+            }
+
+            signature += ']';
+        } else if (value.type() == typeid(double) || value.type() == typeid(float)) {
+            signature += 'd';
+            appendNumber(signature, value.convert<double>());
+        } else if (value.isNumeric() || value.isBoolean()) {
+            signature += 'i';
+            signature += value.convert<std::string>();
+        } else if (value.isString()) {
+            signature += 's';
+            appendString(signature, value.convert<std::string>());
+        } else {
+            throw std::invalid_argument(
+                std::string("Values of type ") + value.type().name() + " can't be part of a land unit signature");
+        }
+
+        signature += ';';
+    }
+
+}}} // namespace moja::modules::cbm
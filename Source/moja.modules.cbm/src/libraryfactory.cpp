@@ -6,6 +6,9 @@
 #include "moja/modules/cbm/cbmaggregatorcsvwriter.h"
 #include "moja/modules/cbm/cbmaggregatorlandunitdata.h"
 #include "moja/modules/cbm/cbmaggregatorlibpqxxwriter.h"
+#ifdef MOJA_MODULES_CBM_USE_PARQUET
+#include "moja/modules/cbm/cbmaggregatorparquetwriter.h"
+#endif
 #include "moja/modules/cbm/cbmaggregatorpostgresqlwriter.h"
 #include "moja/modules/cbm/cbmaggregatorsqlitewriter.h"
 #include "moja/modules/cbm/cbmbuildlandunitmodule.h"
@@ -21,6 +24,9 @@
 #include "moja/modules/cbm/cbmspinupdisturbancemodule.h"
 #include "moja/modules/cbm/cbmspinupsequencer.h"
 #include "moja/modules/cbm/cbmtransitionrulesmodule.h"
+#include "moja/modules/cbm/classifiermatchindex.h"
+#include "moja/modules/cbm/classifiersetinterner.h"
+#include "moja/modules/cbm/disturbancematrixstore.h"
 #include "moja/modules/cbm/disturbancemonitormodule.h"
 #include "moja/modules/cbm/dynamicgrowthcurvetransform.h"
 #include "moja/modules/cbm/dynamicgrowthcurvelookuptransform.h"
@@ -45,6 +51,7 @@
 #include "moja/modules/cbm/peatlandturnovermodule.h"
 #include "moja/modules/cbm/record.h"
 #include "moja/modules/cbm/smalltreegrowthmodule.h"
+#include "moja/modules/cbm/spinupcache.h"
 #include "moja/modules/cbm/standmaturitymodule.h"
 #include "moja/modules/cbm/standgrowthcurvefactory.h"
 #include "moja/modules/cbm/timeseriesidxfromflintdatatransform.h"
@@ -69,6 +76,14 @@ namespace moja {
 				classifierSetDimension = std::make_shared<flint::RecordAccumulatorWithMutex2<cbm::ClassifierSetRow, cbm::ClassifierSetRecord>>();
 				classifierNames = std::make_shared<std::vector<std::string>>();
 				classifierNamesLock = std::make_shared<Poco::Mutex>();
+				classifierSets = std::make_shared<cbm::ClassifierSetInterner>();
+				flushCoordinator = std::make_shared<cbm::RecordFlushCoordinator>();
+				spinupCache = std::make_shared<cbm::SpinupCache>();
+				spinupRegrowthStore = std::make_shared<cbm::SpinupRegrowthStore>();
+				landUnitTraces = std::make_shared<cbm::LandUnitTraceStore>();
+				disturbanceMatrices = std::make_shared<cbm::DisturbanceMatrixStore>();
+				growthCurveIndex = std::make_shared<cbm::ClassifierMatchIndex>();
+				transitionRuleIndex = std::make_shared<cbm::ClassifierMatchIndex>();
 				landClassDimension = std::make_shared<flint::RecordAccumulatorWithMutex2<cbm::LandClassRow, cbm::LandClassRecord>>();
 				locationDimension = std::make_shared<flint::RecordAccumulatorWithMutex2<cbm::TemporalLocationRow, cbm::TemporalLocationRecord>>();
 				poolDimension = std::make_shared<flint::RecordAccumulatorWithMutex2<cbm::PoolRow, cbm::PoolRecord>>();
@@ -91,6 +106,7 @@ namespace moja {
 				flatErrorDimension = std::make_shared<flint::RecordAccumulatorWithMutex2<std::string, cbm::FlatErrorRecord>>();
 				flatAgeDimension = std::make_shared<flint::RecordAccumulatorWithMutex2<std::string, cbm::FlatAgeAreaRecord>>();
 				flatDisturbanceDimension = std::make_shared<flint::RecordAccumulatorWithMutex2<std::string, cbm::FlatDisturbanceRecord>>();
+				flatPoolNames = std::make_shared<cbm::PoolNameTable>();
 			}
 
 			std::shared_ptr<flint::RecordAccumulatorWithMutex2<cbm::DateRow, cbm::DateRecord>> dateDimension;
@@ -98,6 +114,14 @@ namespace moja {
 			std::shared_ptr<flint::RecordAccumulatorWithMutex2<cbm::ClassifierSetRow, cbm::ClassifierSetRecord>> classifierSetDimension;
 			std::shared_ptr<std::vector<std::string>> classifierNames;
 			std::shared_ptr<Poco::Mutex> classifierNamesLock;
+			std::shared_ptr<cbm::ClassifierSetInterner> classifierSets;
+			std::shared_ptr<cbm::RecordFlushCoordinator> flushCoordinator;
+			std::shared_ptr<cbm::SpinupCache> spinupCache;
+			std::shared_ptr<cbm::SpinupRegrowthStore> spinupRegrowthStore;
+			std::shared_ptr<cbm::LandUnitTraceStore> landUnitTraces;
+			std::shared_ptr<cbm::DisturbanceMatrixStore> disturbanceMatrices;
+			std::shared_ptr<cbm::ClassifierMatchIndex> growthCurveIndex;
+			std::shared_ptr<cbm::ClassifierMatchIndex> transitionRuleIndex;
 			std::shared_ptr<flint::RecordAccumulatorWithMutex2<cbm::LandClassRow, cbm::LandClassRecord>> landClassDimension;
 			std::shared_ptr<flint::RecordAccumulatorWithMutex2<cbm::TemporalLocationRow, cbm::TemporalLocationRecord>> locationDimension;
 			std::shared_ptr<flint::RecordAccumulatorWithMutex2<cbm::PoolRow, cbm::PoolRecord>> poolDimension;
@@ -121,6 +145,7 @@ namespace moja {
 			std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, cbm::FlatErrorRecord>> flatErrorDimension;
 			std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, cbm::FlatAgeAreaRecord>> flatAgeDimension;
 			std::shared_ptr<flint::RecordAccumulatorWithMutex2<std::string, cbm::FlatDisturbanceRecord>> flatDisturbanceDimension;
+			std::shared_ptr<cbm::PoolNameTable> flatPoolNames;
 		};
 
 		static CBMObjectHolder cbmObjectHolder;
@@ -143,7 +168,10 @@ namespace moja {
 					cbmObjectHolder.ageClassDimension,
 					cbmObjectHolder.ageAreaDimension,
 					cbmObjectHolder.errorDimension,
-					cbmObjectHolder.locationErrorDimension);
+					cbmObjectHolder.locationErrorDimension,
+					cbmObjectHolder.classifierSets,
+					cbmObjectHolder.flushCoordinator,
+					cbmObjectHolder.landUnitTraces);
 			}
 
 			MOJA_LIB_API flint::IModule* CreateCBMAggregatorSQLiteWriter() {
@@ -164,6 +192,7 @@ namespace moja {
 					cbmObjectHolder.ageAreaDimension,
 					cbmObjectHolder.errorDimension,
 					cbmObjectHolder.locationErrorDimension,
+					cbmObjectHolder.flushCoordinator,
 					isPrimaryAggregator);
 			}
 
@@ -175,7 +204,10 @@ namespace moja {
 					cbmObjectHolder.flatAgeDimension,
 					cbmObjectHolder.flatDisturbanceDimension,
 					cbmObjectHolder.classifierNames,
-					cbmObjectHolder.classifierNamesLock);
+					cbmObjectHolder.classifierNamesLock,
+					cbmObjectHolder.classifierSets,
+					cbmObjectHolder.flatPoolNames,
+					cbmObjectHolder.flushCoordinator);
 			}
 
 			MOJA_LIB_API flint::IModule* CreateCBMAggregatorCsvWriter() {
@@ -187,8 +219,24 @@ namespace moja {
 					cbmObjectHolder.flatAgeDimension,
 					cbmObjectHolder.flatDisturbanceDimension,
 					cbmObjectHolder.classifierNames,
+					cbmObjectHolder.flushCoordinator,
+					isPrimaryAggregator);
+			}
+
+#ifdef MOJA_MODULES_CBM_USE_PARQUET
+			MOJA_LIB_API flint::IModule* CreateCBMAggregatorParquetWriter() {
+				bool isPrimaryAggregator = cbmObjectHolder.landUnitAggregatorId++ == 1;
+				return new cbm::CBMAggregatorParquetWriter(
+					cbmObjectHolder.flatFluxDimension,
+					cbmObjectHolder.flatPoolDimension,
+					cbmObjectHolder.flatErrorDimension,
+					cbmObjectHolder.flatAgeDimension,
+					cbmObjectHolder.flatDisturbanceDimension,
+					cbmObjectHolder.classifierNames,
+					cbmObjectHolder.flushCoordinator,
 					isPrimaryAggregator);
 			}
+#endif
 
 			MOJA_LIB_API flint::IModule* CreateCBMAggregatorPostgreSQLWriter() {
 				bool isPrimaryAggregator = cbmObjectHolder.landUnitAggregatorId++ == 1;
@@ -220,6 +268,7 @@ namespace moja {
 					cbmObjectHolder.flatAgeDimension,
 					cbmObjectHolder.flatDisturbanceDimension,
 					cbmObjectHolder.classifierNames,
+					cbmObjectHolder.flushCoordinator,
 					isPrimaryAggregator);
 			}
 
@@ -232,18 +281,21 @@ namespace moja {
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMAggregatorLibPQXXWriter",     &CreateCBMAggregatorLibPQXXWriter };
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMAggregatorPostgreSQLWriter",  &CreateCBMAggregatorPostgreSQLWriter };
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMAggregatorCsvWriter",         &CreateCBMAggregatorCsvWriter };
+#ifdef MOJA_MODULES_CBM_USE_PARQUET
+				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMAggregatorParquetWriter",     &CreateCBMAggregatorParquetWriter };
+#endif
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMAggregatorSQLiteWriter",      &CreateCBMAggregatorSQLiteWriter };
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMDecayModule",                 []() -> flint::IModule* { return new cbm::CBMDecayModule(); } };
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMDisturbanceEventModule",	   []() -> flint::IModule* { return new cbm::CBMDisturbanceEventModule(); } };
-				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMDisturbanceListener",	       []() -> flint::IModule* { return new cbm::CBMDisturbanceListener(); } };
+				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMDisturbanceListener",	       []() -> flint::IModule* { return new cbm::CBMDisturbanceListener(cbmObjectHolder.disturbanceMatrices, cbmObjectHolder.landUnitTraces); } };
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMGrowthModule",                []() -> flint::IModule* { return new cbm::YieldTableGrowthModule(cbmObjectHolder.gcFactory, cbmObjectHolder.volToBioCarbonGrowth); } };
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMSequencer",				   []() -> flint::IModule* { return new cbm::CBMSequencer(); } };
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "DisturbanceMonitor",             []() -> flint::IModule* { return new cbm::DisturbanceMonitorModule(); } };
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "OutputerStreamPostNotify",	   []() -> flint::IModule* { return new cbm::OutputerStreamPostNotify(); } };
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "OutputerStreamFluxPostNotify",   []() -> flint::IModule* { return new cbm::OutputerStreamFluxPostNotify(); } };
-				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMSpinupSequencer",			   []() -> flint::IModule* { return new cbm::CBMSpinupSequencer(); } };
+				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMSpinupSequencer",			   []() -> flint::IModule* { return new cbm::CBMSpinupSequencer(cbmObjectHolder.spinupCache, cbmObjectHolder.spinupRegrowthStore); } };
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMBuildLandUnitModule",		   []() -> flint::IModule* { return new cbm::CBMBuildLandUnitModule(); } };
-				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMSpinupDisturbanceModule",     []() -> flint::IModule* { return new cbm::CBMSpinupDisturbanceModule(); } };
+				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMSpinupDisturbanceModule",     []() -> flint::IModule* { return new cbm::CBMSpinupDisturbanceModule(cbmObjectHolder.disturbanceMatrices); } };
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMLandClassTransitionModule",   []() -> flint::IModule* { return new cbm::CBMLandClassTransitionModule(); } };
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMMossTurnoverModule",		   []() -> flint::IModule* { return new cbm::MossTurnoverModule(); } };
 				outModuleRegistrations[index++] = flint::ModuleRegistration{ "CBMMossDecayModule",			   []() -> flint::IModule* { return new cbm::MossDecayModule(cbmObjectHolder.gcFactory); } };
@@ -272,9 +324,9 @@ namespace moja {
 				outTransformRegistrations[index++] = flint::TransformRegistration{ "CBMLandUnitDataTransform",             []() -> flint::ITransform* { return new cbm::CBMLandUnitDataTransform(); } };
 				outTransformRegistrations[index++] = flint::TransformRegistration{ "DynamicGrowthCurveTransform",          []() -> flint::ITransform* { return new cbm::DynamicGrowthCurveTransform(cbmObjectHolder.dynamicGcIdCache, cbmObjectHolder.dynamicGcCache, cbmObjectHolder.dynamicGcIdLock, cbmObjectHolder.nextDynamicGcId); } };
 				outTransformRegistrations[index++] = flint::TransformRegistration{ "DynamicGrowthCurveLookupTransform",    []() -> flint::ITransform* { return new cbm::DynamicGrowthCurveLookupTransform(cbmObjectHolder.dynamicGcCache); } };
-				outTransformRegistrations[index++] = flint::TransformRegistration{ "GrowthCurveTransform",                 []() -> flint::ITransform* { return new cbm::GrowthCurveTransform(); } };
+				outTransformRegistrations[index++] = flint::TransformRegistration{ "GrowthCurveTransform",                 []() -> flint::ITransform* { return new cbm::GrowthCurveTransform(cbmObjectHolder.growthCurveIndex); } };
 				outTransformRegistrations[index++] = flint::TransformRegistration{ "PeatlandGrowthCurveTransform",         []() -> flint::ITransform* { return new cbm::PeatlandGrowthCurveTransform(); } };
-				outTransformRegistrations[index++] = flint::TransformRegistration{ "TransitionRuleTransform",              []() -> flint::ITransform* { return new cbm::TransitionRuleTransform(); } };
+				outTransformRegistrations[index++] = flint::TransformRegistration{ "TransitionRuleTransform",              []() -> flint::ITransform* { return new cbm::TransitionRuleTransform(cbmObjectHolder.transitionRuleIndex); } };
 				outTransformRegistrations[index++] = flint::TransformRegistration{ "TimeSeriesIdxFromFlintDataTransform",  []() -> flint::ITransform* { return new cbm::TimeSeriesIdxFromFlintDataTransform(); } };
 				return index;
 			}
@@ -45,7 +45,8 @@ namespace moja {
 			 * Initialise MossDecayModule._mossParameters as variable "moss_parameters" in _landUnitData,  \n
 			 * MossDecayModule.fastToSlowTurnoverRate, MossDecayModule.fastToAirDecayRate, MossDecayModule.kff, MossDecayModule.ksf,
 			 * MossDecayModule.kfs, MossDecayModule.kss, MossDecayModule.q10, MossDecayModule.tref, MossDecayModule.m, MossDecayModule.n values of
-			 * "fastToSlowTurnoverRate", "fastToAirDecayRate", "kff", "ksf", "kfs", "kss", "q10", "tref", "m", "n" in MossDecayModule._mossParameters
+			 * "fastToSlowTurnoverRate", "fastToAirDecayRate", "kff", "ksf", "kfs", "kss", "q10", "tref", "m", "n" in MossDecayModule._mossParameters \n
+			 * Clear MossDecayModule._temperatureModifiers, which depend on q10 and tref
 			 *
 			 * @return void
 			 * ***************************/
@@ -71,6 +72,8 @@ namespace moja {
 
 				m = mossGrowthParameters["m"];
 				n = mossGrowthParameters["n"];
+
+				_temperatureModifiers.clear();
 			};
 
 			/**
@@ -227,15 +230,18 @@ namespace moja {
 			//ksf - sphagnum fast decay rate
 			//kss - sphagnum slow decay rate
 			/**
-			 * Applied decay rate to all moss pools :kff, kfs, ksf, kss, given as (baseDecayRate * (e ^ ((meanAnnualTemperature - 10) * (ln(q10) * 0.1))
+			 * Applied decay rate to all moss pools :kff, kfs, ksf, kss, given as (baseDecayRate * (e ^ ((meanAnnualTemperature - tref) * (ln(q10) * 0.1)) \n
+			 * The temperature modifier is computed once per distinct mean annual temperature and kept in MossDecayModule._temperatureModifiers
 			 *
 			 * @param baseDecayRate double
 			 * @param meanAnnualTemperature double
-			 * @param q10 double
 			 * @return double
 			 * **************************/
-			double MossDecayModule::F7(double baseDecayRate, double meanAnnualTemperature, double q10) {
-				double expValue = exp((meanAnnualTemperature - tref) * log(q10) * 0.1);
+			double MossDecayModule::F7(double baseDecayRate, double meanAnnualTemperature) {
+				double expValue = _temperatureModifiers.get(meanAnnualTemperature, [this](double mat) {
+					return exp((mat - tref) * log(q10) * 0.1);
+				});
+
 				double retValue = baseDecayRate * expValue;
 
 				return retValue;
@@ -245,10 +251,10 @@ namespace moja {
 			 * Update moss pool base decay rate based on mean annual temperature and q10 value
 			 *
 			 * Assign MossDecayModule.kss, sphagnum slow decay rate, result of MossDecayModule.F6() with arguments MossDecayModule.m, MossDecayModule.n and parameter standMaximumVolume \n
-			 * MossDecayModule.akff, applied feather moss fast pool applied decay rate, the result of MossDecayModule.F7() with arguments MossDecayModule.kff, parameter meanAnnualTemperature and MossDecayModule.q10 \n
-			 * MossDecayModule.akfs, applied feather moss slow pool applied decay rate, the result of MossDecayModule.F7() with arguments MossDecayModule.kfs, parameter meanAnnualTemperature and MossDecayModule.q10 \n
-			 * MossDecayModule.aksf, applied sphagnum fast pool applied decay rate, the result of MossDecayModule.F7() with arguments MossDecayModule.ksf, parameter meanAnnualTemperature and MossDecayModule.q10 \n
-			 * MossDecayModule.akss, applied sphagnum slow pool applied decay rate, the result of MossDecayModule.F7() with arguments MossDecayModule.kss, parameter meanAnnualTemperature and MossDecayModule.q10
+			 * MossDecayModule.akff, applied feather moss fast pool applied decay rate, the result of MossDecayModule.F7() with arguments MossDecayModule.kff and parameter meanAnnualTemperature \n
+			 * MossDecayModule.akfs, applied feather moss slow pool applied decay rate, the result of MossDecayModule.F7() with arguments MossDecayModule.kfs and parameter meanAnnualTemperature \n
+			 * MossDecayModule.aksf, applied sphagnum fast pool applied decay rate, the result of MossDecayModule.F7() with arguments MossDecayModule.ksf and parameter meanAnnualTemperature \n
+			 * MossDecayModule.akss, applied sphagnum slow pool applied decay rate, the result of MossDecayModule.F7() with arguments MossDecayModule.kss and parameter meanAnnualTemperature
 			 *
 			 * @param standMaximumVolume double
 			 * @param  meanAnnualTemperature double
@@ -257,10 +263,10 @@ namespace moja {
 			void MossDecayModule::updateMossAppliedDecayParameters(double standMaximumVolume, double meanAnnualTemperature) {
 				kss = F6(m, n, standMaximumVolume);
 
-				akff = F7(kff, meanAnnualTemperature, q10); //applied feather moss fast pool applied decay rate  
-				akfs = F7(kfs, meanAnnualTemperature, q10); //applied feather moss slow pool applied decay rate  
-				aksf = F7(ksf, meanAnnualTemperature, q10); //applied sphagnum fast pool applied decay rate      
-				akss = F7(kss, meanAnnualTemperature, q10); //applied sphagnum slow pool applied decay rate  		
+				akff = F7(kff, meanAnnualTemperature); //applied feather moss fast pool applied decay rate  
+				akfs = F7(kfs, meanAnnualTemperature); //applied feather moss slow pool applied decay rate  
+				aksf = F7(ksf, meanAnnualTemperature); //applied sphagnum fast pool applied decay rate      
+				akss = F7(kss, meanAnnualTemperature); //applied sphagnum slow pool applied decay rate  		
 			}
 		}
 	}
@@ -0,0 +1,80 @@
+/**
+ * @file
+ * Stable hash of parameter values, used to tag cached and persisted results
+ * with the inputs they were built from.
+ */
+
+#include "moja/modules/cbm/parameterhash.h"
+
+#include <typeinfo>
+#include <vector>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * Add parameter value to the hash.
+     *
+     * @param value string&
+     * @return void
+     * ************************/
+    void ParameterHash::add(const std::string& value) {
+        addBytes(value.data(), value.size());
+        addByte(0xFF);
+    }
+
+    /**
+     * Add parameter value to the hash: a table row by row, a struct by member name, a vector item by \n
+     * item, a floating point number by its exact bytes, and any other value as a string.
+     *
+     * @param value DynamicVar&
+     * @return void
+     * ************************/
+    void ParameterHash::add(const DynamicVar& value) {
+        if (value.isEmpty()) {
+            addByte('e');
+        } else if (value.type() == typeid(std::vector<DynamicObject>)) {
+            const auto& rows = value.extract<std::vector<DynamicObject>>();
+            addByte('t');
+            addValue<std::uint64_t>(rows.size());
+            for (const auto& row : rows) {
+                add(row);
+            }
+        } else if (value.isStruct()) {
+            addByte('s');
+            add(value.extract<DynamicObject>());
+        } else if (value.isVector()) {
+            const auto& items = value.extract<std::vector<DynamicVar>>();
+            addByte('v');
+            addValue<std::uint64_t>(items.size());
+            for (const auto& item : items) {
+                add(item);
+            }
+        } else if (value.isNumeric() && !value.isInteger()) {
+            // Hash the exact value rather than a formatted one that may round.
+            addByte('n');
+            addValue(value.convert<double>());
+        } else {
+            addByte('x');
+            add(value.convert<std::string>());
+        }
+    }
+
+    /**
+     * Add the members of parameter row to the hash. DynamicObject::members() is sorted, so the \n
+     * hash does not depend on the order the columns were added in.
+     *
+     * @param row DynamicObject&
+     * @return void
+     * ************************/
+    void ParameterHash::add(const DynamicObject& row) {
+        for (const auto& member : row.members()) {
+            add(member);
+            add(row[member]);
+        }
+
+        addByte(0xFE);
+    }
+
+}}} // namespace moja::modules::cbm
@@ -36,41 +36,50 @@ namespace moja {
 			}
 
 			/**
-			 * Initialise PeatlandDecayModule._woodyFoliageDead, PeatlandDecayModule._woodyFineDead, PeatlandDecayModule._woodyCoarseDead,
-			 * PeatlandDecayModule._woodyRootsDead, PeatlandDecayModule._sedgeFoliageDead, PeatlandDecayModule._sedgeRootsDead,
-			 * PeatlandDecayModule._feathermossDead, PeatlandDecayModule._acrotelm_o, PeatlandDecayModule._catotelm_a, PeatlandDecayModule._acrotelm_a,
-			 * PeatlandDecayModule._catotelm_o, PeatlandDecayModule._co2, PeatlandDecayModule._ch4, PeatlandDecayModule._tempCarbon
-			 *  with the pools "WoodyFoliageDead", "WoodyFineDead", "WoodyCoarseDead", "WoodyRootsDead",
-			 * "SedgeFoliageDead", "SedgeRootsDead", "FeathermossDead", "Acrotelm_o", "Catotelm_a", "Acrotelm_a",
-			 * "Catotelm_o", "CO2", "CH4", "TempCarbon", "PilledPeat" in _landUnitData \n
-			 * Initialise PeatlandDecayModule._spinupMossOnly, PeatlandDecayModule.baseWTDParameters, PeatlandDecayModule._appliedAnnualWTD value of variables
-			 * "spinup_moss_only", "base_wtd_parameters", "applied_annual_wtd" in _landUnitData
+			 * Constructor
+			 *
+			 * Bind the pools "WoodyFoliageDead", "WoodyFineDead", "WoodyCoarseDead", "WoodyRootsDead",
+			 * "SedgeFoliageDead", "SedgeRootsDead", "FeathermossDead", "Acrotelm_O", "Catotelm_A", "Acrotelm_A",
+			 * "Catotelm_O", "CO2", "CH4", "TempPeatlandDecayCarbon", "PilledPeat", the variables
+			 * "spinup_moss_only", "applied_annual_wtd" and, if they exist, the peatland variables read on every step
+			 **/
+			PeatlandDecayModule::PeatlandDecayModule() : CBMModuleBase() {
+				bindPool("WoodyFoliageDead", _woodyFoliageDead);
+				bindPool("WoodyFineDead", _woodyFineDead);
+				bindPool("WoodyCoarseDead", _woodyCoarseDead);
+				bindPool("WoodyRootsDead", _woodyRootsDead);
+				bindPool("SedgeFoliageDead", _sedgeFoliageDead);
+				bindPool("SedgeRootsDead", _sedgeRootsDead);
+				bindPool("FeathermossDead", _feathermossDead);
+
+				bindPool("Acrotelm_O", _acrotelm_o);
+				bindPool("Catotelm_A", _catotelm_a);
+				bindPool("Acrotelm_A", _acrotelm_a);
+				bindPool("Catotelm_O", _catotelm_o);
+
+				bindPool("CO2", _co2);
+				bindPool("CH4", _ch4);
+				bindPool("TempPeatlandDecayCarbon", _tempCarbon);
+				bindPool("PilledPeat", _pilledPeat);
+
+				bindVariable("spinup_moss_only", _spinupMossOnly);
+				bindVariable("applied_annual_wtd", _appliedAnnualWTD);
+
+				bindVariable("enable_peatland", _enablePeatland, true);
+				bindVariable("peatland_class", _peatlandClass, true);
+				bindVariable("mean_annual_temperature", _meanAnnualTemperatureSlot, true);
+				bindVariable("default_mean_annual_temperature", _defaultMeanAnnualTemperature, true);
+				bindVariable("peatland_decay_parameters", _decayParameters, true);
+				bindVariable("peatland_turnover_parameters", _turnoverParameters, true);
+			}
+
+			/**
+			 * Initialise PeatlandDecayModule.baseWTDParameters with the value of variable "base_wtd_parameters" in _landUnitData
 			 *
 			 * @return void
 			 **/
 			void PeatlandDecayModule::doLocalDomainInit() {
-				_woodyFoliageDead = _landUnitData->getPool("WoodyFoliageDead");
-				_woodyFineDead = _landUnitData->getPool("WoodyFineDead");
-				_woodyCoarseDead = _landUnitData->getPool("WoodyCoarseDead");
-				_woodyRootsDead = _landUnitData->getPool("WoodyRootsDead");
-				_sedgeFoliageDead = _landUnitData->getPool("SedgeFoliageDead");
-				_sedgeRootsDead = _landUnitData->getPool("SedgeRootsDead");
-				_feathermossDead = _landUnitData->getPool("FeathermossDead");
-
-				_acrotelm_o = _landUnitData->getPool("Acrotelm_O");
-				_catotelm_a = _landUnitData->getPool("Catotelm_A");
-				_acrotelm_a = _landUnitData->getPool("Acrotelm_A");
-				_catotelm_o = _landUnitData->getPool("Catotelm_O");
-
-				_co2 = _landUnitData->getPool("CO2");
-				_ch4 = _landUnitData->getPool("CH4");
-				_tempCarbon = _landUnitData->getPool("TempPeatlandDecayCarbon");
-				_pilledPeat = _landUnitData->getPool("PilledPeat");
-
-				_spinupMossOnly = _landUnitData->getVariable("spinup_moss_only");
 				baseWTDParameters = _landUnitData->getVariable("base_wtd_parameters")->value().extract<DynamicObject>();
-
-				_appliedAnnualWTD = _landUnitData->getVariable("applied_annual_wtd");
 			}
 
 			/**
@@ -94,22 +103,15 @@ namespace moja {
 			void PeatlandDecayModule::doTimingInit() {
 				_runPeatland = false;
 
-				if (_landUnitData->hasVariable("enable_peatland") &&
-					_landUnitData->getVariable("enable_peatland")->value()) {
-
-					auto& peatland_class = _landUnitData->getVariable("peatland_class")->value();
-					_peatlandId = peatland_class.isEmpty() ? -1 : peatland_class.convert<int>();
+				if (_enablePeatland.isBound() && _enablePeatland.value()) {
+					_peatlandId = _peatlandClass.valueOr(-1);
 
 					if (_peatlandId > 0) {
 						_runPeatland = true;
 
-						//get the mean anual temperture variable
-						double defaultMAT = _landUnitData->getVariable("default_mean_annual_temperature")->value();
-
-						auto matVal = _landUnitData->getVariable("mean_annual_temperature")->value();
-						_meanAnnualTemperature = matVal.isEmpty() ? defaultMAT
-							: matVal.type() == typeid(TimeSeries) ? matVal.extract<TimeSeries>().value()
-							: matVal.convert<double>();
+						//get the mean anual temperture variable, kept for the steps of this land unit
+						_meanAnnualTemperatureSlot.load(_defaultMeanAnnualTemperature.value());
+						_meanAnnualTemperature = _meanAnnualTemperatureSlot.value();
 
 						//get all parameters
 						updateParameters();
@@ -142,12 +144,7 @@ namespace moja {
 				if (spinupMossOnly) { return; }
 
 				//get the mean anual temperture variable
-				double defaultMAT = _landUnitData->getVariable("default_mean_annual_temperature")->value();
-
-				auto matVal = _landUnitData->getVariable("mean_annual_temperature")->value();
-				_meanAnnualTemperature = matVal.isEmpty() ? defaultMAT
-					: matVal.type() == typeid(TimeSeries) ? matVal.extract<TimeSeries>().value()
-					: matVal.convert<double>();
+				_meanAnnualTemperature = _meanAnnualTemperatureSlot.value();
 
 				//update parameter always as MAT may be varied if reading annually
 				updateParameters();
@@ -418,16 +415,25 @@ namespace moja {
 
 			void PeatlandDecayModule::updateParameters() {
 				// 1) get the data by variable "peatland_decay_parameters"
-				const auto& peatlandDecayParams = _landUnitData->getVariable("peatland_decay_parameters")->value();
-				//create the PeaglandDecayParameters, set the value from the variable
-				decayParas = std::make_shared<PeatlandDecayParameters>();
-				decayParas->setValue(peatlandDecayParams.extract<DynamicObject>());
+				const auto& peatlandDecayParams = _decayParameters->value();
+				//set the PeaglandDecayParameters value from the variable, dropping the applied
+				//parameters computed so far if the peatland's decay parameters changed
+				PeatlandDecayParameters currentDecayParas;
+				currentDecayParas.setValue(peatlandDecayParams.extract<DynamicObject>());
+				if (appliedDecayParas.size() == 0 || !currentDecayParas.hasSameBaseParameters(baseDecayParas)) {
+					baseDecayParas = currentDecayParas;
+					appliedDecayParas.clear();
+				}
 
-				//compute the applied parameters
-				decayParas->updateAppliedDecayParameters(_meanAnnualTemperature);
+				//compute the applied parameters once per mean annual temperature
+				decayParas = appliedDecayParas.get(_meanAnnualTemperature, [this](double mat) {
+					auto applied = std::make_shared<PeatlandDecayParameters>(baseDecayParas);
+					applied->updateAppliedDecayParameters(mat);
+					return applied;
+				});
 
 				// 2) get the data by variable "peatland_turnover_parameters"
-				const auto& peatlandTurnoverParams = _landUnitData->getVariable("peatland_turnover_parameters")->value();
+				const auto& peatlandTurnoverParams = _turnoverParameters->value();
 
 				//create the PeatlandTurnoverParameters, set the value from the variable
 				turnoverParas = std::make_shared<PeatlandTurnoverParameters>();
@@ -63,6 +63,26 @@ namespace moja {
 				_Pt = data["Pt"];
 			}
 
+			/**
+			* Return true if the base decay rates, Q10 values, reference temperature, c, d and Pt \n
+			* of parameter other are the same as these, so that the applied decay parameters \n
+			* computed from either for a mean annual temperature are the same.
+			*
+			* @param other PeatlandDecayParameters&
+			* @return bool
+			* ************************/
+			bool PeatlandDecayParameters::hasSameBaseParameters(const PeatlandDecayParameters& other) const {
+				return _kwsb == other._kwsb && _kwc == other._kwc && _kwfe == other._kwfe
+					&& _kwfne == other._kwfne && _kwr == other._kwr && _ksf == other._ksf
+					&& _ksr == other._ksr && _kfm == other._kfm && _ka == other._ka
+					&& _kc == other._kc && _kpp == other._kpp
+					&& _Q10wsb == other._Q10wsb && _Q10wc == other._Q10wc && _Q10wf == other._Q10wf
+					&& _Q10wr == other._Q10wr && _Q10sf == other._Q10sf && _Q10sr == other._Q10sr
+					&& _Q10fm == other._Q10fm && _Q10a == other._Q10a && _Q10c == other._Q10c
+					&& _Q10pp == other._Q10pp
+					&& _tref == other._tref && _c == other._c && _d == other._d && _Pt == other._Pt;
+			}
+
 			/**
 			* .
 			*
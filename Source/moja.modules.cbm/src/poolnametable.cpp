@@ -0,0 +1,47 @@
+/**
+ * @file
+ * Table of pool names shared by the flat aggregator modules, so that output records
+ * can be keyed on the pool index instead of copies of the pool name strings.
+ */
+
+#include "moja/modules/cbm/poolnametable.h"
+
+#include <stdexcept>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * Set the pool names, indexed by pool idx. The first call fills the table; later calls
+     * (one per local domain) must supply the same names, since records from every thread
+     * share the table.
+     *
+     * @param names std::vector<std::string>&
+     * @return void
+     * @exception std::runtime_error if the names differ from those already assigned
+     * ************************/
+    void PoolNameTable::assign(const std::vector<std::string>& names) {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_names.empty()) {
+            _names = names;
+            return;
+        }
+
+        if (_names != names) {
+            throw std::runtime_error("Pool names differ between local domains");
+        }
+    }
+
+    /**
+     * Return the handle for the pool at idx. The table must already have been assigned
+     * by the calling thread.
+     *
+     * @param idx int
+     * @return PoolRef
+     * ************************/
+    PoolRef PoolNameTable::ref(int idx) const {
+        return PoolRef(idx, &_names[idx]);
+    }
+
+}}} // namespace moja::modules::cbm
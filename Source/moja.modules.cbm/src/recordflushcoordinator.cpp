@@ -0,0 +1,128 @@
+/**
+ * @file
+ * Shared trigger for streaming aggregated fact records out to the writers in bounded
+ * batches instead of holding the whole simulation's output in memory until shutdown.
+ */
+
+#include "moja/modules/cbm/recordflushcoordinator.h"
+
+#include <moja/logging.h>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * Configuration function
+     *
+     * Read a writer's streaming thresholds from parameter config: "flush_record_count", the number \n
+     * of pending fact records, and "flush_memory_mb", their estimated size in megabytes. Either one \n
+     * enables streaming.
+     *
+     * @param config DynamicObject&
+     * @return void
+     * ************************/
+    void RecordFlushCoordinator::configure(const DynamicObject& config) {
+        size_t maxRecords = config.contains("flush_record_count")
+            ? config["flush_record_count"].convert<Int64>() : 0;
+
+        size_t maxBytes = config.contains("flush_memory_mb")
+            ? config["flush_memory_mb"].convert<Int64>() * 1024 * 1024 : 0;
+
+        configure(maxRecords, maxBytes);
+    }
+
+    /**
+     * Set the flush thresholds; a value of 0 disables that threshold. Writers configure
+     * the thresholds, so the largest value requested by any writer wins.
+     *
+     * @param maxRecords size_t
+     * @param maxBytes size_t
+     * @return void
+     * ************************/
+    void RecordFlushCoordinator::configure(size_t maxRecords, size_t maxBytes) {
+        if (maxRecords > _maxRecords) {
+            _maxRecords = maxRecords;
+        }
+
+        if (maxBytes > _maxBytes) {
+            _maxBytes = maxBytes;
+        }
+    }
+
+    /**
+     * Register a writer's flush handler, which writes out the pending fact records, and its
+     * clear handler, which releases them once every writer has flushed.
+     *
+     * @param flush function<void()>
+     * @param clear function<void()>
+     * @return void
+     * ************************/
+    void RecordFlushCoordinator::addFlushHandler(std::function<void()> flush, std::function<void()> clear) {
+        Poco::ScopedWriteRWLock lock(_accumulationLock);
+        _flushHandlers.push_back(flush);
+        _clearHandlers.push_back(clear);
+    }
+
+    /**
+     * Return the Id of the row of parameter dimension identified by parameter key: the Id it was first \n
+     * given, in this batch or an earlier one, or parameter id if the key is new. A released dimension \n
+     * numbers a row again in each batch it appears in, so the aggregators refer to rows by this Id \n
+     * and the writers write a row whose stable Id differs from its own Id as an addition to the area \n
+     * of the row written earlier. Without streaming nothing is released and parameter id is returned.
+     *
+     * @param dimension ReleasedDimension
+     * @param key ReleasedKey&
+     * @param id Int64
+     * @return Int64
+     * ************************/
+    Int64 RecordFlushCoordinator::stableId(ReleasedDimension dimension, const ReleasedKey& key, Int64 id) {
+        if (!isEnabled()) {
+            return id;
+        }
+
+        std::lock_guard<std::mutex> lock(_stableIdLock);
+        return _stableIds[(int)dimension].emplace(key, id).first->second;
+    }
+
+    /**
+     * Return true if the pending fact records exceed either configured threshold.
+     *
+     * @return bool
+     * ************************/
+    bool RecordFlushCoordinator::thresholdReached() const {
+        return (_maxRecords > 0 && _pendingRecords >= _maxRecords)
+            || (_maxBytes > 0 && _pendingBytes >= _maxBytes);
+    }
+
+    /**
+     * If a threshold has been reached, wait for in-progress steps to finish and flush the
+     * pending records to every registered writer. Threads that arrive while a flush is
+     * running find the counters reset and carry on.
+     *
+     * @return void
+     * ************************/
+    void RecordFlushCoordinator::flushIfRequired() {
+        if (!thresholdReached()) {
+            return;
+        }
+
+        Poco::ScopedWriteRWLock lock(_accumulationLock);
+        if (!thresholdReached()) {
+            return;
+        }
+
+        MOJA_LOG_DEBUG << "Flushing " << _pendingRecords << " pending records.";
+        for (auto& flush : _flushHandlers) {
+            flush();
+        }
+
+        for (auto& clear : _clearHandlers) {
+            clear();
+        }
+
+        _pendingRecords = 0;
+        _pendingBytes = 0;
+    }
+
+}}} // namespace moja::modules::cbm
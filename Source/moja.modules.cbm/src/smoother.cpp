@@ -11,13 +11,48 @@
 #include <moja/modules/cbm/lmeval.h>
 #include <moja/modules/cbm/lmmin.h>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+
 namespace moja {
 namespace modules {
 namespace cbm {	
 
+    void SmoothingSample::clearAndReserve(int workingFitingRange) {
+        maxMerchC = 0;
+        maxFoliageC = 0;
+        maxOtherC = 0;
+        maxTotalAGC = 0;
+        maxAge = 0;
+
+        merchC.clear();
+        foliageC.clear();
+        otherC.clear();
+        totalAGBioC.clear();
+        ageSerials.clear();
+
+        merchC.resize(workingFitingRange);
+        foliageC.resize(workingFitingRange);
+        otherC.resize(workingFitingRange);
+        totalAGBioC.resize(workingFitingRange);
+        ageSerials.resize(workingFitingRange);
+    }
+
+    size_t WeibullFitKeyHash::operator()(const WeibullFitKey& key) const {
+        size_t seed = std::hash<int>()(key.substitutionPoint);
+        for (auto value : key.values) {
+            seed ^= std::hash<double>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        }
+
+        return seed;
+    }
+
     void Smoother::smooth(const StandGrowthCurve& standGrowthCurve,
                           ComponentBiomassCarbonCurve* carbonCurve,
-                          SpeciesType speciesType) {
+                          SpeciesType speciesType) const {
 
         int substitutionPoint = getComponentSmoothingSubstitutionRegionPoint(
             standGrowthCurve, speciesType);
@@ -26,26 +61,95 @@ namespace cbm {
             return; // no need to smooth
         }		
 
-        clearAndReserveDataSpace(smoothSampleSize);
+        SmoothingSample sample;
+        sample.clearAndReserve(smoothSampleSize);
         prepareSmoothingInputData(*carbonCurve,
                                   substitutionPoint,
-                                  standGrowthCurve.standMaxAge());
+                                  standGrowthCurve.standMaxAge(),
+                                  sample);
 
-        double merchC_wb2[]      = { 1, 0.1 };	// use any starting value, but not { 0, 0, 0 }
-        double foliageC_wb2[]    = { 1, 0.1 };	// use any starting value, but not { 0, 0, 0 }		
-        double totalAGBioC_wb2[] = { 1, 0.1 };	// use any starting value, but not { 0, 0, 0 }	
+        double merchC_wb2[2];
+        double foliageC_wb2[2];
+        double totalAGBioC_wb2[2];
         
-        minimize(_smoothingMerchC.data(), merchC_wb2);		
-        minimize(_smoothingFoliageC.data(), foliageC_wb2);
-        minimize(_smoothingTotalAGBioC.data(), totalAGBioC_wb2);
+        fit(sample, substitutionPoint, sample.merchC, merchC_wb2);
+        fit(sample, substitutionPoint, sample.foliageC, foliageC_wb2);
+        fit(sample, substitutionPoint, sample.totalAGBioC, totalAGBioC_wb2);
         
-        getFinalFittingRegionAndReplaceData(*carbonCurve, substitutionPoint,
+        getFinalFittingRegionAndReplaceData(sample, *carbonCurve, substitutionPoint,
                                             merchC_wb2, foliageC_wb2, totalAGBioC_wb2);
-        clearAndReserveDataSpace(1);
+    }
+
+    /*
+    * Smooth each job's curve with Smoother::smooth(). Threads take the next unclaimed job until
+    * none are left; each job only touches its own curve, so the results do not depend on which
+    * thread smooths which curve. The first exception thrown by a job is rethrown once all threads
+    * have stopped.
+    */
+    void Smoother::smoothAll(const std::vector<SmoothingJob>& jobs, int threadCount) const {
+        if (threadCount <= 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        threadCount = std::min(threadCount, static_cast<int>(jobs.size()));
+        std::atomic<size_t> nextJob(0);
+        std::atomic<bool> failed(false);
+        std::exception_ptr error;
+
+        auto work = [this, &jobs, &nextJob, &failed, &error]() {
+            for (size_t i = nextJob++; i < jobs.size() && !failed; i = nextJob++) {
+                const auto& job = jobs[i];
+                try {
+                    smooth(*job.standGrowthCurve, job.carbonCurve, job.speciesType);
+                } catch (...) {
+                    if (!failed.exchange(true)) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int i = 1; i < threadCount; i++) {
+            threads.emplace_back(work);
+        }
+
+        work();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /*
+    * Fit the Weibull parameters for parameter yValues, or reuse the fit for an identical series
+    * made earlier by any thread. Once the fit table is full, series it doesn't hold are fitted
+    * without being added to it.
+    */
+    void Smoother::fit(const SmoothingSample& sample, int substitutionPoint,
+                       const std::vector<double>& yValues, double parameters[]) const {
+
+        auto build = [this, &sample, &yValues]() {
+            std::array<double, 2> wb2 = { 1, 0.1 };	// use any starting value, but not { 0, 0, 0 }
+            minimize(sample, yValues.data(), wb2.data());
+            return std::make_shared<std::array<double, 2>>(wb2);
+        };
+
+        WeibullFitKey key{ substitutionPoint, yValues };
+        auto fitted = _fits->find(key);
+        if (fitted == nullptr) {
+            fitted = _fits->size() < _maxCachedFits ? _fits->getOrBuild(key, build) : build();
+        }
+
+        parameters[0] = (*fitted)[0];
+        parameters[1] = (*fitted)[1];
     }
 
     int Smoother::getComponentSmoothingSubstitutionRegionPoint(
-        const StandGrowthCurve& standGrowthCurve, SpeciesType speciesType) {
+        const StandGrowthCurve& standGrowthCurve, SpeciesType speciesType) const {
 
         // Get the stand max age.
         int standMaxAge = standGrowthCurve.standMaxAge();
@@ -135,76 +239,58 @@ namespace cbm {
         return -1;
     }
     void Smoother::prepareSmoothingInputData(const ComponentBiomassCarbonCurve& carbonCurve,
-                                             int substitutionPoint, int standMaxAge) {
+                                             int substitutionPoint, int standMaxAge,
+                                             SmoothingSample& sample) const {
         // The first value is set to 0.
-        _smoothingMerchC[0] = 0;
-        _smoothingFoliageC[0] = 0;
-        _smoothingOtherC[0] = 0;
-        _smoothingTotalAGBioC[0] = 0;
-        _smoothingAageSerials[0] = 0;
+        sample.merchC[0] = 0;
+        sample.foliageC[0] = 0;
+        sample.otherC[0] = 0;
+        sample.totalAGBioC[0] = 0;
+        sample.ageSerials[0] = 0;
 
         for (int i = 1; i < smoothSampleSize; i++) {
             int tempAgeIndex = substitutionPoint + i;
             if (tempAgeIndex <= standMaxAge) {
-                _smoothingMerchC[i] = carbonCurve.getMerchCarbonAtAge(tempAgeIndex);
-                _smoothingFoliageC[i] = carbonCurve.getFoliageCarbonAtAge(tempAgeIndex);
-                _smoothingOtherC[i] = carbonCurve.getOtherCarbonAtAge(tempAgeIndex);
+                sample.merchC[i] = carbonCurve.getMerchCarbonAtAge(tempAgeIndex);
+                sample.foliageC[i] = carbonCurve.getFoliageCarbonAtAge(tempAgeIndex);
+                sample.otherC[i] = carbonCurve.getOtherCarbonAtAge(tempAgeIndex);
             }
             else {
-                _smoothingMerchC[i] = carbonCurve.getMerchCarbonAtAge(standMaxAge);
-                _smoothingFoliageC[i] = carbonCurve.getFoliageCarbonAtAge(standMaxAge);
-                _smoothingOtherC[i] = carbonCurve.getOtherCarbonAtAge(standMaxAge);
+                sample.merchC[i] = carbonCurve.getMerchCarbonAtAge(standMaxAge);
+                sample.foliageC[i] = carbonCurve.getFoliageCarbonAtAge(standMaxAge);
+                sample.otherC[i] = carbonCurve.getOtherCarbonAtAge(standMaxAge);
             }
 
-            _smoothingTotalAGBioC[i] = _smoothingMerchC[i] + _smoothingFoliageC[i] + _smoothingOtherC[i];
-            _smoothingAageSerials[i] = substitutionPoint + i;
+            sample.totalAGBioC[i] = sample.merchC[i] + sample.foliageC[i] + sample.otherC[i];
+            sample.ageSerials[i] = substitutionPoint + i;
         }
 
         // Get the maximum value for the data in the smoothing region.
-        _smoothingMaxMerchC		= (*std::max_element(_smoothingMerchC.begin(), _smoothingMerchC.end()));
-        _smoothingMaxFoliageC	= (*std::max_element(_smoothingFoliageC.begin(), _smoothingFoliageC.end()));
-        _smoothingMaxOtherC		= (*std::max_element(_smoothingOtherC.begin(), _smoothingOtherC.end()));
-        _smoothingMaxTotalAGC	= (*std::max_element(_smoothingTotalAGBioC.begin(), _smoothingTotalAGBioC.end()));
-        _smoothingMaxAge		= (*std::max_element(_smoothingAageSerials.begin(), _smoothingAageSerials.end()));
+        sample.maxMerchC		= (*std::max_element(sample.merchC.begin(), sample.merchC.end()));
+        sample.maxFoliageC	= (*std::max_element(sample.foliageC.begin(), sample.foliageC.end()));
+        sample.maxOtherC		= (*std::max_element(sample.otherC.begin(), sample.otherC.end()));
+        sample.maxTotalAGC	= (*std::max_element(sample.totalAGBioC.begin(), sample.totalAGBioC.end()));
+        sample.maxAge		= (*std::max_element(sample.ageSerials.begin(), sample.ageSerials.end()));
 
         // Average the original pool data by the maximum value.
         for (int i = 0; i < smoothSampleSize; i++) {
-            _smoothingMerchC[i] = _smoothingMerchC[i] / _smoothingMaxMerchC;
-            _smoothingOtherC[i] = _smoothingOtherC[i] / _smoothingMaxOtherC;
-            _smoothingFoliageC[i] = _smoothingFoliageC[i] / _smoothingMaxFoliageC;
-            _smoothingTotalAGBioC[i] = _smoothingTotalAGBioC[i] / _smoothingMaxTotalAGC;
-            _smoothingAageSerials[i] = _smoothingAageSerials[i] / _smoothingMaxAge;
+            sample.merchC[i] = sample.merchC[i] / sample.maxMerchC;
+            sample.otherC[i] = sample.otherC[i] / sample.maxOtherC;
+            sample.foliageC[i] = sample.foliageC[i] / sample.maxFoliageC;
+            sample.totalAGBioC[i] = sample.totalAGBioC[i] / sample.maxTotalAGC;
+            sample.ageSerials[i] = sample.ageSerials[i] / sample.maxAge;
         }
     }
 
-    void Smoother::clearAndReserveDataSpace(int workingFitingRange) {
-        _smoothingMaxMerchC = 0;
-        _smoothingMaxFoliageC = 0;
-        _smoothingMaxOtherC = 0;
-        _smoothingMaxTotalAGC = 0;
-        _smoothingMaxAge = 0;
-
-        _smoothingMerchC.clear();
-        _smoothingFoliageC.clear();
-        _smoothingOtherC.clear();
-        _smoothingTotalAGBioC.clear();
-        _smoothingAageSerials.clear();		
-
-        _smoothingMerchC.resize(workingFitingRange);
-        _smoothingFoliageC.resize(workingFitingRange);
-        _smoothingOtherC.resize(workingFitingRange);
-        _smoothingTotalAGBioC.resize(workingFitingRange);
-        _smoothingAageSerials.resize(workingFitingRange);
-    }
-
     /*
     * Find the minimum weibull paramters which are stored in the startingVals array
     */
-    void Smoother::minimize(double yValues[], double startingVals[]) {	
+    void Smoother::minimize(const SmoothingSample& sample, const double yValues[], double startingVals[]) const {
+        // The evaluation only reads the sample and yValues.
         lm_data_type data;
         data.user_func = Smoother::weibull_2Parameter;
-        data.user_t = _smoothingAageSerials.data();
-        data.user_y = yValues;
+        data.user_t = const_cast<double*>(sample.ageSerials.data());
+        data.user_y = const_cast<double*>(yValues);
 
         LmMin lmMin;
         lm_control_type control;		
@@ -242,9 +328,10 @@ namespace cbm {
 
 
     int Smoother::getFinalFittingRegionAndReplaceData(
+        const SmoothingSample& sample,
         ComponentBiomassCarbonCurve& carbonCurve, int substitutionPoint,
         double merchCWeibullParameters[], double foliageCWeibullParameters[],
-        double totalAGBioCWeibullParameters[]) {
+        double totalAGBioCWeibullParameters[]) const {
 
         int finalReplacementLength = 0;
 
@@ -263,14 +350,14 @@ namespace cbm {
             double other = carbonCurve.getOtherCarbonAtAge(i);
             double total = merch + foliage + other;
 
-            double fitMerch = weibull_2Parameter(i / _smoothingMaxAge, merchCWeibullParameters)
-                * _smoothingMaxMerchC;
+            double fitMerch = weibull_2Parameter(i / sample.maxAge, merchCWeibullParameters)
+                * sample.maxMerchC;
 
-            double fitFoliage = weibull_2Parameter(i / _smoothingMaxAge, foliageCWeibullParameters)
-                * _smoothingMaxFoliageC;
+            double fitFoliage = weibull_2Parameter(i / sample.maxAge, foliageCWeibullParameters)
+                * sample.maxFoliageC;
 
-            double fitTotal = weibull_2Parameter(i / _smoothingMaxAge, totalAGBioCWeibullParameters)
-                * _smoothingMaxTotalAGC;
+            double fitTotal = weibull_2Parameter(i / sample.maxAge, totalAGBioCWeibullParameters)
+                * sample.maxTotalAGC;
 
             if (total == 0) {
                 total = 0.00001;
@@ -0,0 +1,322 @@
+/**
+ * @file
+ * Process-wide cache of spinup results shared by all threads, with optional
+ * persistence so that a re-run of the same landscape can skip spinup.
+ */
+
+#include "moja/modules/cbm/spinupcache.h"
+#include "moja/modules/cbm/parameterhash.h"
+
+#include <moja/logging.h>
+
+#include <Poco/File.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    namespace {
+        const std::string FileHeader = "# moja.modules.cbm spinup cache";
+        const std::string VersionTag = "version";
+    }
+
+    /**
+     * Constructor
+     *
+     * Look up parameter key in parameter cache. If no other thread has a result for it, this \n
+     * reservation owns the key until a result is stored or the reservation goes out of scope.
+     *
+     * @param cache SpinupCache&
+     * @param key Key&
+     * ************************/
+    SpinupCache::Reservation::Reservation(SpinupCache& cache, const Key& key)
+        : _cache(cache), _key(key), _owner(false) {
+        _owner = _cache.reserve(_key, _values);
+    }
+
+    /**
+     * Destructor
+     *
+     * Release the key if it is still owned, i.e. no result was stored.
+     * ************************/
+    SpinupCache::Reservation::~Reservation() {
+        if (_owner) {
+            _cache.release(_key);
+        }
+    }
+
+    /**
+     * Store parameter values as the result for the reserved key and wake any threads waiting for it.
+     *
+     * @param values vector<double>&
+     * @return void
+     * ************************/
+    void SpinupCache::Reservation::store(const std::vector<double>& values) {
+        _cache.insert(_key, values);
+        _values = values;
+        if (_owner) {
+            _owner = false;
+            _cache.release(_key);
+        }
+    }
+
+    /**
+     * Copy the cached values for parameter key into parameter values, return false if there are none.
+     *
+     * @param key Key&
+     * @param values vector<double>&
+     * @return bool
+     * ************************/
+    bool SpinupCache::find(const Key& key, std::vector<double>& values) const {
+        Poco::ScopedReadRWLock lock(_lock);
+        auto it = _entries.find(key);
+        if (it == _entries.end()) {
+            return false;
+        }
+
+        values = it->second;
+        return true;
+    }
+
+    /**
+     * Store parameter values for parameter key, replacing any existing result.
+     *
+     * @param key Key&
+     * @param values vector<double>&
+     * @return void
+     * ************************/
+    void SpinupCache::insert(const Key& key, const std::vector<double>& values) {
+        Poco::ScopedWriteRWLock lock(_lock);
+        _entries[key] = values;
+        _unsavedEntries++;
+    }
+
+    /**
+     * Return the number of cached results.
+     *
+     * @return size_t
+     * ************************/
+    size_t SpinupCache::size() const {
+        Poco::ScopedReadRWLock lock(_lock);
+        return _entries.size();
+    }
+
+    /**
+     * Return false and copy the cached values into parameter values if parameter key has a result. \n
+     * Otherwise, if another thread has reserved the key, wait for it to store or release it; if nobody \n
+     * has, reserve the key for the caller and return true.
+     *
+     * @param key Key&
+     * @param values vector<double>&
+     * @return bool
+     * ************************/
+    bool SpinupCache::reserve(const Key& key, std::vector<double>& values) {
+        if (find(key, values)) {
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(_pendingLock);
+        for (;;) {
+            if (find(key, values)) {
+                return false;
+            }
+
+            if (_pending.insert(key).second) {
+                return true;
+            }
+
+            _pendingChanged.wait(lock);
+        }
+    }
+
+    /**
+     * Release a reservation on parameter key and wake any waiting threads.
+     *
+     * @param key Key&
+     * @return void
+     * ************************/
+    void SpinupCache::release(const Key& key) {
+        {
+            std::lock_guard<std::mutex> lock(_pendingLock);
+            _pending.erase(key);
+        }
+
+        _pendingChanged.notify_all();
+    }
+
+    /**
+     * Build the version tag for a cache file from the pool names, in pool index order, parameter \n
+     * parameterVersion, a user-supplied tag for the inputs, and the values of parameter parameters, \n
+     * the parameter tables the spinup results depend on, by variable name. Uses a 64-bit FNV-1a hash \n
+     * so the tag is the same across platforms and builds.
+     *
+     * @param poolNames vector<string>&
+     * @param parameterVersion string&
+     * @param parameters map<string, DynamicVar>&
+     * @return string
+     * ************************/
+    std::string SpinupCache::version(const std::vector<std::string>& poolNames, const std::string& parameterVersion,
+                                     const std::map<std::string, DynamicVar>& parameters) {
+        ParameterHash hash;
+        for (const auto& name : poolNames) {
+            hash.add(name);
+        }
+
+        hash.add(parameterVersion);
+        for (const auto& parameter : parameters) {
+            hash.add(parameter.first);
+            hash.add(parameter.second);
+        }
+
+        std::ostringstream version;
+        version << std::hex << std::setw(16) << std::setfill('0') << hash.value();
+        return version.str();
+    }
+
+    /**
+     * Use parameter path as the cache's backing file, loading it if it exists and was written \n
+     * with parameter version. Only the first call has any effect, so every thread's sequencer \n
+     * can open the shared cache.
+     *
+     * @param path string&
+     * @param version string&
+     * @return void
+     * ************************/
+    void SpinupCache::open(const std::string& path, const std::string& version) {
+        std::lock_guard<std::mutex> lock(_fileLock);
+        if (!_path.empty()) {
+            return;
+        }
+
+        _path = path;
+        _version = version;
+        if (Poco::File(path).exists()) {
+            load(path, version);
+        }
+    }
+
+    /**
+     * Save any results added since the last save to the file given to SpinupCache.open().
+     *
+     * @return void
+     * ************************/
+    void SpinupCache::save() {
+        std::lock_guard<std::mutex> lock(_fileLock);
+        if (_path.empty() || _unsavedEntries == 0) {
+            return;
+        }
+
+        save(_path, _version);
+    }
+
+    /**
+     * Load the results saved in parameter path. Returns false without loading anything if the file \n
+     * was written with a version other than parameter version, i.e. for a different pool set or \n
+     * different spinup parameters.
+     *
+     * @param path string&
+     * @param version string&
+     * @exception std::runtime_error: Handles error when the file is malformed
+     * @return bool
+     * ************************/
+    bool SpinupCache::load(const std::string& path, const std::string& version) {
+        std::ifstream file(path);
+        if (!file) {
+            return false;
+        }
+
+        std::string line;
+        std::vector<std::string> fields;
+        std::getline(file, line);
+        std::getline(file, line);
+        boost::split(fields, line, boost::is_any_of("\t"));
+        if (fields.size() != 2 || fields[0] != VersionTag) {
+            throw std::runtime_error("Spinup cache file " + path + " is missing its version");
+        }
+
+        if (fields[1] != version) {
+            MOJA_LOG_INFO << "Spinup cache " << path << " was built for a different pool set or parameters, ignoring it.";
+            return false;
+        }
+
+        std::unordered_map<Key, std::vector<double>, moja::Hash> entries;
+        while (std::getline(file, line)) {
+            if (line.empty()) {
+                continue;
+            }
+
+            boost::split(fields, line, boost::is_any_of("\t"));
+            if (fields.size() < 6 || fields.size() != 6 + std::stoul(fields[5])) {
+                throw std::runtime_error("Malformed entry in spinup cache file " + path);
+            }
+
+            Key key{ std::stoi(fields[0]), fields[1], std::stoi(fields[2]), std::stoi(fields[3]), std::stod(fields[4]) };
+            std::vector<double> values;
+            values.reserve(fields.size() - 6);
+            for (size_t i = 6; i < fields.size(); i++) {
+                values.push_back(std::stod(fields[i]));
+            }
+
+            entries[key] = std::move(values);
+        }
+
+        Poco::ScopedWriteRWLock lock(_lock);
+        for (auto& entry : entries) {
+            _entries.insert(std::move(entry));
+        }
+
+        MOJA_LOG_INFO << "Loaded " << entries.size() << " spinup results from " << path;
+        return true;
+    }
+
+    /**
+     * Write all cached results to parameter path, tagged with parameter version. The file is written \n
+     * to a temporary path first so that a failed run never leaves a truncated cache behind.
+     *
+     * @param path string&
+     * @param version string&
+     * @return void
+     * ************************/
+    void SpinupCache::save(const std::string& path, const std::string& version) {
+        _unsavedEntries = 0;
+        std::unordered_map<Key, std::vector<double>, moja::Hash> entries;
+        {
+            Poco::ScopedReadRWLock lock(_lock);
+            entries = _entries;
+        }
+
+        auto tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::trunc);
+            file << std::setprecision(std::numeric_limits<double>::max_digits10);
+            file << FileHeader << "\n" << VersionTag << "\t" << version << "\n";
+            for (const auto& entry : entries) {
+                const auto& key = entry.first;
+                file << std::get<0>(key) << "\t" << std::get<1>(key) << "\t" << std::get<2>(key) << "\t"
+                     << std::get<3>(key) << "\t" << std::get<4>(key) << "\t" << entry.second.size();
+
+                for (auto value : entry.second) {
+                    file << "\t" << value;
+                }
+
+                file << "\n";
+            }
+
+            if (!file) {
+                throw std::runtime_error("Error writing spinup cache file " + tempPath);
+            }
+        }
+
+        Poco::File(tempPath).renameTo(path);
+    }
+
+}}} // namespace moja::modules::cbm
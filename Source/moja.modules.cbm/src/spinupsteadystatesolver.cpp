@@ -0,0 +1,484 @@
+/**
+ * @file
+ * Shortcuts for the regular spinup procedure from recorded rotations: projecting the remaining
+ * rotations under the stopping rule, and solving for the periodic steady state directly.
+ */
+
+#include "moja/modules/cbm/spinupsteadystatesolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <utility>
+
+namespace moja {
+namespace modules {
+namespace cbm {
+
+    /**
+     * Constructor
+     *
+     * @param slowPools vector<int>&, idx of the pools whose total is checked for stability
+     * @param minimumRotations int, rotations that have to be done before the rule can stop on stability
+     * @param maximumRotations int, rotation at which the rule stops regardless
+     * ************************/
+    SpinupStoppingRule::SpinupStoppingRule(const std::vector<int>& slowPools, int minimumRotations, int maximumRotations)
+        : _slowPools(slowPools), _minimumRotations(minimumRotations), _maximumRotations(maximumRotations),
+          _lastSlowPoolValue(0), _stable(false) { }
+
+    /**
+     * Return true if the spinup stops at the end of pass parameter rotation, given parameter passEndValues, \n
+     * the pool values at the end of that pass. Must be called once for every pass, in order.
+     *
+     * @param rotation int
+     * @param passEndValues vector<double>&
+     * @return bool
+     * ************************/
+    bool SpinupStoppingRule::isDone(int rotation, const std::vector<double>& passEndValues) {
+        double currentSlowPoolValue = 0;
+        for (auto pool : _slowPools) {
+            currentSlowPoolValue += passEndValues[pool];
+        }
+
+        _stable = isSlowPoolStable(_lastSlowPoolValue, currentSlowPoolValue);
+        _lastSlowPoolValue = currentSlowPoolValue;
+
+        return (_stable && rotation > _minimumRotations) || rotation >= _maximumRotations;
+    }
+
+    /**
+     * If parameter lastSlowPoolValue != 0, returns if the the ratio currentSlowPoolValue / lastSlowPoolValue \n
+     * is greater than 0.999 and less than 1.001, else returns false.
+     *
+     * @param lastSlowPoolValue double
+     * @param currentSlowPoolValue double
+     * @return bool
+     * ************************/
+    bool SpinupStoppingRule::isSlowPoolStable(double lastSlowPoolValue, double currentSlowPoolValue) {
+        double changeRatio = 0;
+        if (lastSlowPoolValue != 0) {
+            changeRatio = currentSlowPoolValue / lastSlowPoolValue;
+        }
+
+        return changeRatio > 0.999 && changeRatio < 1.001;
+    }
+
+    /**
+     * Return parameter values mapped through the affine map
+     *
+     * @param values vector<double>&
+     * @return vector<double>
+     * ************************/
+    std::vector<double> SpinupSteadyStateSolver::AffineMap::apply(const std::vector<double>& values) const {
+        std::vector<double> result(offset);
+        for (size_t i = 0; i < result.size(); i++) {
+            const auto& row = matrix[i];
+            for (size_t j = 0; j < values.size(); j++) {
+                result[i] += row[j] * values[j];
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Constructor
+     *
+     * @param poolCount size_t, number of pools in the simulation
+     * @param tolerance double, relative tolerance used to match fluxes between rotations
+     * ************************/
+    SpinupSteadyStateSolver::SpinupSteadyStateSolver(size_t poolCount, double tolerance)
+        : _poolCount(poolCount), _tolerance(tolerance), _valid(true), _inRotation(false) { }
+
+    /**
+     * Start recording a rotation from parameter poolValues, the pool values after the previous \n
+     * rotation's disturbance and reset. Only the last two rotations are kept.
+     *
+     * @param poolValues vector<double>&
+     * @return void
+     * ************************/
+    void SpinupSteadyStateSolver::beginRotation(const std::vector<double>& poolValues) {
+        if (!_valid) {
+            return;
+        }
+
+        if (poolValues.size() != _poolCount) {
+            invalidate();
+            return;
+        }
+
+        if (_rotations.size() == 2) {
+            _rotations.erase(_rotations.begin());
+        }
+
+        _rotations.push_back(Rotation{ poolValues, {}, std::numeric_limits<size_t>::max() });
+        _currentValues = poolValues;
+        _inRotation = true;
+    }
+
+    /**
+     * Record an applied operation's fluxes, along with the value each source pool had when \n
+     * the operation was applied.
+     *
+     * @param transfers vector<SpinupPoolTransfer>&
+     * @return void
+     * ************************/
+    void SpinupSteadyStateSolver::addOperation(const std::vector<SpinupPoolTransfer>& transfers) {
+        if (!_valid || !_inRotation) {
+            return;
+        }
+
+        Event event{ false, {}, {} };
+        event.transfers.reserve(transfers.size());
+        for (const auto& transfer : transfers) {
+            if (transfer.source == transfer.sink) {
+                continue;
+            }
+
+            if (transfer.source < 0 || transfer.sink < 0
+                || transfer.source >= int(_poolCount) || transfer.sink >= int(_poolCount)) {
+
+                invalidate();
+                return;
+            }
+
+            event.transfers.push_back(Transfer{
+                transfer.source, transfer.sink, transfer.value, _currentValues[transfer.source] });
+        }
+
+        for (const auto& transfer : event.transfers) {
+            _currentValues[transfer.source] -= transfer.value;
+            _currentValues[transfer.sink] += transfer.value;
+        }
+
+        _rotations.back().events.push_back(std::move(event));
+    }
+
+    /**
+     * Mark the end of the current rotation's pass: the operations recorded after this are the \n
+     * historic disturbance, after which the stopping rule is not checked.
+     *
+     * @return void
+     * ************************/
+    void SpinupSteadyStateSolver::endPass() {
+        if (!_valid || !_inRotation) {
+            return;
+        }
+
+        _rotations.back().passEnd = _rotations.back().events.size();
+    }
+
+    /**
+     * Record that parameter pools were set to zero outside of an operation.
+     *
+     * @param pools vector<int>&
+     * @return void
+     * ************************/
+    void SpinupSteadyStateSolver::resetPools(const std::vector<int>& pools) {
+        if (!_valid || !_inRotation) {
+            return;
+        }
+
+        for (auto pool : pools) {
+            _currentValues[pool] = 0;
+        }
+
+        _rotations.back().events.push_back(Event{ true, {}, pools });
+    }
+
+    /**
+     * Finish recording the current rotation.
+     *
+     * @return void
+     * ************************/
+    void SpinupSteadyStateSolver::endRotation() {
+        _inRotation = false;
+    }
+
+    /**
+     * Return true if the pool values replayed from the recorded operations agree with \n
+     * parameter poolValues. If they don't, something changed the pools without going \n
+     * through an operation and the recording can't be used.
+     *
+     * @param poolValues vector<double>&
+     * @return bool
+     * ************************/
+    bool SpinupSteadyStateSolver::matches(const std::vector<double>& poolValues) const {
+        if (!_valid || poolValues.size() != _currentValues.size()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < poolValues.size(); i++) {
+            if (!isClose(poolValues[i], _currentValues[i])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Return true if parameters first and second are equal within SpinupSteadyStateSolver._tolerance, \n
+     * relative to the larger of the two.
+     *
+     * @param first double
+     * @param second double
+     * @return bool
+     * ************************/
+    bool SpinupSteadyStateSolver::isClose(double first, double second) const {
+        auto scale = std::max({ std::abs(first), std::abs(second), 1e-12 });
+        return std::abs(first - second) <= _tolerance * scale;
+    }
+
+    /**
+     * Build the pass and the whole rotation as affine maps of the pool values at the start of a \n
+     * rotation, from the last two recorded rotations.
+     *
+     * Each flux in the last rotation is matched against the same flux in the previous one: \n
+     * if the amount is unchanged it is treated as constant, and if the amount changed but its \n
+     * proportion of the source pool did not, it is treated as proportional. Composing the \n
+     * operations in order gives each map.
+     *
+     * Returns false if fewer than two rotations were recorded, the rotations differ in \n
+     * structure or a flux is neither constant nor proportional. Parameter pass is only \n
+     * set if endPass() was called in both rotations.
+     *
+     * @param pass AffineMap&
+     * @param rotation AffineMap&
+     * @return bool
+     * ************************/
+    bool SpinupSteadyStateSolver::buildMaps(AffineMap& pass, AffineMap& rotation) const {
+        if (!_valid || _inRotation || _rotations.size() < 2) {
+            return false;
+        }
+
+        const auto& previous = _rotations[0];
+        const auto& current = _rotations[1];
+        if (previous.events.size() != current.events.size() || previous.passEnd != current.passEnd) {
+            return false;
+        }
+
+        auto n = _poolCount;
+        auto& T = rotation.matrix;
+        auto& t = rotation.offset;
+        T.assign(n, std::vector<double>(n, 0.0));
+        t.assign(n, 0.0);
+        for (size_t i = 0; i < n; i++) {
+            T[i][i] = 1.0;
+        }
+
+        for (size_t e = 0; e < current.events.size(); e++) {
+            if (e == current.passEnd) {
+                pass = rotation;
+            }
+
+            const auto& before = previous.events[e];
+            const auto& event = current.events[e];
+            if (event.isReset != before.isReset
+                || event.pools != before.pools
+                || event.transfers.size() != before.transfers.size()) {
+
+                return false;
+            }
+
+            if (event.isReset) {
+                for (auto pool : event.pools) {
+                    std::fill(T[pool].begin(), T[pool].end(), 0.0);
+                    t[pool] = 0.0;
+                }
+
+                continue;
+            }
+
+            // Proportional fluxes are fractions of the source pool's value before the operation.
+            std::map<int, std::pair<std::vector<double>, double>> sourceRows;
+            for (const auto& transfer : event.transfers) {
+                if (sourceRows.find(transfer.source) == sourceRows.end()) {
+                    sourceRows[transfer.source] = std::make_pair(T[transfer.source], t[transfer.source]);
+                }
+            }
+
+            for (size_t f = 0; f < event.transfers.size(); f++) {
+                const auto& earlier = before.transfers[f];
+                const auto& transfer = event.transfers[f];
+                if (transfer.source != earlier.source || transfer.sink != earlier.sink) {
+                    return false;
+                }
+
+                if (isClose(transfer.value, earlier.value)) {
+                    t[transfer.source] -= transfer.value;
+                    t[transfer.sink] += transfer.value;
+                    continue;
+                }
+
+                // An empty source pool (i.e. the slow pools in the first rotation) says nothing about
+                // the proportion, but a flux out of one can't be proportional.
+                bool hasCurrent = transfer.sourceValue != 0;
+                bool hasEarlier = earlier.sourceValue != 0;
+                if ((!hasCurrent && transfer.value != 0) || (!hasEarlier && earlier.value != 0)
+                    || (!hasCurrent && !hasEarlier)) {
+
+                    return false;
+                }
+
+                auto proportion = hasCurrent ? transfer.value / transfer.sourceValue : earlier.value / earlier.sourceValue;
+                if (hasCurrent && hasEarlier && !isClose(proportion, earlier.value / earlier.sourceValue)) {
+                    return false;
+                }
+
+                const auto& sourceRow = sourceRows[transfer.source];
+                for (size_t j = 0; j < n; j++) {
+                    auto amount = proportion * sourceRow.first[j];
+                    T[transfer.source][j] -= amount;
+                    T[transfer.sink][j] += amount;
+                }
+
+                auto amount = proportion * sourceRow.second;
+                t[transfer.source] -= amount;
+                t[transfer.sink] += amount;
+            }
+        }
+
+        if (current.passEnd == current.events.size()) {
+            pass = rotation;
+        }
+
+        return true;
+    }
+
+    /**
+     * Run the regular procedure's remaining rotations on the recorded maps instead of simulating them. \n
+     * Starting from parameter startValues, the pool values at the start of rotation parameter rotation + 1, \n
+     * each rotation's pass end values are checked against parameter stoppingRule and, if it does not \n
+     * stop there, the whole rotation is applied. On return parameter rotation is the rotation the rule \n
+     * stopped at and parameter poolValues the pool values at its start, so that simulating that one pass \n
+     * leaves the stand where the regular procedure would have stopped. The maps are exact for linear \n
+     * modules, so this only differs from simulating the rotations by round-off.
+     *
+     * Returns false, leaving the parameters unchanged, if the maps can't be built (see buildMaps()) or \n
+     * endPass() was not called.
+     *
+     * @param startValues vector<double>&
+     * @param stoppingRule SpinupStoppingRule&
+     * @param rotation int&
+     * @param poolValues vector<double>&
+     * @return bool
+     * ************************/
+    bool SpinupSteadyStateSolver::project(const std::vector<double>& startValues, SpinupStoppingRule& stoppingRule,
+                                          int& rotation, std::vector<double>& poolValues) const {
+        if (startValues.size() != _poolCount) {
+            return false;
+        }
+
+        AffineMap pass;
+        AffineMap fullRotation;
+        if (!buildMaps(pass, fullRotation) || pass.matrix.empty()) {
+            return false;
+        }
+
+        auto values = startValues;
+        while (!stoppingRule.isDone(++rotation, pass.apply(values))) {
+            values = fullRotation.apply(values);
+        }
+
+        poolValues = values;
+        return true;
+    }
+
+    /**
+     * Solve for the pool values at the start of a rotation that the rotation maps back onto \n
+     * themselves, and write them to parameter poolValues.
+     *
+     * The rotation is x' = Mx + m (see buildMaps()). Pools that nothing flows out of in \n
+     * proportion to their value (the atmosphere, products) only accumulate and have no steady \n
+     * state; they keep their current values and are left out of the solve, since no other \n
+     * pool depends on them. The remaining pools are solved from (I - M)x = m.
+     *
+     * Returns false if the rotation map can't be built or the system has no unique \n
+     * non-negative solution.
+     *
+     * @param poolValues vector<double>&
+     * @return bool
+     * ************************/
+    bool SpinupSteadyStateSolver::solve(std::vector<double>& poolValues) const {
+        AffineMap pass;
+        AffineMap rotation;
+        if (!buildMaps(pass, rotation)) {
+            return false;
+        }
+
+        auto n = _poolCount;
+        const auto& T = rotation.matrix;
+        const auto& t = rotation.offset;
+
+        // Accumulating pools: no other pool depends on them and they map onto themselves.
+        std::vector<size_t> solved;
+        for (size_t j = 0; j < n; j++) {
+            bool accumulates = T[j][j] == 1.0;
+            for (size_t i = 0; accumulates && i < n; i++) {
+                accumulates = i == j || T[i][j] == 0.0;
+            }
+
+            if (!accumulates) {
+                solved.push_back(j);
+            }
+        }
+
+        // Gaussian elimination with partial pivoting on (I - M)x = m for the remaining pools.
+        auto size = solved.size();
+        std::vector<std::vector<double>> A(size, std::vector<double>(size + 1, 0.0));
+        for (size_t r = 0; r < size; r++) {
+            for (size_t c = 0; c < size; c++) {
+                A[r][c] = (r == c ? 1.0 : 0.0) - T[solved[r]][solved[c]];
+            }
+
+            A[r][size] = t[solved[r]];
+        }
+
+        for (size_t c = 0; c < size; c++) {
+            size_t pivot = c;
+            for (size_t r = c + 1; r < size; r++) {
+                if (std::abs(A[r][c]) > std::abs(A[pivot][c])) {
+                    pivot = r;
+                }
+            }
+
+            if (std::abs(A[pivot][c]) < 1e-12) {
+                return false;
+            }
+
+            std::swap(A[c], A[pivot]);
+            for (size_t r = 0; r < size; r++) {
+                if (r == c || A[r][c] == 0.0) {
+                    continue;
+                }
+
+                auto factor = A[r][c] / A[c][c];
+                for (size_t k = c; k <= size; k++) {
+                    A[r][k] -= factor * A[c][k];
+                }
+            }
+        }
+
+        std::vector<double> result = _currentValues;
+        double largest = 1.0;
+        for (size_t r = 0; r < size; r++) {
+            result[solved[r]] = A[r][size] / A[r][r];
+            largest = std::max(largest, std::abs(result[solved[r]]));
+        }
+
+        // Round-off can leave empty pools slightly negative; anything more means there is no steady state.
+        for (auto pool : solved) {
+            if (result[pool] < -_tolerance * largest) {
+                return false;
+            }
+
+            result[pool] = std::max(0.0, result[pool]);
+        }
+
+        poolValues = result;
+        return true;
+    }
+
+}}} // namespace moja::modules::cbm
@@ -1,5 +1,6 @@
 #include "moja/modules/cbm/standbiomasscarboncurve.h"
 
+#include <moja/flint/ivariable.h>
 #include <moja/logging.h>
 #include <algorithm>
 #include <fstream>
@@ -7,6 +8,34 @@
 namespace moja {
 namespace modules {
 namespace cbm {
+
+    namespace {
+        bool isHardwood(const StandComponent& component) {
+            return component.forestType() == "Hardwood";
+        }
+    }
+
+    /**
+     * Constructor
+     * 
+     * Resolve variable "age" and the softwood and hardwood "Merch", "Other", "Foliage", "CoarseRoots" \n
+     * and "FineRoots" pools in parameter landUnitData
+     * 
+     * @param landUnitData flint::ILandUnitDataWrapper&
+     * ***********************/
+    StandBiomassPools::StandBiomassPools(flint::ILandUnitDataWrapper& landUnitData) {
+        age = landUnitData.getVariable("age");
+        softwood.merch = landUnitData.getPool("SoftwoodMerch");
+        softwood.other = landUnitData.getPool("SoftwoodOther");
+        softwood.foliage = landUnitData.getPool("SoftwoodFoliage");
+        softwood.coarseRoots = landUnitData.getPool("SoftwoodCoarseRoots");
+        softwood.fineRoots = landUnitData.getPool("SoftwoodFineRoots");
+        hardwood.merch = landUnitData.getPool("HardwoodMerch");
+        hardwood.other = landUnitData.getPool("HardwoodOther");
+        hardwood.foliage = landUnitData.getPool("HardwoodFoliage");
+        hardwood.coarseRoots = landUnitData.getPool("HardwoodCoarseRoots");
+        hardwood.fineRoots = landUnitData.getPool("HardwoodFineRoots");
+    }
     
     /**
      * Create a variable standRootBiomass with initial value 0.0 \n
@@ -33,6 +62,34 @@ namespace cbm {
         return increments;
     }
 
+    /**
+     * Typed equivalent of StandBiomassCarbonCurve.getIncrements(): set parameter increments to the increments \n
+     * of each component in StandBiomassCarbonCurve._components, at the age and pool values in parameter pools. \n
+     * A component that is missing from the curve gets no increments
+     * 
+     * @param pools StandBiomassPools&
+     * @param increments StandBiomassCarbonIncrements&
+     * @return void
+     * ***********************/
+    void StandBiomassCarbonCurve::getIncrements(const StandBiomassPools& pools, StandBiomassCarbonIncrements& increments) const {
+        increments = StandBiomassCarbonIncrements();
+        int age = pools.age->value();
+
+        double standRootBiomass = 0.0;
+        for (const auto& component : _components) {
+            standRootBiomass += component.calculateRootBiomass(
+                age, isHardwood(component) ? pools.hardwood : pools.softwood);
+        }
+
+        for (const auto& component : _components) {
+            if (isHardwood(component)) {
+                component.getIncrements(age, pools.hardwood, standRootBiomass, increments.hardwood);
+            } else {
+                component.getIncrements(age, pools.softwood, standRootBiomass, increments.softwood);
+            }
+        }
+    }
+
     /**
      * Get the absolute total aboveground carbon at each age, where index = age
      * 
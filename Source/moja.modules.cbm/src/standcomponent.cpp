@@ -4,6 +4,8 @@
 
 #include <boost/format.hpp>
 
+#include <algorithm>
+
 namespace moja {
 namespace modules {
 namespace cbm {
@@ -113,6 +115,100 @@ namespace cbm {
         };
     }
 
+    /**
+     * Store the merchantable, other and foliage carbon increments of StandComponent._growthCurve at each age in \n
+     * StandComponent._agIncrements, so that a growth step only has to index them
+     * 
+     * @return void
+     * *****************************/
+    void StandComponent::precomputeAGIncrements() {
+        _agIncrements.clear();
+        if (_growthCurve == nullptr) {
+            return;
+        }
+
+        auto maxAge = std::max({ _growthCurve->getMerchCarbonCurve().size(),
+                                 _growthCurve->getOtherCarbonCurve().size(),
+                                 _growthCurve->getFoliageCarbonCurve().size() });
+
+        _agIncrements.reserve(maxAge);
+        for (int age = 0; age < maxAge; age++) {
+            _agIncrements.push_back(AGIncrement{
+                _growthCurve->getMerchCarbonIncrement(age),
+                _growthCurve->getOtherCarbonIncrement(age),
+                _growthCurve->getFoliageCarbonIncrement(age)
+            });
+        }
+    }
+
+    /**
+     * Return the precomputed increments at parameter age, or the remainder of the pool values parameter merch, \n
+     * parameter other and parameter foliage, if the increment results in a negative pool value. There is no \n
+     * increment before age 0 or beyond the end of the curve, as with the increments of StandComponent._growthCurve
+     * 
+     * @param age int
+     * @param merch double
+     * @param other double
+     * @param foliage double
+     * @return ComponentBiomassCarbonIncrements
+     * *****************************/
+    ComponentBiomassCarbonIncrements StandComponent::getAGIncrements(int age, double merch, double other, double foliage) const {
+        AGIncrement increment{ 0.0, 0.0, 0.0 };
+        if (age >= 0 && age < _agIncrements.size()) {
+            increment = _agIncrements[age];
+        }
+
+        ComponentBiomassCarbonIncrements increments;
+        increments.merch = std::max(increment.merch, -merch);
+        increments.other = std::max(increment.other, -other);
+        increments.foliage = std::max(increment.foliage, -foliage);
+
+        return increments;
+    }
+
+    /**
+     * Typed equivalent of StandComponent.calculateRootBiomass() for the stand at parameter age with the \n
+     * component pools in parameter pools
+     * 
+     * @param age int
+     * @param pools ComponentBiomassPools&
+     * @return double
+     * *****************************/
+    double StandComponent::calculateRootBiomass(int age, const ComponentBiomassPools& pools) const {
+        auto agIncrements = getAGIncrements(
+            age, pools.merch->value(), pools.other->value(), pools.foliage->value());
+        double totalAGBiomass =
+            pools.merch->value() + agIncrements.merch +
+            pools.other->value() + agIncrements.other +
+            pools.foliage->value() + agIncrements.foliage;
+
+        return _rootBiomassEquation->calculateRootBiomass(totalAGBiomass);
+    }
+
+    /**
+     * Typed equivalent of StandComponent.getIncrements(): store the increments for the stand at parameter age \n
+     * with the component pools in parameter pools in parameter increments
+     * 
+     * @param age int
+     * @param pools ComponentBiomassPools&
+     * @param standRootBiomass double
+     * @param increments ComponentBiomassCarbonIncrements&
+     * @return void
+     * *****************************/
+    void StandComponent::getIncrements(int age, const ComponentBiomassPools& pools, double standRootBiomass,
+                                       ComponentBiomassCarbonIncrements& increments) const {
+        auto agIncrements = getAGIncrements(
+            age, pools.merch->value(), pools.other->value(), pools.foliage->value());
+        double rootCarbon = _rootBiomassEquation->biomassToCarbon(calculateRootBiomass(age, pools));
+        auto rootProps = _rootBiomassEquation->calculateRootProportions(standRootBiomass);
+
+        increments.merch = agIncrements.merch;
+        increments.other = agIncrements.other;
+        increments.foliage = agIncrements.foliage;
+        increments.fineRoots = rootCarbon * rootProps.fine - pools.fineRoots->value();
+        increments.coarseRoots = rootCarbon * rootProps.coarse - pools.coarseRoots->value();
+    }
+
     /**
      * Return StandComponent.getAboveGroundCarbonCurve() on StandComponent._growthCurve
      * 
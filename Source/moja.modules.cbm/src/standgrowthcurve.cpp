@@ -19,6 +19,7 @@ namespace cbm {
         _standMaxAge = 0;
         _standAgeForMaximumMerchVolume = 0;
         _standMaximumMerchVolume = 0;
+        _inputHash = 0;
     }
 
     /**
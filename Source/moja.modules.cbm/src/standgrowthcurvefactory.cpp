@@ -2,10 +2,12 @@
  * @file 
  * StandGrowthCurveFactory is a singleton factory class to create a stand growth curve.
  * This object will be instantiated in module factory, and be injected to other objects that requires the stand growth factory 
+ * Each stand growth curve is built once and shared by all threads.
  *******************************/
 #include "moja/flint/variable.h"
 #include "moja/modules/cbm/standgrowthcurvefactory.h"
 #include "moja/modules/cbm/foresttypeconfiguration.h"
+#include "moja/modules/cbm/parameterhash.h"
 
 namespace moja {
 namespace modules {
@@ -17,6 +19,30 @@ namespace cbm {
      * ******************/
 	StandGrowthCurveFactory::StandGrowthCurveFactory() {}  
 		
+    /**
+     * Return the stand growth curve for parameters standGrowthCurveID and spuID, building it with \n
+     * StandGrowthCurveFactory.buildStandGrowthCurve() if no thread has yet. If another thread is \n
+     * building the same curve, wait for it instead of building it again \n
+     * Add the curve to the lookup by stand growth curve ID used by StandGrowthCurveFactory.getStandGrowthCurve()
+     * 
+     * @param standGrowthCurveID Int64
+     * @param spuID Int64
+     * @param landUnitData flint::ILandUnitDataWrapper&
+     * @return shared_ptr<StandGrowthCurve>
+     * *******************************/
+	std::shared_ptr<StandGrowthCurve> StandGrowthCurveFactory::createStandGrowthCurve(
+		Int64 standGrowthCurveID, Int64 spuID, flint::ILandUnitDataWrapper& landUnitData) {
+
+		auto standGrowthCurve = _curves.getOrBuild(std::make_tuple(standGrowthCurveID, spuID), [&]() {
+			return buildStandGrowthCurve(standGrowthCurveID, spuID, landUnitData);
+		});
+
+		// Time to store the stand growth curve lookup for moss related modules
+		_curvesById.insert(standGrowthCurveID, standGrowthCurve);
+
+		return standGrowthCurve;
+	}
+
     /**
      * Instantiate an object standGrowthCurve of StandGrowthCurve with parameters standGrowthCurveID, spuID \n
      * Get the softwoodYieldTable and hardwoodYieldTable from variables "softwood_yield_table", "hardwood_yield_table" in parameter landUnitData \n
@@ -24,18 +50,19 @@ namespace cbm {
      * Instantiate an object of TreeYieldTable with hardwoodYieldTable, SpeciesType::Hardwood and add it to standGrowthCurve \n
      * For each row of variable "volume_to_biomass_parameters" in parameter landUnitData, query for the appropriate PERD factor data, 
      * based on the value of "forest_type" for each row either "Softwood" or "Hardwood", invoke StandGrowthCurve.setPERDFactor() and StandGrowthCurve.setForestTypeConfiguration() \n
-     * Invoke StandGrowthCurveFactory.processStandYieldTables() to pre-process the stand growth curve, addStandGrowthCurve() with arguments standGrowthCurveID and standGrowthCurve and return the 
-     * value of standGrowthCurveID in StandGrowthCurveFactory.getCache()
+     * Invoke StandGrowthCurveFactory.processStandYieldTables() to pre-process the stand growth curve \n
+     * Tag the curve with a hash of the three variables, so that biomass carbon curves saved from it can be \n
+     * recognized as stale when the yield tables or parameters change, and return it
      * 
      * @param standGrowthCurveID Int64
      * @param spuID Int64
      * @param landUnitData flint::ILandUnitDataWrapper&
-     * @return Poco::SharedPtr<StandGrowthCurve>
+     * @return shared_ptr<StandGrowthCurve>
      * *******************************/
-	Poco::SharedPtr<StandGrowthCurve> StandGrowthCurveFactory::createStandGrowthCurve(
+	std::shared_ptr<StandGrowthCurve> StandGrowthCurveFactory::buildStandGrowthCurve(
 		Int64 standGrowthCurveID, Int64 spuID, flint::ILandUnitDataWrapper& landUnitData) {
 
-        StandGrowthCurve standGrowthCurve(standGrowthCurveID, spuID);
+        auto standGrowthCurve = std::make_shared<StandGrowthCurve>(standGrowthCurveID, spuID);
 
 		 // Get the table of softwood merchantable volumes associated to the stand growth curve.
         std::vector<DynamicObject> softwoodYieldTable;
@@ -45,7 +72,7 @@ namespace cbm {
         }
 
         TreeYieldTable swTreeYieldTable(softwoodYieldTable, SpeciesType::Softwood);
-        standGrowthCurve.addYieldTable(swTreeYieldTable);
+        standGrowthCurve->addYieldTable(swTreeYieldTable);
 
         // Get the table of hardwood merchantable volumes associated to the stand growth curve.
         std::vector<DynamicObject> hardwoodYieldTable;
@@ -55,7 +82,7 @@ namespace cbm {
         }
 
         TreeYieldTable hwTreeYieldTable(hardwoodYieldTable, SpeciesType::Hardwood);
-        standGrowthCurve.addYieldTable(hwTreeYieldTable);
+        standGrowthCurve->addYieldTable(hwTreeYieldTable);
         
         // Query for the appropriate PERD factor data.
         std::vector<DynamicObject> vol2bioParams;
@@ -74,15 +101,15 @@ namespace cbm {
 
             std::string forestType = row["forest_type"].convert<std::string>();
             if (forestType == "Softwood") {
-                standGrowthCurve.setPERDFactor(std::move(perdFactor), SpeciesType::Softwood);
-                standGrowthCurve.setForestTypeConfiguration(ForestTypeConfiguration{
+                standGrowthCurve->setPERDFactor(std::move(perdFactor), SpeciesType::Softwood);
+                standGrowthCurve->setForestTypeConfiguration(ForestTypeConfiguration{
                     "Softwood",
                     std::make_shared<SoftwoodRootBiomassEquation>(
                         row["sw_a"], row["frp_a"], row["frp_b"], row["frp_c"])
                 }, SpeciesType::Softwood);
             } else if (forestType == "Hardwood") {
-                standGrowthCurve.setPERDFactor(std::move(perdFactor), SpeciesType::Hardwood);
-                standGrowthCurve.setForestTypeConfiguration(ForestTypeConfiguration{
+                standGrowthCurve->setPERDFactor(std::move(perdFactor), SpeciesType::Hardwood);
+                standGrowthCurve->setForestTypeConfiguration(ForestTypeConfiguration{
                     "Hardwood",
                     std::make_shared<HardwoodRootBiomassEquation>(
                         row["hw_a"], row["hw_b"], row["frp_a"], row["frp_b"], row["frp_c"])
@@ -91,39 +118,28 @@ namespace cbm {
         }
 
 		// Pre-process the stand growth curve here.
-		standGrowthCurve.processStandYieldTables();
+		standGrowthCurve->processStandYieldTables();
 
-		// Time to store the stand growth curve lookup for moss related modules		
-		addStandGrowthCurve(standGrowthCurveID, standGrowthCurve);
+        ParameterHash inputs;
+        inputs.add("softwood_yield_table");
+        inputs.add(swTable);
+        inputs.add("hardwood_yield_table");
+        inputs.add(hwTable);
+        inputs.add("volume_to_biomass_parameters");
+        inputs.add(vol2bio);
+        standGrowthCurve->setInputHash(inputs.value());
 
-        return getCache().get(standGrowthCurveID);	
+        return standGrowthCurve;
 	}  	
 	
 	/**
-     * Return the value of paramter growthCurveID in StandGrowthCurveFactory.getCache() if not null, else return nullptr 
+     * Return the stand growth curve for paramter growthCurveID created by any thread, else return nullptr 
      * 
      * @param growthCurveID
-     * @return Poco::SharedPtr<StandGrowthCurve>
+     * @return shared_ptr<StandGrowthCurve>
      ************************/
-	Poco::SharedPtr<StandGrowthCurve> StandGrowthCurveFactory::getStandGrowthCurve(Int64 growthCurveID) {
-        Poco::SharedPtr<StandGrowthCurve> standGrowthCurve = nullptr;
-        auto cached = getCache().get(growthCurveID);
-        if (!cached.isNull()) {
-            standGrowthCurve = cached;
-        }
-
-        return standGrowthCurve;
+	std::shared_ptr<StandGrowthCurve> StandGrowthCurveFactory::getStandGrowthCurve(Int64 growthCurveID) {
+        return _curvesById.find(growthCurveID);
     }
 
-    /**
-     * Add the result of StandGrowthCurve.standGrowthCurveID() on parameter standGrowthCurve and parameter standGrowthCurve to 
-     * the cache using StandGrowthCurveFactory.getCache()
-     * 
-     * @param standGrowthCurveID Int64
-     * @param standGrowthCurve StandGrowthCurve&
-     * @return void
-     *****************************/
-	void StandGrowthCurveFactory::addStandGrowthCurve(Int64 standGrowthCurveID, StandGrowthCurve& standGrowthCurve) {
-		getCache().add(standGrowthCurve.standGrowthCurveID(), standGrowthCurve);
-	}
 }}}
\ No newline at end of file
@@ -3,54 +3,84 @@
 
 #include "moja/modules/cbm/timeseries.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <limits>
+#include <stdexcept>
 #include <Poco/Bugcheck.h>
 
 namespace moja {
 namespace modules {
 namespace cbm {
 
-class TimeSeries::TimeSeriesPrep {
-public:
-    TimeSeriesPrep(int yr0, int dataPerYr, int nYrs, bool subSame, DateOrigin origin,
-                   int extraSteps, const std::vector<boost::optional<double>> raw);
+namespace {
+
+// Copy raw data into values, with missing values as NaN; return true if any are missing.
+template<typename T>
+bool copyRaw(const std::vector<boost::optional<T>>& raw, double* values) {
+    bool hasGaps = false;
+    for (std::size_t i = 0; i < raw.size(); ++i) {
+        if (raw[i].is_initialized() && !std::isnan(raw[i].get())) {
+            values[i] = raw[i].get();
+        } else {
+            values[i] = std::numeric_limits<double>::quiet_NaN();
+            hasGaps = true;
+        }
+    }
 
-    TimeSeriesPrep() :
-        _extrap(ExtrapType::NearestYr), _origin(DateOrigin::StartSim), _yr0(0), _nYrs(0),
-        _dataPerYr(0), _mult(1.0), _subSame(false), _prepared(false), _extraStepsIfSprout(0) {}
+    return hasGaps;
+}
 
-    ~TimeSeriesPrep() = default;
+// Series prepared together by TimeSeriesBatch; bounds the size of the interleaved arrays.
+const std::size_t kBatchWidth = 64;
+
+} // namespace
+
+/**
+ * Sizing and computation of a prepared timeseries, shared by TimeSeries and TimeSeriesBatch.
+ * The data and prepared arrays hold _width interleaved series: value k of series s is at
+ * [k * _width + s]. Every step of the computation is a loop over the series, doing for each
+ * one the same arithmetic as for a single series.
+ */
+class TimeSeriesPlan {
+public:
+    TimeSeriesPlan(int yr0, int dataPerYr, int nYrs, bool subSame, DateOrigin origin, int extraSteps) :
+        _extrap(ExtrapType::NearestYr), _origin(origin), _yr0(yr0), _nYrs(nYrs), _dataPerYr(dataPerYr),
+        _mult(1.0), _subSame(subSame), _timing(nullptr), _extraStepsIfSprout(extraSteps),
+        _width(1), _nData(0) {}
 
     void setTiming(const flint::ITiming* timing);
-    const std::vector<double>& series();
-    double value();
-    int yr0() const;
-    int nYrs() const;
-    int dataPerYr() const;
-    bool subSame() const;
-    const std::vector<boost::optional<double>> raw() const;
-    DateOrigin origin() const;
-    ExtrapType extrap() const;
+    void fillGapsMult(const double* raw, double* result, int width);
+    void prepare(const double* data, int nData, double* prep, int width);
+
+    int yr0() const { return _yr0; }
+    int nYrs() const { return _nYrs; }
+    int dataPerYr() const { return _dataPerYr; }
+    bool subSame() const { return _subSame; }
+    DateOrigin origin() const { return _origin; }
+    ExtrapType extrap() const { return _extrap; }
+    double mult() const { return _mult; }
+    const flint::ITiming* timing() const { return _timing; }
+    int nSteps() const { return _prepNSteps; }
 
 private:
-    void preparedTS();
     void calcSizes();
-    std::vector<double> fillGapsMult();
-    void computeOneDataPoint(const std::vector<double>& data, std::vector<double>& prep);
-    void computeAvgYr(const std::vector<double>& data);
-    void computeWholeYrsInterp(const std::vector<double>& data, std::vector<double>& prep);
-    void computeWholeYrsBefore(const std::vector<double>& data, std::vector<double>& prep);
-    void computeWholeYrsAfter(const std::vector<double>& data, std::vector<double>& prep);
-    void computeOneWholeYr(const std::vector<double>& data, std::vector<double>& prep, int dix, int pix);
-    void computeOddStepsBefore(const std::vector<double>& data, std::vector<double>& prep);
-    void computeOddStepsAfter(const std::vector<double>& data, std::vector<double>& prep);
-    void copyOddStepsBefore(const std::vector<double>& src, std::vector<double>& prep, int srcIx);
-    void copyOddStepsAfter(const std::vector<double>& src, std::vector<double>& prep, int srcIx, int pix);
-    int dixFromYr(const std::vector<double>& data, int yr);
+    void computeOneDataPoint(const double* data, double* prep);
+    void computeAvgYr(const double* data);
+    void computeWholeYrsInterp(const double* data, double* prep);
+    void computeWholeYrsBefore(const double* data, double* prep);
+    void computeWholeYrsAfter(const double* data, double* prep);
+    void computeOneWholeYr(const double* data, double* prep, int dix, int pix);
+    void computeOddStepsBefore(const double* data, double* prep);
+    void computeOddStepsAfter(const double* data, double* prep);
+    void copyOddStepsBefore(const double* src, double* prep, int srcIx);
+    void copyOddStepsAfter(const double* src, double* prep, int srcIx, int pix);
+    int dixFromYr(int yr);
     void interpOneYr(const double* d, double* p, int prepIxLo, int prepIxHi);
 
     void interpOneYrWithCheck(
-        const std::vector<double>& data, std::vector<double>& prep,
+        const double* data, double* prep,
         int dix, int pix, int prepIxLo, int prepIxHi);
 
     ExtrapType _extrap;	// NearestYr, CycleYrs, AvgYr
@@ -61,9 +91,11 @@ private:
     double _mult;
     bool _subSame;
     const flint::ITiming* _timing;
-    const std::vector<boost::optional<double>> _raw; // User's raw data
-    std::vector<double> _series;
-    bool _prepared;
+    int _extraStepsIfSprout;
+
+    // About the current computation
+    int _width;	// Number of interleaved series
+    int _nData;	// Number of data points in each series
 
     // About the current prepTS
     int	_prepFirstYr;
@@ -74,6 +106,8 @@ private:
     // Used for computing the time series prepTS by PrepareTS:
     std::vector<double> _avgData; // one year of averaged data (if required)
     std::vector<double> _avgPrep; // one year of prepared averaged data
+    std::vector<double> _colAvg;  // column average of each series while filling gaps
+    std::vector<int> _colN;       // number of values in the column of each series
 
     int	_dataStYr; // Start year of data
     int _dataEnYr; // End year of data
@@ -91,16 +125,93 @@ private:
     int _oddStepsAfter;		//   Part year after  last  whole year [0..prepStepsPerYr - 1]
     int	_nWholeYrs;			//   wholeYrsBefore + wholeYrsInterp + wholeYrsAfter
     int _firstWholeYr;
-    int _extraStepsIfSprout;
 };
 
+class TimeSeries::TimeSeriesPrep {
+public:
+    template<typename T>
+    TimeSeriesPrep(int yr0, int dataPerYr, int nYrs, bool subSame, DateOrigin origin,
+                   int extraSteps, const std::vector<boost::optional<T>>& raw);
+
+    TimeSeriesPrep() :
+        _plan(0, 0, 0, false, DateOrigin::StartSim, 0), _hasGaps(false), _prepared(false) {}
+
+    ~TimeSeriesPrep() = default;
+
+    void setTiming(const flint::ITiming* timing);
+    const std::vector<double>& series();
+    double value();
+    int yr0() const;
+    int nYrs() const;
+    int dataPerYr() const;
+    bool subSame() const;
+    const std::vector<boost::optional<double>> raw() const;
+    DateOrigin origin() const;
+    ExtrapType extrap() const;
+
+private:
+    void preparedTS();
+
+    TimeSeriesPlan _plan;
+    std::vector<double> _raw;    // User's raw data, NaN where a value is missing
+    bool _hasGaps;
+    std::vector<double> _filled; // Raw data with its gaps filled, if it has any
+    std::vector<double> _series;
+    bool _prepared;
+};
+
+class TimeSeriesBatch::BatchPrep {
+public:
+    BatchPrep(int yr0, int dataPerYr, int nYrs, bool subSame, DateOrigin origin, int extraSteps) :
+        _plan(yr0, dataPerYr, nYrs, subSame, origin, extraSteps),
+        _nData(static_cast<std::size_t>(dataPerYr) * nYrs), _nSeries(0) {}
+
+    template<typename T>
+    std::size_t add(const std::vector<boost::optional<T>>& raw);
+
+    std::size_t size() const { return _nSeries; }
+    void prepare(const flint::ITiming* timing);
+    TimeSeriesView series(std::size_t index) const;
+
+private:
+    TimeSeriesPlan _plan;
+    std::size_t _nData;
+    std::size_t _nSeries;
+    std::vector<double> _raw;         // Raw data of every series, one after another, NaN where missing
+    std::vector<double> _series;      // Prepared data of every series, one after another
+    std::vector<double> _interleaved; // Raw, then gap filled, data of the series being prepared
+    std::vector<double> _prep;        // Prepared data of the series being prepared
+};
+
+// Raw data is copied once into a contiguous array of doubles, with missing values as NaN.
+template<typename T>
+TimeSeries::TimeSeriesPrep::TimeSeriesPrep(
+    int yr0, int dataPerYr, int nYrs, bool subSame, DateOrigin origin,
+    int extraSteps, const std::vector<boost::optional<T>>& raw) :
+    _plan(yr0, dataPerYr, nYrs, subSame, origin, extraSteps), _raw(raw.size()),
+    _hasGaps(false), _prepared(false) {
+
+    _hasGaps = copyRaw(raw, _raw.data());
+}
+
 TimeSeries::TimeSeries() : _impl(std::make_shared<TimeSeriesPrep>()) {}
 
 TimeSeries::TimeSeries(int yr0, int dataPerYr, int nYrs, bool subSame,
-                       const std::vector<boost::optional<double>> raw,
+                       const std::vector<boost::optional<double>>& raw,
                        DateOrigin origin, int extraSteps) :
     _impl(std::make_shared<TimeSeriesPrep>(yr0, dataPerYr, nYrs, subSame, origin, extraSteps, raw)) {}
 
+TimeSeries::TimeSeries(int yr0, int dataPerYr, int nYrs, bool subSame,
+                       const std::vector<boost::optional<float>>& raw,
+                       DateOrigin origin, int extraSteps) :
+    _impl(std::make_shared<TimeSeriesPrep>(yr0, dataPerYr, nYrs, subSame, origin, extraSteps, raw)) {}
+
+bool TimeSeries::hasData(const std::vector<boost::optional<float>>& raw) {
+    return std::any_of(raw.begin(), raw.end(), [](const boost::optional<float>& value) {
+        return value.is_initialized() && !std::isnan(value.get());
+    });
+}
+
 const std::vector<double>& TimeSeries::series() const { return _impl->series(); }
 double TimeSeries::value() const { return _impl->value(); }
 int TimeSeries::yr0() const { return _impl->yr0(); }
@@ -115,13 +226,117 @@ void TimeSeries::setTiming(const flint::ITiming* timing) {
     _impl->setTiming(timing);
 }
 
-TimeSeries::TimeSeriesPrep::TimeSeriesPrep(
-    int yr0, int dataPerYr, int nYrs, bool subSame, DateOrigin origin,
-    int extraSteps, const std::vector<boost::optional<double>> raw) :
-    _extrap(ExtrapType::NearestYr), _origin(origin), _yr0(yr0), _nYrs(nYrs), _dataPerYr(dataPerYr),
-    _mult(1.0), _subSame(subSame), _raw(raw), _prepared(false), _extraStepsIfSprout(extraSteps) {}
-
 void TimeSeries::TimeSeriesPrep::setTiming(const flint::ITiming* timing) {
+    _plan.setTiming(timing);
+    _prepared = false;
+}
+
+const std::vector<double>& TimeSeries::TimeSeriesPrep::series() {
+    if (!_prepared) {
+        preparedTS();
+    }
+
+    return _series;
+}
+
+double TimeSeries::TimeSeriesPrep::value() {
+    if (!_prepared) {
+        preparedTS();
+    }
+
+    return _series[_plan.timing()->step()];
+}
+
+int TimeSeries::TimeSeriesPrep::yr0() const { return _plan.yr0(); }
+int TimeSeries::TimeSeriesPrep::nYrs() const { return _plan.nYrs(); }
+int TimeSeries::TimeSeriesPrep::dataPerYr() const { return _plan.dataPerYr(); }
+bool TimeSeries::TimeSeriesPrep::subSame() const { return _plan.subSame(); }
+DateOrigin TimeSeries::TimeSeriesPrep::origin() const { return _plan.origin(); }
+ExtrapType TimeSeries::TimeSeriesPrep::extrap() const { return _plan.extrap(); }
+
+const std::vector<boost::optional<double>> TimeSeries::TimeSeriesPrep::raw() const {
+    std::vector<boost::optional<double>> raw;
+    raw.reserve(_raw.size());
+    for (auto value : _raw) {
+        raw.push_back(std::isnan(value) ? boost::optional<double>() : boost::optional<double>(value));
+    }
+
+    return raw;
+}
+
+void TimeSeries::TimeSeriesPrep::preparedTS() {
+    // Computations with raw data. Complete raw data is used as is.
+    const double* data = _raw.data();
+    if (_hasGaps || _plan.mult() != 1.0) {
+        _filled.resize(_raw.size());
+        _plan.fillGapsMult(_raw.data(), _filled.data(), 1);
+        data = _filled.data();
+    }
+
+    _series.resize(_plan.nSteps());
+    _plan.prepare(data, static_cast<int>(_raw.size()), _series.data(), 1);
+    _prepared = true;
+}
+
+TimeSeriesBatch::TimeSeriesBatch(int yr0, int dataPerYr, int nYrs, bool subSame,
+                                 DateOrigin origin, int extraSteps) :
+    _impl(std::make_shared<BatchPrep>(yr0, dataPerYr, nYrs, subSame, origin, extraSteps)) {}
+
+std::size_t TimeSeriesBatch::add(const std::vector<boost::optional<double>>& raw) { return _impl->add(raw); }
+std::size_t TimeSeriesBatch::add(const std::vector<boost::optional<float>>& raw) { return _impl->add(raw); }
+std::size_t TimeSeriesBatch::size() const { return _impl->size(); }
+void TimeSeriesBatch::prepare(const flint::ITiming* timing) { _impl->prepare(timing); }
+TimeSeriesView TimeSeriesBatch::series(std::size_t index) const { return _impl->series(index); }
+
+template<typename T>
+std::size_t TimeSeriesBatch::BatchPrep::add(const std::vector<boost::optional<T>>& raw) {
+    if (raw.size() != _nData) {
+        throw std::invalid_argument("Timeseries length does not match the batch's data per year and years");
+    }
+
+    _raw.resize(_raw.size() + _nData);
+    copyRaw(raw, &_raw[_raw.size() - _nData]);
+
+    return _nSeries++;
+}
+
+void TimeSeriesBatch::BatchPrep::prepare(const flint::ITiming* timing) {
+    _plan.setTiming(timing);
+    const std::size_t nSteps = _plan.nSteps();
+    _series.resize(_nSeries * nSteps);
+
+    // Series are interleaved kBatchWidth at a time, gap filled in place, prepared together
+    // and copied back out one after another.
+    for (std::size_t first = 0; first < _nSeries; first += kBatchWidth) {
+        const std::size_t width = std::min(kBatchWidth, _nSeries - first);
+        _interleaved.resize(_nData * width);
+        for (std::size_t s = 0; s < width; ++s) {
+            const double* raw = &_raw[(first + s) * _nData];
+            for (std::size_t k = 0; k < _nData; ++k) {
+                _interleaved[k * width + s] = raw[k];
+            }
+        }
+
+        _plan.fillGapsMult(_interleaved.data(), _interleaved.data(), static_cast<int>(width));
+
+        _prep.resize(nSteps * width);
+        _plan.prepare(_interleaved.data(), static_cast<int>(_nData), _prep.data(), static_cast<int>(width));
+
+        for (std::size_t s = 0; s < width; ++s) {
+            double* series = &_series[(first + s) * nSteps];
+            for (std::size_t i = 0; i < nSteps; ++i) {
+                series[i] = _prep[i * width + s];
+            }
+        }
+    }
+}
+
+TimeSeriesView TimeSeriesBatch::BatchPrep::series(std::size_t index) const {
+    const std::size_t nSteps = _nSeries == 0 ? 0 : _series.size() / _nSeries;
+    return TimeSeriesView(_series.data() + index * nSteps, nSteps);
+}
+
+void TimeSeriesPlan::setTiming(const flint::ITiming* timing) {
 	_timing = timing;
 	_prepNSteps = _timing->nSteps();
 	if (_origin == DateOrigin::Sprout)
@@ -156,41 +371,14 @@ void TimeSeries::TimeSeriesPrep::setTiming(const flint::ITiming* timing) {
 
 	// Compute sizing parameters
 	calcSizes();
-	_prepared = false;
-}
-
-
-const std::vector<double>& TimeSeries::TimeSeriesPrep::series() {
-    if (!_prepared) {
-        preparedTS();
-    }
-
-    return _series;
-}
-
-double TimeSeries::TimeSeriesPrep::value() {
-    if (!_prepared) {
-        preparedTS();
-    }
-
-    return _series[_timing->step()];
 }
 
-int TimeSeries::TimeSeriesPrep::yr0() const { return _yr0; }
-int TimeSeries::TimeSeriesPrep::nYrs() const { return _nYrs; }
-int TimeSeries::TimeSeriesPrep::dataPerYr() const { return _dataPerYr; }
-bool TimeSeries::TimeSeriesPrep::subSame() const { return _subSame; }
-const std::vector<boost::optional<double>> TimeSeries::TimeSeriesPrep::raw() const { return _raw; }
-DateOrigin TimeSeries::TimeSeriesPrep::origin() const { return _origin; }
-ExtrapType TimeSeries::TimeSeriesPrep::extrap() const { return _extrap; }
+void TimeSeriesPlan::prepare(const double* data, int nData, double* prep, int width) {
+    _width = width;
+    _nData = nData;
 
-void TimeSeries::TimeSeriesPrep::preparedTS() {
-    // Computations with raw data.
-    auto data = fillGapsMult();
-    _series.resize(_prepNSteps);
-
-    if (data.size() == 1) {
-        computeOneDataPoint(data, _series);
+    if (_nData == 1) {
+        computeOneDataPoint(data, prep);
         return;
     }
 
@@ -203,12 +391,11 @@ void TimeSeries::TimeSeriesPrep::preparedTS() {
     }
 
     // Compute prepared data. Must go in this order!
-    if (_wholeYrsInterp > 0) computeWholeYrsInterp(data, _series);
-    if (_wholeYrsBefore > 0) computeWholeYrsBefore(data, _series);
-    if (_wholeYrsAfter  > 0)  computeWholeYrsAfter(data, _series);
-    if (_oddStepsBefore > 0) computeOddStepsBefore(data, _series);
-    if (_oddStepsAfter  > 0)  computeOddStepsAfter(data, _series);
-    _prepared = true;
+    if (_wholeYrsInterp > 0) computeWholeYrsInterp(data, prep);
+    if (_wholeYrsBefore > 0) computeWholeYrsBefore(data, prep);
+    if (_wholeYrsAfter  > 0)  computeWholeYrsAfter(data, prep);
+    if (_oddStepsBefore > 0) computeOddStepsBefore(data, prep);
+    if (_oddStepsAfter  > 0)  computeOddStepsAfter(data, prep);
 }
 
 #if 0
@@ -272,7 +459,7 @@ void TimeSeries::TimeSeriesPrep::preparedTS() {
 }
 #endif
 
-void TimeSeries::TimeSeriesPrep::calcSizes() {
+void TimeSeriesPlan::calcSizes() {
     // Already set: prepNSteps, prepFirstYr, prepFirstStep, prepStepsPerYr
 	poco_assert(   _extrap == ExtrapType::NearestYr
                 || _extrap == ExtrapType::CycleYrs
@@ -329,70 +516,95 @@ void TimeSeries::TimeSeriesPrep::calcSizes() {
     poco_assert(_wholeYrsInterp <= _nYrs);
 }
 
-std::vector<double> TimeSeries::TimeSeriesPrep::fillGapsMult() {
+void TimeSeriesPlan::fillGapsMult(const double* raw, double* result, int width) {
     // - Later interpolations and extrapolations require the TS table to be complete.
     // - Empty cells are assigned the average of the column.
+    // - result may be raw: each value is read before it is written.
+    _colAvg.resize(width);
+    _colN.resize(width);
+    double* colAvg = _colAvg.data();
+    int* n = _colN.data();
 
-    std::vector<double> result(_raw.size());
     for (auto c = 0; c < _dataPerYr; ++c) {              // Calculate col sum
-        double colAvg = 0.0;
-        int n = 0;
+        std::fill(colAvg, colAvg + width, 0.0);
+        std::fill(n, n + width, 0);
         int ix = c;
         for (auto r = 0; r < _nYrs; ++r) {
-            if (_raw[ix].is_initialized()) {
-                colAvg += _raw[ix].get();
-                ++n;
+            const double* row = raw + ix * width;
+            for (int s = 0; s < width; ++s) {
+                bool isValue = !std::isnan(row[s]);
+                colAvg[s] += isValue ? row[s] : 0.0;
+                n[s] += isValue ? 1 : 0;
             }
             ix += _dataPerYr;
         }
 
-        if (n == 0)
-            throw std::runtime_error("No data for timeseries column");
+        for (int s = 0; s < width; ++s) {
+            if (n[s] == 0)
+                throw std::runtime_error("No data for timeseries column");
+
+            colAvg[s] /= n[s];
+        }
 
-        colAvg /= n;
         ix = c;
         for (auto r = 0; r < _nYrs; ++r) {
-            result[ix] = (_raw[ix].is_initialized() ? _raw[ix].get() : colAvg) * _mult;
+            const double* row = raw + ix * width;
+            double* out = result + ix * width;
+            for (int s = 0; s < width; ++s) {
+                out[s] = (std::isnan(row[s]) ? colAvg[s] : row[s]) * _mult;
+            }
             ix += _dataPerYr;
         }
     }
-    return result;
 }
 
-void TimeSeries::TimeSeriesPrep::computeOneDataPoint(const std::vector<double>& data,
-                                                     std::vector<double>& prep) {
-    poco_assert(data.size() == 1);
-    double val = data.front();
-    if (!_subSame)
-        val /= static_cast<double>(_prepStepsPerYr);
-    std::fill(std::begin(prep), std::end(prep), val);
+void TimeSeriesPlan::computeOneDataPoint(const double* data, double* prep) {
+    poco_assert(_nData == 1);
+    if (_prepNSteps == 0) {
+        return;
+    }
+
+    for (int s = 0; s < _width; ++s) {
+        double val = data[s];
+        if (!_subSame)
+            val /= static_cast<double>(_prepStepsPerYr);
+        prep[s] = val;
+    }
+
+    for (int i = 1; i < _prepNSteps; ++i) {
+        std::memcpy(&prep[i * _width], prep, _width * sizeof(double));
+    }
 }
 
-void TimeSeries::TimeSeriesPrep::computeAvgYr(const std::vector<double>& data) {
+void TimeSeriesPlan::computeAvgYr(const double* data) {
     poco_assert(_nYrs >= 1);
     // Compute raw avg -> avgData
-    _avgData.resize(_dataPerYr);
+    _avgData.resize(_dataPerYr * _width);
     if (_nYrs == 1) {
-        std::copy(std::begin(data), std::end(data), std::begin(_avgData));
+        std::copy(data, data + _dataPerYr * _width, std::begin(_avgData));
     }
     else {
         double nYrsInv = 1.0 / static_cast<double>(_nYrs);
         for (int i = _dataPerYr - 1; i >= 0; --i) {
-            double sum = 0.0;
+            double* sum = &_avgData[i * _width];
+            std::fill(sum, sum + _width, 0.0);
             int k = i;
-            for (int j = _nYrs - 1; j >= 0; --j, k += _dataPerYr)
-                sum += data[k];
-            _avgData[i] = sum * nYrsInv;
+            for (int j = _nYrs - 1; j >= 0; --j, k += _dataPerYr) {
+                const double* row = data + k * _width;
+                for (int s = 0; s < _width; ++s)
+                    sum[s] += row[s];
+            }
+            for (int s = 0; s < _width; ++s)
+                sum[s] *= nYrsInv;
         }
     }
     // Compute prepared avg -> avgPrep
-    _avgPrep.resize(_prepStepsPerYr);
+    _avgPrep.resize(_prepStepsPerYr * _width);
     interpOneYr(&_avgData[0], &_avgPrep[0], 0, _prepStepsPerYr - 1);
 }
 
 // Interpolate whole years from user's data
-void TimeSeries::TimeSeriesPrep::computeWholeYrsInterp(const std::vector<double>& data,
-                                                       std::vector<double>& prep) {
+void TimeSeriesPlan::computeWholeYrsInterp(const double* data, double* prep) {
     poco_assert(_wholeYrsInterp > 0);
     int dix = (_firstWholeYr + _wholeYrsBefore - _yr0) * _dataPerYr;
     int pix = _oddStepsBefore + _wholeYrsBefore * _prepStepsPerYr;
@@ -404,11 +616,10 @@ void TimeSeries::TimeSeriesPrep::computeWholeYrsInterp(const std::vector<double>
 }
 
 // Extrapolate whole years before user's data
-void TimeSeries::TimeSeriesPrep::computeWholeYrsBefore(const std::vector<double>& data,
-                                                       std::vector<double>& prep) {
+void TimeSeriesPlan::computeWholeYrsBefore(const double* data, double* prep) {
     poco_assert(_wholeYrsBefore > 0);
     // PrepareTSComputeWholeYrsInterp must already have run!
-    int nbOneYr = _prepStepsPerYr * sizeof(double);
+    int nbOneYr = _prepStepsPerYr * _width * sizeof(double);
     // Set to last whole-year-before
     int lastYrBefore = _firstWholeYr + _wholeYrsBefore - 1;
     int pix = _oddStepsBefore + (_wholeYrsBefore - 1) * _prepStepsPerYr;
@@ -418,7 +629,7 @@ void TimeSeries::TimeSeriesPrep::computeWholeYrsBefore(const std::vector<double>
     switch (_extrap) {
     case ExtrapType::NearestYr:
         if (_wholeYrsInterp == 0) {
-            int dix = dixFromYr(data, lastYrBefore);
+            int dix = dixFromYr(lastYrBefore);
             computeOneWholeYr(data, prep, dix, pix);
             pix -= _prepStepsPerYr;
             nCalcYrs = 1;
@@ -434,19 +645,19 @@ void TimeSeries::TimeSeriesPrep::computeWholeYrsBefore(const std::vector<double>
         if (nCalcYrs <= 0)
             nCalcYrs = 0;
         else {
-            int dix = dixFromYr(data, lastYrBefore);
+            int dix = dixFromYr(lastYrBefore);
             for (int i = nCalcYrs; i > 0; --i) {
                 computeOneWholeYr(data, prep, dix, pix);
                 dix -= _dataPerYr;
                 if (dix < 0)
-                    dix = static_cast<int>(data.size()) - _dataPerYr;
+                    dix = _nData - _dataPerYr;
                 pix -= _prepStepsPerYr;
             }
         }
         pixCopyIncr = _prepStepsPerYr * _nYrs;
         break;
     case ExtrapType::AvgYr:
-        std::memcpy(&prep[pix], &_avgPrep[0], nbOneYr);
+        std::memcpy(&prep[pix * _width], &_avgPrep[0], nbOneYr);
         pix -= _prepStepsPerYr;
         nCalcYrs = 1;
         pixCopyIncr = _prepStepsPerYr;
@@ -456,17 +667,16 @@ void TimeSeries::TimeSeriesPrep::computeWholeYrsBefore(const std::vector<double>
     }
     // Copied years
     for (int i = _wholeYrsBefore - nCalcYrs; i > 0; --i) {
-        memcpy(&prep[pix], &prep[pix + pixCopyIncr], nbOneYr);
+        memcpy(&prep[pix * _width], &prep[(pix + pixCopyIncr) * _width], nbOneYr);
         pix -= _prepStepsPerYr;
     }
 }
 
 // Extrapolate whole years after user's data
-void TimeSeries::TimeSeriesPrep::computeWholeYrsAfter(const std::vector<double>& data,
-                                                      std::vector<double>& prep) {
+void TimeSeriesPlan::computeWholeYrsAfter(const double* data, double* prep) {
     poco_assert(_wholeYrsAfter > 0);
     // PrepareTSComputeWholeYrsInterp must already have run!
-    int nbOneYr = _prepStepsPerYr * sizeof(double);
+    int nbOneYr = _prepStepsPerYr * _width * sizeof(double);
     // Set to first whole-year-after
     int firstYrAfter = _firstWholeYr + _wholeYrsBefore + _wholeYrsInterp;
     int pix = _oddStepsBefore + (_wholeYrsBefore + _wholeYrsInterp) * _prepStepsPerYr;
@@ -476,7 +686,7 @@ void TimeSeries::TimeSeriesPrep::computeWholeYrsAfter(const std::vector<double>&
     switch (_extrap) {
     case ExtrapType::NearestYr:
         if (_wholeYrsInterp == 0) {
-            int dix = dixFromYr(data, firstYrAfter);
+            int dix = dixFromYr(firstYrAfter);
             computeOneWholeYr(data, prep, dix, pix);
             pix += _prepStepsPerYr;
             nCalcYrs = 1;
@@ -493,11 +703,11 @@ void TimeSeries::TimeSeriesPrep::computeWholeYrsAfter(const std::vector<double>&
             nCalcYrs = 0;
         }
         else {
-            int dix = dixFromYr(data, firstYrAfter);
+            int dix = dixFromYr(firstYrAfter);
             for (int i = nCalcYrs; i > 0; --i) {
                 computeOneWholeYr(data, prep, dix, pix);
                 dix += _dataPerYr;
-                if (dix >= static_cast<int>(data.size()))
+                if (dix >= _nData)
                     dix = 0;
                 pix += _prepStepsPerYr;
             }
@@ -505,7 +715,7 @@ void TimeSeries::TimeSeriesPrep::computeWholeYrsAfter(const std::vector<double>&
         pixCopyDecr = _prepStepsPerYr * _nYrs;
         break;
     case ExtrapType::AvgYr:
-        memcpy(&prep.data()[pix], &_avgPrep.data()[0], nbOneYr);
+        memcpy(&prep[pix * _width], &_avgPrep[0], nbOneYr);
         pix += _prepStepsPerYr;
         nCalcYrs = 1;
         pixCopyDecr = _prepStepsPerYr;
@@ -515,20 +725,17 @@ void TimeSeries::TimeSeriesPrep::computeWholeYrsAfter(const std::vector<double>&
     }
     // Copied years
     for (int i = _wholeYrsAfter - nCalcYrs; i > 0; --i) {
-        memcpy(&prep.data()[pix], &prep.data()[pix - pixCopyDecr], nbOneYr);
+        memcpy(&prep[pix * _width], &prep[(pix - pixCopyDecr) * _width], nbOneYr);
         pix += _prepStepsPerYr;
     }
 }
 
-void TimeSeries::TimeSeriesPrep::computeOneWholeYr(const std::vector<double>& data,
-                                                   std::vector<double>& prep,
-                                                   int dix, int pix) {
+void TimeSeriesPlan::computeOneWholeYr(const double* data, double* prep, int dix, int pix) {
     interpOneYrWithCheck(data, prep, dix, pix, 0, _prepStepsPerYr - 1);
 }
 
 // Partial year at start of prep
-void TimeSeries::TimeSeriesPrep::computeOddStepsBefore(const std::vector<double>& data,
-                                                       std::vector<double>& prep) {
+void TimeSeriesPlan::computeOddStepsBefore(const double* data, double* prep) {
     poco_assert(_oddStepsBefore > 0);
     if (_oddStepsBefore <= 0) {
         return;
@@ -539,7 +746,7 @@ void TimeSeries::TimeSeriesPrep::computeOddStepsBefore(const std::vector<double>
 
     // Interpolated
     if (_yr0 <= _prepStYr && _prepStYr <= _dataEnYr) {
-        int dix = dixFromYr(data, _prepStYr);
+        int dix = dixFromYr(_prepStYr);
         interpOneYrWithCheck(data, prep, dix, 0, _prepStepsPerYr - _oddStepsBefore, _prepStepsPerYr - 1);
     }
     else { // Extrapolated
@@ -549,7 +756,7 @@ void TimeSeries::TimeSeriesPrep::computeOddStepsBefore(const std::vector<double>
                 copyOddStepsBefore(prep, prep, _prepStepsPerYr);
             }
             else {
-                int dix = dixFromYr(data, _prepStYr);
+                int dix = dixFromYr(_prepStYr);
                 interpOneYrWithCheck(data, prep, dix, 0, _prepStepsPerYr - _oddStepsBefore, _prepStepsPerYr - 1);
             }
             break;
@@ -558,32 +765,27 @@ void TimeSeries::TimeSeriesPrep::computeOddStepsBefore(const std::vector<double>
                 copyOddStepsBefore(prep, prep, _nYrs * _prepStepsPerYr);
             }
             else {
-                int dix = dixFromYr(data, _prepStYr);
+                int dix = dixFromYr(_prepStYr);
                 interpOneYrWithCheck(data, prep, dix, 0, _prepStepsPerYr - _oddStepsBefore, _prepStepsPerYr - 1);
             }
             break;
         case ExtrapType::AvgYr:
-            copyOddStepsBefore(_avgPrep, prep, _prepStepsPerYr - _oddStepsBefore);
+            copyOddStepsBefore(_avgPrep.data(), prep, _prepStepsPerYr - _oddStepsBefore);
             break;
         }
     }
 }
 
-void TimeSeries::TimeSeriesPrep::copyOddStepsBefore(const std::vector<double>& src,
-                                                    std::vector<double>& prep,
-                                                    int srcIx) {
-    memcpy(&prep.data()[0], &src.data()[srcIx], _oddStepsBefore * sizeof(double));
+void TimeSeriesPlan::copyOddStepsBefore(const double* src, double* prep, int srcIx) {
+    memcpy(&prep[0], &src[srcIx * _width], _oddStepsBefore * _width * sizeof(double));
 }
 
-void TimeSeries::TimeSeriesPrep::copyOddStepsAfter(const std::vector<double>& src,
-                                                   std::vector<double>& prep,
-                                                   int srcIx, int pix) {
-    std::memcpy(&prep.data()[pix], &src.data()[srcIx], _oddStepsAfter * sizeof(double));
+void TimeSeriesPlan::copyOddStepsAfter(const double* src, double* prep, int srcIx, int pix) {
+    std::memcpy(&prep[pix * _width], &src[srcIx * _width], _oddStepsAfter * _width * sizeof(double));
 }
 
 // Partial year at end of prep
-void TimeSeries::TimeSeriesPrep::computeOddStepsAfter(const std::vector<double>& data,
-                                                      std::vector<double>& prep) {
+void TimeSeriesPlan::computeOddStepsAfter(const double* data, double* prep) {
     poco_assert(_oddStepsAfter > 0);
     if (_oddStepsAfter <= 0) {
         return;
@@ -595,7 +797,7 @@ void TimeSeries::TimeSeriesPrep::computeOddStepsAfter(const std::vector<double>&
 
     // Interpolated
     if (_yr0 <= _prepEnYr && _prepEnYr <= _dataEnYr) {
-        int dix = dixFromYr(data, _prepEnYr);
+        int dix = dixFromYr(_prepEnYr);
         interpOneYrWithCheck(data, prep, dix, pix, 0, _oddStepsAfter - 1);
     }
     else { // Extrapolated
@@ -605,7 +807,7 @@ void TimeSeries::TimeSeriesPrep::computeOddStepsAfter(const std::vector<double>&
                 copyOddStepsAfter(prep, prep, pix - _prepStepsPerYr, pix);
             }
             else {
-                int dix = dixFromYr(data, _prepEnYr);
+                int dix = dixFromYr(_prepEnYr);
                 interpOneYrWithCheck(data, prep, dix, pix, 0, _oddStepsAfter - 1);
             }
             break;
@@ -614,18 +816,18 @@ void TimeSeries::TimeSeriesPrep::computeOddStepsAfter(const std::vector<double>&
                 copyOddStepsAfter(prep, prep, pix - _nYrs * _prepStepsPerYr, pix);
             }
             else {
-                int dix = dixFromYr(data, _prepEnYr);
+                int dix = dixFromYr(_prepEnYr);
                 interpOneYrWithCheck(data, prep, dix, pix, 0, _oddStepsAfter - 1);
             }
             break;
         case ExtrapType::AvgYr:
-            copyOddStepsAfter(_avgPrep, prep, 0, pix);
+            copyOddStepsAfter(_avgPrep.data(), prep, 0, pix);
             break;
         }
     }
 }
 
-void TimeSeries::TimeSeriesPrep::interpOneYr(const double* d, double* p, int prepIxLo, int prepIxHi) {
+void TimeSeriesPlan::interpOneYr(const double* d, double* p, int prepIxLo, int prepIxHi) {
     // - For a full year's calculation (prepIxLo = 0, prepIxHi = prepStepsPerYr - 1):
     //     In:  d[0, .. , dataPerYr  - 1] 		<-- user's data
     //     Out: p[0, .. , prepStepsPerYr - 1]   <-- prepared time series
@@ -646,6 +848,8 @@ void TimeSeries::TimeSeriesPrep::interpOneYr(const double* d, double* p, int pre
     // - kEpsilon counters roundoff error in conversion from flo to int by boosting st and en.
     // - st and en are in [0..10,000], less than 10^4. Double prescion, so has 15 significant
     //   figures. So set kEpsilon safely more than 10-^(15 - 4).
+    // - Each block holds _width interleaved series; the weights are the same for all of them,
+    //   so each term of the sum is one loop over the series.
     poco_assert(prepIxHi >= prepIxLo);
     poco_assert(prepIxHi <= prepIxLo + _prepStepsPerYr - 1);
     const double kEpsilon = 0.0000000001;
@@ -654,6 +858,7 @@ void TimeSeries::TimeSeriesPrep::interpOneYr(const double* d, double* p, int pre
     double nInBlocksPerOutBlock = static_cast<double>(_dataPerYr) / static_cast<double>(_prepStepsPerYr);
     double nOutBlocksPerInBlock = 1.0 / nInBlocksPerOutBlock;
 
+    const int w = _width;
     int n = prepIxHi - prepIxLo;
     double st0 = prepIxLo * nInBlocksPerOutBlock + kEpsilon;
     double st = st0 + (n + 1) * nInBlocksPerOutBlock;
@@ -667,36 +872,48 @@ void TimeSeries::TimeSeriesPrep::interpOneYr(const double* d, double* p, int pre
             enIx = _dataPerYr - 1;
         poco_assert(0 <= stIx && stIx < _dataPerYr);
         poco_assert(0 <= enIx && enIx < _dataPerYr);
-        double sum;
-        if (stIx == enIx)							// No interior input blocks
-            sum = d[stIx] * nInBlocksPerOutBlock;
+        double* sum = p + i * w;
+        if (stIx == enIx) {							// No interior input blocks
+            const double* in = d + stIx * w;
+            for (int s = 0; s < w; ++s)
+                sum[s] = in[s] * nInBlocksPerOutBlock;
+        }
         else {										// Some interior input blocks
             double stDiff = st - static_cast<double>(stIx) - kEpsilonPlus;
             if (stDiff > 0.0) {						// - Partial input block to left of interior
-                sum = d[stIx] * (1.0 - stDiff);
+                const double* in = d + stIx * w;
+                for (int s = 0; s < w; ++s)
+                    sum[s] = in[s] * (1.0 - stDiff);
                 ++stIx;
             }
             else
-                sum = 0.0;
-            for (int j = stIx; j < enIx; ++j)		// - Whole input blocks in interior
-                sum += d[j];
+                std::fill(sum, sum + w, 0.0);
+            for (int j = stIx; j < enIx; ++j) {		// - Whole input blocks in interior
+                const double* in = d + j * w;
+                for (int s = 0; s < w; ++s)
+                    sum[s] += in[s];
+            }
             double enDiff = en - static_cast<double>(enIx) - kEpsilonPlus;
-            if (enDiff > 0.0) 						// - Partial input block to right of interior
-                sum += d[enIx] * enDiff;
+            if (enDiff > 0.0) { 					// - Partial input block to right of interior
+                const double* in = d + enIx * w;
+                for (int s = 0; s < w; ++s)
+                    sum[s] += in[s] * enDiff;
+            }
+        }
+        if (_subSame) {
+            for (int s = 0; s < w; ++s)
+                sum[s] *= nOutBlocksPerInBlock;
         }
-        if (_subSame) sum *= nOutBlocksPerInBlock;
-        p[i] = sum;
     }
 }
 
-void TimeSeries::TimeSeriesPrep::interpOneYrWithCheck(const std::vector<double>& data,
-                                                      std::vector<double>& prep,
-                                                      int dix, int pix,
-                                                      int prepIxLo, int prepIxHi) {
-    interpOneYr(&data.data()[dix], &prep.data()[pix], prepIxLo, prepIxHi);
+void TimeSeriesPlan::interpOneYrWithCheck(const double* data, double* prep,
+                                          int dix, int pix,
+                                          int prepIxLo, int prepIxHi) {
+    interpOneYr(&data[dix * _width], &prep[pix * _width], prepIxLo, prepIxHi);
 }
 
-int TimeSeries::TimeSeriesPrep::dixFromYr(const std::vector<double>& data, int yr) {
+int TimeSeriesPlan::dixFromYr(int yr) {
     // - Returns dix (data index) for the data for the simulation year yr.
     // - Does not apply if tExtrapTS = AvgYr.
     // yr is before user data begins
@@ -716,7 +933,7 @@ int TimeSeries::TimeSeriesPrep::dixFromYr(const std::vector<double>& data, int y
     // yr is after user data ends
     if (yr >= _dataEnYr) {
         switch (_extrap) {
-        case ExtrapType::NearestYr:	return static_cast<int>(data.size()) - _dataPerYr;
+        case ExtrapType::NearestYr:	return _nData - _dataPerYr;
         case ExtrapType::CycleYrs:	return _dataPerYr * ((yr - _yr0) % _nYrs);
         case ExtrapType::AvgYr:		return 0;
         }
@@ -728,4 +945,4 @@ int TimeSeries::TimeSeriesPrep::dixFromYr(const std::vector<double>& data, int y
 
 } // namespace cbm
 } // namespace modules
-} // namespace moja
\ No newline at end of file
+} // namespace moja
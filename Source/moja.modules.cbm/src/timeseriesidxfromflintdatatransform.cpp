@@ -19,7 +19,7 @@ namespace cbm {
 	 * Assign TimeSeriesIdxFromFlintDataTransform._landUnitController as parameter landUnitController&, 
 	 * TimeSeriesIdxFromFlintDataTransform._subsame, TimeSeriesIdxFromFlintDataTransform._startYear, TimeSeriesIdxFromFlintDataTransform._dataPerYear, 
 	 * TimeSeriesIdxFromFlintDataTransform._nYears value of "sub_same", "start_year", "data_per_year" in 
-	 * parameter config, _origin, value of "origin" if it exists in parameter config, else the string "start_sim",
+	 * parameter config, _origin, DateOrigin::Calendar if "origin" in parameter config is "calendar", else DateOrigin::StartSim,
 	 * TimeSeriesIdxFromFlintDataTransform._spatialLocationInfo value of variable "spatialLocationInfo" in parameter landUnitController \n
 	 * Assign the value of the getProvider() on parameter dataRepository with argument config["provider"] to a variable provider,
 	 * set the result of the indexer() method on variable provider to TimeSeriesIdxFromFlintDataTransform._providerIndex, and result of getLayer() on
@@ -39,7 +39,8 @@ namespace cbm {
 		_startYear = config["start_year"].convert<int>();
 		_dataPerYear = config["data_per_year"].convert<int>();
 		_nYears = config["n_years"].convert<int>();
-		_origin = config.contains("origin") ? config["origin"].convert<std::string>() : "start_sim";
+		_origin = config.contains("origin") && config["origin"].convert<std::string>() == "calendar"
+			? DateOrigin::Calendar : DateOrigin::StartSim;
 
 		_spatialLocationInfo = std::static_pointer_cast<flint::SpatialLocationInfo>(landUnitController.getVariable("spatialLocationInfo")->value().extract<std::shared_ptr<flint::IFlintData>>());
 	}
@@ -62,11 +63,10 @@ namespace cbm {
 	 * and provider index corresponding to the current spatial location \n
 	 * If the value of TimeSeriesIdxFromFlintDataTransform._lastCellHash is not the same as the current cell hash, then assign the value of the current cell hash to 
 	 * TimeSeriesIdxFromFlintDataTransform._lastCellHash \n
-	 * For each value in the result of getValueByCellIndex() on TimeSeriesIdxFromFlintDataTransform._layer, if
-	 * value.is_initialized() is true, add the value to a vector raw. \n
-	 * If atleast one value returned a true value for value.is_initialized(), instantiate an object of TimeSeries
-	 * and assgin it to TimeSeriesIdxFromFlintDataTransform._cachedValue \n
-	 * If none of the values return true for value.is_initialized(), assign TimeSeriesIdxFromFlintDataTransform._cachedValue to DynamicVar() \n
+	 * If TimeSeries::hasData() finds at least one value in the result of getValueByCellIndex() on 
+	 * TimeSeriesIdxFromFlintDataTransform._layer that is initialized and not NaN, instantiate an object of TimeSeries directly from the layer's values, without copying them first,
+	 * and assign it to TimeSeriesIdxFromFlintDataTransform._cachedValue. The TimeSeries is only prepared when its value is read \n
+	 * If there is no such value, as for a cell of NaN nodata values, assign TimeSeriesIdxFromFlintDataTransform._cachedValue to DynamicVar() \n
 	 * Return TimeSeriesIdxFromFlintDataTransform._cachedValue
 	 * 
 	 * @return DynamicVar&
@@ -77,23 +77,12 @@ namespace cbm {
 		auto cellHash = layerIdx.hash();
 		if (_lastCellHash != cellHash) {
 			_lastCellHash = cellHash;
-			bool atLeastOneValue = false;
-			auto series = _layer->getValueByCellIndex(cell).extract<std::vector<boost::optional<float>>>();
-			std::vector<boost::optional<double>> raw;
-			for (const auto& f : series) {
-				if (f.is_initialized()) {
-					raw.push_back(boost::optional<double> { f.is_initialized(), f.get() });
-					atLeastOneValue = true;
-				}
-				else {
-					raw.push_back(boost::none);
-				}
-			}
-
+			const auto cellValue = _layer->getValueByCellIndex(cell);
+			const auto& series = cellValue.extract<std::vector<boost::optional<float>>>();
 			_cachedValue = DynamicVar();
-			if (atLeastOneValue) {
+			if (TimeSeries::hasData(series)) {
 				const auto& timing = _landUnitController->timing();
-				TimeSeries ts(_startYear, _dataPerYear, _nYears, _subsame, raw, _origin == "calendar" ? DateOrigin::Calendar : DateOrigin::StartSim);
+				TimeSeries ts(_startYear, _dataPerYear, _nYears, _subsame, series, _origin);
 				ts.setTiming(&timing);
 				_cachedValue = ts;
 			}
@@ -8,10 +8,6 @@
 #include <moja/datarepository/datarepository.h>
 #include <moja/logging.h>
 
-#include <boost/format.hpp>
-#include <boost/algorithm/string/join.hpp>
-#include <boost/algorithm/string.hpp>
-
 
 using moja::datarepository::IProviderRelationalInterface;
 
@@ -23,7 +19,8 @@ namespace cbm {
      * Configuration function
      * 
      * Assign TransitionRuleTransform._landUnitController, TransitionRuleTransform._dataRepository as parameters &landUnitController, &dataRepository, 
-     * TransitionRuleTransform._provider the result of getProvider() on "provider" in config, TransitionRuleTransform._csetVar, value of "classifier_set_var" of config in TransitionRuleTransform._landUnitController
+     * TransitionRuleTransform._provider the result of getProvider() on "provider" in config, TransitionRuleTransform._csetVar, value of "classifier_set_var" of config in TransitionRuleTransform._landUnitController \n
+     * Load the classifier values of every transition rule into TransitionRuleTransform._transitionRuleIndex, unless another thread already has
      * 
      * @param config DynamicObject
      * @param landUnitController const flint::ILandUnitController&
@@ -44,6 +41,10 @@ namespace cbm {
 
         auto csetVarName = config["classifier_set_var"].convert<std::string>();
         _csetVar = _landUnitController->getVariable(csetVarName);
+
+        if (!_transitionRuleIndex->isInitialized()) {
+            _transitionRuleIndex->initialize(loadClassifierValues());
+        }
     }
 
     /**
@@ -57,48 +58,40 @@ namespace cbm {
     };
 
     /**
-     * Create variables classifierNames, a vector of strings and classifierValuesSql, a string \n
-     * For each classifier in parameter classifierSet, append classifier.first to classifierNames, concatenate classifierValuesSql with the SQL query TransitionRuleTransform._matchSql, placeholder values
-     * clasifier.first and classifier.second (gives the classifier value)
-     * Assign a variable classifierNamesSql the join vector classifierNames, separated by "," \n
-     * Return the SQL query TransitionRuleTransform._baseSql with placeholders classifierNamesSql and classifierValuesSql
+     * Return one row for each classifier value of each transition rule in TransitionRuleTransform._provider, \n
+     * grouped by the name of the rule's disturbance type
      * 
-     * @param classifierSet const DynamicObject&
-     * @return string
+     * @return vector<ClassifierMatchRow>
      * **********************/
-    const std::string TransitionRuleTransform::buildSql(const DynamicObject& classifierSet) const {
-        std::vector<std::string> classifierNames;
-        std::string classifierValuesSql = "";
-
-        for (const auto& classifier : classifierSet) {
-            const std::string& classifierName = classifier.first;
-            classifierNames.push_back("'" + classifierName + "'");
-
-            if (!classifier.second.isEmpty()) {
-                const std::string& classifierValue = classifier.second;
-                classifierValuesSql += (boost::format(_matchSql)
-                    % classifierName % classifierValue).str();
-            } else {
-                classifierValuesSql += (boost::format(_matchSql)
-                    % classifierName % "NULL").str();
+    std::vector<ClassifierMatchRow> TransitionRuleTransform::loadClassifierValues() const {
+        auto toRow = [](const DynamicObject& row) {
+            return ClassifierMatchRow{
+                row["transition_id"].convert<int>(),
+                row["disturbance_type"].convert<std::string>(),
+                row["classifier_name"].convert<std::string>(),
+                row["classifier_value"].convert<std::string>() };
+        };
+
+        std::vector<ClassifierMatchRow> rows;
+        const auto& result = _provider->GetDataSet(_classifierValuesSql);
+        if (result.isVector()) {
+            for (const auto& row : result.extract<std::vector<DynamicObject>>()) {
+                rows.push_back(toRow(row));
             }
+        } else if (!result.isEmpty()) {
+            rows.push_back(toRow(result.extract<DynamicObject>()));
         }
 
-        std::string classifierNamesSql = boost::algorithm::join(classifierNames, ",");
-
-        return (boost::format(_baseSql) % classifierNamesSql % classifierValuesSql).str();
+        return rows;
     }
 
     /**
      * If value of TransitionRuleTransform._csetVar is empty assign TransitionRuleTransform._value as DynamicObject() and return TransitionRuleTransform._value \n
      * Extract DynamicObject from the value of TransitionRuleTransform._csetVar and store it in variable cset \n
-     * Assign variable sql, the result of TransitionRuleTransform.buildSql() on argument cset \n
-     * If sql has a null value in TransitionRuleTransform._cache, assign TransitionRuleTransform._value, a pointer to the result and return TransitionRuleTransform._value \n
      * Create a variable disturbanceTypeTransitions \n
-     * For each row in the result of GetDataSet() on TransitionRuleTransform._provider with argument sql, 
-     * using row["disturbance_type"] as the key in disturbanceTypeTransitions, map it to row["transition_id"]
-     * Add (sql, disturbanceTypeTransitions) to TransitionRuleTransform._cache, assign TransitionRuleTransform._value as disturbanceTypeTransitions. \n
-     * Return TransitionRuleTransform._value
+     * For each disturbance type with a matching rule for cset in TransitionRuleTransform._transitionRuleIndex, 
+     * using the disturbance type as the key in disturbanceTypeTransitions, map it to the best matching transition ID \n
+     * Assign TransitionRuleTransform._value as disturbanceTypeTransitions and return TransitionRuleTransform._value
      * 
      * @return const DynamicVar&
      ***************************/
@@ -111,42 +104,25 @@ namespace cbm {
 
         const auto& cset = csetVariableValue.extract<DynamicObject>();
 
-        TRCacheKey key;
+        ClassifierMatchQuery classifierSet;
+        classifierSet.reserve(cset.size());
         for (const auto& classifier : cset) {
             if (!classifier.second.isEmpty()) {
                 const std::string& classifierValue = classifier.second;
-                key.add(classifierValue);
+                classifierSet.emplace_back(classifier.first, classifierValue);
             } else {
-                key.add("null");
+                classifierSet.emplace_back(classifier.first, "NULL");
             }
         }
 
-        auto cachedValue = _cache->get(key);
-        if (!cachedValue.isNull()) {
-            _value = *cachedValue;
-            return _value;
-        }
-
         DynamicObject disturbanceTypeTransitions;
-        const auto sql = buildSql(cset);
-        const auto& result = _provider->GetDataSet(sql);
-        if (result.isVector()) {
-            for (auto row : result.extract<std::vector<DynamicObject>>()) {
-                std::string disturbanceType = row["disturbance_type"];
-                int transitionId = row["transition_id"];
-                disturbanceTypeTransitions[disturbanceType] = transitionId;
-            }
-        } else {
-            std::string disturbanceType = result["disturbance_type"];
-            int transitionId = result["transition_id"];
-            disturbanceTypeTransitions[disturbanceType] = transitionId;
+        for (const auto& match : _transitionRuleIndex->match(classifierSet)) {
+            disturbanceTypeTransitions[match.first] = match.second;
         }
 
-        _cache->add(key, disturbanceTypeTransitions);
         _value = disturbanceTypeTransitions;
 
         return _value;
     }
 
-}}} // namespace moja::modules::cbm
-
+}}} // namespace moja::modules::cbm
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "moja/modules/cbm/volumetobiomasscarbongrowth.h"
 
+#include <stdexcept>
+#include <string>
+
 namespace moja {
 namespace modules {
 namespace cbm {
@@ -13,7 +16,35 @@ namespace cbm {
      * *************************/
     bool VolumeToBiomassCarbonGrowth::isBiomassCarbonCurveAvailable(Int64 growthCurveID, Int64 spuID) {
         auto standBioCarbonCurve = getBiomassCarbonCurve(growthCurveID, spuID);
-        return !standBioCarbonCurve.isNull();
+        return standBioCarbonCurve != nullptr;
+    }
+
+    /**
+     * Generate the biomass carbon curve for parameter standGrowthCurve and add it to VolumeToBiomassCarbonGrowth._curves \n
+     * for the tuple key (StandGrowthCurve.standGrowthCurveID(), StandGrowthCurve.spuID()), unless any thread already has. \n
+     * If another thread is generating the same curve, wait for it instead of generating it again. \n
+     * The curve is read from VolumeToBiomassCarbonGrowth._curveFile if the file has one built from inputs with the same \n
+     * StandGrowthCurve.inputHash(), else it is built with VolumeToBiomassCarbonGrowth.buildBiomassCarbonCurve()
+     * 
+     * @param standGrowthCurve StandGrowthCurve& 
+     * @return void
+     * ********************/
+    void VolumeToBiomassCarbonGrowth::generateBiomassCarbonCurve(StandGrowthCurve& standGrowthCurve) {
+        auto key = std::make_tuple(standGrowthCurve.standGrowthCurveID(), standGrowthCurve.spuID());
+        _curves.getOrBuild(key, [this, &key, &standGrowthCurve]() {
+            auto inputHash = standGrowthCurve.inputHash();
+            {
+                std::lock_guard<std::mutex> lock(_curveFileLock);
+                _curveHashes[key] = inputHash;
+                if (_curveFile.contains(key, inputHash)) {
+                    return _curveFile.read(key);
+                }
+            }
+
+            auto curve = buildBiomassCarbonCurve(standGrowthCurve);
+            _builtCurves++;
+            return curve;
+        });
     }
 
     /**
@@ -21,99 +52,175 @@ namespace cbm {
      * 
      * If parameter standGrowthCurve has the yield component SpeciesType::Softwood or/and SpeciesType::Hardwood, 
      * generate the component biomass carbon curve and the root biomass equation corresponding to the forest configuration using moja::modules::CBM::StandGrowthCurve.getForestTypeConfiguration() \n
-     * Add the components species type, root biomass equation and carbon curve to the parameter standCarbonCurve \n
-     * Add the standCarbonCurve to the cache using VolumeToBiomassCarbonGrowth.getCache() for the tuple key (StandGrowthCurve.standGrowthCurveID(), StandGrowthCurve.spuID())
+     * Smooth the component curves as one batch with VolumeToBiomassConverter.doSmoothing(), so that a stand with both components \n
+     * smooths them in parallel while any other threads needing the curve wait for it \n
+     * Add the components species type, root biomass equation and carbon curve to the parameter standCarbonCurve and return it
      * 
      * @param standGrowthCurve StandGrowthCurve& 
-     * @return void
+     * @return shared_ptr<StandBiomassCarbonCurve>
      * ********************/
-    void VolumeToBiomassCarbonGrowth::generateBiomassCarbonCurve(StandGrowthCurve& standGrowthCurve) {
-        StandBiomassCarbonCurve standCarbonCurve;
-
-        // Converter to generate softwood component biomass carbon curve.
-        if (standGrowthCurve.hasYieldComponent(SpeciesType::Softwood)) {
-            auto carbonCurve = getConverter().generateComponentBiomassCarbonCurve(
-                standGrowthCurve, SpeciesType::Softwood);
+    std::shared_ptr<StandBiomassCarbonCurve> VolumeToBiomassCarbonGrowth::buildBiomassCarbonCurve(StandGrowthCurve& standGrowthCurve) {
+        std::vector<std::shared_ptr<ComponentBiomassCarbonCurve>> carbonCurves;
+        std::vector<SmoothingJob> smoothingJobs;
 
-            getConverter().doSmoothing(standGrowthCurve, carbonCurve.get(), SpeciesType::Softwood);
-            const auto forestTypeConfig = standGrowthCurve.getForestTypeConfiguration(SpeciesType::Softwood);
-            standCarbonCurve.addComponent(StandComponent(
-                "Softwood", forestTypeConfig.rootBiomassEquation, carbonCurve
-            ));
+        // Converter to generate softwood and hardwood component biomass carbon curves.
+        for (auto speciesType : { SpeciesType::Softwood, SpeciesType::Hardwood }) {
+            if (standGrowthCurve.hasYieldComponent(speciesType)) {
+                carbonCurves.push_back(_converter.generateComponentBiomassCarbonCurve(standGrowthCurve, speciesType));
+                smoothingJobs.push_back(SmoothingJob{ &standGrowthCurve, carbonCurves.back().get(), speciesType });
+            }
         }
 
-        // Converter to generate hardwood component biomass carbon curve.
-        if (standGrowthCurve.hasYieldComponent(SpeciesType::Hardwood)) {
-            auto carbonCurve = getConverter().generateComponentBiomassCarbonCurve(
-                standGrowthCurve, SpeciesType::Hardwood);
+        _converter.doSmoothing(smoothingJobs);
 
-            getConverter().doSmoothing(standGrowthCurve, carbonCurve.get(), SpeciesType::Hardwood);
-            const auto forestTypeConfig = standGrowthCurve.getForestTypeConfiguration(SpeciesType::Hardwood);
-            standCarbonCurve.addComponent(StandComponent(
-                "Hardwood", forestTypeConfig.rootBiomassEquation, carbonCurve
+        auto standCarbonCurve = std::make_shared<StandBiomassCarbonCurve>();
+        for (size_t i = 0; i < smoothingJobs.size(); i++) {
+            auto speciesType = smoothingJobs[i].speciesType;
+            const auto forestTypeConfig = standGrowthCurve.getForestTypeConfiguration(speciesType);
+            standCarbonCurve->addComponent(StandComponent(
+                speciesType == SpeciesType::Softwood ? "Softwood" : "Hardwood",
+                forestTypeConfig.rootBiomassEquation, carbonCurves[i]
             ));
         }
 
-        auto key = std::make_tuple(standGrowthCurve.standGrowthCurveID(), standGrowthCurve.spuID());
-        getCache().add(key, standCarbonCurve);
+        return standCarbonCurve;
     }
     
     /**
-     * If the tuple parameter growthCurveId, spuId exists in VolumeToBiomassCarbonGrowth.getCache(), get the StandBiomassCarbonCurve object from cache, 
+     * Return the StandBiomassCarbonCurve for the tuple parameter growthCurveId, spuId in VolumeToBiomassCarbonGrowth._curves
+     * 
+     * @param growthCurveId Int64
+     * @param spuId Int64
+     * @return shared_ptr<StandBiomassCarbonCurve>
+     * @exception std::runtime_error if no thread has generated the curve
+     *************************/
+    std::shared_ptr<StandBiomassCarbonCurve> VolumeToBiomassCarbonGrowth::requireBiomassCarbonCurve(
+        Int64 growthCurveID, Int64 spuID) {
+
+        auto standBioCarbonCurve = getBiomassCarbonCurve(growthCurveID, spuID);
+        if (standBioCarbonCurve == nullptr) {
+            throw std::runtime_error(
+                "No biomass carbon curve generated for growth curve " + std::to_string(growthCurveID)
+                + " in spatial unit " + std::to_string(spuID));
+        }
+
+        return standBioCarbonCurve;
+    }
+
+    /**
+     * Get the StandBiomassCarbonCurve for the tuple parameter growthCurveId, spuId with VolumeToBiomassCarbonGrowth.requireBiomassCarbonCurve(), 
      * and return the result of StandBiomassCarbonCurve.getIncrements() with argument as parameter landUnitData
      * 
      * @param landUnitData flint::ILandUnitDataWrapper*
      * @param growthCurveID Int64
      * @param spuID Int64
      * @return unordered_map<std::string, double>
+     * @exception std::runtime_error if the curve has not been generated
      * *****************************/
     std::unordered_map<std::string, double> VolumeToBiomassCarbonGrowth::getBiomassCarbonIncrements(
         flint::ILandUnitDataWrapper* landUnitData, Int64 growthCurveID, Int64 spuID) {
 
-        auto key = std::make_tuple(growthCurveID, spuID);
-        auto standBioCarbonCurve = getCache().get(key);
+        auto standBioCarbonCurve = requireBiomassCarbonCurve(growthCurveID, spuID);
         return standBioCarbonCurve->getIncrements(landUnitData);
     }
     
     /**
-     * If the tuple parameter growthCurveId, spuId exists in VolumeToBiomassCarbonGrowth.getCache(), get the StandBiomassCarbonCurve object from cache, 
-     * and return the result of VolumeToBiomassCarbonGrowth.getAboveGroundCarbonCurve()
+     * Get the StandBiomassCarbonCurve for the tuple parameter growthCurveId, spuId with VolumeToBiomassCarbonGrowth.requireBiomassCarbonCurve(), 
+     * and return the result of StandBiomassCarbonCurve.getAboveGroundCarbonCurve()
      * 
      * @param growthCurveId Int64
      * @param spuId Int64
      * @return vector<double>
+     * @exception std::runtime_error if the curve has not been generated
      *************************/
     std::vector<double> VolumeToBiomassCarbonGrowth::getAboveGroundCarbonCurve(Int64 growthCurveID, Int64 spuID) {
-        auto key = std::make_tuple(growthCurveID, spuID);
-        auto standBioCarbonCurve = getCache().get(key);
+        auto standBioCarbonCurve = requireBiomassCarbonCurve(growthCurveID, spuID);
         return standBioCarbonCurve->getAboveGroundCarbonCurve();
     }
 
     /**
-     * If the tuple parameter growthCurveId, spuId exists in VolumeToBiomassCarbonGrowth.getCache(), if the StandBiomassCarbonCurve object returned from cache is not null, 
-     * return it, else return nullptr
+     * Get the StandBiomassCarbonCurve for the tuple parameter growthCurveId, spuId with VolumeToBiomassCarbonGrowth.requireBiomassCarbonCurve(), 
+     * and return the result of StandBiomassCarbonCurve.getFoliageCarbonCurve()
      * 
      * @param growthCurveId Int64
      * @param spuId Int64
      * @return vector<double>
+     * @exception std::runtime_error if the curve has not been generated
      *************************/
     std::vector<double> VolumeToBiomassCarbonGrowth::getFoliageCarbonCurve(Int64 growthCurveID, Int64 spuID) {
-        auto key = std::make_tuple(growthCurveID, spuID);
-        auto standBioCarbonCurve = getCache().get(key);
+        auto standBioCarbonCurve = requireBiomassCarbonCurve(growthCurveID, spuID);
         return standBioCarbonCurve->getFoliageCarbonCurve();
     }
 
-    Poco::SharedPtr<StandBiomassCarbonCurve> VolumeToBiomassCarbonGrowth::getBiomassCarbonCurve(
+    /**
+     * Return the StandBiomassCarbonCurve for the tuple parameter growthCurveId, spuId in VolumeToBiomassCarbonGrowth._curves, 
+     * generated by any thread, else return nullptr. Curves in VolumeToBiomassCarbonGrowth._curveFile are only \n
+     * used once VolumeToBiomassCarbonGrowth.generateBiomassCarbonCurve() has checked their input hash
+     * 
+     * @param growthCurveId Int64
+     * @param spuId Int64
+     * @return shared_ptr<StandBiomassCarbonCurve>
+     *************************/
+    std::shared_ptr<StandBiomassCarbonCurve> VolumeToBiomassCarbonGrowth::getBiomassCarbonCurve(
         Int64 growthCurveID, Int64 spuID) {
 
         auto key = std::make_tuple(growthCurveID, spuID);
-        Poco::SharedPtr<StandBiomassCarbonCurve> standBioCarbonCurve = nullptr;
-        auto cached = getCache().get(key);
-        if (!cached.isNull()) {
-            standBioCarbonCurve = cached;
+        return _curves.find(key);
+    }
+
+    /**
+     * Use parameter path as the file of precompiled curves, mapping it if it exists and was written \n
+     * with parameter version. Only the first call has any effect, so every thread's module can open it.
+     * 
+     * @param path string&
+     * @param version string&
+     * @return void
+     *************************/
+    void VolumeToBiomassCarbonGrowth::openCurveFile(const std::string& path, const std::string& version) {
+        std::lock_guard<std::mutex> lock(_curveFileLock);
+        if (_curveFileOpened) {
+            return;
         }
 
-        return standBioCarbonCurve;
+        _curveFileOpened = true;
+        _curveFilePath = path;
+        _curveFileVersion = version;
+        _curveFile.open(path, version);
+    }
+
+    /**
+     * If any curves were built since the file given to VolumeToBiomassCarbonGrowth.openCurveFile() \n
+     * was opened, rewrite it with those curves and the ones it already had, each with its input hash. \n
+     * The file is unmapped first, after reading the rest of its curves into VolumeToBiomassCarbonGrowth._curves. \n
+     * Curves this run rebuilt from changed inputs replace the ones in the file.
+     * 
+     * @return void
+     *************************/
+    void VolumeToBiomassCarbonGrowth::saveCurveFile() {
+        std::lock_guard<std::mutex> lock(_curveFileLock);
+        if (_curveFilePath.empty() || _builtCurves == 0) {
+            return;
+        }
+
+        for (const auto& key : _curveFile.keys()) {
+            if (_curves.find(key) == nullptr) {
+                _curves.insert(key, _curveFile.read(key));
+                _curveHashes[key] = _curveFile.inputHash(key);
+            }
+        }
+
+        _curveFile.close();
+        _builtCurves = 0;
+
+        BiomassCarbonCurveFile::CurveList curves;
+        _curves.forEach([this, &curves](const std::tuple<Int64, Int64>& key, const std::shared_ptr<StandBiomassCarbonCurve>& curve) {
+            auto inputHash = _curveHashes.find(key);
+            if (inputHash != _curveHashes.end()) {
+                curves.push_back(BiomassCarbonCurveFile::Entry{ key, inputHash->second, curve });
+            }
+        });
+
+        BiomassCarbonCurveFile::write(_curveFilePath, _curveFileVersion, curves);
     }
 
 }}}
@@ -15,7 +15,7 @@ namespace cbm {
      * @return shared_ptr<ComponentBiomassCarbonCurve>
      ****************************************/
     std::shared_ptr<ComponentBiomassCarbonCurve> VolumeToBiomassConverter::generateComponentBiomassCarbonCurve(
-        StandGrowthCurve& standGrowthCurve, SpeciesType speciesType) {
+        StandGrowthCurve& standGrowthCurve, SpeciesType speciesType) const {
 
         int standMaxAge = standGrowthCurve.standMaxAge();
         auto pf = standGrowthCurve.getPERDFactor(speciesType);
@@ -154,11 +154,24 @@ namespace cbm {
     void VolumeToBiomassConverter::doSmoothing(
         const StandGrowthCurve& standGrowthCurve,
         ComponentBiomassCarbonCurve* carbonCurve,
-        SpeciesType speciesType) {
+        SpeciesType speciesType) const {
 
         if (_smootherEnabled) {
             _smoother.smooth(standGrowthCurve, carbonCurve, speciesType);
         }
     }
 
+    /**
+     * If VolumeToBiomassConverter._smootherEnabled is true, invoke Smoother.smoothAll with arguments as parameters jobs, threadCount
+     * 
+     * @param jobs vector<SmoothingJob>&
+     * @param threadCount int, 0 for one thread per core
+     * @return void
+     ***************************/
+    void VolumeToBiomassConverter::doSmoothing(const std::vector<SmoothingJob>& jobs, int threadCount) const {
+        if (_smootherEnabled) {
+            _smoother.smoothAll(jobs, threadCount);
+        }
+    }
+
 }}}
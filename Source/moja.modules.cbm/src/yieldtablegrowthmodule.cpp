@@ -30,11 +30,32 @@ namespace moja {
 	namespace modules {
 		namespace cbm {
 
+			/**
+			 * Destructor
+			 * 
+			 * Save the biomass carbon curves built by this run to YieldTableGrowthModule._growthCurveCachePath. \n
+			 * Only the first thread's module to finish writes the file, with the curves built by every thread so far.
+			 **/
+			YieldTableGrowthModule::~YieldTableGrowthModule() {
+				if (_growthCurveCachePath.empty()) {
+					return;
+				}
+
+				try {
+					_volumeToBioGrowth->saveCurveFile();
+				}
+				catch (const std::exception& e) {
+					MOJA_LOG_ERROR << "Error saving growth curve cache: " << e.what();
+				}
+			}
+
 			/**
 			 * Configuration function
 			 * 
 			 * Assign YieldTableGrowthModule._smootherEnabled, YieldTableGrowthModule._debuggingEnabled, YieldTableGrowthModule._debuggingOutputPath values of "smoother_enabled", 
 			 * "debugging_enabled", "debugging_output_path" in parameter config. \n
+			 * Assign YieldTableGrowthModule._growthCurveCachePath, YieldTableGrowthModule._growthCurveCacheVersion values of "growth_curve_cache_path", 
+			 * "growth_curve_cache_version" in parameter config, if present. \n
 			 * Invoke VolumeToBiomassConverter.setSmoothing() with the value of YieldTableGrowthModule._smootherEnabled. \n
 			 * 
 			 * @param config DynamicObject&
@@ -53,6 +74,14 @@ namespace moja {
 				if (config.contains("debugging_output_path")) {
 					_debuggingOutputPath = config["debugging_output_path"].convert<std::string>();
 				}
+
+				if (config.contains("growth_curve_cache_path")) {
+					_growthCurveCachePath = config["growth_curve_cache_path"].convert<std::string>();
+				}
+
+				if (config.contains("growth_curve_cache_version")) {
+					_growthCurveCacheVersion = config["growth_curve_cache_version"].convert<std::string>();
+				}
 			}
 
 			/**
@@ -70,13 +99,14 @@ namespace moja {
 			/**
 			 * If the value of YieldTableGrowthModule._gcId is not empty, set YieldTableGrowthModule._standGrowthCurveID as value of _gcId, else to -1 \n
 			 * If the value of YieldTableGrowthModule._standGrowthCurveID is -1, set YieldTableGrowthModule._isDecaying to false \n
-			 * Try to get the stand growth curve and related yield table data from memory, if the result of 
-			 * VolumeToBiomassConverter.isBiomassCarbonCurveAvailable() on YieldTableGrowthModule._volumeToBioGrowth with parameter YieldTableGrowthModule._standGrowthCurveID 
-			 * and YieldTableGrowthModule._standSPUID true, indicating that the carbon curve is found, 
+			 * Try to get the stand biomass carbon curve from memory into YieldTableGrowthModule._standBiomassCarbonCurve with 
+			 * VolumeToBiomassCarbonGrowth.getBiomassCarbonCurve() on YieldTableGrowthModule._volumeToBioGrowth with parameter YieldTableGrowthModule._standGrowthCurveID 
+			 * and YieldTableGrowthModule._standSPUID, if it is not found, 
 			 * call the stand growth curve factory to create the stand growth curve, invoke StandGrowthCurveFactory.createStandGrowthCurve() on
 			 * YieldTableGrowthModule._gcFactory with parameter YieldTableGrowthModule._standGrowthCurveID, YieldTableGrowthModule._standSPUID and _landUnitData \n
 			 * Process and convert yield volume to carbon curves, invoke VolumeToBiomassCarbonGrowth.generateBiomassCarbonCurve() on YieldTableGrowthModule._volumeToBioGrowth 
-			 * with argument as the generated stand growth curve \n
+			 * with argument as the generated stand growth curve. This reuses the curve from the growth curve cache file instead if it was built from the \n
+			 * same yield tables and volume to biomass parameters, so the yield table queries still run but the conversion and smoothing are skipped \n
 			 * 
 			 * @return void
 			 **/
@@ -90,22 +120,23 @@ namespace moja {
 				}
 
 				// Try to get the stand growth curve and related yield table data from memory.
-				bool carbonCurveFound = _volumeToBioGrowth->isBiomassCarbonCurveAvailable(
+				_standBiomassCarbonCurve = _volumeToBioGrowth->getBiomassCarbonCurve(
 					_standGrowthCurveID, _standSPUID);
 
-				if (!carbonCurveFound) {
+				if (_standBiomassCarbonCurve == nullptr) {
 					// Call the stand growth curve factory to create the stand growth curve.
 					auto standGrowthCurve = _gcFactory->createStandGrowthCurve(
 						_standGrowthCurveID, _standSPUID, *_landUnitData);
 
 					// Process and convert yield volume to carbon curves.
 					_volumeToBioGrowth->generateBiomassCarbonCurve(*standGrowthCurve);
+					_standBiomassCarbonCurve = _volumeToBioGrowth->getBiomassCarbonCurve(
+						_standGrowthCurveID, _standSPUID);
 
 					if (_debuggingEnabled) {
-						auto curve = _volumeToBioGrowth->getBiomassCarbonCurve(_standGrowthCurveID, _standSPUID);
 						std::string outPath = (boost::format("%1%%2%_%3%.csv")
 							% _debuggingOutputPath % _standGrowthCurveID % _standSPUID).str();
-						curve->writeDebuggingInfo(outPath);
+						_standBiomassCarbonCurve->writeDebuggingInfo(outPath);
 					}
 				}
 			}
@@ -130,6 +161,7 @@ namespace moja {
 			 * in _landUnitData to YieldTableGrowthModule._age, YieldTableGrowthModule._gcId, YieldTableGrowthModule._spuId, 
 			 * YieldTableGrowthModule._turnoverRates, YieldTableGrowthModule._regenDelay, YieldTableGrowthModule._spinupMossOnly,
 			 * YieldTableGrowthModule._isForest, YieldTableGrowthModule._isDecaying. \n
+			 * If YieldTableGrowthModule._growthCurveCachePath is set, open it as the file of precompiled biomass carbon curves. \n
 			 * 
 			 * @return void
 			 **/
@@ -163,6 +195,10 @@ namespace moja {
 				_mediumSoil = _landUnitData->getPool("MediumSoil");
 				_atmosphere = _landUnitData->getPool("Atmosphere");
 
+				for (int p = 0; p < GrowthTurnoverKernel::PoolCount; p++) {
+					_growthTurnoverPools[p] = _landUnitData->getPool(growthPoolName(GrowthPool(p)));
+				}
+
 				if (_landUnitData->hasVariable("enable_peatland") &&
 					_landUnitData->getVariable("enable_peatland")->value().extract<bool>()) {
 					_woodyFineDead = _landUnitData->getPool("WoodyFineDead");
@@ -172,6 +208,7 @@ namespace moja {
 				}
 
 				_age = _landUnitData->getVariable("age");
+				_standBiomassPools = StandBiomassPools(*_landUnitData);
 				_gcId = _landUnitData->getVariable("growth_curve_id");
 				_spuId = _landUnitData->getVariable("spatial_unit_id");
 				_turnoverRates = _landUnitData->getVariable("turnover_rates");
@@ -187,6 +224,14 @@ namespace moja {
 				else {
 					_output_removal = nullptr;
 				}
+
+				if (!_growthCurveCachePath.empty()) {
+					// Curves built with smoothing on and off differ, so keep them apart. Each curve in the
+					// file is also tagged with a hash of the yield tables and parameters it was built from.
+					auto version = (boost::format("%1%;smoother_enabled=%2%")
+						% _growthCurveCacheVersion % _smootherEnabled).str();
+					_volumeToBioGrowth->openCurveFile(_growthCurveCachePath, version);
+				}
 			}
 
 			/**
@@ -263,12 +308,13 @@ namespace moja {
 			 * 
 			 * If _landUnitData does not have the variable "delay", and YieldTableGrowthModule.shouldRun() is false, return \n
 			 * Else, invoke YieldTableGrowthModule.getIncrements() to get and store the biomass carbon growth increments,
-			 * YieldTableGrowthModule.getTurnoverRates() to get and store the ecoboundary/genus-specific turnover rates,
-			 * YieldTableGrowthModule.switchHalfGrowth() to  transfer half of the biomass growth increment to the biomass pool,
+			 * YieldTableGrowthModule.getTurnoverRates() to get and store the ecoboundary/genus-specific turnover rates. \n
+			 * For forested peatland, invoke YieldTableGrowthModule.doPeatlandHalfGrowth() to transfer half of the biomass growth increment to the biomass pool,
 			 * YieldTableGrowthModule.updateBiomassPools() to update to record the current biomass pool value plus the half increment of biomass,
 			 * YieldTableGrowthModule.doMidSeasonGrowth() to the foliage and snags that grow and are turned over,
-			 * YieldTableGrowthModule.switchTurnover() to switch to do biomass and snag turnover for peatland or regular forest land 
-			 * YieldTableGrowthModule.switchHalfGrowth() to transfer the remaining half increment to the biomass pool \n
+			 * YieldTableGrowthModule.switchTurnover() to do biomass and snag turnover for peatland,
+			 * YieldTableGrowthModule.doPeatlandHalfGrowth() to transfer the remaining half increment to the biomass pool \n
+			 * For regular forest land, invoke YieldTableGrowthModule.doGrowthAndTurnover() to do the same as a single operation \n
 			 * 
 			 * Set the value of YieldTableGrowthModule._age to the increment of the current value of YieldTableGrowthModule._age by 1
 			 * 
@@ -341,19 +387,24 @@ namespace moja {
 
 				getIncrements();		// 1) get and store the biomass carbon growth increments
 				getTurnoverRates();		// 2) get and store the ecoboundary/genus-specific turnover rates
-				switchHalfGrowth();		// 3) transfer half of the biomass growth increment to the biomass pool
-				updateBiomassPools();	// 4) update to record the current biomass pool value plus the half increment of biomass
-				doMidSeasonGrowth();	// 5) the foliage and snags that grow and are turned over
-				switchTurnover();		// 6) switch to do biomass and snag turnover for peatland or regular forest land 
-				switchHalfGrowth();		// 7) transfer the remaining half increment to the biomass pool
+				if (_runForForestedPeatland) {
+					doPeatlandHalfGrowth();	// 3) transfer half of the biomass growth increment to the biomass pool
+					updateBiomassPools();	// 4) update to record the current biomass pool value plus the half increment of biomass
+					doMidSeasonGrowth();	// 5) the foliage and snags that grow and are turned over
+					switchTurnover();		// 6) biomass and snag turnover for peatland
+					doPeatlandHalfGrowth();	// 7) transfer the remaining half increment to the biomass pool
+				}
+				else {
+					doGrowthAndTurnover();	// 3-7) the same steps for regular forest land, as one operation
+				}
 
 				int standAge = _age->value();
 				_age->set_value(standAge + 1);
 			}
 
 			/**
-			 * If the result of VolumeToBiomassCarbonGrowth.getBiomassCarbonIncrements() on YieldTableGrowthModule._volumeToBioGrowth, indicating there are increments
-			 * for the particular _standGrowthCurveID and _standSPUID, assign YieldTableGrowthModule.swm, 
+			 * Get the increments of YieldTableGrowthModule._standBiomassCarbonCurve for the pools in YieldTableGrowthModule._standBiomassPools \n
+			 * with StandBiomassCarbonCurve.getIncrements() into YieldTableGrowthModule._increments, and assign YieldTableGrowthModule.swm, 
 			 * YieldTableGrowthModule.swo, YieldTableGrowthModule.swf, YieldTableGrowthModule.swcr, YieldTableGrowthModule.swfr 
 			 * the Softwood increments, YieldTableGrowthModule.hwm, YieldTableGrowthModule.hwo, YieldTableGrowthModule.hwf, 
 			 * YieldTableGrowthModule.hwcr, YieldTableGrowthModule.hwfr Hardwood increments \n
@@ -367,35 +418,34 @@ namespace moja {
 			 * @return void
 			 **/
 			void YieldTableGrowthModule::getIncrements() {
-				auto increments = _volumeToBioGrowth->getBiomassCarbonIncrements(
-					_landUnitData.get(), _standGrowthCurveID, _standSPUID);
-
-				if (increments.size() == 0) {
+				if (_standBiomassCarbonCurve->isEmpty()) {
 					MOJA_LOG_INFO << "Warning - growth curve with no increments found: " << _standGrowthCurveID;
 				}
 
-				swm = increments["SoftwoodMerch"];
-				swo = increments["SoftwoodOther"];
-				swf = increments["SoftwoodFoliage"];
-				swcr = increments["SoftwoodCoarseRoots"];
-				swfr = increments["SoftwoodFineRoots"];
+				_standBiomassCarbonCurve->getIncrements(_standBiomassPools, _increments);
 
-				hwm = increments["HardwoodMerch"];
-				hwo = increments["HardwoodOther"];
-				hwf = increments["HardwoodFoliage"];
-				hwcr = increments["HardwoodCoarseRoots"];
-				hwfr = increments["HardwoodFineRoots"];
+				swm = _increments.softwood.merch;
+				swo = _increments.softwood.other;
+				swf = _increments.softwood.foliage;
+				swcr = _increments.softwood.coarseRoots;
+				swfr = _increments.softwood.fineRoots;
+
+				hwm = _increments.hardwood.merch;
+				hwo = _increments.hardwood.other;
+				hwf = _increments.hardwood.foliage;
+				hwcr = _increments.hardwood.coarseRoots;
+				hwfr = _increments.hardwood.fineRoots;
 
 				if (!_growthMultipliersEnabled) {
 					return;
 				}
 
-				auto growthMultipliers = _growthMultipliers->value();
+				const auto& growthMultipliers = _growthMultipliers->value();
 				if (growthMultipliers.size() == 0) {
 					return;
 				}
 
-				auto multipliers = growthMultipliers.extract<
+				const auto& multipliers = growthMultipliers.extract<
 					std::unordered_map<std::string, double>>();
 
 				auto newSwMult = multipliers.find("Softwood");
@@ -452,89 +502,28 @@ namespace moja {
 				}
 			}
 
-			void YieldTableGrowthModule::doHalfGrowth() const {
-				static double tolerance = -0.0001;
-				auto growth = _landUnitData->createStockOperation();
-
-				bool swOvermature = swm + swo + swf + swcr + swfr < tolerance;
-				if (swOvermature && swm < 0) {
-					growth->addTransfer(_softwoodMerch, _softwoodStemSnag, -swm / 2);
-				}
-				else {
-					growth->addTransfer(_atmosphere, _softwoodMerch, swm / 2);
-				}
-
-				if (swOvermature && swo < 0) {
-					growth->addTransfer(_softwoodOther, _softwoodBranchSnag, -swo * _currentTurnoverRates->swBranchSnagSplit() / 2);
-					growth->addTransfer(_softwoodOther, _aboveGroundFastSoil, -swo * (1 - _currentTurnoverRates->swBranchSnagSplit()) / 2);
-				}
-				else {
-					growth->addTransfer(_atmosphere, _softwoodOther, swo / 2);
-				}
-
-				if (swOvermature && swf < 0) {
-					growth->addTransfer(_softwoodFoliage, _aboveGroundVeryFastSoil, -swf / 2);
-				}
-				else {
-					growth->addTransfer(_atmosphere, _softwoodFoliage, swf / 2);
-				}
-
-				if (swOvermature && swcr < 0) {
-					growth->addTransfer(_softwoodCoarseRoots, _aboveGroundFastSoil, -swcr * _currentTurnoverRates->swCoarseRootSplit() / 2);
-					growth->addTransfer(_softwoodCoarseRoots, _belowGroundFastSoil, -swcr * (1 - _currentTurnoverRates->swCoarseRootSplit()) / 2);
-				}
-				else {
-					growth->addTransfer(_atmosphere, _softwoodCoarseRoots, swcr / 2);
-				}
-
-				if (swOvermature && swfr < 0) {
-					growth->addTransfer(_softwoodFineRoots, _aboveGroundVeryFastSoil, -swfr * _currentTurnoverRates->swFineRootSplit() / 2);
-					growth->addTransfer(_softwoodFineRoots, _belowGroundVeryFastSoil, -swfr * (1 - _currentTurnoverRates->swFineRootSplit()) / 2);
-				}
-				else {
-					growth->addTransfer(_atmosphere, _softwoodFineRoots, swfr / 2);
-				}
-
-				bool hwOvermature = hwm + hwo + hwf + hwcr + hwfr < tolerance;
-				if (hwOvermature && hwm < 0) {
-					growth->addTransfer(_hardwoodMerch, _hardwoodStemSnag, -hwm / 2);
-				}
-				else {
-					growth->addTransfer(_atmosphere, _hardwoodMerch, hwm / 2);
-				}
-
-				if (hwOvermature && hwo < 0) {
-					growth->addTransfer(_hardwoodOther, _hardwoodBranchSnag, -hwo * _currentTurnoverRates->hwBranchSnagSplit() / 2);
-					growth->addTransfer(_hardwoodOther, _aboveGroundFastSoil, -hwo * (1 - _currentTurnoverRates->hwBranchSnagSplit()) / 2);
-				}
-				else {
-					growth->addTransfer(_atmosphere, _hardwoodOther, hwo / 2);
-				}
-
-				if (hwOvermature && hwf < 0) {
-					growth->addTransfer(_hardwoodFoliage, _aboveGroundVeryFastSoil, -hwf / 2);
-				}
-				else {
-					growth->addTransfer(_atmosphere, _hardwoodFoliage, hwf / 2);
-				}
-
-				if (hwOvermature && hwcr < 0) {
-					growth->addTransfer(_hardwoodCoarseRoots, _aboveGroundFastSoil, -hwcr * _currentTurnoverRates->hwCoarseRootSplit() / 2);
-					growth->addTransfer(_hardwoodCoarseRoots, _belowGroundFastSoil, -hwcr * (1 - _currentTurnoverRates->hwCoarseRootSplit()) / 2);
-				}
-				else {
-					growth->addTransfer(_atmosphere, _hardwoodCoarseRoots, hwcr / 2);
+			/**
+			 * Grow and turn over a regular forest stand as one stock operation
+			 * 
+			 * Read the current values of YieldTableGrowthModule._growthTurnoverPools, build the year's half growth, mid-season growth,
+			 * snag and biomass turnover and second half growth transfers with GrowthTurnoverKernel.build() from the increments 
+			 * YieldTableGrowthModule.swm to YieldTableGrowthModule.hwfr and YieldTableGrowthModule._currentTurnoverRates, 
+			 * then submit and apply them as a single operation. The transfers are in the order they used to be submitted 
+			 * as separate operations, so the pools end up the same
+			 * 
+			 * @return void
+			 **/
+			void YieldTableGrowthModule::doGrowthAndTurnover() {
+				double pools[GrowthTurnoverKernel::PoolCount];
+				for (int p = 0; p < GrowthTurnoverKernel::PoolCount; p++) {
+					pools[p] = _growthTurnoverPools[p]->value();
 				}
 
-				if (hwOvermature && hwfr < 0) {
-					growth->addTransfer(_hardwoodFineRoots, _aboveGroundVeryFastSoil, -hwfr * _currentTurnoverRates->hwFineRootSplit() / 2);
-					growth->addTransfer(_hardwoodFineRoots, _belowGroundVeryFastSoil, -hwfr * (1 - _currentTurnoverRates->hwFineRootSplit()) / 2);
-				}
-				else {
-					growth->addTransfer(_atmosphere, _hardwoodFineRoots, hwfr / 2);
-				}
+				StandBiomassCarbonIncrements increments;
+				increments.softwood = { swm, swo, swf, swcr, swfr };
+				increments.hardwood = { hwm, hwo, hwf, hwcr, hwfr };
 
-				_landUnitData->submitOperation(growth);
+				submitGrowthTransfers(_growthTurnover.build(increments, *_currentTurnoverRates, pools));
 				_landUnitData->applyOperations();
 			}
 
@@ -674,63 +663,30 @@ namespace moja {
 				}
 			}
 
-			/**
-			 * If YieldTableGrowthModule._runForForestedPeatland is true, invoke the YieldTableGrowthModule.doPeatlandHalfGrowth(), else invoke 
-			 * YieldTableGrowthModule.doHalfGrowth()
-			 * 
-			 * @return void
-			 **/
-			void YieldTableGrowthModule::switchHalfGrowth() const {
-				if (_runForForestedPeatland) {
-					doPeatlandHalfGrowth();
-				}
-				else {
-					doHalfGrowth();
-				}
-			}
-
 			/**
 			 * Perform snag and biomass turnovers as stock operations
 			 * 
-			 * Invoke createStockOperation() on _landUnitData . Add transfers between softwood and hardwood branch
-			 * and snag pools to medium and above ground fast soil pools. Invoke submitStockOperation() on _landUnitData to submit the transfers \n
-			 * Invoke createStockOperation() on _landUnitData . Add transfers between softwood and hardwood merchantable, foilage, 
-			 * other, coarse and fine roots to softwood and hardwood stem and branch snag pools, above and below ground
-			 * fast and slow pools. Invoke submitStockOperation() on _landUnitData to submit the transfers \n
+			 * Build the transfers between softwood and hardwood branch and snag pools to medium and above ground fast soil pools
+			 * with GrowthTurnoverKernel.addSnagTurnover(), and submit them as a stock operation \n
+			 * Build the transfers between softwood and hardwood merchantable, foilage, other, coarse and fine roots to softwood 
+			 * and hardwood stem and branch snag pools, above and below ground fast and slow pools with 
+			 * GrowthTurnoverKernel.addBiomassTurnover(), and submit them as a stock operation \n
 			 * 
 			 * @return void
 			 **/
 			void YieldTableGrowthModule::doTurnover() const {
+				double pools[GrowthTurnoverKernel::PoolCount];
+				getStandPools(pools);
+
 				// Snag turnover.
-				auto domTurnover = _landUnitData->createStockOperation();
-				domTurnover
-					->addTransfer(_softwoodStemSnag, _mediumSoil, softwoodStemSnag * _currentTurnoverRates->swStemSnagTurnover())
-					->addTransfer(_softwoodBranchSnag, _aboveGroundFastSoil, softwoodBranchSnag * _currentTurnoverRates->swBranchSnagTurnover())
-					->addTransfer(_hardwoodStemSnag, _mediumSoil, hardwoodStemSnag * _currentTurnoverRates->hwStemSnagTurnover())
-					->addTransfer(_hardwoodBranchSnag, _aboveGroundFastSoil, hardwoodBranchSnag * _currentTurnoverRates->hwBranchSnagTurnover());
-				_landUnitData->submitOperation(domTurnover);
+				std::vector<GrowthTransfer> domTurnover;
+				GrowthTurnoverKernel::addSnagTurnover(domTurnover, *_currentTurnoverRates, pools);
+				submitGrowthTransfers(domTurnover);
 
 				// Biomass turnover as stock operation.
-				auto bioTurnover = _landUnitData->createStockOperation();
-				bioTurnover
-					->addTransfer(_softwoodMerch, _softwoodStemSnag, standSoftwoodMerch * _currentTurnoverRates->swStemTurnover())
-					->addTransfer(_softwoodFoliage, _aboveGroundVeryFastSoil, standSoftwoodFoliage * _currentTurnoverRates->swFoliageTurnover())
-					->addTransfer(_softwoodOther, _softwoodBranchSnag, standSoftwoodOther * _currentTurnoverRates->swBranchSnagSplit() * _currentTurnoverRates->swBranchTurnover())
-					->addTransfer(_softwoodOther, _aboveGroundFastSoil, standSoftwoodOther * (1 - _currentTurnoverRates->swBranchSnagSplit()) * _currentTurnoverRates->swBranchTurnover())
-					->addTransfer(_softwoodCoarseRoots, _aboveGroundFastSoil, standSWCoarseRootsCarbon * _currentTurnoverRates->swCoarseRootSplit() * _currentTurnoverRates->swCoarseRootTurnover())
-					->addTransfer(_softwoodCoarseRoots, _belowGroundFastSoil, standSWCoarseRootsCarbon * (1 - _currentTurnoverRates->swCoarseRootSplit()) * _currentTurnoverRates->swCoarseRootTurnover())
-					->addTransfer(_softwoodFineRoots, _aboveGroundVeryFastSoil, standSWFineRootsCarbon * _currentTurnoverRates->swFineRootSplit() * _currentTurnoverRates->swFineRootTurnover())
-					->addTransfer(_softwoodFineRoots, _belowGroundVeryFastSoil, standSWFineRootsCarbon * (1 - _currentTurnoverRates->swFineRootSplit()) * _currentTurnoverRates->swFineRootTurnover())
-
-					->addTransfer(_hardwoodMerch, _hardwoodStemSnag, standHardwoodMerch * _currentTurnoverRates->hwStemTurnover())
-					->addTransfer(_hardwoodFoliage, _aboveGroundVeryFastSoil, standHardwoodFoliage * _currentTurnoverRates->hwFoliageTurnover())
-					->addTransfer(_hardwoodOther, _hardwoodBranchSnag, standHardwoodOther * _currentTurnoverRates->hwBranchSnagSplit() * _currentTurnoverRates->hwBranchTurnover())
-					->addTransfer(_hardwoodOther, _aboveGroundFastSoil, standHardwoodOther * (1 - _currentTurnoverRates->hwBranchSnagSplit()) * _currentTurnoverRates->hwBranchTurnover())
-					->addTransfer(_hardwoodCoarseRoots, _aboveGroundFastSoil, standHWCoarseRootsCarbon * _currentTurnoverRates->hwCoarseRootSplit() * _currentTurnoverRates->hwCoarseRootTurnover())
-					->addTransfer(_hardwoodCoarseRoots, _belowGroundFastSoil, standHWCoarseRootsCarbon * (1 - _currentTurnoverRates->hwCoarseRootSplit()) * _currentTurnoverRates->hwCoarseRootTurnover())
-					->addTransfer(_hardwoodFineRoots, _aboveGroundVeryFastSoil, standHWFineRootsCarbon * _currentTurnoverRates->hwFineRootSplit() * _currentTurnoverRates->hwFineRootTurnover())
-					->addTransfer(_hardwoodFineRoots, _belowGroundVeryFastSoil, standHWFineRootsCarbon * (1 - _currentTurnoverRates->hwFineRootSplit()) * _currentTurnoverRates->hwFineRootTurnover());
-				_landUnitData->submitOperation(bioTurnover);
+				std::vector<GrowthTransfer> bioTurnover;
+				GrowthTurnoverKernel::addBiomassTurnover(bioTurnover, *_currentTurnoverRates, pools);
+				submitGrowthTransfers(bioTurnover);
 			}
 
 			/**
@@ -782,26 +738,63 @@ namespace moja {
 			 * Add transfers from the atmospheric pools to softwood and hardwood pools
 			 * 
 			 * Record carbon transfers that occur from the atmosphere to softwood and hardwoord pools during mid-season
-			 * Invoke createStockOperation() on _landUnitData \n
-			 * Add transfers from the atmosphere pool to softwood and hardwood merchantable, foilage, coarse root and fine root pools.
-			 * Submit the operation to the _landUnitData by invoking submitOperation() 
+			 * Build the transfers from the atmosphere pool to softwood and hardwood merchantable, foilage, coarse root and fine root pools
+			 * with GrowthTurnoverKernel.addMidSeasonGrowth(), and submit them as a stock operation
 			 * 
 			 * @return void
 			 **/
 			void YieldTableGrowthModule::doMidSeasonGrowth() const {
-				auto seasonalGrowth = _landUnitData->createStockOperation();
-				seasonalGrowth
-					->addTransfer(_atmosphere, _softwoodMerch, standSoftwoodMerch * _currentTurnoverRates->swStemTurnover())
-					->addTransfer(_atmosphere, _softwoodOther, standSoftwoodOther * _currentTurnoverRates->swBranchTurnover())
-					->addTransfer(_atmosphere, _softwoodFoliage, standSoftwoodFoliage * _currentTurnoverRates->swFoliageTurnover())
-					->addTransfer(_atmosphere, _softwoodCoarseRoots, standSWCoarseRootsCarbon * _currentTurnoverRates->swCoarseRootTurnover())
-					->addTransfer(_atmosphere, _softwoodFineRoots, standSWFineRootsCarbon * _currentTurnoverRates->swFineRootTurnover())
-					->addTransfer(_atmosphere, _hardwoodMerch, standHardwoodMerch * _currentTurnoverRates->hwStemTurnover())
-					->addTransfer(_atmosphere, _hardwoodOther, standHardwoodOther * _currentTurnoverRates->hwBranchTurnover())
-					->addTransfer(_atmosphere, _hardwoodFoliage, standHardwoodFoliage * _currentTurnoverRates->hwFoliageTurnover())
-					->addTransfer(_atmosphere, _hardwoodCoarseRoots, standHWCoarseRootsCarbon * _currentTurnoverRates->hwCoarseRootTurnover())
-					->addTransfer(_atmosphere, _hardwoodFineRoots, standHWFineRootsCarbon * _currentTurnoverRates->hwFineRootTurnover());
-				_landUnitData->submitOperation(seasonalGrowth);
+				double pools[GrowthTurnoverKernel::PoolCount];
+				getStandPools(pools);
+
+				std::vector<GrowthTransfer> seasonalGrowth;
+				GrowthTurnoverKernel::addMidSeasonGrowth(seasonalGrowth, *_currentTurnoverRates, pools);
+				submitGrowthTransfers(seasonalGrowth);
+			}
+
+			/**
+			 * Fill parameter pools, by GrowthPool, with the stand's recorded biomass (YieldTableGrowthModule.standSoftwoodMerch 
+			 * to YieldTableGrowthModule.standHWFineRootsCarbon) and snags at the start of the step (YieldTableGrowthModule.softwoodStemSnag
+			 * to YieldTableGrowthModule.hardwoodBranchSnag); the other pools are not read by the turnover transfers and are set to 0
+			 * 
+			 * @param pools double*
+			 * @return void
+			 **/
+			void YieldTableGrowthModule::getStandPools(double* pools) const {
+				for (int p = 0; p < GrowthTurnoverKernel::PoolCount; p++) {
+					pools[p] = 0.0;
+				}
+
+				pools[int(GrowthPool::SoftwoodMerch)] = standSoftwoodMerch;
+				pools[int(GrowthPool::SoftwoodOther)] = standSoftwoodOther;
+				pools[int(GrowthPool::SoftwoodFoliage)] = standSoftwoodFoliage;
+				pools[int(GrowthPool::SoftwoodCoarseRoots)] = standSWCoarseRootsCarbon;
+				pools[int(GrowthPool::SoftwoodFineRoots)] = standSWFineRootsCarbon;
+				pools[int(GrowthPool::HardwoodMerch)] = standHardwoodMerch;
+				pools[int(GrowthPool::HardwoodOther)] = standHardwoodOther;
+				pools[int(GrowthPool::HardwoodFoliage)] = standHardwoodFoliage;
+				pools[int(GrowthPool::HardwoodCoarseRoots)] = standHWCoarseRootsCarbon;
+				pools[int(GrowthPool::HardwoodFineRoots)] = standHWFineRootsCarbon;
+				pools[int(GrowthPool::SoftwoodStemSnag)] = softwoodStemSnag;
+				pools[int(GrowthPool::SoftwoodBranchSnag)] = softwoodBranchSnag;
+				pools[int(GrowthPool::HardwoodStemSnag)] = hardwoodStemSnag;
+				pools[int(GrowthPool::HardwoodBranchSnag)] = hardwoodBranchSnag;
+			}
+
+			/**
+			 * Submit parameter transfers between the pools in YieldTableGrowthModule._growthTurnoverPools as one stock operation
+			 * 
+			 * @param transfers vector<GrowthTransfer>&
+			 * @return void
+			 **/
+			void YieldTableGrowthModule::submitGrowthTransfers(const std::vector<GrowthTransfer>& transfers) const {
+				auto operation = _landUnitData->createStockOperation();
+				for (const auto& transfer : transfers) {
+					operation->addTransfer(_growthTurnoverPools[int(transfer.source)],
+										   _growthTurnoverPools[int(transfer.sink)], transfer.value);
+				}
+
+				_landUnitData->submitOperation(operation);
 			}
 
 			/**
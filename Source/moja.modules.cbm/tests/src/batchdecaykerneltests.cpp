@@ -0,0 +1,227 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/batchdecaykernel.h"
+#include "moja/modules/cbm/decaytransfers.h"
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace moja::modules;
+using cbm::DecayPool;
+
+namespace {
+
+    const char* const PoolNames[] = {
+        "AboveGroundVeryFastSoil", "BelowGroundVeryFastSoil", "AboveGroundFastSoil", "BelowGroundFastSoil",
+        "MediumSoil", "SoftwoodStemSnag", "SoftwoodBranchSnag", "HardwoodStemSnag", "HardwoodBranchSnag",
+        "AboveGroundSlowSoil", "BelowGroundSlowSoil"
+    };
+
+    const double SlowMixingRate = 0.006;
+
+    std::map<std::string, cbm::PoolDecayParameters> decayParameters() {
+        std::map<std::string, cbm::PoolDecayParameters> parameters;
+        double rate = 0.5;
+        for (auto name : PoolNames) {
+            cbm::PoolDecayParameters pool;
+            pool.pool = name;
+            pool.baseDecayRate = rate;
+            pool.maxDecayRate = 1.0;
+            pool.q10 = 2.0;
+            pool.tRef = 10.0;
+            pool.pAtm = 0.83;
+            parameters[name] = pool;
+            rate *= 0.6;
+        }
+
+        return parameters;
+    }
+
+    typedef std::map<std::string, double> Pools;
+
+    const cbm::DecayPools<std::string> DecayPoolNames = {
+        "AboveGroundVeryFastSoil", "BelowGroundVeryFastSoil", "AboveGroundFastSoil", "BelowGroundFastSoil",
+        "MediumSoil", "AboveGroundSlowSoil", "BelowGroundSlowSoil", "SoftwoodStemSnag", "SoftwoodBranchSnag",
+        "HardwoodStemSnag", "HardwoodBranchSnag", "CO2"
+    };
+
+    /**
+     * A proportional operation on a land unit's pools by name: every flux is a proportion of
+     * the pool values before the operation, and all of them are applied together.
+     */
+    class ProportionalOperation {
+    public:
+        explicit ProportionalOperation(Pools& pools) : _pools(pools), _start(pools) { }
+
+        void operator()(const std::string& source, const std::string& sink, double proportion) {
+            double flux = _start[source] * proportion;
+            _pools[source] -= flux;
+            _pools[sink] += flux;
+        }
+
+    private:
+        Pools& _pools;
+        Pools _start;
+    };
+
+    /**
+     * Per land unit reference: CBMDecayModule::doTimingStep's three proportional operations,
+     * built from the same DecayTransfers the module submits.
+     */
+    void referenceStep(Pools& pools, double mat,
+                       const std::map<std::string, cbm::PoolDecayParameters>& parameters,
+                       const std::map<std::string, std::map<std::string, double>>& removals) {
+
+        std::map<std::string, double> decayRates;
+        for (const auto& pool : parameters) {
+            decayRates[pool.first] = pool.second.getDecayRate(mat);
+        }
+
+        cbm::DecayTransfers::addDomDecayTransfers(DecayPoolNames, decayRates, parameters, ProportionalOperation(pools));
+        cbm::DecayTransfers::addSlowDecayTransfers(DecayPoolNames, decayRates, parameters, removals,
+            [](const std::string& pool) { return pool; }, ProportionalOperation(pools));
+        cbm::DecayTransfers::addSlowMixingTransfers(DecayPoolNames, SlowMixingRate, ProportionalOperation(pools));
+    }
+
+    void checkAgainstReference(const std::map<std::string, std::map<std::string, double>>& removals) {
+        const size_t landUnits = 50;
+        const int steps = 20;
+
+        auto parameters = decayParameters();
+        cbm::BatchDecayKernel kernel(parameters, SlowMixingRate, removals);
+        cbm::DecayBatch batch(landUnits);
+        kernel.prepare(batch);
+
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<double> poolValue(0.0, 100.0);
+        std::uniform_int_distribution<int> temperature(-10, 10);
+
+        std::vector<double> mats(landUnits);
+        std::vector<Pools> reference(landUnits);
+        for (size_t i = 0; i < landUnits; i++) {
+            // Few distinct temperatures, so the kernel's memoized rates are shared between land units.
+            mats[i] = temperature(generator) * 0.5;
+            for (int p = 0; p < cbm::DecayBatch::PoolCount - 1; p++) {
+                double value = poolValue(generator);
+                batch.pool(DecayPool(p))[i] = value;
+                reference[i][PoolNames[p]] = value;
+            }
+
+            reference[i]["CO2"] = 0.0;
+            for (const auto& pool : kernel.removalPools()) {
+                reference[i][pool] = 0.0;
+            }
+        }
+
+        kernel.setTemperatures(batch, mats.data());
+        for (int step = 0; step < steps; step++) {
+            kernel.step(batch);
+            for (size_t i = 0; i < landUnits; i++) {
+                referenceStep(reference[i], mats[i], parameters, removals);
+            }
+        }
+
+        for (size_t i = 0; i < landUnits; i++) {
+            for (int p = 0; p < cbm::DecayBatch::PoolCount - 1; p++) {
+                BOOST_CHECK_CLOSE(batch.pool(DecayPool(p))[i], reference[i][PoolNames[p]], 1e-9);
+            }
+
+            BOOST_CHECK_CLOSE(batch.pool(DecayPool::CO2)[i], reference[i]["CO2"], 1e-9);
+            for (size_t r = 0; r < kernel.removalPools().size(); r++) {
+                BOOST_CHECK_CLOSE(batch.removalPool(r)[i], reference[i][kernel.removalPools()[r]], 1e-9);
+            }
+        }
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(BatchDecayKernelTests);
+
+BOOST_AUTO_TEST_CASE(MatchesPerLandUnitDecay) {
+    checkAgainstReference({});
+}
+
+BOOST_AUTO_TEST_CASE(MatchesPerLandUnitDecayWithRemovals) {
+    checkAgainstReference({
+        { "AboveGroundSlowSoil", { { "DissolvedOrganicCarbon", 0.05 } } },
+        { "BelowGroundSlowSoil", { { "DissolvedOrganicCarbon", 0.02 }, { "Products", 0.01 } } }
+    });
+}
+
+BOOST_AUTO_TEST_CASE(ConservesCarbon) {
+    auto parameters = decayParameters();
+    cbm::BatchDecayKernel kernel(parameters, SlowMixingRate);
+    cbm::DecayBatch batch(3);
+    kernel.prepare(batch);
+
+    double total = 0.0;
+    for (int p = 0; p < cbm::DecayBatch::PoolCount - 1; p++) {
+        for (size_t i = 0; i < batch.size(); i++) {
+            batch.pool(DecayPool(p))[i] = 10.0 * (p + 1) + i;
+            total += batch.pool(DecayPool(p))[i];
+        }
+    }
+
+    std::vector<double> mats = { -5.0, 0.0, 5.0 };
+    kernel.setTemperatures(batch, mats.data());
+    for (int step = 0; step < 100; step++) {
+        kernel.step(batch);
+    }
+
+    double after = 0.0;
+    for (int p = 0; p < cbm::DecayBatch::PoolCount; p++) {
+        for (size_t i = 0; i < batch.size(); i++) {
+            after += batch.pool(DecayPool(p))[i];
+        }
+    }
+
+    BOOST_CHECK_CLOSE(after, total, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(TemperaturesCanChangeEachStep) {
+    const size_t landUnits = 4;
+    auto parameters = decayParameters();
+    cbm::BatchDecayKernel kernel(parameters, SlowMixingRate);
+    cbm::DecayBatch batch(landUnits);
+    kernel.prepare(batch);
+
+    std::vector<Pools> reference(landUnits);
+    for (size_t i = 0; i < landUnits; i++) {
+        for (int p = 0; p < cbm::DecayBatch::PoolCount - 1; p++) {
+            batch.pool(DecayPool(p))[i] = 10.0 * (p + 1) + i;
+            reference[i][PoolNames[p]] = batch.pool(DecayPool(p))[i];
+        }
+
+        reference[i]["CO2"] = 0.0;
+    }
+
+    // A mean annual temperature timeseries: each step's temperatures are set before the step.
+    std::vector<double> mats(landUnits);
+    for (int step = 0; step < 20; step++) {
+        for (size_t i = 0; i < landUnits; i++) {
+            mats[i] = -5.0 + 0.5 * step + i;
+            referenceStep(reference[i], mats[i], parameters, {});
+        }
+
+        kernel.setTemperatures(batch, mats.data());
+        kernel.step(batch);
+    }
+
+    for (size_t i = 0; i < landUnits; i++) {
+        for (int p = 0; p < cbm::DecayBatch::PoolCount - 1; p++) {
+            BOOST_CHECK_CLOSE(batch.pool(DecayPool(p))[i], reference[i][PoolNames[p]], 1e-9);
+        }
+
+        BOOST_CHECK_CLOSE(batch.pool(DecayPool::CO2)[i], reference[i]["CO2"], 1e-9);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(MissingDecayParametersThrows) {
+    auto parameters = decayParameters();
+    parameters.erase("MediumSoil");
+    BOOST_CHECK_THROW(cbm::BatchDecayKernel(parameters, SlowMixingRate), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,129 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/biomasscarboncurvefile.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace moja::modules;
+
+namespace {
+
+    struct CurveFile {
+        CurveFile() : path((std::filesystem::temp_directory_path()
+            / ("biomass_carbon_curves_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()))).string()) { }
+
+        ~CurveFile() { std::filesystem::remove(path); }
+
+        std::string path;
+    };
+
+    std::shared_ptr<cbm::ComponentBiomassCarbonCurve> carbonCurve(int maxAge, double scale) {
+        auto curve = std::make_shared<cbm::ComponentBiomassCarbonCurve>(maxAge);
+        for (int age = 0; age <= maxAge; age++) {
+            curve->setMerchCarbonAtAge(age, scale * age);
+            curve->setFoliageCarbonAtAge(age, scale * age * 0.1);
+            curve->setOtherCarbonAtAge(age, scale * age * 0.3);
+        }
+
+        return curve;
+    }
+
+    std::shared_ptr<cbm::StandBiomassCarbonCurve> mixedwoodCurve() {
+        auto curve = std::make_shared<cbm::StandBiomassCarbonCurve>();
+        curve->addComponent(cbm::StandComponent("Softwood",
+            std::make_shared<cbm::SoftwoodRootBiomassEquation>(0.222, 0.072, 0.354, -0.06212),
+            carbonCurve(200, 0.5)));
+
+        curve->addComponent(cbm::StandComponent("Hardwood",
+            std::make_shared<cbm::HardwoodRootBiomassEquation>(1.576, 0.615, 0.072, 0.354, -0.06212),
+            carbonCurve(150, 0.25)));
+
+        return curve;
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(BiomassCarbonCurveFileTests);
+
+BOOST_AUTO_TEST_CASE(CurvesRoundTrip) {
+    CurveFile path;
+    auto expected = mixedwoodCurve();
+    cbm::BiomassCarbonCurveFile::write(path.path, "v1", { { cbm::BiomassCarbonCurveFile::Key{ 101, 42 }, 7, expected } });
+
+    cbm::BiomassCarbonCurveFile file;
+    BOOST_REQUIRE(file.open(path.path, "v1"));
+    BOOST_CHECK_EQUAL(file.keys().size(), 1);
+    BOOST_CHECK_EQUAL(file.inputHash(cbm::BiomassCarbonCurveFile::Key{ 101, 42 }), 7);
+    BOOST_CHECK(file.read(cbm::BiomassCarbonCurveFile::Key{ 101, 43 }) == nullptr);
+
+    auto actual = file.read(cbm::BiomassCarbonCurveFile::Key{ 101, 42 });
+    BOOST_REQUIRE(actual != nullptr);
+    BOOST_REQUIRE_EQUAL(actual->components().size(), 2);
+    for (size_t i = 0; i < 2; i++) {
+        const auto& expectedComponent = expected->components()[i];
+        const auto& actualComponent = actual->components()[i];
+        BOOST_CHECK_EQUAL(actualComponent.forestType(), expectedComponent.forestType());
+        BOOST_CHECK_EQUAL(actualComponent.growthCurve()->maxAge(), expectedComponent.growthCurve()->maxAge());
+
+        auto expectedCoefficients = expectedComponent.rootBiomassEquation()->coefficients();
+        auto actualCoefficients = actualComponent.rootBiomassEquation()->coefficients();
+        BOOST_CHECK_EQUAL_COLLECTIONS(actualCoefficients.begin(), actualCoefficients.end(),
+                                      expectedCoefficients.begin(), expectedCoefficients.end());
+
+        BOOST_CHECK(actualComponent.getMerchCarbonCurve() == expectedComponent.getMerchCarbonCurve());
+        BOOST_CHECK(actualComponent.getFoliageCarbonCurve() == expectedComponent.getFoliageCarbonCurve());
+        BOOST_CHECK(actualComponent.getOtherCarbonCurve() == expectedComponent.getOtherCarbonCurve());
+    }
+
+    // Curves read from the file stay valid after it is unmapped.
+    file.close();
+    BOOST_CHECK(!file.isOpen());
+    BOOST_CHECK(actual->getAboveGroundCarbonCurve() == expected->getAboveGroundCarbonCurve());
+}
+
+BOOST_AUTO_TEST_CASE(FileWithOtherVersionIsIgnored) {
+    CurveFile path;
+    cbm::BiomassCarbonCurveFile::write(path.path, "v1", { { cbm::BiomassCarbonCurveFile::Key{ 101, 42 }, 7, mixedwoodCurve() } });
+
+    cbm::BiomassCarbonCurveFile file;
+    BOOST_CHECK(!file.open(path.path, "v2"));
+    BOOST_CHECK(!file.isOpen());
+    BOOST_CHECK(!file.contains(cbm::BiomassCarbonCurveFile::Key{ 101, 42 }));
+}
+
+BOOST_AUTO_TEST_CASE(CurvesFromOtherInputsAreNotMatched) {
+    CurveFile path;
+    cbm::BiomassCarbonCurveFile::write(path.path, "v1", {
+        { cbm::BiomassCarbonCurveFile::Key{ 101, 42 }, 7, mixedwoodCurve() },
+        { cbm::BiomassCarbonCurveFile::Key{ 102, 42 }, 8, mixedwoodCurve() } });
+
+    cbm::BiomassCarbonCurveFile file;
+    BOOST_REQUIRE(file.open(path.path, "v1"));
+    BOOST_CHECK(file.contains(cbm::BiomassCarbonCurveFile::Key{ 101, 42 }, 7));
+    BOOST_CHECK(!file.contains(cbm::BiomassCarbonCurveFile::Key{ 101, 42 }, 8));
+    BOOST_CHECK(file.contains(cbm::BiomassCarbonCurveFile::Key{ 102, 42 }, 8));
+    BOOST_CHECK(!file.contains(cbm::BiomassCarbonCurveFile::Key{ 103, 42 }, 7));
+}
+
+BOOST_AUTO_TEST_CASE(MissingFileIsNotOpened) {
+    CurveFile path;
+    cbm::BiomassCarbonCurveFile file;
+    BOOST_CHECK(!file.open(path.path, "v1"));
+}
+
+BOOST_AUTO_TEST_CASE(TruncatedFileThrows) {
+    CurveFile path;
+    cbm::BiomassCarbonCurveFile::write(path.path, "v1", { { cbm::BiomassCarbonCurveFile::Key{ 101, 42 }, 7, mixedwoodCurve() } });
+    std::filesystem::resize_file(path.path, std::filesystem::file_size(path.path) - 64);
+
+    cbm::BiomassCarbonCurveFile file;
+    BOOST_REQUIRE(file.open(path.path, "v1"));
+    BOOST_CHECK_THROW(file.read(cbm::BiomassCarbonCurveFile::Key{ 101, 42 }), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
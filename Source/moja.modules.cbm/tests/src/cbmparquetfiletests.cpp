@@ -0,0 +1,208 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/cbmaggregatorparquetwriter.h"
+#include "moja/modules/cbm/classifiersetinterner.h"
+#include "moja/modules/cbm/flatrecord.h"
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <parquet/arrow/reader.h>
+#include <parquet/exception.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace moja::modules;
+
+namespace {
+
+    class ColumnTypes : public cbm::FlatRecordColumnVisitor {
+    public:
+        void integer(int) override { types.push_back(cbm::FlatColumnType::Integer); }
+        void number(double) override { types.push_back(cbm::FlatColumnType::Number); }
+        void text(const std::string&) override { types.push_back(cbm::FlatColumnType::Text); }
+        void null(cbm::FlatColumnType type) override { types.push_back(type); }
+
+        std::vector<cbm::FlatColumnType> types;
+    };
+
+    template<class TRecord>
+    std::vector<cbm::FlatColumnType> columnTypes(const TRecord& record) {
+        ColumnTypes visitor;
+        record.visitColumns(visitor);
+        return visitor.types;
+    }
+
+    std::vector<std::string> columnNames(const std::string& header) {
+        std::vector<std::string> names;
+        boost::split(names, boost::trim_copy(header), boost::is_any_of(","));
+        return names;
+    }
+
+    std::optional<std::string> cellAsString(const arrow::Array& column, int64_t row) {
+        if (column.IsNull(row)) {
+            return std::nullopt;
+        }
+
+        switch (column.type_id()) {
+            case arrow::Type::INT32:
+                return std::to_string(static_cast<const arrow::Int32Array&>(column).Value(row));
+            case arrow::Type::DOUBLE:
+                return std::to_string(static_cast<const arrow::DoubleArray&>(column).Value(row));
+            case arrow::Type::DICTIONARY: {
+                const auto& dictionaryColumn = static_cast<const arrow::DictionaryArray&>(column);
+                const auto& dictionary = static_cast<const arrow::StringArray&>(*dictionaryColumn.dictionary());
+                return dictionary.GetString(dictionaryColumn.GetValueIndex(row));
+            }
+            default:
+                return column.GetScalar(row).ValueOrDie()->ToString();
+        }
+    }
+
+    std::shared_ptr<arrow::Table> readTable(const std::string& path) {
+        PARQUET_ASSIGN_OR_THROW(auto input, arrow::io::ReadableFile::Open(path));
+        PARQUET_ASSIGN_OR_THROW(auto reader, parquet::arrow::OpenFile(input, arrow::default_memory_pool()));
+        std::shared_ptr<arrow::Table> table;
+        PARQUET_THROW_NOT_OK(reader->ReadTable(&table));
+        PARQUET_ASSIGN_OR_THROW(table, table->CombineChunks());
+        return table;
+    }
+
+    size_t filesIn(const std::filesystem::path& dir) {
+        size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            (void)entry;
+            count++;
+        }
+
+        return count;
+    }
+
+    struct ParquetFixture {
+        ParquetFixture()
+            : dir(std::filesystem::temp_directory_path() / ("cbmparquetfiletests_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()))),
+              names({ "admin", "species" }),
+              current(interner.intern({ std::string("AB"), std::string("BF") })),
+              previous(interner.intern({ std::string("AB"), Poco::Nullable<std::string>() })) {
+            std::filesystem::remove_all(dir);
+            std::filesystem::create_directories(dir);
+        }
+
+        ~ParquetFixture() {
+            std::filesystem::remove_all(dir);
+        }
+
+        template<class TRecord>
+        std::unique_ptr<cbm::CBMParquetFile> open(const std::string& fileName, const TRecord& firstRecord) {
+            return std::make_unique<cbm::CBMParquetFile>(
+                (dir / fileName).string(), columnNames(firstRecord.header(names)),
+                columnTypes(firstRecord), "snappy", 1024);
+        }
+
+        std::filesystem::path dir;
+        cbm::ClassifierSetInterner interner;
+        std::vector<std::string> names;
+        cbm::ClassifierSetRef current;
+        cbm::ClassifierSetRef previous;
+    };
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(CBMParquetFileTests, ParquetFixture);
+
+BOOST_AUTO_TEST_CASE(RoundTripsRecordsAcrossRowGroups) {
+    std::vector<cbm::FlatFluxRecord> records;
+    for (int year = 2010; year < 2013; year++) {
+        records.emplace_back(year, current, "FL", "20-29", previous, "FL", "10-19",
+                             std::string("Fire"), 1, "SoftwoodMerch", "CO2", year * 0.5);
+        records.emplace_back(year, current, "FL", "20-29", current, "FL", "20-29",
+                             Poco::Nullable<std::string>(), Poco::Nullable<int>(), "SoftwoodMerch", "SoftwoodOther", 1.25);
+    }
+
+    auto file = open("flux.parquet", records[0]);
+    for (size_t i = 0; i < records.size(); i++) {
+        records[i].visitColumns(file->rowBuilder());
+        file->endRow();
+        if (i % 2 == 1) {
+            file->writeRowGroup();
+        }
+    }
+
+    file->save();
+    BOOST_CHECK_EQUAL(filesIn(dir), 1);
+
+    auto table = readTable((dir / "flux.parquet").string());
+    auto expectedNames = columnNames(records[0].header(names));
+    auto expectedTypes = columnTypes(records[0]);
+    BOOST_REQUIRE_EQUAL(table->num_columns(), expectedNames.size());
+    BOOST_REQUIRE_EQUAL(table->num_rows(), records.size());
+    for (int c = 0; c < table->num_columns(); c++) {
+        BOOST_CHECK_EQUAL(table->field(c)->name(), expectedNames[c]);
+    }
+
+    for (size_t r = 0; r < records.size(); r++) {
+        auto expected = records[r].asVector();
+        for (int c = 0; c < table->num_columns(); c++) {
+            BOOST_TEST_CONTEXT("row " << r << " column " << expectedNames[c]) {
+                auto actual = cellAsString(*table->column(c)->chunk(0), r);
+                BOOST_REQUIRE_EQUAL(actual.has_value(), expected[c].has_value());
+                if (!actual.has_value()) {
+                    continue;
+                }
+
+                if (expectedTypes[c] == cbm::FlatColumnType::Text) {
+                    BOOST_CHECK_EQUAL(*actual, *expected[c]);
+                } else {
+                    BOOST_CHECK_CLOSE(std::stod(*actual), std::stod(*expected[c]), 1e-9);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(RejectsRecordWithMismatchedColumnType) {
+    cbm::FlatPoolRecord pool(2010, current, "FL", "20-29", "SoftwoodMerch", 42.5);
+    cbm::FlatErrorRecord error(2010, current, "CBMGrowthModule", "no growth curve", 3.0);
+
+    auto file = open("pools.parquet", pool);
+    pool.visitColumns(file->rowBuilder());
+    file->endRow();
+    BOOST_CHECK_THROW(error.visitColumns(file->rowBuilder()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(RejectsRecordWithTooFewColumns) {
+    cbm::FlatPoolRecord pool(2010, current, "FL", "20-29", "SoftwoodMerch", 42.5);
+
+    auto file = open("pools.parquet", pool);
+    file->rowBuilder().integer(2010);
+    BOOST_CHECK_THROW(file->endRow(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(RejectsRecordWithTooManyColumns) {
+    cbm::FlatErrorRecord error(2010, current, "CBMGrowthModule", "no growth curve", 3.0);
+
+    auto file = open("errors.parquet", error);
+    error.visitColumns(file->rowBuilder());
+    BOOST_CHECK_THROW(file->rowBuilder().number(1.0), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(UnsavedFileLeavesNothingBehind) {
+    cbm::FlatPoolRecord pool(2010, current, "FL", "20-29", "SoftwoodMerch", 42.5);
+    {
+        auto file = open("pools.parquet", pool);
+        pool.visitColumns(file->rowBuilder());
+        file->endRow();
+        file->writeRowGroup();
+        BOOST_CHECK_EQUAL(filesIn(dir), 1);
+    }
+
+    BOOST_CHECK_EQUAL(filesIn(dir), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
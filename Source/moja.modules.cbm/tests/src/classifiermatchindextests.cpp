@@ -0,0 +1,133 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/classifiermatchindex.h"
+
+#include <string>
+#include <vector>
+
+using namespace moja::modules;
+using cbm::ClassifierMatchIndex;
+using cbm::ClassifierMatchQuery;
+using cbm::ClassifierMatchRow;
+
+namespace {
+
+    // Growth curves 1-3: 1 is specific to BF on site class G, 2 accepts any species on
+    // site class G, 3 is specific to SW on any site class.
+    std::vector<ClassifierMatchRow> growthCurveRows() {
+        return {
+            { 1, "", "species", "BF" }, { 1, "", "site", "G" },
+            { 2, "", "species", "?" },  { 2, "", "site", "G" },
+            { 3, "", "species", "SW" }, { 3, "", "site", "?" }
+        };
+    }
+
+    ClassifierMatchQuery classifierSet(const std::string& species, const std::string& site) {
+        return { { "species", species }, { "site", site } };
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ClassifierMatchIndexTests);
+
+BOOST_AUTO_TEST_CASE(ExactValuesScoreHigherThanWildcards) {
+    ClassifierMatchIndex index;
+    index.initialize(growthCurveRows());
+    BOOST_CHECK_EQUAL(index.candidateCount(), 3);
+
+    auto bfGood = index.match(classifierSet("BF", "G"));
+    BOOST_REQUIRE_EQUAL(bfGood.size(), 1);
+    BOOST_CHECK_EQUAL(bfGood[0].second, 1);
+
+    auto pjGood = index.match(classifierSet("PJ", "G"));
+    BOOST_REQUIRE_EQUAL(pjGood.size(), 1);
+    BOOST_CHECK_EQUAL(pjGood[0].second, 2);
+
+    auto swPoor = index.match(classifierSet("SW", "P"));
+    BOOST_REQUIRE_EQUAL(swPoor.size(), 1);
+    BOOST_CHECK_EQUAL(swPoor[0].second, 3);
+}
+
+BOOST_AUTO_TEST_CASE(ValuesIgnoreCaseLikeTheQueryDid) {
+    ClassifierMatchIndex index;
+    index.initialize(growthCurveRows());
+
+    auto matches = index.match(classifierSet("bf", "g"));
+    BOOST_REQUIRE_EQUAL(matches.size(), 1);
+    BOOST_CHECK_EQUAL(matches[0].second, 1);
+}
+
+BOOST_AUTO_TEST_CASE(ClassifierNamesMatchExactlyLikeTheQueryDid) {
+    ClassifierMatchIndex index;
+    index.initialize({
+        { 1, "", "Species", "BF" }, { 1, "", "site", "G" },
+        { 2, "", "species", "?" },  { 2, "", "site", "G" }
+    });
+
+    // "Species" is not a classifier of the classifier set, so growth curve 1 mismatches it.
+    auto matches = index.match({ { "species", "BF" }, { "site", "G" } });
+    BOOST_REQUIRE_EQUAL(matches.size(), 1);
+    BOOST_CHECK_EQUAL(matches[0].second, 2);
+
+    matches = index.match({ { "Species", "BF" }, { "site", "G" } });
+    BOOST_REQUIRE_EQUAL(matches.size(), 1);
+    BOOST_CHECK_EQUAL(matches[0].second, 1);
+
+    BOOST_CHECK(index.match({ { "SPECIES", "BF" }, { "Site", "G" } }).empty());
+}
+
+BOOST_AUTO_TEST_CASE(AnyMismatchedOrMissingClassifierRulesOutACandidate) {
+    ClassifierMatchIndex index;
+    index.initialize(growthCurveRows());
+
+    BOOST_CHECK(index.match(classifierSet("PJ", "P")).empty());
+    BOOST_CHECK(index.match({ { "species", "BF" } }).empty());
+}
+
+BOOST_AUTO_TEST_CASE(TiesGoToTheLowestId) {
+    ClassifierMatchIndex index;
+    index.initialize({
+        { 7, "", "species", "BF" },
+        { 4, "", "species", "BF" },
+        { 9, "", "species", "BF" }
+    });
+
+    auto matches = index.match({ { "species", "BF" } });
+    BOOST_REQUIRE_EQUAL(matches.size(), 1);
+    BOOST_CHECK_EQUAL(matches[0].second, 4);
+}
+
+BOOST_AUTO_TEST_CASE(TransitionRulesAreRankedPerDisturbanceType) {
+    ClassifierMatchIndex index;
+    index.initialize({
+        { 10, "fire", "species", "?" },
+        { 11, "fire", "species", "BF" },
+        { 20, "harvest", "species", "SW" },
+        { 30, "insects", "species", "?" }, { 30, "insects", "site", "P" }
+    });
+
+    auto matches = index.match(classifierSet("BF", "G"));
+    BOOST_REQUIRE_EQUAL(matches.size(), 1);
+    BOOST_CHECK_EQUAL(matches[0].first, "fire");
+    BOOST_CHECK_EQUAL(matches[0].second, 11);
+
+    matches = index.match(classifierSet("SW", "P"));
+    BOOST_REQUIRE_EQUAL(matches.size(), 3);
+    BOOST_CHECK_EQUAL(matches[0].second, 10);
+    BOOST_CHECK_EQUAL(matches[1].second, 20);
+    BOOST_CHECK_EQUAL(matches[2].second, 30);
+}
+
+BOOST_AUTO_TEST_CASE(CachedMatchesAreSharedAndInitializeRunsOnce) {
+    ClassifierMatchIndex index;
+    index.initialize(growthCurveRows());
+    index.initialize({ { 99, "", "species", "BF" } });
+    BOOST_CHECK_EQUAL(index.candidateCount(), 3);
+
+    const auto& first = index.match(classifierSet("BF", "G"));
+    const auto& second = index.match(classifierSet("BF", "G"));
+    BOOST_CHECK_EQUAL(&first, &second);
+    BOOST_CHECK(&first != &index.match(classifierSet("BF", "P")));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,59 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/classifiersetinterner.h"
+#include "moja/modules/cbm/flatrecord.h"
+
+using namespace moja::modules;
+
+BOOST_AUTO_TEST_SUITE(ClassifierSetInternerTests);
+
+BOOST_AUTO_TEST_CASE(IdenticalSetsShareAnId) {
+    cbm::ClassifierSetInterner interner;
+    auto first = interner.intern({ std::string("AB"), std::string("BF") });
+    auto second = interner.intern({ std::string("AB"), std::string("BF") });
+
+    BOOST_CHECK(first == second);
+    BOOST_CHECK_EQUAL(first.id(), 1);
+    BOOST_CHECK_EQUAL(interner.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(DistinctSetsGetDistinctIds) {
+    cbm::ClassifierSetInterner interner;
+    auto first = interner.intern({ std::string("AB"), std::string("BF") });
+    auto second = interner.intern({ std::string("BF"), std::string("AB") });
+
+    BOOST_CHECK(first != second);
+    BOOST_CHECK_EQUAL(second.values()[0].value(), "BF");
+}
+
+BOOST_AUTO_TEST_CASE(NullValuesMatchEmptyStrings) {
+    cbm::ClassifierSetInterner interner;
+    auto first = interner.intern({ Poco::Nullable<std::string>(), std::string("BF") });
+    auto second = interner.intern({ std::string(""), std::string("BF") });
+
+    BOOST_CHECK(first == second);
+}
+
+BOOST_AUTO_TEST_CASE(ReusesPreviousSetWhenUnchanged) {
+    cbm::ClassifierSetInterner interner;
+    auto previous = interner.intern({ std::string("AB") });
+    auto current = interner.intern({ std::string("AB") }, previous);
+    auto changed = interner.intern({ std::string("SK") }, previous);
+
+    BOOST_CHECK(current == previous);
+    BOOST_CHECK(changed != previous);
+    BOOST_CHECK_EQUAL(interner.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(FlatRecordsExpandClassifiersWhenPersisted) {
+    cbm::ClassifierSetInterner interner;
+    auto cset = interner.intern({ std::string("AB"), Poco::Nullable<std::string>() });
+    cbm::FlatPoolRecord first(2010, cset, "FL", "0-19", "SoftwoodMerch", 1.0);
+    cbm::FlatPoolRecord second(2010, interner.intern({ std::string("AB"), std::string("") }), "FL", "0-19", "SoftwoodMerch", 2.0);
+
+    BOOST_CHECK(first == second);
+    BOOST_CHECK_EQUAL(first.hash(), second.hash());
+    BOOST_CHECK_EQUAL(first.asPersistable(), "2010,\"AB\",,FL,0-19,SoftwoodMerch,1\n");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
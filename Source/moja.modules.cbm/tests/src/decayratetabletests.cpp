@@ -0,0 +1,104 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/decayratetable.h"
+#include "moja/modules/cbm/pooldecayparameters.h"
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace moja::modules;
+
+namespace {
+
+    typedef std::map<std::string, double> DecayRates;
+
+    std::map<std::string, cbm::PoolDecayParameters> decayParameters() {
+        std::map<std::string, cbm::PoolDecayParameters> parameters;
+        double rate = 0.5;
+        for (auto name : {
+            "AboveGroundVeryFastSoil", "BelowGroundVeryFastSoil", "AboveGroundFastSoil", "BelowGroundFastSoil",
+            "MediumSoil", "SoftwoodStemSnag", "SoftwoodBranchSnag", "HardwoodStemSnag", "HardwoodBranchSnag",
+            "AboveGroundSlowSoil", "BelowGroundSlowSoil" }) {
+
+            cbm::PoolDecayParameters pool;
+            pool.pool = name;
+            pool.baseDecayRate = rate;
+            pool.maxDecayRate = 1.0;
+            pool.q10 = 2.65;
+            pool.tRef = 10.0;
+            pool.pAtm = 0.83;
+            parameters[name] = pool;
+            rate *= 0.6;
+        }
+
+        return parameters;
+    }
+
+    DecayRates computeRates(const std::map<std::string, cbm::PoolDecayParameters>& parameters, double mat) {
+        DecayRates rates;
+        for (const auto& pool : parameters) {
+            rates.emplace(pool.first, pool.second.getDecayRate(mat));
+        }
+
+        return rates;
+    }
+
+    // A mean annual temperature raster: many pixels, few distinct values.
+    std::vector<double> temperatureRaster(size_t pixels, int distinctValues) {
+        std::mt19937 generator(7);
+        std::uniform_int_distribution<int> value(0, distinctValues - 1);
+        std::vector<double> raster(pixels);
+        for (auto& mat : raster) {
+            mat = -5.0 + value(generator) * 0.25;
+        }
+
+        return raster;
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(DecayRateTableTests);
+
+BOOST_AUTO_TEST_CASE(RatesMatchDirectComputation) {
+    auto parameters = decayParameters();
+    cbm::DecayRateTable<DecayRates> table;
+    for (auto mat : temperatureRaster(1000, 40)) {
+        const auto& rates = table.get(mat, [&parameters](double t) { return computeRates(parameters, t); });
+        for (const auto& pool : parameters) {
+            // Exactly equal: the table stores the result of the same expression.
+            BOOST_CHECK_EQUAL(rates.at(pool.first), pool.second.getDecayRate(mat));
+        }
+    }
+
+    BOOST_CHECK_LE(table.size(), 40);
+}
+
+BOOST_AUTO_TEST_CASE(ComputesOncePerTemperature) {
+    int computed = 0;
+    cbm::DecayRateTable<double> table;
+    for (int step = 0; step < 3; step++) {
+        for (double mat : { -2.5, 0.0, 3.5 }) {
+            auto rate = table.get(mat, [&computed](double t) { computed++; return t * 2; });
+            BOOST_CHECK_EQUAL(rate, mat * 2);
+        }
+    }
+
+    BOOST_CHECK_EQUAL(computed, 3);
+
+    // Changed parameters: the owner clears the table and rates are computed again.
+    table.clear();
+    table.get(0.0, [&computed](double t) { computed++; return t; });
+    BOOST_CHECK_EQUAL(computed, 4);
+}
+
+BOOST_AUTO_TEST_CASE(SizeIsBounded) {
+    cbm::DecayRateTable<double> table(10);
+    for (int i = 0; i < 25; i++) {
+        BOOST_CHECK_EQUAL(table.get(i, [](double t) { return t + 1; }), i + 1.0);
+        BOOST_CHECK_LE(table.size(), 10);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
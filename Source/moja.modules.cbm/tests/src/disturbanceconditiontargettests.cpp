@@ -0,0 +1,70 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/disturbanceconditiontarget.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace moja::modules;
+using cbm::DisturbanceConditionTarget;
+using cbm::DisturbanceConditionType;
+using moja::DynamicVar;
+
+BOOST_AUTO_TEST_SUITE(DisturbanceConditionTargetTests);
+
+BOOST_AUTO_TEST_CASE(OrderedComparisonsAreNumeric) {
+    DisturbanceConditionTarget lessThan(DisturbanceConditionType::LessThan, DynamicVar(40));
+    BOOST_CHECK(lessThan.check(39.5));
+    BOOST_CHECK(!lessThan.check(40.0));
+    BOOST_CHECK(lessThan.check(DynamicVar(39)));
+
+    DisturbanceConditionTarget atLeast(DisturbanceConditionType::AtLeast, DynamicVar(12.5));
+    BOOST_CHECK(atLeast.check(12.5));
+    BOOST_CHECK(!atLeast.check(DynamicVar(12)));
+
+    DisturbanceConditionTarget between(DisturbanceConditionType::Between,
+                                       DynamicVar(std::vector<DynamicVar>{ DynamicVar(10), DynamicVar(20) }));
+    BOOST_CHECK(between.check(10.0));
+    BOOST_CHECK(between.check(DynamicVar(20)));
+    BOOST_CHECK(!between.check(20.5));
+}
+
+BOOST_AUTO_TEST_CASE(TextIsComparedAsText) {
+    DisturbanceConditionTarget species(DisturbanceConditionType::EqualTo, DynamicVar(std::string("BF")));
+    BOOST_CHECK(species.check(DynamicVar(std::string("BF"))));
+    BOOST_CHECK(!species.check(DynamicVar(std::string("SW"))));
+    BOOST_CHECK(!species.check(DynamicVar()));
+    BOOST_CHECK(!species.check(1.0));
+
+    DisturbanceConditionTarget code(DisturbanceConditionType::EqualTo, DynamicVar(1));
+    BOOST_CHECK(code.check(DynamicVar(std::string("1"))));
+    BOOST_CHECK(code.check(DynamicVar(1)));
+    BOOST_CHECK(!code.check(DynamicVar(2)));
+}
+
+BOOST_AUTO_TEST_CASE(InAndNotInLookUpEveryTarget) {
+    DynamicVar targets(std::vector<DynamicVar>{
+        DynamicVar(std::string("BF")), DynamicVar(std::string("SW")), DynamicVar(3) });
+
+    DisturbanceConditionTarget in(DisturbanceConditionType::In, targets);
+    BOOST_CHECK(in.check(DynamicVar(std::string("SW"))));
+    BOOST_CHECK(in.check(DynamicVar(3)));
+    BOOST_CHECK(in.check(DynamicVar(std::string("3"))));
+    BOOST_CHECK(!in.check(DynamicVar(std::string("PJ"))));
+    BOOST_CHECK(!in.check(DynamicVar()));
+
+    DisturbanceConditionTarget notIn(DisturbanceConditionType::NotIn, targets);
+    BOOST_CHECK(!notIn.check(DynamicVar(std::string("BF"))));
+    BOOST_CHECK(notIn.check(DynamicVar(std::string("PJ"))));
+    BOOST_CHECK(notIn.check(4.0));
+    BOOST_CHECK(notIn.check(DynamicVar()));
+}
+
+BOOST_AUTO_TEST_CASE(OrderedComparisonNeedsANumber) {
+    BOOST_CHECK_THROW(DisturbanceConditionTarget(DisturbanceConditionType::AtLeast, DynamicVar(std::string("old"))),
+                      std::invalid_argument);
+    BOOST_CHECK_NO_THROW(DisturbanceConditionTarget(DisturbanceConditionType::LessThan, DynamicVar(std::string("40"))));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,85 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/disturbanceeventqueue.h"
+
+#include <vector>
+
+using namespace moja::modules;
+
+namespace {
+
+    // Disturbance type ids of the events in parameter year, in the order they're returned.
+    std::vector<int> typesIn(cbm::DisturbanceEventQueue& queue, int year) {
+        std::vector<int> types;
+        auto events = queue.eventsIn(year);
+        for (auto it = events.first; it != events.second; ++it) {
+            types.push_back(it->disturbanceTypeId());
+        }
+
+        return types;
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(DisturbanceEventQueueTests);
+
+BOOST_AUTO_TEST_CASE(EventsAreSortedByYearThenOrder) {
+    cbm::DisturbanceEventQueue queue;
+    queue.push(cbm::CBMDistEventRef(1, 3, 2010, -1, 0, 0));
+    queue.push(cbm::CBMDistEventRef(2, 1, 2010, -1, 1, 0));
+    queue.push(cbm::CBMDistEventRef(3, 2, 2005, -1, 0, 1));
+    queue.push(cbm::CBMDistEventRef(4, 1, 2010, -1, 2, -1));
+    queue.sort();
+
+    std::vector<int> expected2005 = { 3 };
+    std::vector<int> expected2010 = { 2, 4, 1 };
+    auto types2005 = typesIn(queue, 2005);
+    auto types2010 = typesIn(queue, 2010);
+    BOOST_CHECK_EQUAL_COLLECTIONS(types2005.begin(), types2005.end(), expected2005.begin(), expected2005.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(types2010.begin(), types2010.end(), expected2010.begin(), expected2010.end());
+}
+
+BOOST_AUTO_TEST_CASE(CursorSkipsYearsWithoutEvents) {
+    cbm::DisturbanceEventQueue queue;
+    queue.push(cbm::CBMDistEventRef(1, 0, 2001, -1, 0, 0));
+    queue.push(cbm::CBMDistEventRef(2, 0, 2003, -1, 0, 1));
+    queue.push(cbm::CBMDistEventRef(3, 0, 2007, -1, 0, 2));
+    queue.sort();
+
+    BOOST_CHECK(typesIn(queue, 2000).empty());
+    BOOST_CHECK(typesIn(queue, 2002).empty());
+    BOOST_CHECK_EQUAL(typesIn(queue, 2003).size(), 1);
+    BOOST_CHECK_EQUAL(typesIn(queue, 2003).size(), 1);
+    BOOST_CHECK(typesIn(queue, 2006).empty());
+    BOOST_CHECK_EQUAL(typesIn(queue, 2007)[0], 3);
+    BOOST_CHECK(typesIn(queue, 2008).empty());
+}
+
+BOOST_AUTO_TEST_CASE(ChangesToEventsAreKept) {
+    cbm::DisturbanceEventQueue queue;
+    queue.push(cbm::CBMDistEventRef(1, 0, 2001, 7, 0, 0, 2, 3));
+    queue.sort();
+
+    auto events = queue.eventsIn(2001);
+    BOOST_REQUIRE(events.first != events.second);
+    BOOST_CHECK_EQUAL(events.first->transitionRuleId(), 7);
+    BOOST_CHECK_EQUAL(events.first->firstCondition(), 2);
+    BOOST_CHECK_EQUAL(events.first->conditionCount(), 3);
+    events.first->setDisturbanceTypeId(5);
+    BOOST_CHECK_EQUAL(typesIn(queue, 2001)[0], 5);
+}
+
+BOOST_AUTO_TEST_CASE(ClearResetsTheCursor) {
+    cbm::DisturbanceEventQueue queue;
+    queue.push(cbm::CBMDistEventRef(1, 0, 2010, -1, 0, 0));
+    queue.sort();
+    BOOST_CHECK(typesIn(queue, 2020).empty());
+
+    queue.clear();
+    BOOST_CHECK(queue.empty());
+    queue.push(cbm::CBMDistEventRef(2, 0, 2010, -1, 0, 0));
+    queue.sort();
+    BOOST_CHECK_EQUAL(typesIn(queue, 2010)[0], 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,123 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/disturbancematrixstore.h"
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace moja;
+using namespace moja::modules;
+
+namespace {
+
+    DynamicObject transfer(int dmId, const std::string& source, const std::string& sink, double proportion) {
+        return DynamicObject({
+            { "disturbance_matrix_id", dmId },
+            { "source_pool_name", source },
+            { "dest_pool_name", sink },
+            { "proportion", proportion }
+        });
+    }
+
+    std::unordered_map<std::string, int> poolIndices() {
+        return {
+            { "SoftwoodMerch", 0 },
+            { "SoftwoodFoliage", 1 },
+            { "MediumSoil", 2 },
+            { "Products", 3 },
+            { "CO2", 4 }
+        };
+    }
+
+    // Rows of two matrices, interleaved as they may come from the input database.
+    std::vector<DynamicObject> transfers() {
+        return {
+            transfer(7, "SoftwoodMerch", "Products", 0.85),
+            transfer(3, "SoftwoodFoliage", "CO2", 0.9),
+            transfer(7, "SoftwoodMerch", "MediumSoil", 0.15),
+            transfer(3, "SoftwoodFoliage", "SoftwoodFoliage", 0.1),
+            transfer(7, "SoftwoodFoliage", "MediumSoil", 1.0)
+        };
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(DisturbanceMatrixStoreTests);
+
+BOOST_AUTO_TEST_CASE(MatricesKeepTheirTransfersInOrder) {
+    cbm::DisturbanceMatrixStore store;
+    BOOST_CHECK(!store.isInitialized());
+    store.initialize(transfers(), poolIndices());
+
+    BOOST_CHECK(store.isInitialized());
+    BOOST_CHECK_EQUAL(store.matrixCount(), 2);
+    BOOST_CHECK_EQUAL(store.transferCount(), 5);
+
+    auto harvest = store.matrix(7);
+    BOOST_CHECK_EQUAL(harvest.id(), 7);
+    BOOST_REQUIRE_EQUAL(harvest.size(), 3);
+    BOOST_CHECK_EQUAL(harvest.sourcePool(0), 0);
+    BOOST_CHECK_EQUAL(harvest.sinkPool(0), 3);
+    BOOST_CHECK_EQUAL(harvest.proportion(0), 0.85);
+    BOOST_CHECK_EQUAL(harvest.sinkPool(1), 2);
+    BOOST_CHECK_EQUAL(harvest.proportion(1), 0.15);
+    BOOST_CHECK_EQUAL(harvest.sourcePool(2), 1);
+    BOOST_CHECK_EQUAL(harvest.proportion(2), 1.0);
+
+    auto fire = store.matrix(3);
+    BOOST_REQUIRE_EQUAL(fire.size(), 2);
+    BOOST_CHECK_EQUAL(fire.sinkPool(0), 4);
+    BOOST_CHECK_EQUAL(fire.sourcePool(1), fire.sinkPool(1));
+}
+
+BOOST_AUTO_TEST_CASE(UnknownMatrixIsEmpty) {
+    cbm::DisturbanceMatrixStore store;
+    store.initialize(transfers(), poolIndices());
+
+    BOOST_CHECK(store.contains(3));
+    BOOST_CHECK(!store.contains(42));
+    BOOST_CHECK(store.matrix(42).empty());
+    BOOST_CHECK_EQUAL(store.matrix(42).id(), -1);
+}
+
+BOOST_AUTO_TEST_CASE(UnknownPoolThrowsAndStoreCanBeRebuilt) {
+    cbm::DisturbanceMatrixStore store;
+    auto rows = transfers();
+    rows.push_back(transfer(9, "SoftwoodMerch", "NoSuchPool", 1.0));
+    BOOST_CHECK_THROW(store.initialize(rows, poolIndices()), std::invalid_argument);
+    BOOST_CHECK(!store.isInitialized());
+
+    store.initialize(transfers(), poolIndices());
+    BOOST_CHECK_EQUAL(store.matrixCount(), 2);
+    BOOST_CHECK_EQUAL(store.matrix(7).size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(BuiltOnceWhenInitializedFromManyThreads) {
+    cbm::DisturbanceMatrixStore store;
+    auto rows = transfers();
+    auto pools = poolIndices();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; i++) {
+        threads.emplace_back([&store, &rows, &pools, i]() {
+            // Later initializations are no-ops, so only the first set of rows counts.
+            auto threadRows = rows;
+            threadRows.resize(rows.size() - i % 2);
+            store.initialize(threadRows, pools);
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    BOOST_CHECK(store.isInitialized());
+    BOOST_CHECK_EQUAL(store.matrixCount(), 2);
+    auto size = store.matrix(7).size();
+    BOOST_CHECK(size == 3 || size == 2);
+    BOOST_CHECK_EQUAL(store.transferCount(), size + 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,144 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/classifiersetinterner.h"
+#include "moja/modules/cbm/flatrecord.h"
+#include "moja/modules/cbm/poolnametable.h"
+
+#include <boost/algorithm/string.hpp>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace moja::modules;
+
+namespace {
+
+    /**
+     * Records each visited column as its type and its value in the same text form as asVector().
+     */
+    class RecordingVisitor : public cbm::FlatRecordColumnVisitor {
+    public:
+        void integer(int value) override {
+            types.push_back(cbm::FlatColumnType::Integer);
+            values.push_back(std::to_string(value));
+        }
+
+        void number(double value) override {
+            types.push_back(cbm::FlatColumnType::Number);
+            values.push_back(std::to_string(value));
+        }
+
+        void text(const std::string& value) override {
+            types.push_back(cbm::FlatColumnType::Text);
+            values.push_back(value);
+        }
+
+        void null(cbm::FlatColumnType type) override {
+            types.push_back(type);
+            values.push_back(std::nullopt);
+        }
+
+        std::vector<cbm::FlatColumnType> types;
+        std::vector<std::optional<std::string>> values;
+    };
+
+    size_t headerColumnCount(const std::string& header) {
+        std::vector<std::string> columns;
+        boost::split(columns, boost::trim_copy(header), boost::is_any_of(","));
+        return columns.size();
+    }
+
+    template<class TRecord>
+    void checkVisitMatchesVector(const TRecord& record, const std::vector<std::string>& classifierNames) {
+        RecordingVisitor visitor;
+        record.visitColumns(visitor);
+        auto expected = record.asVector();
+
+        BOOST_REQUIRE_EQUAL(visitor.values.size(), headerColumnCount(record.header(classifierNames)));
+        BOOST_REQUIRE_EQUAL(visitor.values.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            BOOST_TEST_CONTEXT("column " << i) {
+                BOOST_REQUIRE_EQUAL(visitor.values[i].has_value(), expected[i].has_value());
+                if (!expected[i].has_value()) {
+                    continue;
+                }
+
+                if (visitor.types[i] == cbm::FlatColumnType::Text) {
+                    BOOST_CHECK_EQUAL(*visitor.values[i], *expected[i]);
+                } else {
+                    BOOST_CHECK_CLOSE(std::stod(*visitor.values[i]), std::stod(*expected[i]), 1e-9);
+                }
+            }
+        }
+    }
+
+    struct ClassifierFixture {
+        ClassifierFixture()
+            : names({ "admin", "eco", "species" }),
+              current(interner.intern({ std::string("AB"), Poco::Nullable<std::string>(), std::string("BF") })),
+              previous(interner.intern({ std::string("AB"), std::string("Boreal"), std::string("BS") })) {
+            pools.assign({ "SoftwoodMerch", "CO2" });
+        }
+
+        cbm::ClassifierSetInterner interner;
+        std::vector<std::string> names;
+        cbm::ClassifierSetRef current;
+        cbm::ClassifierSetRef previous;
+        cbm::PoolNameTable pools;
+    };
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(FlatRecordTests, ClassifierFixture);
+
+BOOST_AUTO_TEST_CASE(FluxRecordColumnsMatchVector) {
+    checkVisitMatchesVector(cbm::FlatFluxRecord(
+        2010, current, "FL", "20-29", previous, "FL", "10-19",
+        std::string("Fire"), 1, pools.ref(0), pools.ref(1), 12.375), names);
+}
+
+BOOST_AUTO_TEST_CASE(FluxRecordColumnsMatchVectorWithoutDisturbance) {
+    checkVisitMatchesVector(cbm::FlatFluxRecord(
+        2010, current, "FL", "20-29", previous, "FL", "10-19",
+        Poco::Nullable<std::string>(), Poco::Nullable<int>(), pools.ref(0), pools.ref(1), 0.125), names);
+}
+
+BOOST_AUTO_TEST_CASE(PoolRecordColumnsMatchVector) {
+    checkVisitMatchesVector(cbm::FlatPoolRecord(2010, current, "FL", "20-29", pools.ref(0), 42.5), names);
+}
+
+BOOST_AUTO_TEST_CASE(ErrorRecordColumnsMatchVector) {
+    checkVisitMatchesVector(cbm::FlatErrorRecord(2010, current, "CBMGrowthModule", "no growth curve", 3.0), names);
+}
+
+BOOST_AUTO_TEST_CASE(AgeAreaRecordColumnsMatchVector) {
+    std::string landClass = "FL";
+    std::string ageClass = "20-29";
+    checkVisitMatchesVector(cbm::FlatAgeAreaRecord(2010, current, landClass, ageClass, 7.25), names);
+}
+
+BOOST_AUTO_TEST_CASE(DisturbanceRecordColumnsMatchVector) {
+    checkVisitMatchesVector(cbm::FlatDisturbanceRecord(
+        2010, current, "FL", "20-29", previous, "FL", "10-19", "Fire", 1, 5.5), names);
+}
+
+BOOST_AUTO_TEST_CASE(PoolRecordsAreKeyedOnPoolIndex) {
+    cbm::FlatPoolRecord merch(2010, current, "FL", "20-29", pools.ref(0), 1.0);
+    cbm::FlatPoolRecord sameMerch(2010, current, "FL", "20-29", pools.ref(0), 2.0);
+    cbm::FlatPoolRecord co2(2010, current, "FL", "20-29", pools.ref(1), 1.0);
+
+    BOOST_CHECK(merch == sameMerch);
+    BOOST_CHECK_EQUAL(merch.hash(), sameMerch.hash());
+    BOOST_CHECK(!(merch == co2));
+    BOOST_CHECK_EQUAL(*co2.asVector()[6], "CO2");
+}
+
+BOOST_AUTO_TEST_CASE(PoolNamesMustAgreeBetweenLocalDomains) {
+    const std::string* name = &pools.ref(0).name();
+    pools.assign({ "SoftwoodMerch", "CO2" });
+    BOOST_CHECK_EQUAL(&pools.ref(0).name(), name);
+    BOOST_CHECK_THROW(pools.assign({ "CO2", "SoftwoodMerch" }), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
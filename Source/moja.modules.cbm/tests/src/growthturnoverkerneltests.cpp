@@ -0,0 +1,144 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/growthturnoverkernel.h"
+
+#include <random>
+#include <vector>
+
+using namespace moja::modules;
+using cbm::GrowthPool;
+using moja::DynamicObject;
+
+namespace {
+
+    typedef std::vector<cbm::GrowthTransfer> Operation;
+
+    cbm::TurnoverRates turnoverRates() {
+        return cbm::TurnoverRates(DynamicObject({
+            { "sw_foliage_turnover", 0.1 }, { "sw_stem_turnover", 0.0067 }, { "sw_branch_turnover", 0.04 },
+            { "sw_stem_snag_turnover", 0.032 }, { "sw_branch_snag_turnover", 0.1 },
+            { "sw_coarse_root_turnover", 0.02 }, { "sw_fine_root_turnover", 0.641 },
+            { "sw_other_to_branch_snag_split", 0.25 }, { "sw_coarse_root_split", 0.5 },
+            { "sw_fine_root_ag_split", 0.5 },
+            { "hw_foliage_turnover", 0.95 }, { "hw_stem_turnover", 0.0067 }, { "hw_branch_turnover", 0.04 },
+            { "hw_stem_snag_turnover", 0.032 }, { "hw_branch_snag_turnover", 0.1 },
+            { "hw_coarse_root_turnover", 0.02 }, { "hw_fine_root_turnover", 0.641 },
+            { "hw_other_to_branch_snag_split", 0.25 }, { "hw_coarse_root_split", 0.5 },
+            { "hw_fine_root_ag_split", 0.5 }
+        }));
+    }
+
+    void applyTransfers(const Operation& operation, std::vector<double>& pools) {
+        for (const auto& transfer : operation) {
+            pools[int(transfer.source)] -= transfer.value;
+            pools[int(transfer.sink)] += transfer.value;
+        }
+    }
+
+    /**
+     * Run a step as separate operations, built by the GrowthTurnoverKernel functions YieldTableGrowthModule
+     * also submits on their own in the spinup delay, then as the fused one, and check they agree exactly. Snag turnover uses the snags at the start of the step; mid-season growth
+     * and biomass turnover the biomass after the first half of the increment.
+     */
+    void checkStep(const cbm::StandBiomassCarbonIncrements& increments, const std::vector<double>& start) {
+        auto rates = turnoverRates();
+
+        std::vector<double> expected = start;
+        Operation reference;
+        Operation halfGrowth;
+        cbm::GrowthTurnoverKernel::addHalfGrowth(halfGrowth, increments, rates);
+        applyTransfers(halfGrowth, expected);
+        reference.insert(reference.end(), halfGrowth.begin(), halfGrowth.end());
+
+        Operation midSeasonGrowth, snagTurnover, biomassTurnover;
+        cbm::GrowthTurnoverKernel::addMidSeasonGrowth(midSeasonGrowth, rates, expected.data());
+        cbm::GrowthTurnoverKernel::addSnagTurnover(snagTurnover, rates, start.data());
+        cbm::GrowthTurnoverKernel::addBiomassTurnover(biomassTurnover, rates, expected.data());
+        for (const auto& operation : { midSeasonGrowth, snagTurnover, biomassTurnover, halfGrowth }) {
+            reference.insert(reference.end(), operation.begin(), operation.end());
+            applyTransfers(operation, expected);
+        }
+
+        cbm::GrowthTurnoverKernel kernel;
+        std::vector<double> actual = start;
+        const auto& transfers = kernel.build(increments, rates, start.data());
+        applyTransfers(transfers, actual);
+
+        BOOST_REQUIRE_EQUAL(transfers.size(), reference.size());
+        for (size_t i = 0; i < reference.size(); i++) {
+            BOOST_CHECK(transfers[i].source == reference[i].source);
+            BOOST_CHECK(transfers[i].sink == reference[i].sink);
+            BOOST_CHECK_EQUAL(transfers[i].value, reference[i].value);
+        }
+
+        for (int p = 0; p < cbm::GrowthTurnoverKernel::PoolCount; p++) {
+            BOOST_CHECK_EQUAL(actual[p], expected[p]);
+        }
+    }
+
+    std::vector<double> randomPools(std::mt19937& generator) {
+        std::uniform_real_distribution<double> value(0.0, 80.0);
+        std::vector<double> pools(cbm::GrowthTurnoverKernel::PoolCount);
+        for (auto& pool : pools) {
+            pool = value(generator);
+        }
+
+        return pools;
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(GrowthTurnoverKernelTests);
+
+BOOST_AUTO_TEST_CASE(GrowingStandMatchesSeparateOperations) {
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> increment(0.0, 2.0);
+    for (int i = 0; i < 20; i++) {
+        cbm::StandBiomassCarbonIncrements increments;
+        increments.softwood = { increment(generator), increment(generator), increment(generator),
+                                increment(generator), increment(generator) };
+        increments.hardwood = { increment(generator), increment(generator), increment(generator),
+                                increment(generator), increment(generator) };
+        checkStep(increments, randomPools(generator));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(OvermatureStandMatchesSeparateOperations) {
+    std::mt19937 generator(12);
+    std::uniform_real_distribution<double> increment(-2.0, 0.5);
+    for (int i = 0; i < 20; i++) {
+        cbm::StandBiomassCarbonIncrements increments;
+        increments.softwood = { increment(generator), increment(generator), increment(generator),
+                                increment(generator), increment(generator) };
+        increments.hardwood = { -1.0, -0.5, 0.2, -0.3, -0.1 };
+        checkStep(increments, randomPools(generator));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GrowingStandMovesTheExpectedCarbon) {
+    cbm::StandBiomassCarbonIncrements increments;
+    increments.softwood = { 2.0, 0.0, 0.0, 0.0, 0.0 };
+    increments.hardwood = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+    std::vector<double> pools(cbm::GrowthTurnoverKernel::PoolCount, 0.0);
+    pools[int(GrowthPool::SoftwoodMerch)] = 100.0;
+    pools[int(GrowthPool::SoftwoodStemSnag)] = 10.0;
+
+    cbm::GrowthTurnoverKernel kernel;
+    std::vector<double> actual = pools;
+    applyTransfers(kernel.build(increments, turnoverRates(), pools.data()), actual);
+
+    // Merch turned over during the season regrows; the stem snag gains it and loses its own turnover.
+    BOOST_CHECK_CLOSE(actual[int(GrowthPool::SoftwoodMerch)], 102.0, 1e-9);
+    BOOST_CHECK_CLOSE(actual[int(GrowthPool::SoftwoodStemSnag)], 10.0 + 101.0 * 0.0067 - 10.0 * 0.032, 1e-9);
+    BOOST_CHECK_CLOSE(actual[int(GrowthPool::MediumSoil)], 10.0 * 0.032, 1e-9);
+    BOOST_CHECK_CLOSE(actual[int(GrowthPool::Atmosphere)], -2.0 - 101.0 * 0.0067, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(PoolNamesMatchThePoolCollection) {
+    BOOST_CHECK_EQUAL(cbm::growthPoolName(GrowthPool::SoftwoodMerch), "SoftwoodMerch");
+    BOOST_CHECK_EQUAL(cbm::growthPoolName(GrowthPool::HardwoodBranchSnag), "HardwoodBranchSnag");
+    BOOST_CHECK_EQUAL(cbm::growthPoolName(GrowthPool::MediumSoil), "MediumSoil");
+    BOOST_CHECK_EQUAL(cbm::growthPoolName(GrowthPool::Atmosphere), "Atmosphere");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,264 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/landunittrace.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace moja::modules;
+using moja::DynamicObject;
+using moja::DynamicVar;
+
+namespace {
+
+    std::string signature(const std::vector<DynamicVar>& values) {
+        std::string signature;
+        for (const auto& value : values) {
+            cbm::appendSignature(signature, value);
+        }
+
+        return signature;
+    }
+
+    typedef std::map<std::string, DynamicVar> LandUnitInputs;
+
+    // A land unit's signature from the values of the store's inputs that it has, as CBMAggregatorLandUnitData builds it.
+    std::string signature(const cbm::LandUnitTraceStore& store, const LandUnitInputs& inputs) {
+        std::string signature;
+        for (const auto& name : store.inputs()) {
+            auto input = inputs.find(name);
+            if (input != inputs.end()) {
+                cbm::appendSignature(signature, input->second);
+            }
+        }
+
+        return signature;
+    }
+
+    // A toy stand, per unit area: growth slows with age, decay follows the mean annual temperature
+    // and a fire in the events layer moves the biomass to the atmosphere.
+    std::vector<cbm::LandUnitStep> simulate(const LandUnitInputs& inputs, int years) {
+        int age = inputs.at("initial_age").convert<int>();
+        double mat = inputs.at("mean_annual_temperature").convert<double>();
+        int fireYear = inputs.at("fire_layer").extract<DynamicObject>()["year"].convert<int>();
+
+        std::vector<cbm::LandUnitStep> steps;
+        std::vector<double> pools = { 1.0, age * 0.5, 0.0 };
+        for (int year = 0; year <= years; year++) {
+            cbm::LandUnitStep step;
+            step.isSpinup = year == 0;
+            step.date = cbm::DateRecord(year, 2000 + year, 1, 1, 1.0, 1.0);
+            step.age = age;
+            step.operations.push_back(cbm::TracedOperation{ cbm::ModuleInfoRecord(1, 1, 1, 1, "Toy"), {} });
+            if (year > 0) {
+                double growth = 10.0 / (1.0 + age);
+                double decay = pools[1] * 0.01 * (1.0 + mat / 10.0);
+                pools[1] += growth - decay;
+                pools[2] += decay;
+                step.fluxes.push_back(cbm::TracedFlux{ 0, 0, 1, growth });
+                step.fluxes.push_back(cbm::TracedFlux{ 0, 1, 2, decay });
+                if (year == fireYear) {
+                    step.fluxes.push_back(cbm::TracedFlux{ 0, 1, 2, pools[1] });
+                    pools[2] += pools[1];
+                    pools[1] = 0.0;
+                    age = 0;
+                }
+
+                age++;
+            }
+
+            step.pools = pools;
+            steps.push_back(step);
+        }
+
+        return steps;
+    }
+
+    // Area-weighted totals of the recorded pools, fluxes and age areas by year, as the aggregator records them.
+    struct Totals {
+        std::map<std::pair<int, int>, double> pools;
+        std::map<std::tuple<int, int, int>, double> fluxes;
+        std::map<std::pair<int, int>, double> ageArea;
+
+        void record(int year, const cbm::LandUnitStep& step, double area) {
+            for (size_t i = 0; i < step.pools.size(); i++) {
+                pools[{ year, int(i) }] += step.pools[i] * area;
+            }
+
+            for (const auto& flux : step.fluxes) {
+                fluxes[std::make_tuple(year, flux.source, flux.sink)] += flux.value * area;
+            }
+
+            ageArea[{ year, step.age }] += area;
+        }
+    };
+
+    std::vector<std::pair<LandUnitInputs, double>> landUnits() {
+        std::vector<std::pair<LandUnitInputs, double>> landUnits;
+        for (int i = 0; i < 200; i++) {
+            LandUnitInputs inputs;
+            inputs["initial_classifier_set"] = DynamicObject({ { "species", std::string(i % 2 == 0 ? "BF" : "BS") } });
+            inputs["initial_age"] = 10 * (i % 3);
+            inputs["mean_annual_temperature"] = i % 5 == 0 ? -1.5 : 2.25;
+            inputs["fire_layer"] = DynamicObject({ { "year", i % 7 == 0 ? 5 : -1 } });
+
+            // A handful of land units are unique, the rest come in groups with the same inputs.
+            if (i % 50 == 0) {
+                inputs["initial_age"] = 100 + i;
+            }
+
+            landUnits.push_back({ inputs, 0.5 + (i % 4) * 0.25 });
+        }
+
+        return landUnits;
+    }
+
+    // Run the land units through parameter store the way CBMAggregatorLandUnitData does: replay a trace
+    // if there is one, otherwise simulate the land unit and trace it if the store says so.
+    Totals runDeduplicated(cbm::LandUnitTraceStore& store, int& simulated) {
+        Totals totals;
+        simulated = 0;
+        for (const auto& landUnit : landUnits()) {
+            auto landUnitSignature = signature(store, landUnit.first);
+            auto trace = store.find(landUnitSignature);
+            if (trace != nullptr) {
+                for (size_t year = 0; year < trace->steps.size(); year++) {
+                    totals.record(int(year), trace->steps[year], landUnit.second);
+                }
+
+                continue;
+            }
+
+            bool tracing = store.shouldTrace(landUnitSignature);
+            auto steps = simulate(landUnit.first, 10);
+            simulated++;
+            for (size_t year = 0; year < steps.size(); year++) {
+                totals.record(int(year), steps[year], landUnit.second);
+            }
+
+            if (tracing) {
+                auto newTrace = std::make_shared<cbm::LandUnitTrace>();
+                newTrace->steps = steps;
+                store.insert(landUnitSignature, newTrace);
+            }
+        }
+
+        return totals;
+    }
+
+    template<class TKey>
+    void checkEqual(const std::map<TKey, double>& expected, const std::map<TKey, double>& actual) {
+        BOOST_REQUIRE_EQUAL(expected.size(), actual.size());
+        for (const auto& value : expected) {
+            auto other = actual.find(value.first);
+            BOOST_REQUIRE(other != actual.end());
+            BOOST_CHECK_EQUAL(value.second, other->second);
+        }
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(LandUnitTraceTests);
+
+BOOST_AUTO_TEST_CASE(EqualInputsHaveEqualSignatures) {
+    DynamicObject classifierSet({ { "species", std::string("BF") }, { "site", std::string("G") } });
+    std::vector<DynamicObject> events = { DynamicObject({ { "year", 2005 }, { "disturbance_type", std::string("Fire") } }) };
+
+    auto first = signature({ DynamicVar(classifierSet), DynamicVar(42), DynamicVar(-1.25), DynamicVar(events), DynamicVar() });
+    auto second = signature({ DynamicVar(classifierSet), DynamicVar(42), DynamicVar(-1.25), DynamicVar(events), DynamicVar() });
+    BOOST_CHECK_EQUAL(first, second);
+}
+
+BOOST_AUTO_TEST_CASE(DifferentInputsHaveDifferentSignatures) {
+    BOOST_CHECK_NE(signature({ DynamicVar(0.1) }), signature({ DynamicVar(0.1 + 1e-16) }));
+    BOOST_CHECK_NE(signature({ DynamicVar(1) }), signature({ DynamicVar(std::string("1")) }));
+    BOOST_CHECK_NE(signature({ DynamicVar() }), signature({ DynamicVar(std::string("")) }));
+
+    // Strings are length-prefixed, so values can't run into each other.
+    BOOST_CHECK_NE(signature({ DynamicVar(std::string("a;sb")), DynamicVar(std::string("c")) }),
+                   signature({ DynamicVar(std::string("a")), DynamicVar(std::string("b;sc")) }));
+
+    std::vector<DynamicObject> fire = { DynamicObject({ { "year", 2005 }, { "disturbance_type", std::string("Fire") } }) };
+    std::vector<DynamicObject> laterFire = { DynamicObject({ { "year", 2006 }, { "disturbance_type", std::string("Fire") } }) };
+    BOOST_CHECK_NE(signature({ DynamicVar(fire) }), signature({ DynamicVar(laterFire) }));
+}
+
+BOOST_AUTO_TEST_CASE(InputsIncludeTheCBMInputsAndAddedLayers) {
+    cbm::LandUnitTraceStore store;
+    auto inputs = store.inputs();
+    BOOST_CHECK(std::find(inputs.begin(), inputs.end(), "initial_classifier_set") != inputs.end());
+    BOOST_CHECK(std::find(inputs.begin(), inputs.end(), "mean_annual_temperature") != inputs.end());
+
+    store.addInputs({ "fire_layer", "harvest_layer" });
+    store.addInputs({ "fire_layer" });
+    auto withLayers = store.inputs();
+    BOOST_CHECK_EQUAL(withLayers.size(), inputs.size() + 2);
+    BOOST_CHECK_EQUAL(std::count(withLayers.begin(), withLayers.end(), "fire_layer"), 1);
+}
+
+BOOST_AUTO_TEST_CASE(LandUnitsAreTracedOnceTheirSignatureIsSeenAgain) {
+    cbm::LandUnitTraceStore store;
+    BOOST_CHECK(!store.shouldTrace("a"));
+    BOOST_CHECK(!store.shouldTrace("b"));
+    BOOST_CHECK(store.shouldTrace("a"));
+
+    auto trace = std::make_shared<cbm::LandUnitTrace>();
+    BOOST_CHECK(store.insert("a", trace));
+    BOOST_CHECK(!store.insert("a", std::make_shared<cbm::LandUnitTrace>()));
+    BOOST_CHECK(store.find("a") == trace);
+    BOOST_CHECK(store.find("b") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(TraceStoreIsBounded) {
+    cbm::LandUnitTraceStore store(2, 3);
+    for (auto name : { "a", "b", "c", "d" }) {
+        store.shouldTrace(name);
+    }
+
+    // "d" didn't fit in the seen signatures, so it is never traced.
+    BOOST_CHECK(!store.shouldTrace("d"));
+    BOOST_CHECK(store.shouldTrace("a"));
+    BOOST_CHECK(store.insert("a", std::make_shared<cbm::LandUnitTrace>()));
+    BOOST_CHECK(store.insert("b", std::make_shared<cbm::LandUnitTrace>()));
+
+    // Full: nothing more is traced or kept.
+    BOOST_CHECK(!store.shouldTrace("c"));
+    BOOST_CHECK(!store.insert("c", std::make_shared<cbm::LandUnitTrace>()));
+    BOOST_CHECK_EQUAL(store.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(ReplayedLandUnitsMatchSimulatedLandUnits) {
+    Totals expected;
+    for (const auto& landUnit : landUnits()) {
+        auto steps = simulate(landUnit.first, 10);
+        for (size_t year = 0; year < steps.size(); year++) {
+            expected.record(int(year), steps[year], landUnit.second);
+        }
+    }
+
+    for (size_t maxTraces : { size_t(10000), size_t(3) }) {
+        cbm::LandUnitTraceStore store(maxTraces);
+        store.addInputs({ "fire_layer" });
+        int simulated = 0;
+        auto totals = runDeduplicated(store, simulated);
+
+        checkEqual(expected.pools, totals.pools);
+        checkEqual(expected.fluxes, totals.fluxes);
+        checkEqual(expected.ageArea, totals.ageArea);
+        BOOST_CHECK_LE(store.size(), maxTraces);
+        BOOST_CHECK_LT(simulated, 200);
+    }
+
+    // Without the disturbance layer among the inputs, burned and unburned land units share traces.
+    cbm::LandUnitTraceStore withoutLayers;
+    int simulated = 0;
+    auto totals = runDeduplicated(withoutLayers, simulated);
+    BOOST_CHECK(totals.pools != expected.pools);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
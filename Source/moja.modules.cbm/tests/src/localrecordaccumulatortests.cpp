@@ -0,0 +1,100 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/localrecordaccumulator.h"
+#include "moja/modules/cbm/record.h"
+#include "moja/flint/recordaccumulatorwithmutex.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace moja;
+using namespace moja::modules;
+
+namespace {
+
+    const int kDistinctKeys = 5000;
+
+    cbm::FluxRecord makeFlux(int i) {
+        auto key = i % kDistinctKeys;
+        return cbm::FluxRecord(key, 1, Poco::Nullable<Int64>(), key % 23, key % 29, 1.0);
+    }
+
+    double sumFluxes(const std::vector<cbm::FluxRow>& rows) {
+        double total = 0.0;
+        for (const auto& row : rows) {
+            total += row.get<6>();
+        }
+
+        return total;
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(LocalRecordAccumulatorTests);
+
+BOOST_AUTO_TEST_CASE(KeysStartFromOne) {
+    cbm::LocalRecordAccumulator<cbm::LandClassRecord> accumulator;
+    auto stored = accumulator.accumulate(cbm::LandClassRecord("FL"));
+    BOOST_CHECK_EQUAL(stored->getId(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(MergesExistingRecords) {
+    cbm::LocalRecordAccumulator<cbm::PoolRecord> accumulator;
+    accumulator.accumulate(cbm::PoolRecord(1, 2, 1.5));
+    auto stored = accumulator.accumulate(cbm::PoolRecord(1, 2, 2.5));
+
+    BOOST_CHECK_EQUAL(accumulator.size(), 1);
+    BOOST_CHECK_EQUAL(stored->getId(), 1);
+    BOOST_CHECK_CLOSE(std::get<3>(stored->asTuple()), 4.0, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(RecordsByIdFollowInsertionOrder) {
+    cbm::LocalRecordAccumulator<cbm::LandClassRecord> accumulator;
+    for (const auto& name : { "FL", "CL", "GL", "FL", "WL" }) {
+        accumulator.accumulate(cbm::LandClassRecord(name));
+    }
+
+    auto ordered = accumulator.recordsById();
+    BOOST_REQUIRE_EQUAL(ordered.size(), 4);
+    for (Int64 i = 0; i < 4; i++) {
+        BOOST_CHECK_EQUAL(ordered[i]->getId(), i + 1);
+    }
+
+    BOOST_CHECK_EQUAL(std::get<1>(ordered[3]->asTuple()), "WL");
+}
+
+BOOST_AUTO_TEST_CASE(ShardedAccumulationMatchesSharedAccumulator) {
+    const unsigned threadCount = 4;
+    const int recordsPerThread = 2000;
+
+    flint::RecordAccumulatorWithMutex2<cbm::FluxRow, cbm::FluxRecord> shared;
+    flint::RecordAccumulatorWithMutex2<cbm::FluxRow, cbm::FluxRecord> merged;
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threadCount; t++) {
+        workers.emplace_back([&shared, &merged]() {
+            cbm::LocalRecordAccumulator<cbm::FluxRecord> local;
+            for (int i = 0; i < recordsPerThread; i++) {
+                shared.accumulate(makeFlux(i));
+                local.accumulate(makeFlux(i));
+            }
+
+            for (const auto record : local.recordsById()) {
+                merged.accumulate(*record);
+            }
+        });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    auto sharedRows = shared.getPersistableCollection();
+    auto mergedRows = merged.getPersistableCollection();
+    BOOST_CHECK_EQUAL(sharedRows.size(), std::min(recordsPerThread, kDistinctKeys));
+    BOOST_CHECK_EQUAL(sharedRows.size(), mergedRows.size());
+    BOOST_CHECK_CLOSE(sumFluxes(sharedRows), threadCount * recordsPerThread * 1.0, 1e-9);
+    BOOST_CHECK_CLOSE(sumFluxes(sharedRows), sumFluxes(mergedRows), 1e-9);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
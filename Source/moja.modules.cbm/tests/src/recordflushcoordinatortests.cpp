@@ -0,0 +1,174 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/recordflushcoordinator.h"
+#include "moja/modules/cbm/localrecordaccumulator.h"
+#include "moja/modules/cbm/record.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace moja;
+using namespace moja::modules;
+
+BOOST_AUTO_TEST_SUITE(RecordFlushCoordinatorTests);
+
+BOOST_AUTO_TEST_CASE(DisabledByDefault) {
+    cbm::RecordFlushCoordinator coordinator;
+    int flushes = 0;
+    coordinator.addFlushHandler([&flushes]() { flushes++; }, []() {});
+
+    for (int i = 0; i < 100; i++) {
+        coordinator.withAccumulationLock([&coordinator]() {
+            coordinator.recordAccumulated<cbm::PoolRecord>(1000);
+        });
+    }
+
+    BOOST_CHECK(!coordinator.isEnabled());
+    BOOST_CHECK_EQUAL(flushes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(FlushesOnceRecordCountReached) {
+    cbm::RecordFlushCoordinator coordinator;
+    coordinator.configure(10, 0);
+
+    std::vector<std::string> calls;
+    coordinator.addFlushHandler([&calls]() { calls.push_back("flush"); }, [&calls]() { calls.push_back("clear"); });
+
+    for (int i = 0; i < 3; i++) {
+        coordinator.withAccumulationLock([&coordinator]() {
+            coordinator.recordAccumulated<cbm::PoolRecord>(4);
+        });
+    }
+
+    // 12 records pending, but the flush only happens at the start of the next step.
+    BOOST_CHECK(calls.empty());
+
+    coordinator.withAccumulationLock([]() {});
+    BOOST_REQUIRE_EQUAL(calls.size(), 2);
+    BOOST_CHECK_EQUAL(calls[0], "flush");
+    BOOST_CHECK_EQUAL(calls[1], "clear");
+
+    coordinator.withAccumulationLock([]() {});
+    BOOST_CHECK_EQUAL(calls.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(FlushesOnceMemoryThresholdReached) {
+    cbm::RecordFlushCoordinator coordinator;
+    auto recordSize = sizeof(cbm::FluxRecord) + cbm::RecordFlushCoordinator::RecordOverheadBytes;
+    coordinator.configure(0, recordSize * 100);
+
+    int flushes = 0;
+    coordinator.addFlushHandler([&flushes]() { flushes++; }, []() {});
+
+    coordinator.withAccumulationLock([&coordinator]() {
+        coordinator.recordAccumulated<cbm::FluxRecord>(99);
+    });
+
+    coordinator.flushIfRequired();
+    BOOST_CHECK_EQUAL(flushes, 0);
+
+    coordinator.recordAccumulated<cbm::FluxRecord>(1);
+    coordinator.flushIfRequired();
+    BOOST_CHECK_EQUAL(flushes, 1);
+}
+
+BOOST_AUTO_TEST_CASE(CountsOnlyNewRecords) {
+    cbm::RecordFlushCoordinator coordinator;
+    coordinator.configure(3, 0);
+
+    int flushes = 0;
+    coordinator.addFlushHandler([&flushes]() { flushes++; }, []() {});
+
+    // Ten steps of the same two pools merge into two records.
+    cbm::LocalRecordAccumulator<cbm::PoolRecord> pools;
+    for (int step = 0; step < 10; step++) {
+        coordinator.withAccumulationLock([&]() {
+            coordinator.accumulate(pools, cbm::PoolRecord(1, 1, 1.0));
+            coordinator.accumulate(pools, cbm::PoolRecord(1, 2, 1.0));
+        });
+    }
+
+    BOOST_CHECK_EQUAL(pools.size(), 2);
+    BOOST_CHECK_EQUAL(flushes, 0);
+
+    coordinator.withAccumulationLock([&]() {
+        coordinator.accumulate(pools, cbm::PoolRecord(2, 1, 1.0));
+    });
+
+    coordinator.flushIfRequired();
+    BOOST_CHECK_EQUAL(flushes, 1);
+}
+
+BOOST_AUTO_TEST_CASE(IdOffsetsStartAtZero) {
+    cbm::RecordFlushCoordinator coordinator;
+    BOOST_CHECK_EQUAL(coordinator.idOffset(cbm::RecordFlushCoordinator::ReleasedDimension::Location), 0);
+    BOOST_CHECK_EQUAL(coordinator.idOffset(cbm::RecordFlushCoordinator::ReleasedDimension::Disturbance), 0);
+
+    coordinator.setIdOffset(cbm::RecordFlushCoordinator::ReleasedDimension::Location, 120);
+    BOOST_CHECK_EQUAL(coordinator.idOffset(cbm::RecordFlushCoordinator::ReleasedDimension::Location), 120);
+    BOOST_CHECK_EQUAL(coordinator.idOffset(cbm::RecordFlushCoordinator::ReleasedDimension::Disturbance), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ReleasedRowsKeepTheIdTheyWereFirstGiven) {
+    typedef cbm::RecordFlushCoordinator::ReleasedDimension ReleasedDimension;
+    cbm::RecordFlushCoordinator coordinator;
+    auto first = std::make_tuple(Int64(1), Int64(1), Int64(1), Int64(-1));
+    auto second = std::make_tuple(Int64(2), Int64(1), Int64(1), Int64(3));
+
+    // Without streaming nothing is released, so every Id is its own.
+    BOOST_CHECK_EQUAL(coordinator.stableId(ReleasedDimension::Location, first, 7), 7);
+    BOOST_CHECK_EQUAL(coordinator.stableId(ReleasedDimension::Location, first, 8), 8);
+
+    coordinator.configure(10, 0);
+    BOOST_CHECK_EQUAL(coordinator.stableId(ReleasedDimension::Location, first, 1), 1);
+    BOOST_CHECK_EQUAL(coordinator.stableId(ReleasedDimension::Location, second, 2), 2);
+
+    // The next batch numbers its rows past the offset; rows seen before keep their Id.
+    BOOST_CHECK_EQUAL(coordinator.stableId(ReleasedDimension::Location, second, 3), 2);
+    BOOST_CHECK_EQUAL(coordinator.stableId(ReleasedDimension::Location, first, 4), 1);
+    BOOST_CHECK_EQUAL(coordinator.stableId(ReleasedDimension::Location, std::make_tuple(Int64(3), Int64(1), Int64(1), Int64(-1)), 5), 5);
+
+    // Dimensions are numbered independently.
+    BOOST_CHECK_EQUAL(coordinator.stableId(ReleasedDimension::Disturbance, first, 1), 1);
+    BOOST_CHECK_EQUAL(coordinator.stableId(ReleasedDimension::Disturbance, first, 2), 1);
+}
+
+BOOST_AUTO_TEST_CASE(FlushNeverOverlapsAccumulation) {
+    cbm::RecordFlushCoordinator coordinator;
+    coordinator.configure(50, 0);
+
+    std::atomic<int> accumulating(0);
+    std::atomic<int> overlaps(0);
+    std::atomic<int> flushes(0);
+    coordinator.addFlushHandler([&]() {
+        if (accumulating > 0) {
+            overlaps++;
+        }
+
+        flushes++;
+    }, []() {});
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([&]() {
+            for (int i = 0; i < 1000; i++) {
+                coordinator.withAccumulationLock([&]() {
+                    accumulating++;
+                    coordinator.recordAccumulated<cbm::PoolRecord>(1);
+                    accumulating--;
+                });
+            }
+        });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    BOOST_CHECK_GT(flushes, 0);
+    BOOST_CHECK_EQUAL(overlaps, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
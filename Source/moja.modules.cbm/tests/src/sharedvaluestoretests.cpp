@@ -0,0 +1,88 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/sharedvaluestore.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace moja::modules;
+
+typedef cbm::SharedValueStore<int, std::vector<double>> CurveStore;
+
+BOOST_AUTO_TEST_SUITE(SharedValueStoreTests);
+
+BOOST_AUTO_TEST_CASE(MissingCurveIsNull) {
+    CurveStore store;
+    BOOST_CHECK(store.find(101) == nullptr);
+    BOOST_CHECK_EQUAL(store.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(CurveIsBuiltOnce) {
+    CurveStore store;
+    int built = 0;
+    auto build = [&built]() {
+        built++;
+        return std::make_shared<std::vector<double>>(std::vector<double>{ 1.0, 2.0 });
+    };
+
+    auto first = store.getOrBuild(101, build);
+    auto second = store.getOrBuild(101, build);
+    BOOST_CHECK_EQUAL(built, 1);
+    BOOST_CHECK(first == second);
+    BOOST_CHECK(store.find(101) == first);
+}
+
+BOOST_AUTO_TEST_CASE(InsertKeepsExistingCurve) {
+    CurveStore store;
+    auto first = store.insert(101, std::make_shared<std::vector<double>>(1, 1.0));
+    auto stored = store.insert(101, std::make_shared<std::vector<double>>(1, 2.0));
+    BOOST_CHECK(stored == first);
+    BOOST_CHECK_EQUAL(store.find(101)->at(0), 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(FailedBuildReleasesKey) {
+    CurveStore store;
+    BOOST_CHECK_THROW(store.getOrBuild(101, []() -> CurveStore::ValuePtr {
+        throw std::runtime_error("bad yield table");
+    }), std::runtime_error);
+
+    BOOST_CHECK(store.find(101) == nullptr);
+    auto curve = store.getOrBuild(101, []() { return std::make_shared<std::vector<double>>(1, 3.0); });
+    BOOST_CHECK_EQUAL(curve->at(0), 3.0);
+}
+
+BOOST_AUTO_TEST_CASE(ThreadsShareOneBuildPerCurve) {
+    CurveStore store;
+    std::atomic<int> built(0);
+    std::vector<std::thread> threads;
+    std::vector<CurveStore::ValuePtr> curves(8 * 4);
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&store, &built, &curves, t]() {
+            for (int key = 0; key < 4; key++) {
+                curves[t * 4 + key] = store.getOrBuild(key, [&built, key]() {
+                    built++;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    return std::make_shared<std::vector<double>>(1, key);
+                });
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    BOOST_CHECK_EQUAL(built, 4);
+    BOOST_CHECK_EQUAL(store.size(), 4);
+    for (int t = 0; t < 8; t++) {
+        for (int key = 0; key < 4; key++) {
+            BOOST_CHECK(curves[t * 4 + key] == store.find(key));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -9,6 +9,8 @@
 #include "moja/modules/cbm/volumetobiomassconverter.h"
 
 #include <math.h>
+#include <algorithm>
+#include <memory>
 
 namespace cbm = moja::modules::cbm;
 using moja::DynamicObject;
@@ -452,3 +454,121 @@ BOOST_AUTO_TEST_CASE(GetFinalFittingRegionAndReplaceDataHW) {
 }
 
 BOOST_AUTO_TEST_SUITE_END();
+
+namespace {
+
+    // A yield table set like a real landscape's: tableCount distinct softwood/hardwood tables,
+    // varied in scale and rate of growth, each used in spuCount SPUs.
+    std::vector<std::unique_ptr<cbm::StandGrowthCurve>> yieldTableSet(int tableCount, int spuCount) {
+        std::vector<std::unique_ptr<cbm::StandGrowthCurve>> curves;
+        for (int table = 0; table < tableCount; table++) {
+            double scale = 0.5 + (table % 50) * 0.03;
+            double growthRate = 0.6 + (table / 50) * 0.05;
+            std::vector<DynamicObject> swRows;
+            for (int i = 0; i < 14; i++) {
+                swRows.push_back(DynamicObject({ { "age", i * 5 }, { "merchantable_volume", aVolumes[i] * scale } }));
+            }
+
+            std::vector<DynamicObject> hwRows;
+            for (int i = 0; i < 25; i++) {
+                double age = std::min(24.0, i * growthRate);
+                double volume = cVolumes[int(age)] + (age - int(age)) * (cVolumes[std::min(24, int(age) + 1)] - cVolumes[int(age)]);
+                hwRows.push_back(DynamicObject({ { "age", i * 5 }, { "merchantable_volume", volume } }));
+            }
+
+            for (int spu = 0; spu < spuCount; spu++) {
+                auto curve = std::make_unique<cbm::StandGrowthCurve>(table, spu);
+                cbm::TreeYieldTable swYieldTable(swRows, cbm::SpeciesType::Softwood);
+                cbm::TreeYieldTable hwYieldTable(hwRows, cbm::SpeciesType::Hardwood);
+                curve->addYieldTable(swYieldTable);
+                curve->addYieldTable(hwYieldTable);
+
+                auto swPerdFactor = std::make_unique<cbm::PERDFactor>();
+                swPerdFactor->setDefaultValue(swPerdFactors);
+                curve->setPERDFactor(std::move(swPerdFactor), cbm::SpeciesType::Softwood);
+
+                auto hwPerdFactor = std::make_unique<cbm::PERDFactor>();
+                hwPerdFactor->setDefaultValue(hwPerdFactors);
+                curve->setPERDFactor(std::move(hwPerdFactor), cbm::SpeciesType::Hardwood);
+
+                curve->processStandYieldTables();
+                curves.push_back(std::move(curve));
+            }
+        }
+
+        return curves;
+    }
+
+    // Unsmoothed softwood and hardwood carbon curves for each stand growth curve, and a smoothing job for each.
+    std::vector<cbm::SmoothingJob> smoothingJobs(const std::vector<std::unique_ptr<cbm::StandGrowthCurve>>& growthCurves,
+                                                 std::vector<std::shared_ptr<cbm::ComponentBiomassCarbonCurve>>& carbonCurves) {
+        cbm::VolumeToBiomassConverter converter;
+        std::vector<cbm::SmoothingJob> jobs;
+        for (const auto& growthCurve : growthCurves) {
+            for (auto speciesType : { cbm::SpeciesType::Softwood, cbm::SpeciesType::Hardwood }) {
+                carbonCurves.push_back(converter.generateComponentBiomassCarbonCurve(*growthCurve, speciesType));
+                jobs.push_back(cbm::SmoothingJob{ growthCurve.get(), carbonCurves.back().get(), speciesType });
+            }
+        }
+
+        return jobs;
+    }
+
+    bool identical(const cbm::ComponentBiomassCarbonCurve& lhs, const cbm::ComponentBiomassCarbonCurve& rhs) {
+        return lhs.getMerchCarbonCurve() == rhs.getMerchCarbonCurve()
+            && lhs.getFoliageCarbonCurve() == rhs.getFoliageCarbonCurve()
+            && lhs.getOtherCarbonCurve() == rhs.getOtherCarbonCurve();
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(SmootherBatchTests);
+
+BOOST_AUTO_TEST_CASE(BatchMatchesSerialSmoothing) {
+    auto growthCurves = yieldTableSet(60, 2);
+    std::vector<std::shared_ptr<cbm::ComponentBiomassCarbonCurve>> serialCurves;
+    auto serialJobs = smoothingJobs(growthCurves, serialCurves);
+    std::vector<std::shared_ptr<cbm::ComponentBiomassCarbonCurve>> batchCurves;
+    auto batchJobs = smoothingJobs(growthCurves, batchCurves);
+
+    // Each fit is made the first time in a fresh smoother, then reused for the second SPU.
+    for (const auto& job : serialJobs) {
+        cbm::Smoother().smooth(*job.standGrowthCurve, job.carbonCurve, job.speciesType);
+    }
+
+    cbm::Smoother smoother;
+    smoother.smoothAll(batchJobs, 4);
+    BOOST_CHECK(smoother.cachedFitCount() > 0);
+
+    for (size_t i = 0; i < serialCurves.size(); i++) {
+        BOOST_CHECK(identical(*serialCurves[i], *batchCurves[i]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(FullFitTableStillSmoothsTheSame) {
+    auto growthCurves = yieldTableSet(20, 1);
+    std::vector<std::shared_ptr<cbm::ComponentBiomassCarbonCurve>> unboundedCurves;
+    auto unboundedJobs = smoothingJobs(growthCurves, unboundedCurves);
+    std::vector<std::shared_ptr<cbm::ComponentBiomassCarbonCurve>> boundedCurves;
+    auto boundedJobs = smoothingJobs(growthCurves, boundedCurves);
+
+    cbm::Smoother unbounded;
+    unbounded.smoothAll(unboundedJobs, 1);
+    BOOST_REQUIRE(unbounded.cachedFitCount() > 1);
+
+    cbm::Smoother bounded(1);
+    bounded.smoothAll(boundedJobs, 1);
+    BOOST_CHECK_EQUAL(bounded.cachedFitCount(), 1);
+
+    for (size_t i = 0; i < unboundedCurves.size(); i++) {
+        BOOST_CHECK(identical(*unboundedCurves[i], *boundedCurves[i]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BatchOfNoCurvesDoesNothing) {
+    cbm::Smoother smoother;
+    smoother.smoothAll({});
+    BOOST_CHECK_EQUAL(smoother.cachedFitCount(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,223 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/spinupcache.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace moja::modules;
+
+struct SpinupCacheFile {
+    SpinupCacheFile() : path((std::filesystem::temp_directory_path()
+        / ("spinup_cache_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()))).string()) { }
+
+    ~SpinupCacheFile() { std::filesystem::remove(path); }
+
+    std::string path;
+};
+
+// Land unit state that a regular spinup leaves behind, and a stand-in for the spinup: deterministic
+// in the fields of the stand's SpinupRegrowthKey, like the sequencer's procedure when it can be replayed.
+struct SpinupStand {
+    cbm::SpinupRegrowthKey key;
+    std::vector<double> pools;
+    int age;
+    bool isDecaying;
+
+    void simulate() {
+        double mat = std::get<4>(key);
+        int returnInterval = std::get<3>(key);
+        pools.assign(3, 0.0);
+        for (int rotation = 0; rotation < 10; rotation++) {
+            for (int year = 0; year < returnInterval; year++) {
+                pools[0] += 1.5;
+                pools[1] += pools[0] * 0.02 - pools[1] * 0.01 * (1.0 + mat / 10.0);
+                pools[2] += pools[1] * 0.001;
+            }
+
+            pools[1] += pools[0] * (std::get<1>(key) == "Wildfire" ? 0.5 : 0.8);
+            pools[0] = 0.0;
+        }
+
+        pools[1] += pools[0] * (std::get<5>(key) == "Clearcut harvesting" ? 0.2 : 0.5);
+        pools[0] = 1.5 * std::get<6>(key);
+        age = std::get<6>(key);
+        isDecaying = std::get<7>(key) == 0;
+    }
+
+    std::shared_ptr<cbm::SpinupRegrowth> capture() const {
+        return std::make_shared<cbm::SpinupRegrowth>(cbm::SpinupRegrowth{ pools, age, isDecaying });
+    }
+
+    void apply(const cbm::SpinupRegrowth& regrowth) {
+        pools = regrowth.pools;
+        age = regrowth.age;
+        isDecaying = regrowth.isDecaying;
+    }
+};
+
+BOOST_AUTO_TEST_SUITE(SpinupCacheTests);
+
+BOOST_AUTO_TEST_CASE(MissReservesKeyUntilStored) {
+    cbm::SpinupCache cache;
+    cbm::SpinupCache::Key key{ 42, "Wildfire", 101, 125, -1.5 };
+    {
+        cbm::SpinupCache::Reservation reservation(cache, key);
+        BOOST_CHECK(!reservation.isCached());
+        reservation.store({ 1.0, 2.0, 3.0 });
+    }
+
+    cbm::SpinupCache::Reservation reservation(cache, key);
+    BOOST_REQUIRE(reservation.isCached());
+    BOOST_CHECK_EQUAL(reservation.values()[2], 3.0);
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(AbandonedReservationIsReleased) {
+    cbm::SpinupCache cache;
+    cbm::SpinupCache::Key key{ 42, "Wildfire", 101, 125, -1.5 };
+    {
+        cbm::SpinupCache::Reservation reservation(cache, key);
+    }
+
+    cbm::SpinupCache::Reservation reservation(cache, key);
+    BOOST_CHECK(!reservation.isCached());
+}
+
+BOOST_AUTO_TEST_CASE(OnlyOneThreadComputesEachKey) {
+    cbm::SpinupCache cache;
+    cbm::SpinupCache::Key key{ 42, "Wildfire", 101, 125, -1.5 };
+    std::atomic<int> computed(0);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; i++) {
+        threads.emplace_back([&cache, &key, &computed]() {
+            cbm::SpinupCache::Reservation reservation(cache, key);
+            if (!reservation.isCached()) {
+                computed++;
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                reservation.store({ 1.0 });
+            }
+
+            BOOST_CHECK_EQUAL(reservation.values()[0], 1.0);
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    BOOST_CHECK_EQUAL(computed, 1);
+}
+
+BOOST_AUTO_TEST_CASE(SavedResultsReloadExactly) {
+    SpinupCacheFile file;
+    auto version = cbm::SpinupCache::version({ "SoftwoodMerch", "AboveGroundSlowSoil" }, "params-1");
+    cbm::SpinupCache::Key key{ 42, "Wildfire with spaces", 101, 125, 0.1 + 0.2 };
+    {
+        cbm::SpinupCache cache;
+        cache.open(file.path, version);
+        cache.insert(key, { 1.0 / 3.0, 12345.678901234567 });
+        cache.save();
+    }
+
+    cbm::SpinupCache cache;
+    cache.open(file.path, version);
+    std::vector<double> values;
+    BOOST_REQUIRE(cache.find(key, values));
+    BOOST_CHECK_EQUAL(values[0], 1.0 / 3.0);
+    BOOST_CHECK_EQUAL(values[1], 12345.678901234567);
+}
+
+BOOST_AUTO_TEST_CASE(DifferentVersionIsNotLoaded) {
+    SpinupCacheFile file;
+    cbm::SpinupCache::Key key{ 42, "Wildfire", 101, 125, -1.5 };
+    {
+        cbm::SpinupCache cache;
+        cache.insert(key, { 1.0 });
+        cache.save(file.path, cbm::SpinupCache::version({ "SoftwoodMerch" }, ""));
+    }
+
+    cbm::SpinupCache cache;
+    BOOST_CHECK(!cache.load(file.path, cbm::SpinupCache::version({ "HardwoodMerch" }, "")));
+    BOOST_CHECK(!cache.load(file.path, cbm::SpinupCache::version({ "SoftwoodMerch" }, "params-2")));
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(VersionChangesWithParameterValues) {
+    std::vector<std::string> pools{ "SoftwoodMerch", "AboveGroundSlowSoil" };
+    auto decayParameters = [](double decayRate) {
+        moja::DynamicObject row;
+        row["pool"] = std::string("AboveGroundSlowSoil");
+        row["organic_matter_decay_rate"] = decayRate;
+        row["q10"] = 2.65;
+        return moja::DynamicVar(std::vector<moja::DynamicObject>{ row });
+    };
+
+    auto base = cbm::SpinupCache::version(pools, "", {
+        { "decay_parameters", decayParameters(0.015) }, { "slow_ag_to_bg_mixing_rate", 0.006 } });
+
+    BOOST_CHECK_EQUAL(base, cbm::SpinupCache::version(pools, "", {
+        { "decay_parameters", decayParameters(0.015) }, { "slow_ag_to_bg_mixing_rate", 0.006 } }));
+    BOOST_CHECK_NE(base, cbm::SpinupCache::version(pools, "", {
+        { "decay_parameters", decayParameters(0.0150001) }, { "slow_ag_to_bg_mixing_rate", 0.006 } }));
+    BOOST_CHECK_NE(base, cbm::SpinupCache::version(pools, "", {
+        { "decay_parameters", decayParameters(0.015) }, { "slow_ag_to_bg_mixing_rate", 0.0061 } }));
+    BOOST_CHECK_NE(base, cbm::SpinupCache::version(pools, "", {
+        { "decay_parameters", decayParameters(0.015) } }));
+    BOOST_CHECK_NE(base, cbm::SpinupCache::version(pools, ""));
+}
+
+BOOST_AUTO_TEST_CASE(ReplayedRegrowthMatchesSimulatedRegrowth) {
+    std::vector<cbm::SpinupRegrowthKey> keys{
+        cbm::SpinupRegrowthKey{ 42, "Wildfire", 101, 125, -1.5, "Wildfire", 60, 0 },
+        cbm::SpinupRegrowthKey{ 42, "Wildfire", 101, 125, -1.5, "Clearcut harvesting", 60, 0 },
+        cbm::SpinupRegrowthKey{ 42, "Wildfire", 101, 125, 2.5, "Wildfire", 60, 0 },
+        cbm::SpinupRegrowthKey{ 17, "Insects", 102, 80, -1.5, "Wildfire", 0, 12 }
+    };
+
+    // Stands start out with another stand's state, as they do when a thread moves on to its next land unit.
+    std::vector<SpinupStand> stands;
+    for (int i = 0; i < 64; i++) {
+        stands.push_back(SpinupStand{ keys[i % keys.size()], std::vector<double>(3, i), i, i % 2 == 0 });
+    }
+
+    cbm::SpinupRegrowthStore store;
+    std::atomic<int> simulated(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&store, &simulated, &stands, t]() {
+            for (size_t i = t; i < stands.size(); i += 8) {
+                auto& stand = stands[i];
+                bool wasSimulated = cbm::replaySpinupRegrowth(store, stand.key,
+                    [&stand]() { stand.simulate(); },
+                    [&stand]() { return stand.capture(); },
+                    [&stand](const cbm::SpinupRegrowth& regrowth) { stand.apply(regrowth); });
+
+                simulated += wasSimulated ? 1 : 0;
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    BOOST_CHECK_EQUAL(simulated, keys.size());
+    BOOST_CHECK_EQUAL(store.size(), keys.size());
+    for (const auto& stand : stands) {
+        SpinupStand expected{ stand.key, {}, -1, false };
+        expected.simulate();
+        BOOST_CHECK(stand.pools == expected.pools);
+        BOOST_CHECK_EQUAL(stand.age, expected.age);
+        BOOST_CHECK_EQUAL(stand.isDecaying, expected.isDecaying);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,256 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/spinupsteadystatesolver.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace moja::modules;
+
+namespace {
+
+    enum Pools { Atmosphere, Merch, Foliage, AGVeryFast, AGSlow, BGSlow, CO2, PoolCount };
+
+    /**
+     * A small stand following the same rotation procedure as CBMSpinupSequencer::runRegularSpinup:
+     * growth along a yield curve, turnover, decay, then a historic disturbance and a biomass reset.
+     */
+    class ToyStand {
+    public:
+        explicit ToyStand(bool linearDecay = true) : values(PoolCount, 0.0), _linearDecay(linearDecay) { }
+
+        void step(int age, cbm::SpinupSteadyStateSolver* recorder) {
+            double increment = curve(age + 1) - curve(age);
+            apply({ { Atmosphere, Merch, increment }, { Atmosphere, Foliage, 0.1 * increment } }, recorder);
+
+            apply({
+                proportional(Merch, AGSlow, 0.01),
+                proportional(Foliage, AGVeryFast, 0.95)
+            }, recorder);
+
+            double slowRate = _linearDecay ? 0.015 : 0.0005 * std::sqrt(values[AGSlow]);
+            apply({
+                proportional(AGVeryFast, CO2, 0.4),
+                proportional(AGVeryFast, AGSlow, 0.1),
+                proportional(AGSlow, CO2, slowRate),
+                proportional(AGSlow, BGSlow, 0.006),
+                proportional(BGSlow, CO2, 0.0033)
+            }, recorder);
+        }
+
+        void disturb(cbm::SpinupSteadyStateSolver* recorder) {
+            apply({
+                proportional(Merch, CO2, 0.6),
+                proportional(Merch, AGSlow, 0.3),
+                proportional(Foliage, CO2, 0.9),
+                proportional(AGVeryFast, CO2, 0.5)
+            }, recorder);
+
+            values[Merch] = 0;
+            values[Foliage] = 0;
+            if (recorder != nullptr) {
+                recorder->resetPools({ Merch, Foliage });
+            }
+        }
+
+        double slowPools() const { return values[AGSlow] + values[BGSlow]; }
+
+        std::vector<double> values;
+
+    private:
+        bool _linearDecay;
+
+        static double curve(int age) {
+            return 120.0 * std::pow(1.0 - std::exp(-0.03 * age), 2.0);
+        }
+
+        cbm::SpinupPoolTransfer proportional(int source, int sink, double proportion) const {
+            return cbm::SpinupPoolTransfer{ source, sink, values[source] * proportion };
+        }
+
+        void apply(const std::vector<cbm::SpinupPoolTransfer>& transfers, cbm::SpinupSteadyStateSolver* recorder) {
+            for (const auto& transfer : transfers) {
+                values[transfer.source] -= transfer.value;
+                values[transfer.sink] += transfer.value;
+            }
+
+            if (recorder != nullptr) {
+                recorder->addOperation(transfers);
+            }
+        }
+    };
+
+    const int ReturnInterval = 125;
+    const int MinimumRotations = 3;
+
+    void runPass(ToyStand& stand, cbm::SpinupSteadyStateSolver* recorder = nullptr) {
+        for (int age = 0; age < ReturnInterval; age++) {
+            stand.step(age, recorder);
+        }
+    }
+
+    /**
+     * The regular spinup loop: rotations until parameter stoppingRule stops at the end of a pass.
+     */
+    ToyStand regularSpinup(cbm::SpinupStoppingRule stoppingRule, int& rotations) {
+        ToyStand stand;
+        for (rotations = 1; ; rotations++) {
+            runPass(stand);
+            if (stoppingRule.isDone(rotations, stand.values)) {
+                return stand;
+            }
+
+            stand.disturb(nullptr);
+        }
+    }
+
+    /**
+     * The accelerated loop, in the same order as CBMSpinupSequencer::runRegularSpinup: record rotations
+     * until the remaining ones can be projected, then simulate the pass the stopping rule stops at.
+     */
+    ToyStand acceleratedSpinup(cbm::SpinupStoppingRule stoppingRule, int& rotations, int& simulatedPasses) {
+        ToyStand stand;
+        cbm::SpinupSteadyStateSolver solver(PoolCount);
+        simulatedPasses = 0;
+        for (rotations = 1; ; rotations++) {
+            solver.beginRotation(stand.values);
+            runPass(stand, &solver);
+            solver.endPass();
+            simulatedPasses++;
+            if (stoppingRule.isDone(rotations, stand.values)) {
+                return stand;
+            }
+
+            stand.disturb(&solver);
+            solver.endRotation();
+            BOOST_REQUIRE(solver.matches(stand.values));
+
+            std::vector<double> lastPassStart;
+            if (solver.project(stand.values, stoppingRule, rotations, lastPassStart)) {
+                stand.values = lastPassStart;
+                runPass(stand);
+                simulatedPasses++;
+                return stand;
+            }
+        }
+    }
+
+    cbm::SpinupStoppingRule stoppingRule(int maximumRotations) {
+        return cbm::SpinupStoppingRule({ AGSlow, BGSlow }, MinimumRotations, maximumRotations);
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(SpinupSteadyStateSolverTests);
+
+BOOST_AUTO_TEST_CASE(MatchesRegularSpinupStoppingRule) {
+    int regularRotations = 0;
+    auto regular = regularSpinup(stoppingRule(30), regularRotations);
+
+    int rotations = 0;
+    int simulatedPasses = 0;
+    auto accelerated = acceleratedSpinup(stoppingRule(30), rotations, simulatedPasses);
+
+    BOOST_CHECK_EQUAL(rotations, regularRotations);
+    BOOST_CHECK_GT(regularRotations, MinimumRotations + 1);
+    BOOST_CHECK_EQUAL(simulatedPasses, 3);
+    for (int pool = 0; pool < PoolCount; pool++) {
+        BOOST_TEST_CONTEXT("pool " << pool) {
+            BOOST_CHECK_CLOSE(accelerated.values[pool], regular.values[pool], 1e-8);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(MatchesRegularSpinupStoppedAtMaximumRotations) {
+    int regularRotations = 0;
+    auto regular = regularSpinup(stoppingRule(6), regularRotations);
+
+    int rotations = 0;
+    int simulatedPasses = 0;
+    auto accelerated = acceleratedSpinup(stoppingRule(6), rotations, simulatedPasses);
+
+    BOOST_CHECK_EQUAL(regularRotations, 6);
+    BOOST_CHECK_EQUAL(rotations, 6);
+    for (int pool = 0; pool < PoolCount; pool++) {
+        BOOST_TEST_CONTEXT("pool " << pool) {
+            BOOST_CHECK_CLOSE(accelerated.values[pool], regular.values[pool], 1e-8);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SolvesSteadyStateOfConvergedRegularSpinup) {
+    int regularRotations = 0;
+    auto converged = regularSpinup(stoppingRule(5000), regularRotations);
+    for (; regularRotations < 5000; regularRotations++) {
+        converged.disturb(nullptr);
+        runPass(converged);
+    }
+
+    ToyStand stand;
+    cbm::SpinupSteadyStateSolver solver(PoolCount);
+    for (int rotation = 0; rotation < 2; rotation++) {
+        solver.beginRotation(stand.values);
+        runPass(stand, &solver);
+        solver.endPass();
+        stand.disturb(&solver);
+        solver.endRotation();
+    }
+
+    std::vector<double> steadyState;
+    BOOST_REQUIRE(solver.solve(steadyState));
+    stand.values = steadyState;
+    runPass(stand);
+
+    for (int pool : { Merch, Foliage, AGVeryFast, AGSlow, BGSlow }) {
+        BOOST_CHECK_CLOSE(stand.values[pool], converged.values[pool], 1e-6);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ProjectionNeedsPassEnd) {
+    ToyStand stand;
+    cbm::SpinupSteadyStateSolver solver(PoolCount);
+    for (int rotation = 0; rotation < 2; rotation++) {
+        solver.beginRotation(stand.values);
+        runPass(stand, &solver);
+        stand.disturb(&solver);
+        solver.endRotation();
+    }
+
+    auto rule = stoppingRule(30);
+    int rotations = 2;
+    std::vector<double> lastPassStart;
+    BOOST_CHECK(!solver.project(stand.values, rule, rotations, lastPassStart));
+    BOOST_CHECK_EQUAL(rotations, 2);
+}
+
+BOOST_AUTO_TEST_CASE(NonLinearDecayIsNotSolvedOrProjected) {
+    ToyStand stand(false);
+    cbm::SpinupSteadyStateSolver solver(PoolCount);
+    for (int rotation = 0; rotation < 3; rotation++) {
+        solver.beginRotation(stand.values);
+        runPass(stand, &solver);
+        solver.endPass();
+        stand.disturb(&solver);
+        solver.endRotation();
+
+        std::vector<double> steadyState;
+        BOOST_CHECK(!solver.solve(steadyState));
+
+        auto rule = stoppingRule(30);
+        int rotations = rotation + 1;
+        BOOST_CHECK(!solver.project(stand.values, rule, rotations, steadyState));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DetectsChangesOutsideOperations) {
+    ToyStand stand;
+    cbm::SpinupSteadyStateSolver solver(PoolCount);
+    solver.beginRotation(stand.values);
+    runPass(stand, &solver);
+    BOOST_CHECK(solver.matches(stand.values));
+
+    stand.values[AGSlow] += 10.0;
+    BOOST_CHECK(!solver.matches(stand.values));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
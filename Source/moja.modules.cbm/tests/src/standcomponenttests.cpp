@@ -0,0 +1,105 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/componentbiomasscarboncurve.h"
+#include "moja/modules/cbm/standcomponent.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+using namespace moja::modules;
+
+namespace {
+
+    // A component curve that grows, then declines, so that some increments are negative. The other
+    // carbon curve runs past the maximum age, so the three curves have different lengths.
+    std::shared_ptr<cbm::ComponentBiomassCarbonCurve> growthCurve() {
+        const int maxAge = 60;
+        auto curve = std::make_shared<cbm::ComponentBiomassCarbonCurve>(maxAge);
+        for (int age = 0; age <= maxAge; age++) {
+            double carbon = 80.0 * std::pow(1.0 - std::exp(-0.05 * age), 3.0) * (age > 40 ? 1.0 - 0.04 * (age - 40) : 1.0);
+            curve->setMerchCarbonAtAge(age, carbon);
+            curve->setFoliageCarbonAtAge(age, 0.1 * carbon);
+        }
+
+        for (int age = 0; age <= maxAge + 15; age++) {
+            curve->setOtherCarbonAtAge(age, 0.3 * std::sqrt(age));
+        }
+
+        return curve;
+    }
+
+    // The increments of a growth step as the component got them from the curve on every step.
+    cbm::ComponentBiomassCarbonIncrements perStepIncrements(
+            const cbm::ComponentBiomassCarbonCurve& curve, int age, double merch, double other, double foliage) {
+
+        cbm::ComponentBiomassCarbonIncrements increments;
+        increments.merch = std::max(curve.getMerchCarbonIncrement(age), -merch);
+        increments.other = std::max(curve.getOtherCarbonIncrement(age), -other);
+        increments.foliage = std::max(curve.getFoliageCarbonIncrement(age), -foliage);
+
+        return increments;
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(StandComponentTests);
+
+BOOST_AUTO_TEST_CASE(PrecomputedIncrementsMatchPerStepIncrements) {
+    auto curve = growthCurve();
+    cbm::StandComponent component("Softwood", nullptr, curve);
+
+    // Pools large enough that no increment is limited by the pool value.
+    for (int age = -5; age < 100; age++) {
+        BOOST_TEST_CONTEXT("age " << age) {
+            auto expected = perStepIncrements(*curve, age, 1000.0, 1000.0, 1000.0);
+            auto actual = component.getAGIncrements(age, 1000.0, 1000.0, 1000.0);
+            BOOST_CHECK_EQUAL(actual.merch, expected.merch);
+            BOOST_CHECK_EQUAL(actual.other, expected.other);
+            BOOST_CHECK_EQUAL(actual.foliage, expected.foliage);
+            BOOST_CHECK_EQUAL(actual.coarseRoots, 0.0);
+            BOOST_CHECK_EQUAL(actual.fineRoots, 0.0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(NoIncrementsOutsideTheCurve) {
+    auto curve = growthCurve();
+    cbm::StandComponent component("Softwood", nullptr, curve);
+
+    for (int age : { -100, -1, 76, 200 }) {
+        BOOST_TEST_CONTEXT("age " << age) {
+            auto increments = component.getAGIncrements(age, 10.0, 10.0, 10.0);
+            BOOST_CHECK_EQUAL(increments.merch, 0.0);
+            BOOST_CHECK_EQUAL(increments.other, 0.0);
+            BOOST_CHECK_EQUAL(increments.foliage, 0.0);
+        }
+    }
+
+    // Merch and foliage end at the maximum age while other carbon still grows.
+    auto increments = component.getAGIncrements(65, 10.0, 10.0, 10.0);
+    BOOST_CHECK_EQUAL(increments.merch, 0.0);
+    BOOST_CHECK_EQUAL(increments.foliage, 0.0);
+    BOOST_CHECK_GT(increments.other, 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(DecliningIncrementsAreLimitedByThePoolValues) {
+    auto curve = growthCurve();
+    cbm::StandComponent component("Softwood", nullptr, curve);
+
+    int limited = 0;
+    for (int age = 41; age < 60; age++) {
+        BOOST_TEST_CONTEXT("age " << age) {
+            auto expected = perStepIncrements(*curve, age, 0.1, 0.1, 0.01);
+            auto actual = component.getAGIncrements(age, 0.1, 0.1, 0.01);
+            BOOST_CHECK_EQUAL(actual.merch, expected.merch);
+            BOOST_CHECK_EQUAL(actual.other, expected.other);
+            BOOST_CHECK_EQUAL(actual.foliage, expected.foliage);
+            limited += actual.merch == -0.1 ? 1 : 0;
+        }
+    }
+
+    BOOST_CHECK_GT(limited, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,188 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/timeseries.h"
+
+#include <moja/flint/timing.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace moja;
+using namespace moja::modules;
+
+namespace {
+
+    // Annual timing over ten years, the usual setup for climate timeseries.
+    void initTiming(flint::Timing& timing) {
+        timing.setStartDate(DateTime(2000, 1, 1));
+        timing.setEndDate(DateTime(2010, 1, 1));
+        timing.setStepping(flint::TimeStepping::Annual);
+        timing.init();
+    }
+
+    void initTiming(flint::Timing& timing, DateTime startDate, DateTime endDate, flint::TimeStepping stepping) {
+        timing.setStartDate(startDate);
+        timing.setEndDate(endDate);
+        timing.setStepping(stepping);
+        timing.init();
+    }
+
+    // Random raw data for a series, with roughly one value in gapEvery missing after the
+    // first year, so every column has data.
+    std::vector<boost::optional<double>> randomRaw(std::mt19937& rng, int dataPerYr, int nYrs, int gapEvery) {
+        std::uniform_real_distribution<double> value(0.0, 100.0);
+        std::uniform_int_distribution<int> gap(0, gapEvery - 1);
+        std::vector<boost::optional<double>> raw;
+        for (int i = 0; i < dataPerYr * nYrs; i++) {
+            raw.push_back(i >= dataPerYr && gap(rng) == 0 ? boost::optional<double>() : boost::optional<double>(value(rng)));
+        }
+
+        return raw;
+    }
+
+    bool close(double expected, double actual) {
+        return std::fabs(expected - actual) <= 1e-12 * std::max(1.0, std::fabs(expected));
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(TimeSeriesTests);
+
+BOOST_AUTO_TEST_CASE(SinglePrecisionRawDataGivesTheSameSeries) {
+    flint::Timing timing;
+    initTiming(timing);
+
+    std::vector<boost::optional<double>> rawDouble{ 1.5, boost::none, 4.25, 2.0, boost::none, 8.0 };
+    std::vector<boost::optional<float>> rawFloat{ 1.5f, boost::none, 4.25f, 2.0f, boost::none, 8.0f };
+
+    cbm::TimeSeries fromDouble(1, 1, 6, true, rawDouble);
+    cbm::TimeSeries fromFloat(1, 1, 6, true, rawFloat);
+    fromDouble.setTiming(&timing);
+    fromFloat.setTiming(&timing);
+
+    const auto& expected = fromDouble.series();
+    const auto& actual = fromFloat.series();
+    BOOST_CHECK_EQUAL_COLLECTIONS(actual.begin(), actual.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(GapsAreFilledWithTheColumnAverage) {
+    flint::Timing timing;
+    initTiming(timing);
+
+    cbm::TimeSeries withGap(0, 1, 3, true, std::vector<boost::optional<double>>{ 1.0, boost::none, 5.0 });
+    cbm::TimeSeries filled(0, 1, 3, true, std::vector<boost::optional<double>>{ 1.0, 3.0, 5.0 });
+    withGap.setTiming(&timing);
+    filled.setTiming(&timing);
+
+    const auto& expected = filled.series();
+    const auto& actual = withGap.series();
+    BOOST_CHECK_EQUAL_COLLECTIONS(actual.begin(), actual.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(RawDataKeepsItsMissingValues) {
+    cbm::TimeSeries series(0, 1, 3, true, std::vector<boost::optional<float>>{ 1.0f, boost::none, 5.0f });
+
+    auto raw = series.raw();
+    BOOST_REQUIRE_EQUAL(raw.size(), 3);
+    BOOST_CHECK_EQUAL(raw[0].get(), 1.0);
+    BOOST_CHECK(!raw[1].is_initialized());
+    BOOST_CHECK_EQUAL(raw[2].get(), 5.0);
+}
+
+BOOST_AUTO_TEST_CASE(ColumnWithoutDataIsAnError) {
+    flint::Timing timing;
+    initTiming(timing);
+
+    cbm::TimeSeries series(0, 2, 2, true, std::vector<boost::optional<double>>{ 1.0, boost::none, 2.0, boost::none });
+    series.setTiming(&timing);
+    BOOST_CHECK_THROW(series.series(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(AllNaNRawDataHasNoData) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    std::vector<boost::optional<float>> allNaN{ nan, boost::none, nan };
+    BOOST_CHECK(!cbm::TimeSeries::hasData(allNaN));
+    BOOST_CHECK(!cbm::TimeSeries::hasData(std::vector<boost::optional<float>>{}));
+    BOOST_CHECK(cbm::TimeSeries::hasData(std::vector<boost::optional<float>>{ nan, 2.0f, boost::none }));
+
+    // Without the check, a timeseries of the cell fails when it is first read.
+    flint::Timing timing;
+    initTiming(timing);
+    cbm::TimeSeries series(0, 1, 3, true, allNaN);
+    series.setTiming(&timing);
+    BOOST_CHECK_THROW(series.series(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(BatchGivesTheSameSeriesAsTimeSeries) {
+    struct Layout {
+        int yr0;
+        int dataPerYr;
+        int nYrs;
+        bool subSame;
+        cbm::DateOrigin origin;
+    };
+
+    std::vector<Layout> layouts{
+        { 0, 1, 1, true, cbm::DateOrigin::StartSim },
+        { 0, 1, 5, true, cbm::DateOrigin::StartSim },
+        { 1, 12, 3, false, cbm::DateOrigin::StartSim },
+        { 1995, 12, 10, true, cbm::DateOrigin::Calendar },
+        { 2003, 4, 2, false, cbm::DateOrigin::Calendar },
+        { 2012, 1, 3, true, cbm::DateOrigin::Calendar },
+        { 0, 365, 2, false, cbm::DateOrigin::Sprout }
+    };
+
+    flint::Timing annual;
+    initTiming(annual, DateTime(2000, 1, 1), DateTime(2010, 1, 1), flint::TimeStepping::Annual);
+    flint::Timing monthly;
+    initTiming(monthly, DateTime(2001, 4, 1), DateTime(2006, 9, 1), flint::TimeStepping::Monthly);
+
+    std::mt19937 rng(42);
+    int mismatches = 0;
+    for (const auto& layout : layouts) {
+        for (const flint::ITiming* timing : { static_cast<flint::ITiming*>(&annual), static_cast<flint::ITiming*>(&monthly) }) {
+            // More series than are prepared together, so the last group is partly filled.
+            cbm::TimeSeriesBatch batch(layout.yr0, layout.dataPerYr, layout.nYrs, layout.subSame, layout.origin, 3);
+            std::vector<cbm::TimeSeries> expected;
+            for (int i = 0; i < 150; i++) {
+                auto raw = randomRaw(rng, layout.dataPerYr, layout.nYrs, 5);
+                BOOST_CHECK_EQUAL(batch.add(raw), i);
+                expected.emplace_back(layout.yr0, layout.dataPerYr, layout.nYrs, layout.subSame, raw, layout.origin, 3);
+                expected.back().setTiming(timing);
+            }
+
+            batch.prepare(timing);
+            for (size_t i = 0; i < expected.size(); i++) {
+                const auto& series = expected[i].series();
+                auto view = batch.series(i);
+                BOOST_REQUIRE_EQUAL(view.size(), series.size());
+                for (size_t step = 0; step < series.size(); step++) {
+                    mismatches += close(series[step], view[step]) ? 0 : 1;
+                }
+            }
+        }
+    }
+
+    BOOST_CHECK_EQUAL(mismatches, 0);
+}
+
+BOOST_AUTO_TEST_CASE(BatchRejectsSeriesOfTheWrongLength) {
+    cbm::TimeSeriesBatch batch(0, 12, 2, true);
+    BOOST_CHECK_THROW(batch.add(std::vector<boost::optional<double>>(12, 1.0)), std::invalid_argument);
+    BOOST_CHECK_EQUAL(batch.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(BatchColumnWithoutDataIsAnError) {
+    flint::Timing timing;
+    initTiming(timing);
+
+    cbm::TimeSeriesBatch batch(0, 2, 2, true);
+    batch.add(std::vector<boost::optional<double>>{ 1.0, 2.0, 3.0, 4.0 });
+    batch.add(std::vector<boost::optional<double>>{ 1.0, boost::none, 2.0, boost::none });
+    BOOST_CHECK_THROW(batch.prepare(&timing), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,166 @@
+#include <boost/test/unit_test.hpp>
+
+#include "moja/modules/cbm/timeseries.h"
+#include "moja/modules/cbm/variableslot.h"
+
+#include <moja/flint/timing.h>
+#include <moja/flint/variable.h>
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace moja;
+using namespace moja::modules;
+
+namespace {
+
+    // Annual timing over parameter years.
+    void initTiming(flint::Timing& timing, int years) {
+        timing.setStartDate(DateTime(2000, 1, 1));
+        timing.setEndDate(DateTime(2000 + years, 1, 1));
+        timing.setStepping(flint::TimeStepping::Annual);
+        timing.init();
+    }
+
+    // Land unit variables by name, looked up the way CBMModuleBase resolves its bindings.
+    class LandUnitVariables {
+    public:
+        void add(const std::string& name, DynamicVar value) {
+            _variables[name] = std::make_shared<flint::Variable>(value, flint::VariableInfo{ name });
+        }
+
+        void resolve(const cbm::VariableBindings& bindings) {
+            bindings.resolve([this](const std::string& name) -> flint::IVariable* {
+                auto variable = _variables.find(name);
+                return variable == _variables.end() ? nullptr : variable->second.get();
+            });
+        }
+
+    private:
+        std::map<std::string, std::shared_ptr<flint::Variable>> _variables;
+    };
+
+}
+
+BOOST_AUTO_TEST_SUITE(VariableSlotTests);
+
+BOOST_AUTO_TEST_CASE(ValuesAreConvertedToTheSlotType) {
+    cbm::VariableSlot<int> age;
+    age.assign(DynamicVar(12.0));
+    BOOST_CHECK_EQUAL(age.value(), 12);
+
+    cbm::VariableSlot<bool> enabled;
+    enabled.assign(DynamicVar(true));
+    BOOST_CHECK(enabled.value());
+
+    cbm::VariableSlot<double> rate;
+    rate.assign(DynamicVar(3));
+    BOOST_CHECK_EQUAL(rate.value(), 3.0);
+    BOOST_CHECK(!rate.isBound());
+}
+
+BOOST_AUTO_TEST_CASE(EmptyValuesGiveTheFallback) {
+    cbm::VariableSlot<int> peatlandClass;
+    peatlandClass.assign(DynamicVar(), -1);
+    BOOST_CHECK_EQUAL(peatlandClass.value(), -1);
+
+    cbm::TimeSeriesSlot mat;
+    mat.assign(DynamicVar(), 2.5);
+    BOOST_CHECK(!mat.isSeries());
+    BOOST_CHECK_EQUAL(mat.value(), 2.5);
+
+    mat.assign(DynamicVar(-1.5), 2.5);
+    BOOST_CHECK_EQUAL(mat.value(), -1.5);
+}
+
+BOOST_AUTO_TEST_CASE(TimeSeriesSlotFollowsTheCurrentStep) {
+    flint::Timing timing;
+    initTiming(timing, 5);
+
+    cbm::TimeSeries series(0, 1, 6, true, std::vector<boost::optional<double>>{ 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 });
+    series.setTiming(&timing);
+
+    cbm::TimeSeriesSlot mat;
+    mat.assign(DynamicVar(series));
+    BOOST_REQUIRE(mat.isSeries());
+    for (int step = 0; step < timing.nSteps(); step++) {
+        timing.setStep(step);
+        BOOST_CHECK_EQUAL(mat.value(), series.value());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(RequiredVariablesAreBound) {
+    LandUnitVariables variables;
+    variables.add("age", DynamicVar(12));
+    variables.add("mean_annual_temperature", DynamicVar(-1.5));
+
+    cbm::VariableHandle<int> age;
+    cbm::TimeSeriesSlot mat;
+    cbm::VariableBindings bindings;
+    bindings.add("age", age);
+    bindings.add("mean_annual_temperature", mat);
+    variables.resolve(bindings);
+
+    BOOST_REQUIRE(age.isBound());
+    BOOST_CHECK_EQUAL(age.value(), 12);
+    age.set(13);
+    BOOST_CHECK_EQUAL(age.valueOr(-1), 13);
+
+    BOOST_REQUIRE(mat.isBound());
+    mat.load();
+    BOOST_CHECK_EQUAL(mat.value(), -1.5);
+}
+
+BOOST_AUTO_TEST_CASE(OptionalVariablesAreBoundIfTheyExist) {
+    LandUnitVariables variables;
+    variables.add("enable_peatland", DynamicVar(true));
+    variables.add("peatland_class", DynamicVar());
+
+    cbm::VariableHandle<bool> enablePeatland;
+    cbm::VariableHandle<int> peatlandClass;
+    cbm::VariableBindings bindings;
+    bindings.add("enable_peatland", enablePeatland, true);
+    bindings.add("peatland_class", peatlandClass, true);
+    variables.resolve(bindings);
+
+    BOOST_REQUIRE(enablePeatland.isBound());
+    BOOST_CHECK(enablePeatland.value());
+    BOOST_REQUIRE(peatlandClass.isBound());
+    BOOST_CHECK_EQUAL(peatlandClass.valueOr(-1), -1);
+}
+
+BOOST_AUTO_TEST_CASE(MissingOptionalVariablesAreUnboundAndCannotBeRead) {
+    LandUnitVariables variables;
+
+    cbm::VariableHandle<int> peatlandClass;
+    cbm::VariableSlot<double> snagSplit;
+    cbm::VariableBindings bindings;
+    bindings.add("peatland_class", peatlandClass, true);
+    bindings.add("other_to_branch_snag_split", snagSplit, true);
+    variables.resolve(bindings);
+
+    BOOST_CHECK(!peatlandClass.isBound());
+    BOOST_CHECK_THROW(peatlandClass.valueOr(-1), std::runtime_error);
+    BOOST_CHECK_THROW(peatlandClass.raw(), std::runtime_error);
+    BOOST_CHECK_THROW(peatlandClass.set(1), std::runtime_error);
+
+    BOOST_CHECK(!snagSplit.isBound());
+    BOOST_CHECK_THROW(snagSplit.load(0.25), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(MissingRequiredVariablesAreAnError) {
+    LandUnitVariables variables;
+    variables.add("age", DynamicVar(12));
+
+    cbm::VariableHandle<int> age;
+    cbm::VariableHandle<int> spatialUnit;
+    cbm::VariableBindings bindings;
+    bindings.add("age", age);
+    bindings.add("spatial_unit_id", spatialUnit);
+    BOOST_CHECK_THROW(variables.resolve(bindings), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -260,3 +260,20 @@ BOOST_AUTO_TEST_CASE(GetBGBiomassIncrements) {
 
 BOOST_AUTO_TEST_SUITE_END();
 */
+
+BOOST_AUTO_TEST_SUITE(VolumeToBiomassCarbonGrowthTests);
+
+BOOST_AUTO_TEST_CASE(MissingCurveNamesGrowthCurve) {
+    cbm::VolumeToBiomassCarbonGrowth volumeToBioGrowth;
+    BOOST_CHECK(!volumeToBioGrowth.isBiomassCarbonCurveAvailable(101, 5));
+
+    auto namesCurve = [](const std::runtime_error& e) {
+        return std::string(e.what()).find("growth curve 101") != std::string::npos;
+    };
+
+    BOOST_CHECK_EXCEPTION(volumeToBioGrowth.getAboveGroundCarbonCurve(101, 5), std::runtime_error, namesCurve);
+    BOOST_CHECK_EXCEPTION(volumeToBioGrowth.getFoliageCarbonCurve(101, 5), std::runtime_error, namesCurve);
+    BOOST_CHECK_EXCEPTION(volumeToBioGrowth.getBiomassCarbonIncrements(nullptr, 101, 5), std::runtime_error, namesCurve);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
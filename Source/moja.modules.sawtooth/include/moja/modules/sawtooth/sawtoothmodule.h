@@ -116,6 +116,7 @@ namespace cbm {
 		int RCP_Id;
 		int GCM_Id;
 		std::unordered_set<const moja::flint::IPool*> bioPools;
+		std::vector<const moja::flint::IPool*> _pools;
 
 		SawtoothMatrixWrapper<Sawtooth_Matrix_Int, int> speciesList;
 
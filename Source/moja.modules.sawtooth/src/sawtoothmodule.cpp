@@ -161,6 +161,10 @@ namespace cbm {
 	}
 
 	void SawtoothModule::doLocalDomainInit() {
+		_pools.assign(_landUnitData->poolCollection().size(), nullptr);
+		for (const auto pool : _landUnitData->poolCollection()) {
+			_pools[pool->idx()] = pool;
+		}
 
 		_softwoodMerch = _landUnitData->getPool("SoftwoodMerch");
 		_softwoodFoliage = _landUnitData->getPool("SoftwoodFoliage");
@@ -455,6 +459,18 @@ namespace cbm {
 
 		auto& data = e.extract<DynamicObject>();
 		auto distMatrix = data["transfers"].extract<std::shared_ptr<std::vector<CBMDistEventTransfer>>>();
+		if (data.contains("disturbance_matrix")) {
+			//the CBM matrix is shared by all events: copy it into this event's 
+			//transfers so it can be adjusted, and stop the shared one being applied
+			auto sharedMatrix = data["disturbance_matrix"].extract<std::shared_ptr<DisturbanceMatrixStore::Matrix>>();
+			for (size_t r = 0; r < sharedMatrix->size(); r++) {
+				distMatrix->push_back(CBMDistEventTransfer(sharedMatrix->id(),
+					_pools[sharedMatrix->sourcePool(r)], _pools[sharedMatrix->sinkPool(r)],
+					sharedMatrix->proportion(r)));
+			}
+
+			*sharedMatrix = DisturbanceMatrixStore::Matrix();
+		}
 
 		std::unordered_map<const moja::flint::IPool*, double> bioLossProportions;
 		for (auto row : *distMatrix.get()) {